@@ -8,6 +8,7 @@
 #include <cstdio>
 #include <cstring>
 #include <iterator> // std::size
+#include <limits>
 #include <string_view>
 
 #include "system.h"
@@ -28,6 +29,7 @@
 #if defined(CONF_FAMILY_UNIX)
 #include <csignal>
 #include <locale>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/utsname.h>
@@ -142,7 +144,16 @@ IOHANDLE io_current_exe()
 #endif
 }
 
-static NETSTATS network_stats = {0};
+/* the counters are updated from the server's network threads as well */
+static struct
+{
+	std::atomic<uint64_t> sent_packets{0};
+	std::atomic<uint64_t> sent_bytes{0};
+	std::atomic<uint64_t> recv_packets{0};
+	std::atomic<uint64_t> recv_bytes{0};
+	std::atomic<uint64_t> send_calls{0};
+	std::atomic<uint64_t> recv_calls{0};
+} network_stats;
 
 #define VLEN 128
 #define PACKETSIZE 1400
@@ -160,6 +171,24 @@ typedef struct
 #endif
 } NETSOCKET_BUFFER;
 
+#ifdef CONF_PLATFORM_LINUX
+typedef struct
+{
+	int count;
+	struct mmsghdr msgs[VLEN];
+	struct iovec iovecs[VLEN];
+	char bufs[VLEN][PACKETSIZE];
+	char sockaddrs[VLEN][128];
+} NETSOCKET_SENDQUEUE;
+
+enum
+{
+	SENDQUEUE_IPV4 = 0,
+	SENDQUEUE_IPV6,
+	NUM_SENDQUEUES,
+};
+#endif
+
 void net_buffer_init(NETSOCKET_BUFFER *buffer);
 void net_buffer_reinit(NETSOCKET_BUFFER *buffer);
 void net_buffer_simple(NETSOCKET_BUFFER *buffer, char **buf, int *size);
@@ -172,6 +201,10 @@ struct NETSOCKET_INTERNAL
 	int web_ipv4sock;
 
 	NETSOCKET_BUFFER buffer;
+#ifdef CONF_PLATFORM_LINUX
+	/* only allocated while send batching is enabled */
+	NETSOCKET_SENDQUEUE *send_queues;
+#endif
 };
 static NETSOCKET_INTERNAL invalid_socket = {NETTYPE_INVALID, -1, -1, -1};
 
@@ -471,6 +504,31 @@ int io_sync(IOHANDLE io)
 #endif
 }
 
+bool io_map(IOHANDLE io, void **data, size_t *size)
+{
+#if defined(CONF_FAMILY_WINDOWS)
+	// a mapped file can't be replaced by renaming another file over it
+	return false;
+#else
+	struct stat file_stat;
+	if(fstat(fileno((FILE *)io), &file_stat) != 0 || file_stat.st_size <= 0 || (uint64_t)file_stat.st_size > std::numeric_limits<size_t>::max())
+		return false;
+	void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno((FILE *)io), 0);
+	if(mapping == MAP_FAILED)
+		return false;
+	*data = mapping;
+	*size = file_stat.st_size;
+	return true;
+#endif
+}
+
+void io_unmap(void *data, size_t size)
+{
+#if !defined(CONF_FAMILY_WINDOWS)
+	munmap(data, size);
+#endif
+}
+
 #define ASYNC_BUFSIZE (8 * 1024)
 #define ASYNC_LOCAL_BUFSIZE (64 * 1024)
 
@@ -1523,6 +1581,10 @@ static void priv_net_close_socket(int sock)
 
 static int priv_net_close_all_sockets(NETSOCKET sock)
 {
+#if defined(CONF_PLATFORM_LINUX)
+	net_udp_set_batching(sock, 0);
+#endif
+
 	/* close down ipv4 */
 	if(sock->ipv4sock >= 0)
 	{
@@ -1567,7 +1629,7 @@ std::string windows_format_system_message(unsigned long error)
 }
 #endif
 
-static int priv_net_create_socket(int domain, int type, struct sockaddr *addr, int sockaddrlen)
+static int priv_net_create_socket(int domain, int type, struct sockaddr *addr, int sockaddrlen, int reuse_port = 0)
 {
 	int sock, e;
 
@@ -1596,6 +1658,17 @@ static int priv_net_create_socket(int domain, int type, struct sockaddr *addr, i
 	}
 #endif
 
+	if(reuse_port)
+	{
+#if defined(SO_REUSEPORT)
+		int option = 1;
+		if(setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, (const char *)&option, sizeof(option)) != 0)
+			dbg_msg("socket", "Setting SO_REUSEPORT failed: %d", errno);
+#else
+		dbg_msg("socket", "SO_REUSEPORT is not supported on this platform");
+#endif
+	}
+
 	/* set to IPv6 only if that's what we are creating */
 #if defined(IPV6_V6ONLY) /* windows sdk 6.1 and higher */
 	if(domain == AF_INET6)
@@ -1630,7 +1703,7 @@ int net_socket_type(NETSOCKET sock)
 	return sock->type;
 }
 
-NETSOCKET net_udp_create(NETADDR bindaddr)
+NETSOCKET net_udp_create(NETADDR bindaddr, int reuse_port)
 {
 	NETSOCKET sock = (NETSOCKET_INTERNAL *)malloc(sizeof(*sock));
 	*sock = invalid_socket;
@@ -1645,7 +1718,7 @@ NETSOCKET net_udp_create(NETADDR bindaddr)
 		/* bind, we should check for error */
 		tmpbindaddr.type = NETTYPE_IPV4;
 		netaddr_to_sockaddr_in(&tmpbindaddr, &addr);
-		socket = priv_net_create_socket(AF_INET, SOCK_DGRAM, (struct sockaddr *)&addr, sizeof(addr));
+		socket = priv_net_create_socket(AF_INET, SOCK_DGRAM, (struct sockaddr *)&addr, sizeof(addr), reuse_port);
 		if(socket >= 0)
 		{
 			sock->type |= NETTYPE_IPV4;
@@ -1690,7 +1763,7 @@ NETSOCKET net_udp_create(NETADDR bindaddr)
 		/* bind, we should check for error */
 		tmpbindaddr.type = NETTYPE_IPV6;
 		netaddr_to_sockaddr_in6(&tmpbindaddr, &addr);
-		socket = priv_net_create_socket(AF_INET6, SOCK_DGRAM, (struct sockaddr *)&addr, sizeof(addr));
+		socket = priv_net_create_socket(AF_INET6, SOCK_DGRAM, (struct sockaddr *)&addr, sizeof(addr), reuse_port);
 		if(socket >= 0)
 		{
 			sock->type |= NETTYPE_IPV6;
@@ -1727,6 +1800,53 @@ NETSOCKET net_udp_create(NETADDR bindaddr)
 	return sock;
 }
 
+#if defined(CONF_PLATFORM_LINUX)
+static int priv_net_flush_send_queue(int socket, NETSOCKET_SENDQUEUE *queue)
+{
+	int sent = 0;
+	while(sent < queue->count)
+	{
+		network_stats.send_calls++;
+		int result = sendmmsg(socket, &queue->msgs[sent], queue->count - sent, 0);
+		if(result <= 0)
+		{
+			/* the first remaining packet failed, drop it like a failed sendto */
+			sent++;
+			continue;
+		}
+		sent += result;
+	}
+	queue->count = 0;
+	return sent;
+}
+#endif
+
+static int priv_net_udp_sendto(NETSOCKET sock, int ipv6, const void *data, int size, const struct sockaddr *addr, int addrlen)
+{
+	int socket = ipv6 ? sock->ipv6sock : sock->ipv4sock;
+#if defined(CONF_PLATFORM_LINUX)
+	if(sock->send_queues)
+	{
+		NETSOCKET_SENDQUEUE *queue = &sock->send_queues[ipv6 ? SENDQUEUE_IPV6 : SENDQUEUE_IPV4];
+		if(size <= PACKETSIZE)
+		{
+			if(queue->count == VLEN)
+				priv_net_flush_send_queue(socket, queue);
+			int i = queue->count++;
+			mem_copy(queue->bufs[i], data, size);
+			mem_copy(queue->sockaddrs[i], addr, addrlen);
+			queue->iovecs[i].iov_len = size;
+			queue->msgs[i].msg_hdr.msg_namelen = addrlen;
+			return size;
+		}
+		/* keep the packet order for oversized packets */
+		priv_net_flush_send_queue(socket, queue);
+	}
+#endif
+	network_stats.send_calls++;
+	return sendto(socket, (const char *)data, size, 0, addr, addrlen);
+}
+
 int net_udp_send(NETSOCKET sock, const NETADDR *addr, const void *data, int size)
 {
 	int d = -1;
@@ -1746,7 +1866,7 @@ int net_udp_send(NETSOCKET sock, const NETADDR *addr, const void *data, int size
 			else
 				netaddr_to_sockaddr_in(addr, &sa);
 
-			d = sendto((int)sock->ipv4sock, (const char *)data, size, 0, (struct sockaddr *)&sa, sizeof(sa));
+			d = priv_net_udp_sendto(sock, 0, data, size, (struct sockaddr *)&sa, sizeof(sa));
 		}
 		else
 			dbg_msg("net", "can't send ipv4 traffic to this socket");
@@ -1784,7 +1904,7 @@ int net_udp_send(NETSOCKET sock, const NETADDR *addr, const void *data, int size
 			else
 				netaddr_to_sockaddr_in6(addr, &sa);
 
-			d = sendto((int)sock->ipv6sock, (const char *)data, size, 0, (struct sockaddr *)&sa, sizeof(sa));
+			d = priv_net_udp_sendto(sock, 1, data, size, (struct sockaddr *)&sa, sizeof(sa));
 		}
 		else
 			dbg_msg("net", "can't send ipv6 traffic to this socket");
@@ -1810,6 +1930,49 @@ int net_udp_send(NETSOCKET sock, const NETADDR *addr, const void *data, int size
 	return d;
 }
 
+void net_udp_set_batching(NETSOCKET sock, int enable)
+{
+#if defined(CONF_PLATFORM_LINUX)
+	if(enable && !sock->send_queues)
+	{
+		sock->send_queues = (NETSOCKET_SENDQUEUE *)malloc(sizeof(*sock->send_queues) * NUM_SENDQUEUES);
+		for(int q = 0; q < NUM_SENDQUEUES; q++)
+		{
+			NETSOCKET_SENDQUEUE *queue = &sock->send_queues[q];
+			queue->count = 0;
+			mem_zero(queue->msgs, sizeof(queue->msgs));
+			for(int i = 0; i < VLEN; i++)
+			{
+				queue->iovecs[i].iov_base = queue->bufs[i];
+				queue->msgs[i].msg_hdr.msg_iov = &queue->iovecs[i];
+				queue->msgs[i].msg_hdr.msg_iovlen = 1;
+				queue->msgs[i].msg_hdr.msg_name = queue->sockaddrs[i];
+			}
+		}
+	}
+	else if(!enable && sock->send_queues)
+	{
+		net_udp_flush(sock);
+		free(sock->send_queues);
+		sock->send_queues = nullptr;
+	}
+#endif
+}
+
+int net_udp_flush(NETSOCKET sock)
+{
+	int sent = 0;
+#if defined(CONF_PLATFORM_LINUX)
+	if(!sock->send_queues)
+		return 0;
+	if(sock->ipv4sock >= 0)
+		sent += priv_net_flush_send_queue(sock->ipv4sock, &sock->send_queues[SENDQUEUE_IPV4]);
+	if(sock->ipv6sock >= 0)
+		sent += priv_net_flush_send_queue(sock->ipv6sock, &sock->send_queues[SENDQUEUE_IPV6]);
+#endif
+	return sent;
+}
+
 void net_buffer_init(NETSOCKET_BUFFER *buffer)
 {
 #if defined(CONF_PLATFORM_LINUX)
@@ -1863,6 +2026,7 @@ int net_udp_recv(NETSOCKET sock, NETADDR *addr, unsigned char **data)
 		if(sock->buffer.pos >= sock->buffer.size)
 		{
 			net_buffer_reinit(&sock->buffer);
+			network_stats.recv_calls++;
 			sock->buffer.size = recvmmsg(sock->ipv4sock, sock->buffer.msgs, VLEN, 0, NULL);
 			sock->buffer.pos = 0;
 		}
@@ -1873,6 +2037,7 @@ int net_udp_recv(NETSOCKET sock, NETADDR *addr, unsigned char **data)
 		if(sock->buffer.pos >= sock->buffer.size)
 		{
 			net_buffer_reinit(&sock->buffer);
+			network_stats.recv_calls++;
 			sock->buffer.size = recvmmsg(sock->ipv6sock, sock->buffer.msgs, VLEN, 0, NULL);
 			sock->buffer.pos = 0;
 		}
@@ -1892,6 +2057,7 @@ int net_udp_recv(NETSOCKET sock, NETADDR *addr, unsigned char **data)
 	if(sock->ipv4sock >= 0)
 	{
 		socklen_t fromlen = sizeof(struct sockaddr_in);
+		network_stats.recv_calls++;
 		bytes = recvfrom(sock->ipv4sock, sock->buffer.buf, sizeof(sock->buffer.buf), 0, (struct sockaddr *)&sockaddrbuf, &fromlen);
 		*data = (unsigned char *)sock->buffer.buf;
 	}
@@ -1899,6 +2065,7 @@ int net_udp_recv(NETSOCKET sock, NETADDR *addr, unsigned char **data)
 	if(bytes <= 0 && sock->ipv6sock >= 0)
 	{
 		socklen_t fromlen = sizeof(struct sockaddr_in6);
+		network_stats.recv_calls++;
 		bytes = recvfrom(sock->ipv6sock, sock->buffer.buf, sizeof(sock->buffer.buf), 0, (struct sockaddr *)&sockaddrbuf, &fromlen);
 		*data = (unsigned char *)sock->buffer.buf;
 	}
@@ -3559,7 +3726,12 @@ void str_escape(char **dst, const char *src, const char *end)
 
 void net_stats(NETSTATS *stats_inout)
 {
-	*stats_inout = network_stats;
+	stats_inout->sent_packets = network_stats.sent_packets.load();
+	stats_inout->sent_bytes = network_stats.sent_bytes.load();
+	stats_inout->recv_packets = network_stats.recv_packets.load();
+	stats_inout->recv_bytes = network_stats.recv_bytes.load();
+	stats_inout->send_calls = network_stats.send_calls.load();
+	stats_inout->recv_calls = network_stats.recv_calls.load();
 }
 
 int str_isspace(char c)
@@ -399,6 +399,36 @@ int io_sync(IOHANDLE io);
  */
 int io_error(IOHANDLE io);
 
+/**
+ * Maps the whole file into memory. Writes to the memory are private
+ * to the process and never reach the file.
+ *
+ * @ingroup File-IO
+ *
+ * @param io Handle to the file.
+ * @param data Receives the address of the mapped file.
+ * @param size Receives the size of the mapped file.
+ *
+ * @return true on success, false if the file could not be mapped, e.g. because it is empty.
+ *
+ * @remark The mapping stays valid after the file is closed, it has to be released with @link io_unmap @endlink.
+ * @remark Only supported on POSIX systems, on Windows this always fails, because
+ * a mapped file can't be replaced by renaming another file over it.
+ */
+bool io_map(IOHANDLE io, void **data, size_t *size);
+
+/**
+ * Releases a file mapping.
+ *
+ * @ingroup File-IO
+ *
+ * @param data Address of the mapped file.
+ * @param size Size of the mapped file.
+ *
+ * @see io_map
+ */
+void io_unmap(void *data, size_t size);
+
 /**
  * @ingroup File-IO
  * @return An <IOHANDLE> to the standard input.
@@ -997,12 +1027,15 @@ int net_socket_type(NETSOCKET sock);
 
 	Parameters:
 		bindaddr - Address to bind the socket to.
+		reuse_port - Set SO_REUSEPORT so that several sockets can be bound
+			to the same address, the kernel distributes the incoming
+			packets between them.
 
 	Returns:
 		On success it returns an handle to the socket. On failure it
 		returns NETSOCKET_INVALID.
 */
-NETSOCKET net_udp_create(NETADDR bindaddr);
+NETSOCKET net_udp_create(NETADDR bindaddr, int reuse_port = 0);
 
 /**
  * Sends a packet over an UDP socket.
@@ -1019,6 +1052,35 @@ NETSOCKET net_udp_create(NETADDR bindaddr);
  */
 int net_udp_send(NETSOCKET sock, const NETADDR *addr, const void *data, int size);
 
+/**
+ * Enables or disables batching of outgoing packets on an UDP socket.
+ *
+ * @ingroup Network-UDP
+ *
+ * @param sock Socket to use.
+ * @param enable Whether to batch packets.
+ *
+ * @remark While enabled, @link net_udp_send @endlink only queues the packets
+ * and reports them as sent. They are sent with as few syscalls as possible
+ * on @link net_udp_flush @endlink or when the queue is full.
+ *
+ * @remark Disabling the batching flushes the queued packets.
+ *
+ * @remark Only has an effect on Linux.
+ */
+void net_udp_set_batching(NETSOCKET sock, int enable);
+
+/**
+ * Sends all packets queued on an UDP socket with batching enabled.
+ *
+ * @ingroup Network-UDP
+ *
+ * @param sock Socket to use.
+ *
+ * @return The number of packets that were queued.
+ */
+int net_udp_flush(NETSOCKET sock);
+
 /*
 	Function: net_udp_recv
 		Receives a packet over an UDP socket.
@@ -2230,6 +2292,8 @@ typedef struct
 	uint64_t sent_bytes;
 	uint64_t recv_packets;
 	uint64_t recv_bytes;
+	uint64_t send_calls;
+	uint64_t recv_calls;
 } NETSTATS;
 
 void net_stats(NETSTATS *stats);
@@ -28,4 +28,41 @@ public:
 	}
 };
 
+// lock-free queue with a fixed capacity for exactly one producer and one
+// consumer thread, the items are filled and read in place
+template<class T, unsigned Capacity>
+class CSpscQueue
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+	T m_aItems[Capacity];
+	// next item to read, only written by the consumer
+	alignas(64) std::atomic<unsigned> m_Head{0};
+	// next item to write, only written by the producer
+	alignas(64) std::atomic<unsigned> m_Tail{0};
+
+public:
+	// producer: returns the item to fill or nullptr if the queue is full,
+	// it becomes visible to the consumer with Push
+	T *Back()
+	{
+		const unsigned Tail = m_Tail.load(std::memory_order_relaxed);
+		if(Tail - m_Head.load(std::memory_order_acquire) == Capacity)
+			return nullptr;
+		return &m_aItems[Tail % Capacity];
+	}
+	void Push() { m_Tail.store(m_Tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+	// consumer: returns the oldest item or nullptr if the queue is empty,
+	// it is released to the producer with Pop
+	T *Front()
+	{
+		const unsigned Head = m_Head.load(std::memory_order_relaxed);
+		if(Head == m_Tail.load(std::memory_order_acquire))
+			return nullptr;
+		return &m_aItems[Head % Capacity];
+	}
+	void Pop() { m_Head.store(m_Head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+};
+
 #endif // BASE_TL_THREADING_H
@@ -84,6 +84,9 @@ protected:
 	SGFXErrorContainer m_Error;
 	SGFXWarningContainer m_Warning;
 
+	// set by the backends that can time frames on the GPU
+	std::atomic<int64_t> *m_pGpuFrameTime = nullptr;
+
 	static void *Resize(const unsigned char *pData, int Width, int Height, int NewWidth, int NewHeight, int BPP);
 
 	static bool Texture2DTo3D(void *pImageBuffer, int ImageWidth, int ImageHeight, size_t PixelSize, int SplitCountWidth, int SplitCountHeight, void *pTarget3DImageData, int &Target3DImageWidth, int &Target3DImageHeight);
@@ -140,6 +143,7 @@ public:
 		std::atomic<uint64_t> *m_pBufferMemoryUsage;
 		std::atomic<uint64_t> *m_pStreamMemoryUsage;
 		std::atomic<uint64_t> *m_pStagingMemoryUsage;
+		std::atomic<int64_t> *m_pGpuFrameTime;
 
 		TTWGraphicsGPUList *m_pGPUList;
 
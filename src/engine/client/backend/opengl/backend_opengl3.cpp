@@ -474,6 +474,20 @@ bool CCommandProcessorFragment_OpenGL3_3::Cmd_Init(const SCommand_Init *pCommand
 	// fix the alignment to allow even 1byte changes, e.g. for alpha components
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
+	// timer queries are core since 3.3, but not part of GLES 3
+	m_pGpuFrameTime = pCommand->m_pGpuFrameTime;
+	m_pGpuFrameTime->store(-1, std::memory_order_relaxed);
+	m_FrameQueryCount = 0;
+	m_CurFrameQuery = 0;
+	m_FrameQueryActive = false;
+#ifndef BACKEND_AS_OPENGL_ES
+	if(!m_IsOpenGLES)
+	{
+		glGenQueries(ms_NumFrameQueries, m_aFrameQueries);
+		m_FrameQueriesCreated = true;
+	}
+#endif
+
 	return true;
 }
 
@@ -481,6 +495,18 @@ void CCommandProcessorFragment_OpenGL3_3::Cmd_Shutdown(const SCommand_Shutdown *
 {
 	glUseProgram(0);
 
+#ifndef BACKEND_AS_OPENGL_ES
+	if(m_FrameQueriesCreated)
+	{
+		if(m_FrameQueryActive)
+			glEndQuery(GL_TIME_ELAPSED);
+		glDeleteQueries(ms_NumFrameQueries, m_aFrameQueries);
+	}
+#endif
+	m_FrameQueriesCreated = false;
+	m_FrameQueryActive = false;
+	m_FrameQueryCount = 0;
+
 	m_pPrimitiveProgram->DeleteProgram();
 	m_pPrimitiveProgramTextured->DeleteProgram();
 	m_pBorderTileProgram->DeleteProgram();
@@ -540,6 +566,55 @@ void CCommandProcessorFragment_OpenGL3_3::Cmd_Shutdown(const SCommand_Shutdown *
 	m_vBufferContainers.clear();
 }
 
+void CCommandProcessorFragment_OpenGL3_3::StartCommands(size_t CommandCount, size_t EstimatedRenderCallCount)
+{
+#ifndef BACKEND_AS_OPENGL_ES
+	// a frame can span several command buffers, the query runs until the swap
+	if(m_FrameQueriesCreated && !m_FrameQueryActive && m_FrameQueryCount < ms_NumFrameQueries)
+	{
+		glBeginQuery(GL_TIME_ELAPSED, m_aFrameQueries[m_CurFrameQuery]);
+		m_FrameQueryActive = true;
+	}
+#endif
+}
+
+void CCommandProcessorFragment_OpenGL3_3::EndFrameQuery()
+{
+#ifndef BACKEND_AS_OPENGL_ES
+	if(!m_FrameQueriesCreated)
+		return;
+
+	if(m_FrameQueryActive)
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		m_FrameQueryActive = false;
+		m_CurFrameQuery = (m_CurFrameQuery + 1) % ms_NumFrameQueries;
+		m_FrameQueryCount++;
+	}
+
+	// read the oldest query without stalling, if the GPU is too far behind no new query is started
+	while(m_FrameQueryCount > 0)
+	{
+		const TWGLuint Query = m_aFrameQueries[(m_CurFrameQuery - m_FrameQueryCount + ms_NumFrameQueries) % ms_NumFrameQueries];
+		GLint Available = 0;
+		glGetQueryObjectiv(Query, GL_QUERY_RESULT_AVAILABLE, &Available);
+		if(!Available)
+			break;
+		GLuint64 TimeElapsed = 0;
+		glGetQueryObjectui64v(Query, GL_QUERY_RESULT, &TimeElapsed);
+		m_pGpuFrameTime->store((int64_t)TimeElapsed, std::memory_order_relaxed);
+		m_FrameQueryCount--;
+	}
+#endif
+}
+
+ERunCommandReturnTypes CCommandProcessorFragment_OpenGL3_3::RunCommand(const CCommandBuffer::SCommand *pBaseCommand)
+{
+	if(pBaseCommand->m_Cmd == CCommandBuffer::CMD_SWAP || pBaseCommand->m_Cmd == CCommandBuffer::CMD_TRY_SWAP_AND_SCREENSHOT)
+		EndFrameQuery();
+	return CCommandProcessorFragment_OpenGL3::RunCommand(pBaseCommand);
+}
+
 void CCommandProcessorFragment_OpenGL3_3::TextureUpdate(int Slot, int X, int Y, int Width, int Height, int GLFormat, void *pTexData)
 {
 	glBindTexture(GL_TEXTURE_2D, m_vTextures[Slot].m_Tex);
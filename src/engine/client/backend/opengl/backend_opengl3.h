@@ -73,6 +73,17 @@ protected:
 
 	CCommandBuffer::SColorf m_ClearColor;
 
+	// timer queries of the last frames, read back once the GPU finished them
+	static const int ms_NumFrameQueries = 4;
+	TWGLuint m_aFrameQueries[ms_NumFrameQueries] = {};
+	int m_FrameQueryCount = 0;
+	int m_CurFrameQuery = 0;
+	bool m_FrameQueryActive = false;
+	// command buffers run before Cmd_Init and after Cmd_Shutdown too
+	bool m_FrameQueriesCreated = false;
+
+	void EndFrameQuery();
+
 	void InitPrimExProgram(CGLSLPrimitiveExProgram *pProgram, class CGLSLCompiler *pCompiler, class IStorage *pStorage, bool Textured, bool Rotationless);
 
 	static int TexFormatToNewOpenGLFormat(int TexFormat);
@@ -119,6 +130,9 @@ protected:
 
 public:
 	CCommandProcessorFragment_OpenGL3_3() = default;
+
+	ERunCommandReturnTypes RunCommand(const CCommandBuffer::SCommand *pBaseCommand) override;
+	void StartCommands(size_t CommandCount, size_t EstimatedRenderCallCount) override;
 };
 
 #endif
@@ -909,6 +909,10 @@ class CCommandProcessorFragment_Vulkan : public CCommandProcessorFragment_GLBase
 
 	uint32_t m_MinUniformAlign;
 
+	// nanoseconds per timestamp tick, 0 if the graphics queue can't write timestamps
+	float m_TimestampPeriod = 0.0f;
+	uint64_t m_TimestampMask = 0;
+
 	std::vector<uint8_t> m_vScreenshotHelper;
 
 	SDeviceMemoryBlock m_GetPresentedImgDataHelperMem;
@@ -976,6 +980,10 @@ private:
 	std::vector<VkFence> m_vFrameFences;
 	std::vector<VkFence> m_vImagesFences;
 
+	// a begin and end timestamp per swap chain image
+	VkQueryPool m_FrameTimestampPool = VK_NULL_HANDLE;
+	std::vector<bool> m_vFrameTimestampsWritten;
+
 	uint64_t m_CurFrame = 0;
 	std::vector<uint64_t> m_vImageLastFrameCheck;
 
@@ -2261,6 +2269,9 @@ protected:
 
 		vkCmdEndRenderPass(CommandBuffer);
 
+		if(m_FrameTimestampPool != VK_NULL_HANDLE)
+			vkCmdWriteTimestamp(CommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_FrameTimestampPool, m_CurImageIndex * 2 + 1);
+
 		if(vkEndCommandBuffer(CommandBuffer) != VK_SUCCESS)
 		{
 			SetError(EGFXErrorType::GFX_ERROR_TYPE_RENDER_RECORDING, "Command buffer cannot be ended anymore.");
@@ -2395,6 +2406,15 @@ protected:
 		}
 		m_vImagesFences[m_CurImageIndex] = m_vFrameFences[m_CurFrames];
 
+		// the last frame rendered to this image is finished, so its timestamps are available
+		if(m_FrameTimestampPool != VK_NULL_HANDLE && m_vFrameTimestampsWritten[m_CurImageIndex])
+		{
+			uint64_t aTimestamps[2];
+			if(vkGetQueryPoolResults(m_VKDevice, m_FrameTimestampPool, m_CurImageIndex * 2, 2, sizeof(aTimestamps), aTimestamps, sizeof(aTimestamps[0]), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+				m_pGpuFrameTime->store((int64_t)(((aTimestamps[1] - aTimestamps[0]) & m_TimestampMask) * (double)m_TimestampPeriod), std::memory_order_relaxed);
+			m_vFrameTimestampsWritten[m_CurImageIndex] = false;
+		}
+
 		// next frame
 		m_CurFrame++;
 		m_vImageLastFrameCheck[m_CurImageIndex] = m_CurFrame;
@@ -2432,6 +2452,13 @@ protected:
 			return false;
 		}
 
+		if(m_FrameTimestampPool != VK_NULL_HANDLE)
+		{
+			vkCmdResetQueryPool(CommandBuffer, m_FrameTimestampPool, m_CurImageIndex * 2, 2);
+			vkCmdWriteTimestamp(CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_FrameTimestampPool, m_CurImageIndex * 2);
+			m_vFrameTimestampsWritten[m_CurImageIndex] = true;
+		}
+
 		VkRenderPassBeginInfo RenderPassInfo{};
 		RenderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 		RenderPassInfo.renderPass = m_VKRenderPass;
@@ -3851,6 +3878,8 @@ public:
 			m_MinUniformAlign = DeviceProp.limits.minUniformBufferOffsetAlignment;
 			m_MaxMultiSample = DeviceProp.limits.framebufferColorSampleCounts;
 
+			m_TimestampPeriod = DeviceProp.limits.timestampComputeAndGraphics ? DeviceProp.limits.timestampPeriod : 0.0f;
+
 			if(IsVerbose())
 			{
 				dbg_msg("vulkan", "device prop: non-coherent align: %" PRIzu ", optimal image copy align: %" PRIzu ", max texture size: %u, max sampler anisotropy: %u", (size_t)m_NonCoherentMemAlignment, (size_t)m_OptimalImageCopyMemAlignment, m_MaxTextureSize, m_MaxSamplerAnisotropy);
@@ -3890,6 +3919,11 @@ public:
 			return false;
 		}
 
+		const uint32_t TimestampValidBits = vQueuePropList[QueueNodeIndex].timestampValidBits;
+		if(TimestampValidBits == 0)
+			m_TimestampPeriod = 0.0f;
+		m_TimestampMask = TimestampValidBits >= 64 ? std::numeric_limits<uint64_t>::max() : (((uint64_t)1 << TimestampValidBits) - 1);
+
 		m_VKGPU = CurDevice;
 		m_VKGraphicsQueueIndex = QueueNodeIndex;
 		return true;
@@ -5378,6 +5412,18 @@ public:
 			}
 		}
 
+		// frame timing is optional, the frame is rendered without it
+		m_vFrameTimestampsWritten.resize(m_SwapChainImageCount, false);
+		if(m_TimestampPeriod > 0.0f)
+		{
+			VkQueryPoolCreateInfo QueryPoolInfo{};
+			QueryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			QueryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+			QueryPoolInfo.queryCount = m_SwapChainImageCount * 2;
+			if(vkCreateQueryPool(m_VKDevice, &QueryPoolInfo, nullptr, &m_FrameTimestampPool) != VK_SUCCESS)
+				m_FrameTimestampPool = VK_NULL_HANDLE;
+		}
+
 		return true;
 	}
 
@@ -5398,6 +5444,11 @@ public:
 
 		m_vFrameFences.clear();
 		m_vImagesFences.clear();
+
+		if(m_FrameTimestampPool != VK_NULL_HANDLE)
+			vkDestroyQueryPool(m_VKDevice, m_FrameTimestampPool, nullptr);
+		m_FrameTimestampPool = VK_NULL_HANDLE;
+		m_vFrameTimestampsWritten.clear();
 	}
 
 	void DestroyBufferOfFrame(size_t ImageIndex, SFrameBuffers &Buffer)
@@ -6582,6 +6633,8 @@ public:
 		m_pBufferMemoryUsage = pCommand->m_pBufferMemoryUsage;
 		m_pStreamMemoryUsage = pCommand->m_pStreamMemoryUsage;
 		m_pStagingMemoryUsage = pCommand->m_pStagingMemoryUsage;
+		m_pGpuFrameTime = pCommand->m_pGpuFrameTime;
+		m_pGpuFrameTime->store(-1, std::memory_order_relaxed);
 
 		m_MultiSamplingCount = (g_Config.m_GfxFsaaSamples & 0xFFFFFFFE); // ignore the uneven bit, only even multi sampling works
 
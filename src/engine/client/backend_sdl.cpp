@@ -1300,6 +1300,7 @@ int CGraphicsBackend_SDL_GL::Init(const char *pName, int *pScreen, int *pWidth,
 		CmdGL.m_pBufferMemoryUsage = &m_BufferMemoryUsage;
 		CmdGL.m_pStreamMemoryUsage = &m_StreamMemoryUsage;
 		CmdGL.m_pStagingMemoryUsage = &m_StagingMemoryUsage;
+		CmdGL.m_pGpuFrameTime = &m_GpuFrameTime;
 		CmdGL.m_pGPUList = &m_GPUList;
 		CmdGL.m_pReadPresentedImageDataFunc = &m_ReadPresentedImageDataFunc;
 		CmdGL.m_pStorage = pStorage;
@@ -1445,6 +1446,12 @@ uint64_t CGraphicsBackend_SDL_GL::StagingMemoryUsage() const
 	return m_StagingMemoryUsage;
 }
 
+int64_t CGraphicsBackend_SDL_GL::TakeGpuFrameTime()
+{
+	// the backends store each measurement once, record it only once too
+	return m_GpuFrameTime.exchange(-1, std::memory_order_relaxed);
+}
+
 const TTWGraphicsGPUList &CGraphicsBackend_SDL_GL::GetGPUs() const
 {
 	return m_GPUList;
@@ -220,6 +220,7 @@ class CGraphicsBackend_SDL_GL : public CGraphicsBackend_Threaded
 	std::atomic<uint64_t> m_BufferMemoryUsage{0};
 	std::atomic<uint64_t> m_StreamMemoryUsage{0};
 	std::atomic<uint64_t> m_StagingMemoryUsage{0};
+	std::atomic<int64_t> m_GpuFrameTime{-1};
 
 	TTWGraphicsGPUList m_GPUList;
 
@@ -249,6 +250,7 @@ public:
 	uint64_t BufferMemoryUsage() const override;
 	uint64_t StreamedMemoryUsage() const override;
 	uint64_t StagingMemoryUsage() const override;
+	int64_t TakeGpuFrameTime() override;
 
 	const TTWGraphicsGPUList &GetGPUs() const override;
 
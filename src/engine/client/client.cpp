@@ -797,10 +797,11 @@ int CClient::SnapItemSize(int SnapID, int Index) const
 
 const void *CClient::SnapFindItem(int SnapID, int Type, int ID) const
 {
-	if(!m_aapSnapshots[g_Config.m_ClDummy][SnapID])
+	const CSnapshotStorage::CHolder *pHolder = m_aapSnapshots[g_Config.m_ClDummy][SnapID];
+	if(!pHolder)
 		return 0x0;
 
-	return m_aapSnapshots[g_Config.m_ClDummy][SnapID]->m_pAltSnap->FindItem(Type, ID);
+	return pHolder->m_pAltIndex->FindItem(Type, ID);
 }
 
 int CClient::SnapNumItems(int SnapID) const
@@ -2484,6 +2485,7 @@ void CClient::OnDemoPlayerSnapshot(void *pData, int Size)
 	std::swap(m_aapSnapshots[g_Config.m_ClDummy][SNAP_PREV], m_aapSnapshots[g_Config.m_ClDummy][SNAP_CURRENT]);
 	mem_copy(m_aapSnapshots[g_Config.m_ClDummy][SNAP_CURRENT]->m_pSnap, pData, Size);
 	mem_copy(m_aapSnapshots[g_Config.m_ClDummy][SNAP_CURRENT]->m_pAltSnap, pAltSnapBuffer, AltSnapSize);
+	m_aapSnapshots[g_Config.m_ClDummy][SNAP_CURRENT]->m_pAltIndex->Build(m_aapSnapshots[g_Config.m_ClDummy][SNAP_CURRENT]->m_pAltSnap);
 
 	GameClient()->OnNewSnapshot();
 }
@@ -3755,6 +3757,8 @@ const char *CClient::DemoPlayer_Play(const char *pFilename, int StorageType)
 		m_aapSnapshots[g_Config.m_ClDummy][SnapshotType] = &m_aDemorecSnapshotHolders[SnapshotType];
 		m_aapSnapshots[g_Config.m_ClDummy][SnapshotType]->m_pSnap = (CSnapshot *)&m_aaaDemorecSnapshotData[SnapshotType][0];
 		m_aapSnapshots[g_Config.m_ClDummy][SnapshotType]->m_pAltSnap = (CSnapshot *)&m_aaaDemorecSnapshotData[SnapshotType][1];
+		m_aapSnapshots[g_Config.m_ClDummy][SnapshotType]->m_pAltIndex = &m_aDemorecSnapshotIndices[SnapshotType];
+		m_aapSnapshots[g_Config.m_ClDummy][SnapshotType]->m_pAltIndex->Build(m_aapSnapshots[g_Config.m_ClDummy][SnapshotType]->m_pAltSnap);
 		m_aapSnapshots[g_Config.m_ClDummy][SnapshotType]->m_SnapSize = 0;
 		m_aapSnapshots[g_Config.m_ClDummy][SnapshotType]->m_AltSnapSize = 0;
 		m_aapSnapshots[g_Config.m_ClDummy][SnapshotType]->m_Tick = -1;
@@ -194,6 +194,7 @@ class CClient : public IClient, public CDemoPlayer::IListener
 
 	CSnapshotStorage::CHolder m_aDemorecSnapshotHolders[NUM_SNAPSHOT_TYPES];
 	char m_aaaDemorecSnapshotData[NUM_SNAPSHOT_TYPES][2][CSnapshot::MAX_SIZE];
+	CSnapshotIndex m_aDemorecSnapshotIndices[NUM_SNAPSHOT_TYPES];
 
 	CSnapshotDelta m_SnapshotDelta;
 
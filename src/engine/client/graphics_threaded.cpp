@@ -208,6 +208,11 @@ uint64_t CGraphics_Threaded::StagingMemoryUsage() const
 	return m_pBackend->StagingMemoryUsage();
 }
 
+int64_t CGraphics_Threaded::TakeGpuFrameTime()
+{
+	return m_pBackend->TakeGpuFrameTime();
+}
+
 const TTWGraphicsGPUList &CGraphics_Threaded::GetGPUs() const
 {
 	return m_pBackend->GetGPUs();
@@ -558,10 +563,32 @@ bool CGraphics_Threaded::UpdateTextTexture(CTextureHandle TextureID, int x, int
 
 int CGraphics_Threaded::LoadPNG(CImageInfo *pImg, const char *pFilename, int StorageType)
 {
+	int PngliteIncompatible;
+	if(!LoadPNG(pImg, pFilename, StorageType, PngliteIncompatible))
+		return 0;
+	WarnPngliteIncompatible(pFilename, PngliteIncompatible);
+	return 1;
+}
+
+int CGraphics_Threaded::LoadPNG(CImageInfo *pImg, const char *pFilename, int StorageType, int &PngliteIncompatible)
+{
+	PngliteIncompatible = 0;
 	char aCompleteFilename[IO_MAX_PATH_LENGTH];
 	IOHANDLE File = m_pStorage->OpenFile(pFilename, IOFLAG_READ, StorageType, aCompleteFilename, sizeof(aCompleteFilename));
 	if(File)
 	{
+		// decoded on an earlier start
+		CImageCache::CSource Source;
+		if(m_ImageCache.Enabled())
+		{
+			Source.Init(aCompleteFilename, File);
+			if(m_ImageCache.Load(Source, "", pImg, &PngliteIncompatible))
+			{
+				io_close(File);
+				return 1;
+			}
+		}
+
 		io_seek(File, 0, IOSEEK_END);
 		unsigned int FileSize = io_tell(File);
 		io_seek(File, 0, IOSEEK_START);
@@ -574,9 +601,15 @@ int CGraphics_Threaded::LoadPNG(CImageInfo *pImg, const char *pFilename, int Sto
 
 		io_close(File);
 
+		if(m_ImageCache.Enabled())
+		{
+			Source.m_Hash = sha256(ByteBuffer.data(), ByteBuffer.size());
+			if(m_ImageCache.Load(Source, "", pImg, &PngliteIncompatible))
+				return 1;
+		}
+
 		uint8_t *pImgBuffer = NULL;
 		EImageFormat ImageFormat;
-		int PngliteIncompatible;
 		if(::LoadPNG(ImageByteBuffer, pFilename, PngliteIncompatible, pImg->m_Width, pImg->m_Height, pImgBuffer, ImageFormat))
 		{
 			pImg->m_pData = pImgBuffer;
@@ -591,29 +624,8 @@ int CGraphics_Threaded::LoadPNG(CImageInfo *pImg, const char *pFilename, int Sto
 				return 0;
 			}
 
-			if(m_WarnPngliteIncompatibleImages && PngliteIncompatible != 0)
-			{
-				SWarning Warning;
-				str_format(Warning.m_aWarningMsg, sizeof(Warning.m_aWarningMsg), Localize("\"%s\" is not compatible with pnglite and cannot be loaded by old DDNet versions: "), pFilename);
-				static const int FLAGS[] = {PNGLITE_COLOR_TYPE, PNGLITE_BIT_DEPTH, PNGLITE_INTERLACE_TYPE, PNGLITE_COMPRESSION_TYPE, PNGLITE_FILTER_TYPE};
-				static const char *EXPLANATION[] = {"color type", "bit depth", "interlace type", "compression type", "filter type"};
-
-				bool First = true;
-				for(size_t i = 0; i < std::size(FLAGS); ++i)
-				{
-					if((PngliteIncompatible & FLAGS[i]) != 0)
-					{
-						if(!First)
-						{
-							str_append(Warning.m_aWarningMsg, ", ");
-						}
-						str_append(Warning.m_aWarningMsg, EXPLANATION[i]);
-						First = false;
-					}
-				}
-				str_append(Warning.m_aWarningMsg, " unsupported");
-				m_vWarnings.emplace_back(Warning);
-			}
+			if(m_ImageCache.Enabled())
+				m_ImageCache.Store(Source, "", *pImg, PngliteIncompatible);
 		}
 		else
 		{
@@ -630,6 +642,33 @@ int CGraphics_Threaded::LoadPNG(CImageInfo *pImg, const char *pFilename, int Sto
 	return 1;
 }
 
+void CGraphics_Threaded::WarnPngliteIncompatible(const char *pFilename, int PngliteIncompatible)
+{
+	if(!m_WarnPngliteIncompatibleImages || PngliteIncompatible == 0)
+		return;
+
+	SWarning Warning;
+	str_format(Warning.m_aWarningMsg, sizeof(Warning.m_aWarningMsg), Localize("\"%s\" is not compatible with pnglite and cannot be loaded by old DDNet versions: "), pFilename);
+	static const int FLAGS[] = {PNGLITE_COLOR_TYPE, PNGLITE_BIT_DEPTH, PNGLITE_INTERLACE_TYPE, PNGLITE_COMPRESSION_TYPE, PNGLITE_FILTER_TYPE};
+	static const char *EXPLANATION[] = {"color type", "bit depth", "interlace type", "compression type", "filter type"};
+
+	bool First = true;
+	for(size_t i = 0; i < std::size(FLAGS); ++i)
+	{
+		if((PngliteIncompatible & FLAGS[i]) != 0)
+		{
+			if(!First)
+			{
+				str_append(Warning.m_aWarningMsg, ", ");
+			}
+			str_append(Warning.m_aWarningMsg, EXPLANATION[i]);
+			First = false;
+		}
+	}
+	str_append(Warning.m_aWarningMsg, " unsupported");
+	m_vWarnings.emplace_back(Warning);
+}
+
 void CGraphics_Threaded::FreePNG(CImageInfo *pImg)
 {
 	free(pImg->m_pData);
@@ -720,6 +759,12 @@ void CGraphics_Threaded::CopyTextureFromTextureBufferSub(uint8_t *pDestBuffer, s
 
 void CGraphics_Threaded::KickCommandBuffer()
 {
+	m_CurFrameCommandStats.m_NumBuffers++;
+	m_CurFrameCommandStats.m_NumCommands += m_pCommandBuffer->m_CommandCount;
+	m_CurFrameCommandStats.m_NumRenderCalls += m_pCommandBuffer->m_RenderCallCount;
+	m_CurFrameCommandStats.m_CommandBytes += m_pCommandBuffer->m_CmdBuffer.DataUsed();
+	m_CurFrameCommandStats.m_DataBytes += m_pCommandBuffer->m_DataBuffer.DataUsed();
+
 	m_pBackend->RunBuffer(m_pCommandBuffer);
 
 	std::vector<std::string> WarningStrings;
@@ -2580,6 +2625,12 @@ int CGraphics_Threaded::Init()
 	m_pConsole = Kernel()->RequestInterface<IConsole>();
 	m_pEngine = Kernel()->RequestInterface<IEngine>();
 
+	if(g_Config.m_GfxImageCache)
+	{
+		m_ImageCache.Init(m_pStorage);
+		m_ImageCache.Prune((int64_t)g_Config.m_GfxImageCacheSize * 1024 * 1024);
+	}
+
 	// init textures
 	m_FirstFreeTexture = 0;
 	m_vTextureIndices.resize(CCommandBuffer::MAX_TEXTURES);
@@ -2904,6 +2955,8 @@ void CGraphics_Threaded::Swap()
 
 	// kick the command buffer
 	KickCommandBuffer();
+	m_LastFrameCommandStats = m_CurFrameCommandStats;
+	m_CurFrameCommandStats = CCommandBufferStats();
 	// TODO: Remove when https://github.com/libsdl-org/SDL/issues/5203 is fixed
 #ifdef CONF_PLATFORM_MACOS
 	if(str_find(GetVersionString(), "Metal"))
@@ -3,6 +3,7 @@
 
 #include <engine/graphics.h>
 #include <engine/shared/config.h>
+#include <engine/shared/imagecache.h>
 
 #include <cstddef>
 #include <string>
@@ -716,6 +717,7 @@ public:
 	virtual uint64_t BufferMemoryUsage() const = 0;
 	virtual uint64_t StreamedMemoryUsage() const = 0;
 	virtual uint64_t StagingMemoryUsage() const = 0;
+	virtual int64_t TakeGpuFrameTime() = 0;
 
 	virtual const TTWGraphicsGPUList &GetGPUs() const = 0;
 
@@ -795,6 +797,9 @@ class CGraphics_Threaded : public IEngineGraphics
 	CCommandBuffer *m_pCommandBuffer;
 	unsigned m_CurrentCommandBuffer;
 
+	CCommandBufferStats m_CurFrameCommandStats;
+	CCommandBufferStats m_LastFrameCommandStats;
+
 	//
 	class IStorage *m_pStorage;
 	class IConsole *m_pConsole;
@@ -826,6 +831,9 @@ class CGraphics_Threaded : public IEngineGraphics
 
 	bool m_WarnPngliteIncompatibleImages = false;
 
+	// used by LoadPNG, which can be called from other threads
+	CImageCache m_ImageCache;
+
 	std::vector<SWarning> m_vWarnings;
 
 	// is a non full windowed (in a sense that the viewport won't include the whole window),
@@ -954,6 +962,9 @@ public:
 	uint64_t StreamedMemoryUsage() const override;
 	uint64_t StagingMemoryUsage() const override;
 
+	const CCommandBufferStats &LastFrameCommandStats() const override { return m_LastFrameCommandStats; }
+	int64_t TakeGpuFrameTime() override;
+
 	const TTWGraphicsGPUList &GetGPUs() const override;
 
 	void MapScreen(float TopLeftX, float TopLeftY, float BottomRightX, float BottomRightY) override;
@@ -983,6 +994,8 @@ public:
 	// simple uncompressed RGBA loaders
 	IGraphics::CTextureHandle LoadTexture(const char *pFilename, int StorageType, int Flags = 0) override;
 	int LoadPNG(CImageInfo *pImg, const char *pFilename, int StorageType) override;
+	int LoadPNG(CImageInfo *pImg, const char *pFilename, int StorageType, int &PngliteIncompatible) override;
+	void WarnPngliteIncompatible(const char *pFilename, int PngliteIncompatible) override;
 	void FreePNG(CImageInfo *pImg) override;
 
 	bool CheckImageDivisibility(const char *pFileName, CImageInfo &Img, int DivX, int DivY, bool AllowResize) override;
@@ -7,6 +7,7 @@
 
 #include <engine/graphics.h>
 #include <engine/shared/config.h>
+#include <engine/shared/soundmix.h>
 #include <engine/storage.h>
 
 #include "sound.h"
@@ -21,163 +22,330 @@ extern "C" {
 
 #include <cmath>
 
-void CSound::Mix(short *pFinalOut, unsigned Frames)
+void CSound::VoiceVolume(const CVoice &Voice, int *pVolumeL, int *pVolumeR) const
 {
-	Frames = minimum(Frames, m_MaxFrames);
-	mem_zero(m_pMixBuffer, Frames * 2 * sizeof(int));
-
-	// acquire lock while we are mixing
-	m_SoundLock.lock();
+	int VolumeR = round_truncate(Voice.m_pChannel->m_Vol * (Voice.m_Vol / 255.0f));
+	int VolumeL = VolumeR;
 
-	const int MasterVol = m_SoundVolume.load(std::memory_order_relaxed);
-
-	for(auto &Voice : m_aVoices)
+	// volume calculation
+	if(Voice.m_Flags & ISound::FLAG_POS && Voice.m_pChannel->m_Pan)
 	{
-		if(!Voice.m_pSample)
-			continue;
+		// TODO: we should respect the channel panning value
+		const int dx = Voice.m_X - m_CenterX.load(std::memory_order_relaxed);
+		const int dy = Voice.m_Y - m_CenterY.load(std::memory_order_relaxed);
+		float FalloffX = 0.0f;
+		float FalloffY = 0.0f;
 
-		// mix voice
-		int *pOut = m_pMixBuffer;
+		int RangeX = 0; // for panning
+		bool InVoiceField = false;
 
-		const int Step = Voice.m_pSample->m_Channels; // setup input sources
-		short *pInL = &Voice.m_pSample->m_pData[Voice.m_Tick * Step];
-		short *pInR = &Voice.m_pSample->m_pData[Voice.m_Tick * Step + 1];
-
-		unsigned End = Voice.m_pSample->m_NumFrames - Voice.m_Tick;
+		switch(Voice.m_Shape)
+		{
+		case ISound::SHAPE_CIRCLE:
+		{
+			const float Radius = Voice.m_Circle.m_Radius;
+			RangeX = Radius;
 
-		int VolumeR = round_truncate(Voice.m_pChannel->m_Vol * (Voice.m_Vol / 255.0f));
-		int VolumeL = VolumeR;
+			// dx and dy can be larger than 46341 and thus the calculation would go beyond the limits of a integer,
+			// therefore we cast them into float
+			const int Dist = (int)length(vec2(dx, dy));
+			if(Dist < Radius)
+			{
+				InVoiceField = true;
 
-		// make sure that we don't go outside the sound data
-		if(Frames < End)
-			End = Frames;
+				// falloff
+				int FalloffDistance = Radius * Voice.m_Falloff;
+				if(Dist > FalloffDistance)
+					FalloffX = FalloffY = (Radius - Dist) / (Radius - FalloffDistance);
+				else
+					FalloffX = FalloffY = 1.0f;
+			}
+			else
+				InVoiceField = false;
 
-		// check if we have a mono sound
-		if(Voice.m_pSample->m_Channels == 1)
-			pInR = pInL;
+			break;
+		}
 
-		// volume calculation
-		if(Voice.m_Flags & ISound::FLAG_POS && Voice.m_pChannel->m_Pan)
+		case ISound::SHAPE_RECTANGLE:
 		{
-			// TODO: we should respect the channel panning value
-			const int dx = Voice.m_X - m_CenterX.load(std::memory_order_relaxed);
-			const int dy = Voice.m_Y - m_CenterY.load(std::memory_order_relaxed);
-			float FalloffX = 0.0f;
-			float FalloffY = 0.0f;
+			RangeX = Voice.m_Rectangle.m_Width / 2.0f;
 
-			int RangeX = 0; // for panning
-			bool InVoiceField = false;
+			const int abs_dx = absolute(dx);
+			const int abs_dy = absolute(dy);
 
-			switch(Voice.m_Shape)
-			{
-			case ISound::SHAPE_CIRCLE:
+			const int w = Voice.m_Rectangle.m_Width / 2.0f;
+			const int h = Voice.m_Rectangle.m_Height / 2.0f;
+
+			if(abs_dx < w && abs_dy < h)
 			{
-				const float Radius = Voice.m_Circle.m_Radius;
-				RangeX = Radius;
+				InVoiceField = true;
 
-				// dx and dy can be larger than 46341 and thus the calculation would go beyond the limits of a integer,
-				// therefore we cast them into float
-				const int Dist = (int)length(vec2(dx, dy));
-				if(Dist < Radius)
-				{
-					InVoiceField = true;
-
-					// falloff
-					int FalloffDistance = Radius * Voice.m_Falloff;
-					if(Dist > FalloffDistance)
-						FalloffX = FalloffY = (Radius - Dist) / (Radius - FalloffDistance);
-					else
-						FalloffX = FalloffY = 1.0f;
-				}
-				else
-					InVoiceField = false;
+				// falloff
+				int fx = Voice.m_Falloff * w;
+				int fy = Voice.m_Falloff * h;
 
-				break;
+				FalloffX = abs_dx > fx ? (float)(w - abs_dx) / (w - fx) : 1.0f;
+				FalloffY = abs_dy > fy ? (float)(h - abs_dy) / (h - fy) : 1.0f;
 			}
+			else
+				InVoiceField = false;
 
-			case ISound::SHAPE_RECTANGLE:
+			break;
+		}
+		};
+
+		if(InVoiceField)
+		{
+			// panning
+			if(!(Voice.m_Flags & ISound::FLAG_NO_PANNING))
 			{
-				RangeX = Voice.m_Rectangle.m_Width / 2.0f;
+				if(dx > 0)
+					VolumeL = ((RangeX - absolute(dx)) * VolumeL) / RangeX;
+				else
+					VolumeR = ((RangeX - absolute(dx)) * VolumeR) / RangeX;
+			}
 
-				const int abs_dx = absolute(dx);
-				const int abs_dy = absolute(dy);
+			{
+				VolumeL *= FalloffX * FalloffY;
+				VolumeR *= FalloffX * FalloffY;
+			}
+		}
+		else
+		{
+			VolumeL = 0;
+			VolumeR = 0;
+		}
+	}
 
-				const int w = Voice.m_Rectangle.m_Width / 2.0f;
-				const int h = Voice.m_Rectangle.m_Height / 2.0f;
+	*pVolumeL = clamp(VolumeL, 0, 255);
+	*pVolumeR = clamp(VolumeR, 0, 255);
+}
 
-				if(abs_dx < w && abs_dy < h)
-				{
-					InVoiceField = true;
+void CSound::Mix(short *pFinalOut, unsigned Frames)
+{
+	Frames = minimum(Frames, m_MaxFrames);
+	mem_zero(m_pMixBuffer, Frames * 2 * sizeof(int));
 
-					// falloff
-					int fx = Voice.m_Falloff * w;
-					int fy = Voice.m_Falloff * h;
+	// only contended while the game waits for the mixer, e.g. to unload a sample
+	m_MixLock.lock();
+	ProcessCommands();
 
-					FalloffX = abs_dx > fx ? (float)(w - abs_dx) / (w - fx) : 1.0f;
-					FalloffY = abs_dy > fy ? (float)(h - abs_dy) / (h - fy) : 1.0f;
-				}
-				else
-					InVoiceField = false;
+	for(int VoiceID = 0; VoiceID < NUM_VOICES; VoiceID++)
+	{
+		CVoice &Voice = m_aVoices[VoiceID];
+		if(!Voice.m_pSample)
+			continue;
 
-				break;
-			}
-			};
+		const CSample *pSample = Voice.m_pSample;
+		int VolumeL, VolumeR;
+		VoiceVolume(Voice, &VolumeL, &VolumeR);
+		if(Voice.m_LastVolumeL < 0)
+		{
+			Voice.m_LastVolumeL = VolumeL;
+			Voice.m_LastVolumeR = VolumeR;
+		}
 
-			if(InVoiceField)
+		// ramp from the volumes of the last buffer over this one, looping samples can take several parts
+		unsigned Mixed = 0;
+		while(Mixed < Frames && Voice.m_pSample)
+		{
+			const unsigned End = Voice.m_Tick < pSample->m_NumFrames ? minimum<unsigned>(Frames - Mixed, pSample->m_NumFrames - Voice.m_Tick) : 0;
+			const int StartVolumeL = Voice.m_LastVolumeL + (VolumeL - Voice.m_LastVolumeL) * (int)Mixed / (int)Frames;
+			const int StartVolumeR = Voice.m_LastVolumeR + (VolumeR - Voice.m_LastVolumeR) * (int)Mixed / (int)Frames;
+			const int EndVolumeL = Voice.m_LastVolumeL + (VolumeL - Voice.m_LastVolumeL) * (int)(Mixed + End) / (int)Frames;
+			const int EndVolumeR = Voice.m_LastVolumeR + (VolumeR - Voice.m_LastVolumeR) * (int)(Mixed + End) / (int)Frames;
+			SoundMixVoice(m_pMixBuffer + Mixed * 2, &pSample->m_pData[Voice.m_Tick * pSample->m_Channels], pSample->m_Channels, End, StartVolumeL, StartVolumeR, EndVolumeL, EndVolumeR);
+			Mixed += End;
+			Voice.m_Tick += End;
+
+			// free voice if not used any more
+			if(Voice.m_Tick >= pSample->m_NumFrames)
 			{
-				// panning
-				if(!(Voice.m_Flags & ISound::FLAG_NO_PANNING))
-				{
-					if(dx > 0)
-						VolumeL = ((RangeX - absolute(dx)) * VolumeL) / RangeX;
-					else
-						VolumeR = ((RangeX - absolute(dx)) * VolumeR) / RangeX;
-				}
-
+				if(Voice.m_Flags & ISound::FLAG_LOOP && pSample->m_NumFrames > 0)
+					Voice.m_Tick = 0;
+				else
 				{
-					VolumeL *= FalloffX * FalloffY;
-					VolumeR *= FalloffX * FalloffY;
+					Voice.m_pSample = nullptr;
+					m_aVoiceStatus[VoiceID].m_EndedAge.store(Voice.m_Age, std::memory_order_release);
 				}
 			}
-			else
-			{
-				VolumeL = 0;
-				VolumeR = 0;
-			}
 		}
+		Voice.m_LastVolumeL = VolumeL;
+		Voice.m_LastVolumeR = VolumeR;
+		m_aVoiceStatus[VoiceID].m_Tick.store(Voice.m_Tick, std::memory_order_relaxed);
+	}
+
+	m_MixLock.unlock();
+
+	// clamp accumulated values
+	SoundMixFinish(pFinalOut, m_pMixBuffer, Frames * 2, m_SoundVolume.load(std::memory_order_relaxed));
+
+#if defined(CONF_ARCH_ENDIAN_BIG)
+	swap_endian(pFinalOut, sizeof(short), Frames * 2);
+#endif
+}
+
+void CSound::ProcessCommands()
+{
+	while(const CSoundCommand *pCommand = m_Commands.Front())
+	{
+		ApplyCommand(*pCommand);
+		m_Commands.Pop();
+	}
+}
+
+void CSound::StopMixerVoice(CVoice &Voice)
+{
+	if(!Voice.m_pSample)
+		return;
+	if(Voice.m_Flags & ISound::FLAG_LOOP)
+		Voice.m_pSample->m_PausedAt = Voice.m_Tick;
+	else
+		Voice.m_pSample->m_PausedAt = 0;
+	Voice.m_pSample = nullptr;
+}
 
-		// process all frames
-		for(unsigned s = 0; s < End; s++)
+void CSound::ApplyCommand(const CSoundCommand &Command)
+{
+	switch(Command.m_Type)
+	{
+	case CSoundCommand::PLAY:
+	{
+		CVoice &Voice = m_aVoices[Command.m_VoiceID];
+		CSample &Sample = m_aSamples[Command.m_SampleID];
+		Voice.m_pSample = &Sample;
+		Voice.m_pChannel = &m_aChannels[Command.m_ChannelID];
+		Voice.m_Age = Command.m_Age;
+		if(Command.m_Flags & ISound::FLAG_LOOP)
+		{
+			Voice.m_Tick = Sample.m_PausedAt;
+		}
+		else if(Command.m_Flags & ISound::FLAG_PREVIEW)
+		{
+			Voice.m_Tick = Sample.m_PausedAt;
+			Sample.m_PausedAt = 0;
+		}
+		else
 		{
-			*pOut++ += (*pInL) * VolumeL;
-			*pOut++ += (*pInR) * VolumeR;
-			pInL += Step;
-			pInR += Step;
-			Voice.m_Tick++;
+			Voice.m_Tick = 0;
 		}
+		Voice.m_Vol = 255;
+		Voice.m_Flags = Command.m_Flags;
+		Voice.m_X = Command.m_X;
+		Voice.m_Y = Command.m_Y;
+		Voice.m_Falloff = 0.0f;
+		Voice.m_Shape = ISound::SHAPE_CIRCLE;
+		Voice.m_Circle.m_Radius = 1500;
+		Voice.m_LastVolumeL = -1;
+		Voice.m_LastVolumeR = -1;
+		return;
+	}
 
-		// free voice if not used any more
-		if(Voice.m_Tick == Voice.m_pSample->m_NumFrames)
+	case CSoundCommand::PAUSE:
+	case CSoundCommand::STOP:
+	{
+		CSample *pSample = &m_aSamples[Command.m_SampleID];
+		for(auto &Voice : m_aVoices)
 		{
-			if(Voice.m_Flags & ISound::FLAG_LOOP)
-				Voice.m_Tick = 0;
-			else
+			if(Voice.m_pSample != pSample)
+				continue;
+			if(Command.m_Type == CSoundCommand::PAUSE)
 			{
+				pSample->m_PausedAt = Voice.m_Tick;
 				Voice.m_pSample = nullptr;
-				Voice.m_Age++;
 			}
+			else
+				StopMixerVoice(Voice);
 		}
+		return;
 	}
 
-	m_SoundLock.unlock();
+	case CSoundCommand::STOP_ALL:
+		for(auto &Voice : m_aVoices)
+			StopMixerVoice(Voice);
+		return;
 
-	// clamp accumulated values
-	for(unsigned i = 0; i < Frames * 2; i++)
-		pFinalOut[i] = clamp<int>(((m_pMixBuffer[i] * MasterVol) / 101) >> 8, std::numeric_limits<short>::min(), std::numeric_limits<short>::max());
+	case CSoundCommand::SET_SAMPLE_TIME:
+	{
+		CSample *pSample = &m_aSamples[Command.m_SampleID];
+		bool Playing = false;
+		for(auto &Voice : m_aVoices)
+		{
+			if(Voice.m_pSample == pSample)
+			{
+				Voice.m_Tick = (int)(pSample->m_NumFrames * Command.m_aValues[0]);
+				Playing = true;
+			}
+		}
+		if(!Playing)
+			pSample->m_PausedAt = (int)(pSample->m_NumFrames * Command.m_aValues[0]);
+		return;
+	}
 
-#if defined(CONF_ARCH_ENDIAN_BIG)
-	swap_endian(pFinalOut, sizeof(short), Frames * 2);
-#endif
+	case CSoundCommand::SET_CHANNEL:
+		m_aChannels[Command.m_ChannelID].m_Vol = (int)(Command.m_aValues[0] * 255.0f);
+		m_aChannels[Command.m_ChannelID].m_Pan = (int)(Command.m_aValues[1] * 255.0f); // TODO: this is only on and off right now
+		return;
+	}
+
+	// the remaining commands change a single voice
+	CVoice &Voice = m_aVoices[Command.m_VoiceID];
+	if(Voice.m_Age != Command.m_Age || !Voice.m_pSample)
+		return;
+
+	switch(Command.m_Type)
+	{
+	case CSoundCommand::STOP_VOICE:
+		Voice.m_pSample = nullptr;
+		break;
+
+	case CSoundCommand::SET_VOLUME:
+		Voice.m_Vol = (int)(clamp(Command.m_aValues[0], 0.0f, 1.0f) * 255.0f);
+		break;
+
+	case CSoundCommand::SET_FALLOFF:
+		Voice.m_Falloff = clamp(Command.m_aValues[0], 0.0f, 1.0f);
+		break;
+
+	case CSoundCommand::SET_LOCATION:
+		Voice.m_X = Command.m_X;
+		Voice.m_Y = Command.m_Y;
+		break;
+
+	case CSoundCommand::SET_TIME_OFFSET:
+	{
+		int Tick = 0;
+		bool IsLooping = Voice.m_Flags & ISound::FLAG_LOOP;
+		uint64_t TickOffset = Voice.m_pSample->m_Rate * Command.m_aValues[0];
+		if(Voice.m_pSample->m_NumFrames > 0 && IsLooping)
+			Tick = TickOffset % Voice.m_pSample->m_NumFrames;
+		else
+			Tick = clamp(TickOffset, (uint64_t)0, (uint64_t)Voice.m_pSample->m_NumFrames);
+
+		// at least 200msec off, else depend on buffer size
+		float Threshold = maximum(0.2f * Voice.m_pSample->m_Rate, (float)m_MaxFrames);
+		if(absolute(Voice.m_Tick - Tick) > Threshold)
+		{
+			// take care of looping (modulo!)
+			if(!(IsLooping && (minimum(Voice.m_Tick, Tick) + Voice.m_pSample->m_NumFrames - maximum(Voice.m_Tick, Tick)) <= Threshold))
+			{
+				Voice.m_Tick = Tick;
+			}
+		}
+		break;
+	}
+
+	case CSoundCommand::SET_CIRCLE:
+		Voice.m_Shape = ISound::SHAPE_CIRCLE;
+		Voice.m_Circle.m_Radius = maximum(0.0f, Command.m_aValues[0]);
+		break;
+
+	case CSoundCommand::SET_RECTANGLE:
+		Voice.m_Shape = ISound::SHAPE_RECTANGLE;
+		Voice.m_Rectangle.m_Width = maximum(0.0f, Command.m_aValues[0]);
+		Voice.m_Rectangle.m_Height = maximum(0.0f, Command.m_aValues[1]);
+		break;
+	}
 }
 
 static void SdlCallback(void *pUser, Uint8 *pStream, int Len)
@@ -614,6 +782,11 @@ void CSound::UnloadSample(int SampleID)
 		return;
 
 	Stop(SampleID);
+	{
+		// make sure the mixer doesn't use the sample anymore
+		std::unique_lock<std::mutex> Lock(m_MixLock);
+		ProcessCommands();
+	}
 	free(m_aSamples[SampleID].m_pData);
 	m_aSamples[SampleID].m_pData = nullptr;
 }
@@ -631,16 +804,12 @@ float CSound::GetSampleCurrentTime(int SampleID)
 	if(SampleID == -1 || SampleID >= NUM_SAMPLES)
 		return 0.0f;
 
-	CSample *pSample = &m_aSamples[SampleID];
-	if(IsPlaying(SampleID))
+	const CSample *pSample = &m_aSamples[SampleID];
+	std::unique_lock<std::mutex> Lock(m_CommandLock);
+	for(int VoiceID = 0; VoiceID < NUM_VOICES; VoiceID++)
 	{
-		for(auto &Voice : m_aVoices)
-		{
-			if(Voice.m_pSample == pSample)
-			{
-				return (Voice.m_Tick / (float)pSample->m_Rate);
-			}
-		}
+		if(m_aVoiceStatus[VoiceID].m_SampleID == SampleID && IsVoiceBusy(VoiceID))
+			return (m_aVoiceStatus[VoiceID].m_Tick.load(std::memory_order_relaxed) / (float)pSample->m_Rate);
 	}
 
 	return (pSample->m_PausedAt / (float)pSample->m_Rate);
@@ -651,27 +820,23 @@ void CSound::SetSampleCurrentTime(int SampleID, float Time)
 	if(SampleID == -1 || SampleID >= NUM_SAMPLES)
 		return;
 
-	CSample *pSample = &m_aSamples[SampleID];
-	if(IsPlaying(SampleID))
-	{
-		for(auto &Voice : m_aVoices)
-		{
-			if(Voice.m_pSample == pSample)
-			{
-				Voice.m_Tick = pSample->m_NumFrames * Time;
-			}
-		}
-	}
-	else
-	{
-		pSample->m_PausedAt = pSample->m_NumFrames * Time;
-	}
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::SET_SAMPLE_TIME;
+	Command.m_SampleID = SampleID;
+	Command.m_aValues[0] = Time;
+	std::unique_lock<std::mutex> Lock(m_CommandLock);
+	PushCommand(Command);
 }
 
 void CSound::SetChannel(int ChannelID, float Vol, float Pan)
 {
-	m_aChannels[ChannelID].m_Vol = (int)(Vol * 255.0f);
-	m_aChannels[ChannelID].m_Pan = (int)(Pan * 255.0f); // TODO: this is only on and off right now
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::SET_CHANNEL;
+	Command.m_ChannelID = ChannelID;
+	Command.m_aValues[0] = Vol;
+	Command.m_aValues[1] = Pan;
+	std::unique_lock<std::mutex> Lock(m_CommandLock);
+	PushCommand(Command);
 }
 
 void CSound::SetListenerPos(float x, float y)
@@ -680,126 +845,101 @@ void CSound::SetListenerPos(float x, float y)
 	m_CenterY.store((int)y, std::memory_order_relaxed);
 }
 
-void CSound::SetVoiceVolume(CVoiceHandle Voice, float Volume)
+bool CSound::IsVoiceBusy(int VoiceID)
 {
-	if(!Voice.IsValid())
-		return;
+	CVoiceStatus &Status = m_aVoiceStatus[VoiceID];
+	if(Status.m_SampleID == -1)
+		return false;
+	// the mixer reached the end of the sample
+	if(Status.m_EndedAge.load(std::memory_order_acquire) == Status.m_Age)
+	{
+		FreeVoice(VoiceID);
+		return false;
+	}
+	return true;
+}
 
-	int VoiceID = Voice.Id();
+bool CSound::IsVoiceValid(CVoiceHandle Voice)
+{
+	return Voice.IsValid() && m_aVoiceStatus[Voice.Id()].m_Age == Voice.Age() && IsVoiceBusy(Voice.Id());
+}
 
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	if(m_aVoices[VoiceID].m_Age != Voice.Age())
-		return;
+void CSound::FreeVoice(int VoiceID)
+{
+	m_aVoiceStatus[VoiceID].m_SampleID = -1;
+	m_aVoiceStatus[VoiceID].m_Age++;
+}
 
-	Volume = clamp(Volume, 0.0f, 1.0f);
-	m_aVoices[VoiceID].m_Vol = (int)(Volume * 255.0f);
+void CSound::PushCommand(const CSoundCommand &Command)
+{
+	CSoundCommand *pCommand;
+	while(!(pCommand = m_Commands.Back()))
+	{
+		// the mixer is not running or falls behind, apply the commands here
+		std::unique_lock<std::mutex> Lock(m_MixLock);
+		ProcessCommands();
+	}
+	*pCommand = Command;
+	m_Commands.Push();
 }
 
-void CSound::SetVoiceFalloff(CVoiceHandle Voice, float Falloff)
+void CSound::PushVoiceCommand(CVoiceHandle Voice, int Type, float Value0, float Value1, int X, int Y)
 {
-	if(!Voice.IsValid())
+	std::unique_lock<std::mutex> Lock(m_CommandLock);
+	if(!IsVoiceValid(Voice))
 		return;
 
-	int VoiceID = Voice.Id();
+	CSoundCommand Command = {};
+	Command.m_Type = Type;
+	Command.m_VoiceID = Voice.Id();
+	Command.m_Age = Voice.Age();
+	Command.m_aValues[0] = Value0;
+	Command.m_aValues[1] = Value1;
+	Command.m_X = X;
+	Command.m_Y = Y;
+	PushCommand(Command);
+}
 
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	if(m_aVoices[VoiceID].m_Age != Voice.Age())
-		return;
+void CSound::SetVoiceVolume(CVoiceHandle Voice, float Volume)
+{
+	PushVoiceCommand(Voice, CSoundCommand::SET_VOLUME, Volume);
+}
 
-	Falloff = clamp(Falloff, 0.0f, 1.0f);
-	m_aVoices[VoiceID].m_Falloff = Falloff;
+void CSound::SetVoiceFalloff(CVoiceHandle Voice, float Falloff)
+{
+	PushVoiceCommand(Voice, CSoundCommand::SET_FALLOFF, Falloff);
 }
 
 void CSound::SetVoiceLocation(CVoiceHandle Voice, float x, float y)
 {
-	if(!Voice.IsValid())
-		return;
-
-	int VoiceID = Voice.Id();
-
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	if(m_aVoices[VoiceID].m_Age != Voice.Age())
-		return;
-
-	m_aVoices[VoiceID].m_X = x;
-	m_aVoices[VoiceID].m_Y = y;
+	PushVoiceCommand(Voice, CSoundCommand::SET_LOCATION, 0.0f, 0.0f, (int)x, (int)y);
 }
 
 void CSound::SetVoiceTimeOffset(CVoiceHandle Voice, float TimeOffset)
 {
-	if(!Voice.IsValid())
-		return;
-
-	int VoiceID = Voice.Id();
-
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	if(m_aVoices[VoiceID].m_Age != Voice.Age())
-		return;
-
-	if(!m_aVoices[VoiceID].m_pSample)
-		return;
-
-	int Tick = 0;
-	bool IsLooping = m_aVoices[VoiceID].m_Flags & ISound::FLAG_LOOP;
-	uint64_t TickOffset = m_aVoices[VoiceID].m_pSample->m_Rate * TimeOffset;
-	if(m_aVoices[VoiceID].m_pSample->m_NumFrames > 0 && IsLooping)
-		Tick = TickOffset % m_aVoices[VoiceID].m_pSample->m_NumFrames;
-	else
-		Tick = clamp(TickOffset, (uint64_t)0, (uint64_t)m_aVoices[VoiceID].m_pSample->m_NumFrames);
-
-	// at least 200msec off, else depend on buffer size
-	float Threshold = maximum(0.2f * m_aVoices[VoiceID].m_pSample->m_Rate, (float)m_MaxFrames);
-	if(absolute(m_aVoices[VoiceID].m_Tick - Tick) > Threshold)
-	{
-		// take care of looping (modulo!)
-		if(!(IsLooping && (minimum(m_aVoices[VoiceID].m_Tick, Tick) + m_aVoices[VoiceID].m_pSample->m_NumFrames - maximum(m_aVoices[VoiceID].m_Tick, Tick)) <= Threshold))
-		{
-			m_aVoices[VoiceID].m_Tick = Tick;
-		}
-	}
+	PushVoiceCommand(Voice, CSoundCommand::SET_TIME_OFFSET, TimeOffset);
 }
 
 void CSound::SetVoiceCircle(CVoiceHandle Voice, float Radius)
 {
-	if(!Voice.IsValid())
-		return;
-
-	int VoiceID = Voice.Id();
-
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	if(m_aVoices[VoiceID].m_Age != Voice.Age())
-		return;
-
-	m_aVoices[VoiceID].m_Shape = ISound::SHAPE_CIRCLE;
-	m_aVoices[VoiceID].m_Circle.m_Radius = maximum(0.0f, Radius);
+	PushVoiceCommand(Voice, CSoundCommand::SET_CIRCLE, Radius);
 }
 
 void CSound::SetVoiceRectangle(CVoiceHandle Voice, float Width, float Height)
 {
-	if(!Voice.IsValid())
-		return;
-
-	int VoiceID = Voice.Id();
-
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	if(m_aVoices[VoiceID].m_Age != Voice.Age())
-		return;
-
-	m_aVoices[VoiceID].m_Shape = ISound::SHAPE_RECTANGLE;
-	m_aVoices[VoiceID].m_Rectangle.m_Width = maximum(0.0f, Width);
-	m_aVoices[VoiceID].m_Rectangle.m_Height = maximum(0.0f, Height);
+	PushVoiceCommand(Voice, CSoundCommand::SET_RECTANGLE, Width, Height);
 }
 
 ISound::CVoiceHandle CSound::Play(int ChannelID, int SampleID, int Flags, float x, float y)
 {
-	m_SoundLock.lock();
+	std::unique_lock<std::mutex> Lock(m_CommandLock);
 
 	// search for voice
 	int VoiceID = -1;
 	for(int i = 0; i < NUM_VOICES; i++)
 	{
 		int NextID = (m_NextVoice + i) % NUM_VOICES;
-		if(!m_aVoices[NextID].m_pSample)
+		if(!IsVoiceBusy(NextID))
 		{
 			VoiceID = NextID;
 			m_NextVoice = NextID + 1;
@@ -811,32 +951,23 @@ ISound::CVoiceHandle CSound::Play(int ChannelID, int SampleID, int Flags, float
 	int Age = -1;
 	if(VoiceID != -1)
 	{
-		m_aVoices[VoiceID].m_pSample = &m_aSamples[SampleID];
-		m_aVoices[VoiceID].m_pChannel = &m_aChannels[ChannelID];
-		if(Flags & FLAG_LOOP)
-		{
-			m_aVoices[VoiceID].m_Tick = m_aSamples[SampleID].m_PausedAt;
-		}
-		else if(Flags & FLAG_PREVIEW)
-		{
-			m_aVoices[VoiceID].m_Tick = m_aSamples[SampleID].m_PausedAt;
-			m_aSamples[SampleID].m_PausedAt = 0;
-		}
-		else
-		{
-			m_aVoices[VoiceID].m_Tick = 0;
-		}
-		m_aVoices[VoiceID].m_Vol = 255;
-		m_aVoices[VoiceID].m_Flags = Flags;
-		m_aVoices[VoiceID].m_X = (int)x;
-		m_aVoices[VoiceID].m_Y = (int)y;
-		m_aVoices[VoiceID].m_Falloff = 0.0f;
-		m_aVoices[VoiceID].m_Shape = ISound::SHAPE_CIRCLE;
-		m_aVoices[VoiceID].m_Circle.m_Radius = 1500;
-		Age = m_aVoices[VoiceID].m_Age;
+		CVoiceStatus &Status = m_aVoiceStatus[VoiceID];
+		Status.m_SampleID = SampleID;
+		Status.m_Tick.store(Flags & (FLAG_LOOP | FLAG_PREVIEW) ? m_aSamples[SampleID].m_PausedAt.load() : 0, std::memory_order_relaxed);
+		Age = Status.m_Age;
+
+		CSoundCommand Command = {};
+		Command.m_Type = CSoundCommand::PLAY;
+		Command.m_VoiceID = VoiceID;
+		Command.m_Age = Age;
+		Command.m_SampleID = SampleID;
+		Command.m_ChannelID = ChannelID;
+		Command.m_Flags = Flags;
+		Command.m_X = (int)x;
+		Command.m_Y = (int)y;
+		PushCommand(Command);
 	}
 
-	m_SoundLock.unlock();
 	return CreateVoiceHandle(VoiceID, Age);
 }
 
@@ -853,73 +984,70 @@ ISound::CVoiceHandle CSound::Play(int ChannelID, int SampleID, int Flags)
 void CSound::Pause(int SampleID)
 {
 	// TODO: a nice fade out
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	CSample *pSample = &m_aSamples[SampleID];
-	for(auto &Voice : m_aVoices)
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::PAUSE;
+	Command.m_SampleID = SampleID;
+	std::unique_lock<std::mutex> Lock(m_CommandLock);
+	for(int VoiceID = 0; VoiceID < NUM_VOICES; VoiceID++)
 	{
-		if(Voice.m_pSample == pSample)
-		{
-			Voice.m_pSample->m_PausedAt = Voice.m_Tick;
-			Voice.m_pSample = nullptr;
-		}
+		if(m_aVoiceStatus[VoiceID].m_SampleID == SampleID)
+			FreeVoice(VoiceID);
 	}
+	PushCommand(Command);
 }
 
 void CSound::Stop(int SampleID)
 {
 	// TODO: a nice fade out
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	CSample *pSample = &m_aSamples[SampleID];
-	for(auto &Voice : m_aVoices)
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::STOP;
+	Command.m_SampleID = SampleID;
+	std::unique_lock<std::mutex> Lock(m_CommandLock);
+	for(int VoiceID = 0; VoiceID < NUM_VOICES; VoiceID++)
 	{
-		if(Voice.m_pSample == pSample)
-		{
-			if(Voice.m_Flags & FLAG_LOOP)
-				Voice.m_pSample->m_PausedAt = Voice.m_Tick;
-			else
-				Voice.m_pSample->m_PausedAt = 0;
-			Voice.m_pSample = nullptr;
-		}
+		if(m_aVoiceStatus[VoiceID].m_SampleID == SampleID)
+			FreeVoice(VoiceID);
 	}
+	PushCommand(Command);
 }
 
 void CSound::StopAll()
 {
 	// TODO: a nice fade out
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	for(auto &Voice : m_aVoices)
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::STOP_ALL;
+	std::unique_lock<std::mutex> Lock(m_CommandLock);
+	for(int VoiceID = 0; VoiceID < NUM_VOICES; VoiceID++)
 	{
-		if(Voice.m_pSample)
-		{
-			if(Voice.m_Flags & FLAG_LOOP)
-				Voice.m_pSample->m_PausedAt = Voice.m_Tick;
-			else
-				Voice.m_pSample->m_PausedAt = 0;
-		}
-		Voice.m_pSample = nullptr;
+		if(m_aVoiceStatus[VoiceID].m_SampleID != -1)
+			FreeVoice(VoiceID);
 	}
+	PushCommand(Command);
 }
 
 void CSound::StopVoice(CVoiceHandle Voice)
 {
-	if(!Voice.IsValid())
-		return;
-
-	int VoiceID = Voice.Id();
-
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	if(m_aVoices[VoiceID].m_Age != Voice.Age())
+	std::unique_lock<std::mutex> Lock(m_CommandLock);
+	if(!IsVoiceValid(Voice))
 		return;
 
-	m_aVoices[VoiceID].m_pSample = nullptr;
-	m_aVoices[VoiceID].m_Age++;
+	CSoundCommand Command = {};
+	Command.m_Type = CSoundCommand::STOP_VOICE;
+	Command.m_VoiceID = Voice.Id();
+	Command.m_Age = Voice.Age();
+	FreeVoice(Voice.Id());
+	PushCommand(Command);
 }
 
 bool CSound::IsPlaying(int SampleID)
 {
-	std::unique_lock<std::mutex> Lock(m_SoundLock);
-	const CSample *pSample = &m_aSamples[SampleID];
-	return std::any_of(std::begin(m_aVoices), std::end(m_aVoices), [pSample](const auto &Voice) { return Voice.m_pSample == pSample; });
+	std::unique_lock<std::mutex> Lock(m_CommandLock);
+	for(int VoiceID = 0; VoiceID < NUM_VOICES; VoiceID++)
+	{
+		if(m_aVoiceStatus[VoiceID].m_SampleID == SampleID && IsVoiceBusy(VoiceID))
+			return true;
+	}
+	return false;
 }
 
 void CSound::PauseAudioDevice()
@@ -3,6 +3,8 @@
 #ifndef ENGINE_CLIENT_SOUND_H
 #define ENGINE_CLIENT_SOUND_H
 
+#include <base/tl/threading.h>
+
 #include <engine/sound.h>
 
 #include <SDL_audio.h>
@@ -18,7 +20,8 @@ struct CSample
 	int m_Channels;
 	int m_LoopStart;
 	int m_LoopEnd;
-	int m_PausedAt;
+	// written by the mixer
+	std::atomic<int> m_PausedAt;
 };
 
 struct CChannel
@@ -27,11 +30,12 @@ struct CChannel
 	int m_Pan;
 };
 
+// the voice as seen by the mixer
 struct CVoice
 {
 	CSample *m_pSample;
 	CChannel *m_pChannel;
-	int m_Age; // increases when reused
+	int m_Age; // of the play that started the voice
 	int m_Tick;
 	int m_Vol; // 0 - 255
 	int m_Flags;
@@ -44,6 +48,52 @@ struct CVoice
 		ISound::CVoiceShapeCircle m_Circle;
 		ISound::CVoiceShapeRectangle m_Rectangle;
 	};
+
+	// volumes of the last mixed frame, -1 for new voices
+	int m_LastVolumeL;
+	int m_LastVolumeR;
+};
+
+// the voice as seen by the game
+struct CVoiceStatus
+{
+	// -1 if the voice is free
+	int m_SampleID = -1;
+	int m_Age = 0; // increases when reused
+
+	// published by the mixer
+	std::atomic<int> m_EndedAge = -1;
+	std::atomic<int> m_Tick = 0;
+};
+
+// changes of the voices, sent from the game to the mixer
+struct CSoundCommand
+{
+	enum
+	{
+		PLAY,
+		PAUSE,
+		STOP,
+		STOP_ALL,
+		STOP_VOICE,
+		SET_SAMPLE_TIME,
+		SET_CHANNEL,
+		SET_VOLUME,
+		SET_FALLOFF,
+		SET_LOCATION,
+		SET_TIME_OFFSET,
+		SET_CIRCLE,
+		SET_RECTANGLE,
+	};
+
+	int m_Type;
+	int m_VoiceID;
+	int m_Age;
+	int m_SampleID;
+	int m_ChannelID;
+	int m_Flags;
+	int m_X, m_Y;
+	float m_aValues[2];
 };
 
 class CSound : public IEngineSound
@@ -57,11 +107,17 @@ class CSound : public IEngineSound
 
 	bool m_SoundEnabled = false;
 	SDL_AudioDeviceID m_Device = 0;
-	std::mutex m_SoundLock;
+
+	// held by the mixer, the game only takes it to wait for the mixer
+	std::mutex m_MixLock;
+	// serializes the game threads, never taken by the mixer
+	std::mutex m_CommandLock;
+	CSpscQueue<CSoundCommand, 4096> m_Commands;
 
 	CSample m_aSamples[NUM_SAMPLES] = {{0}};
 	CVoice m_aVoices[NUM_VOICES] = {{0}};
 	CChannel m_aChannels[NUM_CHANNELS] = {{255, 0}};
+	CVoiceStatus m_aVoiceStatus[NUM_VOICES];
 	int m_NextVoice = 0;
 	uint32_t m_MaxFrames = 0;
 
@@ -83,6 +139,19 @@ class CSound : public IEngineSound
 
 	void UpdateVolume();
 
+	// game side, with m_CommandLock held
+	bool IsVoiceBusy(int VoiceID);
+	bool IsVoiceValid(CVoiceHandle Voice);
+	void FreeVoice(int VoiceID);
+	void PushCommand(const CSoundCommand &Command);
+	void PushVoiceCommand(CVoiceHandle Voice, int Type, float Value0 = 0.0f, float Value1 = 0.0f, int X = 0, int Y = 0);
+
+	// mixer side, with m_MixLock held
+	void ProcessCommands();
+	void ApplyCommand(const CSoundCommand &Command);
+	void StopMixerVoice(CVoice &Voice);
+	void VoiceVolume(const CVoice &Voice, int *pVolumeL, int *pVolumeR) const;
+
 public:
 	int Init() override;
 	int Update() override;
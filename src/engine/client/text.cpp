@@ -5,7 +5,9 @@
 #include <base/system.h>
 
 #include <engine/console.h>
+#include <engine/engine.h>
 #include <engine/graphics.h>
+#include <engine/shared/jobs.h>
 #include <engine/shared/json.h>
 #include <engine/storage.h>
 #include <engine/textrender.h>
@@ -17,6 +19,9 @@
 #include <chrono>
 #include <cstddef>
 #include <limits>
+#include <list>
+#include <memory>
+#include <string>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -33,6 +38,7 @@ struct SGlyph
 	enum class EState
 	{
 		UNINITIALIZED,
+		PREWARMING,
 		RENDERED,
 		ERROR,
 	};
@@ -271,6 +277,53 @@ public:
 	}
 };
 
+// A rendered glyph and its outline, padded for the outline, with its metrics in pixels
+struct SRasterizedGlyph
+{
+	unsigned m_Width = 0;
+	unsigned m_Height = 0;
+	unsigned m_CharWidth = 0;
+	unsigned m_CharHeight = 0;
+	int m_OffsetX = 0;
+	int m_OffsetY = 0;
+	int m_AdvanceX = 0;
+	std::vector<uint8_t> m_vFill;
+	std::vector<uint8_t> m_vOutline;
+};
+
+/**
+ * Renders glyphs on the job pool, they are placed in the atlas on the main thread.
+ * FreeType faces must not be used by several threads, so the job opens its own faces
+ * on the font data.
+ */
+class CGlyphPrewarmJob : public IJob
+{
+	void Run() override;
+
+public:
+	struct SFaceSource
+	{
+		// the face of the glyph map, only used to identify it
+		FT_Face m_Face;
+		const FT_Byte *m_pData;
+		FT_Long m_DataSize;
+		FT_Long m_FaceIndex;
+	};
+
+	struct SRequest
+	{
+		size_t m_Source;
+		int m_Chr;
+		FT_UInt m_GlyphIndex;
+		int m_FontSize;
+		bool m_Rasterized = false;
+		SRasterizedGlyph m_Raster;
+	};
+
+	std::vector<SFaceSource> m_vSources;
+	std::vector<SRequest> m_vRequests;
+};
+
 class CGlyphMap
 {
 public:
@@ -311,6 +364,7 @@ private:
 
 	IGraphics *m_pGraphics;
 	IGraphics *Graphics() { return m_pGraphics; }
+	IEngine *m_pEngine;
 
 	// Atlas textures and data
 	IGraphics::CTextureHandle m_aTextures[NUM_FONT_TEXTURES];
@@ -331,6 +385,10 @@ private:
 	FT_Face m_SelectedFace = nullptr;
 	std::vector<FT_Face> m_vFallbackFaces;
 	std::vector<FT_Face> m_vFtFaces;
+	std::vector<CGlyphPrewarmJob::SFaceSource> m_vFaceSources;
+
+	// Glyphs being rendered on the job pool
+	std::vector<std::shared_ptr<CGlyphPrewarmJob>> m_vpPrewarmJobs;
 
 	FT_Face GetFaceByName(const char *pFamilyName)
 	{
@@ -448,7 +506,7 @@ private:
 		return GlyphIndex;
 	}
 
-	void Grow(const unsigned char *pIn, unsigned char *pOut, int w, int h, int OutlineCount) const
+	static void Grow(const unsigned char *pIn, unsigned char *pOut, int w, int h, int OutlineCount)
 	{
 		for(int y = 0; y < h; y++)
 		{
@@ -476,7 +534,7 @@ private:
 		}
 	}
 
-	int AdjustOutlineThicknessToFontSize(int OutlineThickness, int FontSize) const
+	static int AdjustOutlineThicknessToFontSize(int OutlineThickness, int FontSize)
 	{
 		if(FontSize > 48)
 			OutlineThickness *= 4;
@@ -499,42 +557,15 @@ private:
 		return m_TextureAtlas.Add(Width, Height, PosX, PosY);
 	}
 
-	bool RenderGlyph(SGlyph &Glyph)
+	bool PlaceGlyph(SGlyph &Glyph, const SRasterizedGlyph &Raster)
 	{
-		FT_Set_Pixel_Sizes(Glyph.m_Face, 0, Glyph.m_FontSize);
-
-		if(FT_Load_Glyph(Glyph.m_Face, Glyph.m_GlyphIndex, FT_LOAD_RENDER | FT_LOAD_NO_BITMAP))
-		{
-			log_debug("textrender", "Error loading glyph. Chr=%d GlyphIndex=%u", Glyph.m_Chr, Glyph.m_GlyphIndex);
-			return false;
-		}
-
-		const FT_Bitmap *pBitmap = &Glyph.m_Face->glyph->bitmap;
-
-		const unsigned RealWidth = pBitmap->width;
-		const unsigned RealHeight = pBitmap->rows;
-
-		// adjust spacing
-		int OutlineThickness = 0;
-		int x = 0;
-		int y = 0;
-		if(RealWidth > 0)
-		{
-			OutlineThickness = AdjustOutlineThicknessToFontSize(1, Glyph.m_FontSize);
-			x += (OutlineThickness + 1);
-			y += (OutlineThickness + 1);
-		}
-
-		const unsigned Width = RealWidth + x * 2;
-		const unsigned Height = RealHeight + y * 2;
-
 		int X = 0;
 		int Y = 0;
 
-		if(Width > 0 && Height > 0)
+		if(Raster.m_Width > 0 && Raster.m_Height > 0)
 		{
 			// find space in atlas, or increase size if necessary
-			while(!FitGlyph(Width, Height, X, Y))
+			while(!FitGlyph(Raster.m_Width, Raster.m_Height, X, Y))
 			{
 				if(!IncreaseGlyphMapSize())
 				{
@@ -543,46 +574,45 @@ private:
 				}
 			}
 
-			// prepare glyph data
-			mem_zero(m_aaGlyphData[FONT_TEXTURE_FILL], (size_t)Width * Height * sizeof(uint8_t));
-			for(unsigned py = 0; py < pBitmap->rows; ++py)
-			{
-				mem_copy(&m_aaGlyphData[FONT_TEXTURE_FILL][(py + y) * Width + x], &pBitmap->buffer[py * pBitmap->width], pBitmap->width);
-			}
-
 			// upload the glyph
-			UploadGlyph(FONT_TEXTURE_FILL, X, Y, Width, Height, m_aaGlyphData[FONT_TEXTURE_FILL]);
-			Grow(m_aaGlyphData[FONT_TEXTURE_FILL], m_aaGlyphData[FONT_TEXTURE_OUTLINE], Width, Height, OutlineThickness);
-			UploadGlyph(FONT_TEXTURE_OUTLINE, X, Y, Width, Height, m_aaGlyphData[FONT_TEXTURE_OUTLINE]);
+			UploadGlyph(FONT_TEXTURE_FILL, X, Y, Raster.m_Width, Raster.m_Height, Raster.m_vFill.data());
+			UploadGlyph(FONT_TEXTURE_OUTLINE, X, Y, Raster.m_Width, Raster.m_Height, Raster.m_vOutline.data());
 		}
 
 		// set glyph info
-		{
-			const int BmpWidth = pBitmap->width + x * 2;
-			const int BmpHeight = pBitmap->rows + y * 2;
-
-			Glyph.m_Height = Height;
-			Glyph.m_Width = Width;
-			Glyph.m_CharHeight = RealHeight;
-			Glyph.m_CharWidth = RealWidth;
-			Glyph.m_OffsetX = (Glyph.m_Face->glyph->metrics.horiBearingX >> 6);
-			Glyph.m_OffsetY = -((Glyph.m_Face->glyph->metrics.height >> 6) - (Glyph.m_Face->glyph->metrics.horiBearingY >> 6));
-			Glyph.m_AdvanceX = (Glyph.m_Face->glyph->advance.x >> 6);
-
-			Glyph.m_aUVs[0] = X;
-			Glyph.m_aUVs[1] = Y;
-			Glyph.m_aUVs[2] = Glyph.m_aUVs[0] + BmpWidth;
-			Glyph.m_aUVs[3] = Glyph.m_aUVs[1] + BmpHeight;
+		Glyph.m_Height = Raster.m_Height;
+		Glyph.m_Width = Raster.m_Width;
+		Glyph.m_CharHeight = Raster.m_CharHeight;
+		Glyph.m_CharWidth = Raster.m_CharWidth;
+		Glyph.m_OffsetX = Raster.m_OffsetX;
+		Glyph.m_OffsetY = Raster.m_OffsetY;
+		Glyph.m_AdvanceX = Raster.m_AdvanceX;
+
+		Glyph.m_aUVs[0] = X;
+		Glyph.m_aUVs[1] = Y;
+		Glyph.m_aUVs[2] = Glyph.m_aUVs[0] + Raster.m_Width;
+		Glyph.m_aUVs[3] = Glyph.m_aUVs[1] + Raster.m_Height;
+
+		Glyph.m_State = SGlyph::EState::RENDERED;
+		return true;
+	}
 
-			Glyph.m_State = SGlyph::EState::RENDERED;
+	bool RenderGlyph(SGlyph &Glyph)
+	{
+		SRasterizedGlyph Raster;
+		if(!RasterizeGlyph(Glyph.m_Face, Glyph.m_GlyphIndex, Glyph.m_FontSize, Raster))
+		{
+			log_debug("textrender", "Error loading glyph. Chr=%d GlyphIndex=%u", Glyph.m_Chr, Glyph.m_GlyphIndex);
+			return false;
 		}
-		return true;
+		return PlaceGlyph(Glyph, Raster);
 	}
 
 public:
-	CGlyphMap(IGraphics *pGraphics)
+	CGlyphMap(IGraphics *pGraphics, IEngine *pEngine)
 	{
 		m_pGraphics = pGraphics;
+		m_pEngine = pEngine;
 		for(auto &pTextureData : m_apTextureData)
 		{
 			pTextureData = new uint8_t[m_TextureDimension * m_TextureDimension];
@@ -595,6 +625,13 @@ public:
 
 	~CGlyphMap()
 	{
+		// the jobs use the font data
+		for(const auto &pJob : m_vpPrewarmJobs)
+		{
+			while(pJob->Status() != IJob::STATE_DONE)
+				thread_yield();
+		}
+
 		UnloadTextures();
 		for(auto &pTextureData : m_apTextureData)
 		{
@@ -602,6 +639,51 @@ public:
 		}
 	}
 
+	// renders a glyph with only the given face, so it can be used on any thread owning the face
+	static bool RasterizeGlyph(FT_Face Face, FT_UInt GlyphIndex, int FontSize, SRasterizedGlyph &Raster)
+	{
+		FT_Set_Pixel_Sizes(Face, 0, FontSize);
+
+		if(FT_Load_Glyph(Face, GlyphIndex, FT_LOAD_RENDER | FT_LOAD_NO_BITMAP))
+			return false;
+
+		const FT_Bitmap *pBitmap = &Face->glyph->bitmap;
+
+		const unsigned RealWidth = pBitmap->width;
+		const unsigned RealHeight = pBitmap->rows;
+
+		// adjust spacing
+		int OutlineThickness = 0;
+		int x = 0;
+		int y = 0;
+		if(RealWidth > 0)
+		{
+			OutlineThickness = AdjustOutlineThicknessToFontSize(1, FontSize);
+			x += (OutlineThickness + 1);
+			y += (OutlineThickness + 1);
+		}
+
+		Raster.m_Width = RealWidth + x * 2;
+		Raster.m_Height = RealHeight + y * 2;
+		Raster.m_CharWidth = RealWidth;
+		Raster.m_CharHeight = RealHeight;
+		Raster.m_OffsetX = (Face->glyph->metrics.horiBearingX >> 6);
+		Raster.m_OffsetY = -((Face->glyph->metrics.height >> 6) - (Face->glyph->metrics.horiBearingY >> 6));
+		Raster.m_AdvanceX = (Face->glyph->advance.x >> 6);
+
+		if(Raster.m_Width > 0 && Raster.m_Height > 0)
+		{
+			Raster.m_vFill.assign((size_t)Raster.m_Width * Raster.m_Height, 0);
+			for(unsigned py = 0; py < pBitmap->rows; ++py)
+			{
+				mem_copy(&Raster.m_vFill[(py + y) * Raster.m_Width + x], &pBitmap->buffer[py * pBitmap->width], pBitmap->width);
+			}
+			Raster.m_vOutline.resize(Raster.m_vFill.size());
+			Grow(Raster.m_vFill.data(), Raster.m_vOutline.data(), Raster.m_Width, Raster.m_Height, OutlineThickness);
+		}
+		return true;
+	}
+
 	FT_Face DefaultFace() const
 	{
 		return m_DefaultFace;
@@ -612,9 +694,15 @@ public:
 		return m_IconFace;
 	}
 
-	void AddFace(FT_Face Face)
+	FT_Face SelectedFace() const
+	{
+		return m_SelectedFace;
+	}
+
+	void AddFace(FT_Face Face, const FT_Byte *pData, FT_Long DataSize, FT_Long FaceIndex)
 	{
 		m_vFtFaces.push_back(Face);
+		m_vFaceSources.push_back({Face, pData, DataSize, FaceIndex});
 		if(!m_DefaultFace)
 			m_DefaultFace = Face;
 	}
@@ -694,7 +782,8 @@ public:
 		else if(Glyph.m_State == SGlyph::EState::ERROR)
 			return nullptr;
 
-		// Else, render it.
+		// Else, render it. Glyphs that are still being prewarmed are needed now,
+		// the result of the job is ignored then.
 		Glyph.m_FontSize = FontSize;
 		Glyph.m_Face = Face;
 		Glyph.m_Chr = Chr;
@@ -717,6 +806,93 @@ public:
 		return nullptr;
 	}
 
+	/**
+	 * Renders the glyphs of the text on the job pool, so they are ready the first time the text is rendered.
+	 * The glyphs are placed in the atlas by @link UpdatePrewarmedGlyphs @endlink.
+	 */
+	void PrewarmGlyphs(const char *pText, int FontSize)
+	{
+		FontSize = clamp(FontSize, MIN_FONT_SIZE, MAX_FONT_SIZE);
+
+		std::shared_ptr<CGlyphPrewarmJob> pJob;
+		const char *pCursor = pText;
+		while(true)
+		{
+			const int Chr = str_utf8_decode(&pCursor);
+			if(Chr == 0)
+				break;
+			if(Chr < 0)
+				continue;
+
+			FT_Face Face;
+			const FT_UInt GlyphIndex = GetCharGlyph(Chr, &Face, false);
+			if(GlyphIndex == 0)
+				continue;
+			const auto SourceIt = std::find_if(m_vFaceSources.begin(), m_vFaceSources.end(), [Face](const CGlyphPrewarmJob::SFaceSource &Source) { return Source.m_Face == Face; });
+			if(SourceIt == m_vFaceSources.end())
+				continue;
+
+			SGlyph &Glyph = m_Glyphs[std::make_tuple(Face, Chr, FontSize)];
+			if(Glyph.m_State != SGlyph::EState::UNINITIALIZED)
+				continue;
+			Glyph.m_State = SGlyph::EState::PREWARMING;
+
+			if(!pJob)
+				pJob = std::make_shared<CGlyphPrewarmJob>();
+			auto JobSourceIt = std::find_if(pJob->m_vSources.begin(), pJob->m_vSources.end(), [Face](const CGlyphPrewarmJob::SFaceSource &Source) { return Source.m_Face == Face; });
+			if(JobSourceIt == pJob->m_vSources.end())
+			{
+				pJob->m_vSources.push_back(*SourceIt);
+				JobSourceIt = pJob->m_vSources.end() - 1;
+			}
+
+			pJob->m_vRequests.emplace_back();
+			CGlyphPrewarmJob::SRequest &Request = pJob->m_vRequests.back();
+			Request.m_Source = JobSourceIt - pJob->m_vSources.begin();
+			Request.m_Chr = Chr;
+			Request.m_GlyphIndex = GlyphIndex;
+			Request.m_FontSize = FontSize;
+		}
+
+		if(pJob)
+		{
+			m_pEngine->AddJob(pJob);
+			m_vpPrewarmJobs.push_back(pJob);
+		}
+	}
+
+	void UpdatePrewarmedGlyphs()
+	{
+		for(auto JobIt = m_vpPrewarmJobs.begin(); JobIt != m_vpPrewarmJobs.end();)
+		{
+			const std::shared_ptr<CGlyphPrewarmJob> &pJob = *JobIt;
+			if(pJob->Status() != IJob::STATE_DONE)
+			{
+				++JobIt;
+				continue;
+			}
+
+			for(const auto &Request : pJob->m_vRequests)
+			{
+				const FT_Face Face = pJob->m_vSources[Request.m_Source].m_Face;
+				const auto GlyphIt = m_Glyphs.find(std::make_tuple(Face, Request.m_Chr, Request.m_FontSize));
+				// skip glyphs that were rendered in the meantime or removed by clearing the atlas
+				if(GlyphIt == m_Glyphs.end() || GlyphIt->second.m_State != SGlyph::EState::PREWARMING)
+					continue;
+
+				SGlyph &Glyph = GlyphIt->second;
+				Glyph.m_FontSize = Request.m_FontSize;
+				Glyph.m_Face = Face;
+				Glyph.m_Chr = Request.m_Chr;
+				Glyph.m_GlyphIndex = Request.m_GlyphIndex;
+				// failed glyphs are rendered again when they are used, which handles the replacement character
+				if(!Request.m_Rasterized || !PlaceGlyph(Glyph, Request.m_Raster))
+					Glyph.m_State = SGlyph::EState::UNINITIALIZED;
+			}
+			JobIt = m_vpPrewarmJobs.erase(JobIt);
+		}
+	}
+
 	vec2 Kerning(const SGlyph *pLeft, const SGlyph *pRight) const
 	{
 		if(pLeft != nullptr && pRight != nullptr && pLeft->m_Face == pRight->m_Face && pLeft->m_FontSize == pRight->m_FontSize)
@@ -810,6 +986,34 @@ public:
 	}
 };
 
+void CGlyphPrewarmJob::Run()
+{
+	FT_Library Library;
+	if(FT_Init_FreeType(&Library))
+		return;
+
+	std::vector<FT_Face> vFaces(m_vSources.size(), nullptr);
+	std::vector<bool> vFailedFaces(m_vSources.size(), false);
+	for(auto &Request : m_vRequests)
+	{
+		FT_Face &Face = vFaces[Request.m_Source];
+		if(!Face && !vFailedFaces[Request.m_Source])
+		{
+			const SFaceSource &Source = m_vSources[Request.m_Source];
+			if(FT_New_Memory_Face(Library, Source.m_pData, Source.m_DataSize, Source.m_FaceIndex, &Face))
+			{
+				Face = nullptr;
+				vFailedFaces[Request.m_Source] = true;
+			}
+		}
+		if(Face)
+			Request.m_Rasterized = CGlyphMap::RasterizeGlyph(Face, Request.m_GlyphIndex, Request.m_FontSize, Request.m_Raster);
+	}
+
+	// also frees the faces
+	FT_Done_FreeType(Library);
+}
+
 typedef vector4_base<unsigned char> STextCharQuadVertexColor;
 
 struct STextCharQuadVertex
@@ -901,6 +1105,107 @@ struct STextContainer
 	}
 };
 
+// A single line of text laid out relative to where it starts
+struct STextLayout
+{
+	// without color, only set if the text was rendered
+	std::vector<STextCharQuad> m_vQuads;
+	bool m_HasQuads;
+
+	float m_Advance;
+	bool m_HasLongestLine;
+	float m_LongestLine;
+	float m_MaxCharacterHeight;
+	int m_GlyphCount;
+	int m_CharCount;
+};
+
+// Everything the layout of a single line depends on, apart from the glyph map
+struct STextLayoutKey
+{
+	std::string m_Text;
+	FT_Face m_SelectedFace;
+	float m_FontSize;
+	float m_AlignedFontSize;
+	int m_ActualSize;
+	float m_LineWidth;
+	// offset of the text to the start of the cursor, lines are cut relative to it
+	float m_StartOffset;
+	int m_Flags;
+	unsigned m_RenderFlags;
+	bool m_FirstGlyph;
+
+	bool operator==(const STextLayoutKey &Other) const
+	{
+		return m_Text == Other.m_Text && m_SelectedFace == Other.m_SelectedFace && m_FontSize == Other.m_FontSize && m_AlignedFontSize == Other.m_AlignedFontSize &&
+		       m_ActualSize == Other.m_ActualSize && m_LineWidth == Other.m_LineWidth && m_StartOffset == Other.m_StartOffset && m_Flags == Other.m_Flags &&
+		       m_RenderFlags == Other.m_RenderFlags && m_FirstGlyph == Other.m_FirstGlyph;
+	}
+};
+
+struct STextLayoutKeyHash
+{
+	size_t operator()(const STextLayoutKey &Key) const
+	{
+		size_t Hash = std::hash<std::string>()(Key.m_Text);
+		Hash = Hash * 31 + std::hash<FT_Face>()(Key.m_SelectedFace);
+		Hash = Hash * 31 + std::hash<float>()(Key.m_AlignedFontSize);
+		Hash = Hash * 31 + std::hash<float>()(Key.m_LineWidth);
+		Hash = Hash * 31 + std::hash<float>()(Key.m_StartOffset);
+		Hash = Hash * 31 + std::hash<int>()(Key.m_Flags);
+		Hash = Hash * 31 + std::hash<unsigned>()(Key.m_RenderFlags);
+		return Hash;
+	}
+};
+
+/**
+ * Keeps the layouts of the most recently used single line texts, like the names
+ * and scores that are laid out again every frame.
+ */
+class CTextLayoutCache
+{
+	static constexpr size_t MAX_LAYOUTS = 512;
+
+	// most recently used first
+	std::list<std::pair<STextLayoutKey, STextLayout>> m_Layouts;
+	std::unordered_map<STextLayoutKey, std::list<std::pair<STextLayoutKey, STextLayout>>::iterator, STextLayoutKeyHash> m_Index;
+
+public:
+	const STextLayout *Find(const STextLayoutKey &Key)
+	{
+		const auto It = m_Index.find(Key);
+		if(It == m_Index.end())
+			return nullptr;
+		m_Layouts.splice(m_Layouts.begin(), m_Layouts, It->second);
+		return &It->second->second;
+	}
+
+	STextLayout &Insert(const STextLayoutKey &Key)
+	{
+		const auto It = m_Index.find(Key);
+		if(It != m_Index.end())
+		{
+			m_Layouts.splice(m_Layouts.begin(), m_Layouts, It->second);
+			return It->second->second;
+		}
+
+		if(m_Layouts.size() >= MAX_LAYOUTS)
+		{
+			m_Index.erase(m_Layouts.back().first);
+			m_Layouts.pop_back();
+		}
+		m_Layouts.emplace_front(Key, STextLayout());
+		m_Index.emplace(Key, m_Layouts.begin());
+		return m_Layouts.front().second;
+	}
+
+	void Clear()
+	{
+		m_Index.clear();
+		m_Layouts.clear();
+	}
+};
+
 struct SFontLanguageVariant
 {
 	char m_aLanguageFile[IO_MAX_PATH_LENGTH];
@@ -918,6 +1223,7 @@ class CTextRender : public IEngineTextRender
 
 	CGlyphMap *m_pGlyphMap;
 	std::vector<void *> m_vpFontData;
+	CTextLayoutCache m_LayoutCache;
 
 	std::vector<SFontLanguageVariant> m_vVariants;
 
@@ -1024,7 +1330,7 @@ class CTextRender : public IEngineTextRender
 				continue;
 			}
 
-			m_pGlyphMap->AddFace(FtFace);
+			m_pGlyphMap->AddFace(FtFace, pFontData, FontDataSize, FaceIndex);
 
 			char aBuf[256];
 			str_format(aBuf, sizeof(aBuf), "Loaded font face %ld '%s %s' from font file '%s'", FaceIndex, FtFace->family_name, FtFace->style_name, pFontName);
@@ -1077,7 +1383,7 @@ public:
 		m_pGraphics = Kernel()->RequestInterface<IGraphics>();
 		m_pStorage = Kernel()->RequestInterface<IStorage>();
 		FT_Init_FreeType(&m_FTLibrary);
-		m_pGlyphMap = new CGlyphMap(m_pGraphics);
+		m_pGlyphMap = new CGlyphMap(m_pGraphics, Kernel()->RequestInterface<IEngine>());
 
 		// print freetype version
 		{
@@ -1124,6 +1430,7 @@ public:
 			delete pTextCont;
 		m_vpTextContainers.clear();
 
+		m_LayoutCache.Clear();
 		delete m_pGlyphMap;
 		m_pGlyphMap = nullptr;
 
@@ -1241,6 +1548,9 @@ public:
 		}
 
 		json_value_free(pJsonData);
+
+		// layouts of texts without the fonts
+		m_LayoutCache.Clear();
 	}
 
 	void SetFontPreset(EFontPreset FontPreset) override
@@ -1255,10 +1565,19 @@ public:
 			if(str_comp(pLanguageFile, Variant.m_aLanguageFile) == 0)
 			{
 				m_pGlyphMap->SetVariantFaceByName(Variant.m_aFamilyName);
+				m_LayoutCache.Clear();
 				return;
 			}
 		}
 		m_pGlyphMap->SetVariantFaceByName(nullptr);
+		m_LayoutCache.Clear();
+	}
+
+	void PrewarmGlyphs(float Size, const char *pText) override
+	{
+		float ScreenX0, ScreenY0, ScreenX1, ScreenY1;
+		Graphics()->GetScreen(&ScreenX0, &ScreenY0, &ScreenX1, &ScreenY1);
+		m_pGlyphMap->PrewarmGlyphs(pText, round_truncate(Size * Graphics()->ScreenHeight() / (ScreenY1 - ScreenY0)));
 	}
 
 	void SetCursor(CTextCursor *pCursor, float x, float y, float FontSize, int Flags) const override
@@ -1469,6 +1788,8 @@ public:
 		STextContainer &TextContainer = GetTextContainer(TextContainerIndex);
 		str_append(TextContainer.m_aDebugText, pText);
 
+		m_pGlyphMap->UpdatePrewarmedGlyphs();
+
 		float ScreenX0, ScreenY0, ScreenX1, ScreenY1;
 		Graphics()->GetScreen(&ScreenX0, &ScreenY0, &ScreenX1, &ScreenY1);
 
@@ -1611,6 +1932,55 @@ public:
 		bool GotNewLine = false;
 		bool GotNewLineLast = false;
 
+		// single lines without cursor and selection are laid out once, afterwards they are only moved
+		const bool WrapsWords = pCursor->m_LineWidth > 0 && !(pCursor->m_Flags & TEXTFLAG_STOP_AT_END) && !(pCursor->m_Flags & TEXTFLAG_ELLIPSIS_AT_END);
+		const bool CacheLayout = !WrapsWords && pCursor->m_CalculateSelectionMode == TEXT_CURSOR_SELECTION_MODE_NONE && pCursor->m_CursorMode == TEXT_CURSOR_CURSOR_MODE_NONE &&
+					 (m_Color.a != 0.f || !IsRendered) && ((pCursor->m_Flags & TEXTFLAG_DISALLOW_NEWLINE) != 0 || std::find(pCurrent, pEnd, '\n') == pEnd);
+		STextLayoutKey LayoutKey;
+		bool LayoutFromCache = false;
+		const size_t StartQuad = TextContainer.m_StringInfo.m_vCharacterQuads.size();
+		const float StartDrawX = DrawX;
+		const float StartDrawY = DrawY;
+		const int StartGlyphCount = pCursor->m_GlyphCount;
+		const int StartCharCount = pCursor->m_CharCount;
+		const float StartLongestLineWidth = pCursor->m_LongestLineWidth;
+		const float StartMaxCharacterHeight = pCursor->m_MaxCharacterHeight;
+		if(CacheLayout)
+		{
+			const bool CutsLine = (pCursor->m_Flags & (TEXTFLAG_STOP_AT_END | TEXTFLAG_ELLIPSIS_AT_END)) != 0;
+			LayoutKey.m_Text.assign(pCurrent, pEnd - pCurrent);
+			LayoutKey.m_SelectedFace = m_pGlyphMap->SelectedFace();
+			LayoutKey.m_FontSize = pCursor->m_FontSize;
+			LayoutKey.m_AlignedFontSize = pCursor->m_AlignedFontSize;
+			LayoutKey.m_ActualSize = ActualSize;
+			LayoutKey.m_LineWidth = CutsLine ? pCursor->m_LineWidth : 0.0f;
+			LayoutKey.m_StartOffset = CutsLine ? DrawX - pCursor->m_StartX : 0.0f;
+			LayoutKey.m_Flags = pCursor->m_Flags & ~TEXTFLAG_RENDER;
+			LayoutKey.m_RenderFlags = RenderFlags;
+			LayoutKey.m_FirstGlyph = pCursor->m_GlyphCount == 0;
+
+			const STextLayout *pLayout = m_LayoutCache.Find(LayoutKey);
+			if(pLayout != nullptr && (pLayout->m_HasQuads || !IsRendered))
+			{
+				if(IsRendered)
+					AddLayoutQuads(TextContainer, *pLayout, DrawX, DrawY);
+				pCursor->m_GlyphCount += pLayout->m_GlyphCount;
+				pCursor->m_CharCount += pLayout->m_CharCount;
+				pCursor->m_MaxCharacterHeight = maximum(pCursor->m_MaxCharacterHeight, pLayout->m_MaxCharacterHeight);
+				if(pLayout->m_HasLongestLine)
+					pCursor->m_LongestLineWidth = maximum(pCursor->m_LongestLineWidth, DrawX + pLayout->m_LongestLine - pCursor->m_StartX);
+				DrawX += pLayout->m_Advance;
+				pCurrent = pEnd;
+				LayoutFromCache = true;
+			}
+			else
+			{
+				// measure this text alone
+				pCursor->m_LongestLineWidth = std::numeric_limits<float>::lowest();
+				pCursor->m_MaxCharacterHeight = std::numeric_limits<float>::lowest();
+			}
+		}
+
 		while(pCurrent < pEnd && pCurrent != pEllipsis)
 		{
 			bool NewLine = false;
@@ -1872,6 +2242,30 @@ public:
 				GotNewLineLast = false;
 		}
 
+		if(CacheLayout && !LayoutFromCache)
+		{
+			STextLayout &Layout = m_LayoutCache.Insert(LayoutKey);
+			Layout.m_HasQuads = IsRendered;
+			Layout.m_vQuads.assign(TextContainer.m_StringInfo.m_vCharacterQuads.begin() + StartQuad, TextContainer.m_StringInfo.m_vCharacterQuads.end());
+			for(auto &Quad : Layout.m_vQuads)
+			{
+				for(auto &Vertex : Quad.m_aVertices)
+				{
+					Vertex.m_X -= StartDrawX;
+					Vertex.m_Y -= StartDrawY;
+				}
+			}
+			Layout.m_Advance = DrawX - StartDrawX;
+			Layout.m_HasLongestLine = pCursor->m_LongestLineWidth != std::numeric_limits<float>::lowest();
+			Layout.m_LongestLine = pCursor->m_LongestLineWidth + pCursor->m_StartX - StartDrawX;
+			Layout.m_MaxCharacterHeight = pCursor->m_MaxCharacterHeight;
+			Layout.m_GlyphCount = pCursor->m_GlyphCount - StartGlyphCount;
+			Layout.m_CharCount = pCursor->m_CharCount - StartCharCount;
+
+			pCursor->m_LongestLineWidth = maximum(StartLongestLineWidth, pCursor->m_LongestLineWidth);
+			pCursor->m_MaxCharacterHeight = maximum(StartMaxCharacterHeight, pCursor->m_MaxCharacterHeight);
+		}
+
 		if(!TextContainer.m_StringInfo.m_vCharacterQuads.empty() && IsRendered)
 		{
 			// setup the buffers
@@ -1969,6 +2363,28 @@ public:
 		TextContainer.m_BoundingBox = pCursor->BoundingBox();
 	}
 
+	void AddLayoutQuads(STextContainer &TextContainer, const STextLayout &Layout, float DrawX, float DrawY)
+	{
+		STextCharQuadVertexColor Color;
+		Color.r = (unsigned char)(m_Color.r * 255.f);
+		Color.g = (unsigned char)(m_Color.g * 255.f);
+		Color.b = (unsigned char)(m_Color.b * 255.f);
+		Color.a = (unsigned char)(m_Color.a * 255.f);
+
+		std::vector<STextCharQuad> &vQuads = TextContainer.m_StringInfo.m_vCharacterQuads;
+		const size_t StartQuad = vQuads.size();
+		vQuads.insert(vQuads.end(), Layout.m_vQuads.begin(), Layout.m_vQuads.end());
+		for(size_t i = StartQuad; i < vQuads.size(); ++i)
+		{
+			for(auto &Vertex : vQuads[i].m_aVertices)
+			{
+				Vertex.m_X += DrawX;
+				Vertex.m_Y += DrawY;
+				Vertex.m_Color = Color;
+			}
+		}
+	}
+
 	bool CreateOrAppendTextContainer(STextContainerIndex &TextContainerIndex, CTextCursor *pCursor, const char *pText, int Length = -1) override
 	{
 		if(TextContainerIndex.Valid())
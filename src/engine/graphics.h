@@ -320,9 +320,26 @@ public:
 	virtual uint64_t StreamedMemoryUsage() const = 0;
 	virtual uint64_t StagingMemoryUsage() const = 0;
 
+	// what the command buffers of the last frame contained
+	struct CCommandBufferStats
+	{
+		int m_NumBuffers = 0;
+		size_t m_NumCommands = 0;
+		size_t m_NumRenderCalls = 0;
+		size_t m_CommandBytes = 0;
+		size_t m_DataBytes = 0;
+	};
+	virtual const CCommandBufferStats &LastFrameCommandStats() const = 0;
+	// GPU time of the last measured frame in nanoseconds, -1 if there was no
+	// new measurement since the last call or the backend can't measure it
+	virtual int64_t TakeGpuFrameTime() = 0;
+
 	virtual const TTWGraphicsGPUList &GetGPUs() const = 0;
 
 	virtual int LoadPNG(CImageInfo *pImg, const char *pFilename, int StorageType) = 0;
+	// can be called from other threads, the pnglite warning is left to WarnPngliteIncompatible
+	virtual int LoadPNG(CImageInfo *pImg, const char *pFilename, int StorageType, int &PngliteIncompatible) = 0;
+	virtual void WarnPngliteIncompatible(const char *pFilename, int PngliteIncompatible) = 0;
 	virtual void FreePNG(CImageInfo *pImg) = 0;
 
 	virtual bool CheckImageDivisibility(const char *pFileName, CImageInfo &Img, int DivX, int DivY, bool AllowResize) = 0;
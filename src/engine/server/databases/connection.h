@@ -47,6 +47,16 @@ public:
 	// has to be called to return the connection back to the pool
 	virtual void Disconnect() = 0;
 
+	// groups the following queries into one transaction, so that they only
+	// wait for the database once on commit
+	//
+	// returns true on failure
+	virtual bool BeginTransaction(char *pError, int ErrorSize) = 0;
+	// returns true on failure
+	virtual bool CommitTransaction(char *pError, int ErrorSize) = 0;
+	// discards the queries since BeginTransaction
+	virtual void RollbackTransaction() = 0;
+
 	// ? for Placeholders, connection has to be established, can overwrite previous prepared statements
 	//
 	// returns true on failure
@@ -58,6 +68,7 @@ public:
 	virtual void BindInt(int Idx, int Value) = 0;
 	virtual void BindInt64(int Idx, int64_t Value) = 0;
 	virtual void BindFloat(int Idx, float Value) = 0;
+	virtual void BindDouble(int Idx, double Value) = 0;
 
 	// Print expanded sql statement
 	virtual void Print() = 0;
@@ -5,9 +5,11 @@
 #include <cstring>
 #include <engine/console.h>
 
+#include <algorithm>
 #include <chrono>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -117,8 +119,22 @@ CSqlExecData::CSqlExecData(IConsole *pConsole, CDbConnectionPool::Mode m) :
 	m_Ptr.m_Print.m_Mode = m;
 }
 
+void CDbConnectionPool::AddRead(std::unique_ptr<CSqlExecData> pData)
+{
+	{
+		std::lock_guard<std::mutex> Lock(m_pShared->m_ReadLock);
+		m_pShared->m_ReadQueries.push_back(std::move(pData));
+	}
+	m_pShared->m_NumRead.Signal();
+}
+
 void CDbConnectionPool::Print(IConsole *pConsole, Mode DatabaseMode)
 {
+	if(DatabaseMode == Mode::READ)
+	{
+		AddRead(std::make_unique<CSqlExecData>(pConsole, DatabaseMode));
+		return;
+	}
 	m_pShared->m_aQueries[m_InsertIdx++] = std::make_unique<CSqlExecData>(pConsole, DatabaseMode);
 	m_InsertIdx %= std::size(m_pShared->m_aQueries);
 	m_pShared->m_NumBackup.Signal();
@@ -126,6 +142,13 @@ void CDbConnectionPool::Print(IConsole *pConsole, Mode DatabaseMode)
 
 void CDbConnectionPool::RegisterSqliteDatabase(Mode DatabaseMode, const char aFileName[64])
 {
+	if(DatabaseMode == Mode::READ)
+	{
+		// the read workers connect before their next query
+		std::lock_guard<std::mutex> Lock(m_pShared->m_ReadLock);
+		m_pShared->m_vpReadServers.push_back(std::make_unique<CSqlExecData>(DatabaseMode, aFileName));
+		return;
+	}
 	m_pShared->m_aQueries[m_InsertIdx++] = std::make_unique<CSqlExecData>(DatabaseMode, aFileName);
 	m_InsertIdx %= std::size(m_pShared->m_aQueries);
 	m_pShared->m_NumBackup.Signal();
@@ -133,6 +156,12 @@ void CDbConnectionPool::RegisterSqliteDatabase(Mode DatabaseMode, const char aFi
 
 void CDbConnectionPool::RegisterMysqlDatabase(Mode DatabaseMode, const CMysqlConfig *pMysqlConfig)
 {
+	if(DatabaseMode == Mode::READ)
+	{
+		std::lock_guard<std::mutex> Lock(m_pShared->m_ReadLock);
+		m_pShared->m_vpReadServers.push_back(std::make_unique<CSqlExecData>(DatabaseMode, pMysqlConfig));
+		return;
+	}
 	m_pShared->m_aQueries[m_InsertIdx++] = std::make_unique<CSqlExecData>(DatabaseMode, pMysqlConfig);
 	m_InsertIdx %= std::size(m_pShared->m_aQueries);
 	m_pShared->m_NumBackup.Signal();
@@ -143,9 +172,7 @@ void CDbConnectionPool::Execute(
 	std::unique_ptr<const ISqlData> pSqlRequestData,
 	const char *pName)
 {
-	m_pShared->m_aQueries[m_InsertIdx++] = std::make_unique<CSqlExecData>(pFunc, std::move(pSqlRequestData), pName);
-	m_InsertIdx %= std::size(m_pShared->m_aQueries);
-	m_pShared->m_NumBackup.Signal();
+	AddRead(std::make_unique<CSqlExecData>(pFunc, std::move(pSqlRequestData), pName));
 }
 
 void CDbConnectionPool::ExecuteWrite(
@@ -165,8 +192,11 @@ void CDbConnectionPool::OnShutdown()
 	m_Shutdown = true;
 	m_pShared->m_Shutdown.store(true);
 	m_pShared->m_NumBackup.Signal();
+	// an empty query stops a read worker
+	for(size_t i = 0; i < m_vpReadWorkerThreads.size(); i++)
+		AddRead(nullptr);
 	int i = 0;
-	while(m_pShared->m_Shutdown.load())
+	while(m_pShared->m_Shutdown.load() || m_pShared->m_NumReadWorkers.load() > 0)
 	{
 		// print a log about every two seconds
 		if(i % 20 == 0 && i > 0)
@@ -249,6 +279,17 @@ public:
 private:
 	void Print(IConsole *pConsole, CDbConnectionPool::Mode DatabaseMode);
 
+	// waits for the backup worker to be done with the next job and takes it
+	std::unique_ptr<CSqlExecData> TakeJob();
+	// returns whether the backup worker is done with the next job and it is a write
+	bool NextJobIsWrite();
+	// adds the writes queued within the batch latency to the batch
+	void CollectWrites(std::vector<std::unique_ptr<CSqlExecData>> *pvpBatch);
+	void ProcessWrites(const std::vector<std::unique_ptr<CSqlExecData>> &vpBatch, int FirstJobNum, bool *pFailMode);
+
+	// index of the next job in the queue
+	int m_NextJob = 0;
+
 	// There are two possible configurations
 	//  * sqlite mode: There exists exactly one READ and the same WRITE server
 	//                 with no WRITE_BACKUP server
@@ -256,8 +297,8 @@ private:
 	//                most one WRITE server. The WRITE server for all DDNet
 	//                Servers must be the same (to counteract double loads).
 	//                There may be one WRITE_BACKUP sqlite server.
+	// The READ servers are connected by the read workers.
 	// This variable should only change, before the worker threads
-	std::vector<std::unique_ptr<IDbConnection>> m_vpReadConnections;
 	std::unique_ptr<IDbConnection> m_pWriteConnection;
 	std::unique_ptr<IDbConnection> m_pWriteBackup;
 
@@ -274,89 +315,41 @@ void CWorker::Start(void *pUser)
 
 void CWorker::ProcessQueries()
 {
-	// remember last working server and try to connect to it first
-	int ReadServer = 0;
 	// enter fail mode when a sql request fails, skip read request during it and
 	// write to the backup database until all requests are handled
 	bool FailMode = false;
-	for(int JobNum = 0;; JobNum++)
+	for(;;)
 	{
 		if(FailMode && m_pShared->m_NumWorker.GetApproximateValue() == 0)
 		{
 			FailMode = false;
 		}
-		m_pShared->m_NumWorker.Wait();
-		auto pThreadData = std::move(m_pShared->m_aQueries[JobNum % std::size(m_pShared->m_aQueries)]);
+		const int JobNum = m_NextJob;
+		auto pThreadData = TakeJob();
 		// work through all database jobs after OnShutdown is called before exiting the thread
 		if(pThreadData == nullptr)
 		{
 			m_pShared->m_Shutdown.store(false);
 			return;
 		}
-		bool Success = false;
-		switch(pThreadData->m_Mode)
+		if(pThreadData->m_Mode == CSqlExecData::WRITE_ACCESS)
 		{
-		case CSqlExecData::READ_ACCESS:
-		{
-			for(size_t i = 0; i < m_vpReadConnections.size(); i++)
-			{
-				if(m_pShared->m_Shutdown)
-				{
-					dbg_msg("sql", "[%i] %s dismissed read request during shutdown", JobNum, pThreadData->m_pName);
-					break;
-				}
-				if(FailMode)
-				{
-					dbg_msg("sql", "[%i] %s dismissed read request during FailMode", JobNum, pThreadData->m_pName);
-					break;
-				}
-				int CurServer = (ReadServer + i) % (int)m_vpReadConnections.size();
-				if(CDbConnectionPool::ExecSqlFunc(m_vpReadConnections[CurServer].get(), pThreadData.get(), Write::NORMAL))
-				{
-					ReadServer = CurServer;
-					dbg_msg("sql", "[%i] %s done on read database %d", JobNum, pThreadData->m_pName, CurServer);
-					Success = true;
-					break;
-				}
-			}
-			if(!Success)
-			{
-				FailMode = true;
-			}
+			std::vector<std::unique_ptr<CSqlExecData>> vpBatch;
+			vpBatch.push_back(std::move(pThreadData));
+			CollectWrites(&vpBatch);
+			ProcessWrites(vpBatch, JobNum, &FailMode);
+			continue;
 		}
-		break;
-		case CSqlExecData::WRITE_ACCESS:
+		bool Success = false;
+		switch(pThreadData->m_Mode)
 		{
-			if(m_pShared->m_Shutdown && m_pWriteBackup != nullptr)
-			{
-				dbg_msg("sql", "[%i] %s skipped to backup database during shutdown", JobNum, pThreadData->m_pName);
-			}
-			else if(FailMode && m_pWriteBackup != nullptr)
-			{
-				dbg_msg("sql", "[%i] %s skipped to backup database during FailMode", JobNum, pThreadData->m_pName);
-			}
-			else if(CDbConnectionPool::ExecSqlFunc(m_pWriteConnection.get(), pThreadData.get(), Write::NORMAL))
-			{
-				dbg_msg("sql", "[%i] %s done on write database", JobNum, pThreadData->m_pName);
-				Success = true;
-			}
-			// enter fail mode if not successful
-			FailMode = FailMode || !Success;
-			const Write w = Success ? Write::NORMAL_SUCCEEDED : Write::NORMAL_FAILED;
-			if(m_pWriteBackup && CDbConnectionPool::ExecSqlFunc(m_pWriteBackup.get(), pThreadData.get(), w))
-			{
-				dbg_msg("sql", "[%i] %s done move write on backup database to non-backup table", JobNum, pThreadData->m_pName);
-				Success = true;
-			}
-		}
-		break;
 		case CSqlExecData::ADD_MYSQL:
 		{
 			auto pMysql = CreateMysqlConnection(pThreadData->m_Ptr.m_MySql.m_Config);
 			switch(pThreadData->m_Ptr.m_MySql.m_Mode)
 			{
 			case CDbConnectionPool::Mode::READ:
-				m_vpReadConnections.push_back(std::move(pMysql));
+				dbg_assert(false, "read servers are connected by the read workers");
 				break;
 			case CDbConnectionPool::Mode::WRITE:
 				m_pWriteConnection = std::move(pMysql);
@@ -376,7 +369,7 @@ void CWorker::ProcessQueries()
 			switch(pThreadData->m_Ptr.m_Sqlite.m_Mode)
 			{
 			case CDbConnectionPool::Mode::READ:
-				m_vpReadConnections.push_back(std::move(pSqlite));
+				dbg_assert(false, "read servers are connected by the read workers");
 				break;
 			case CDbConnectionPool::Mode::WRITE:
 				m_pWriteConnection = std::move(pSqlite);
@@ -394,6 +387,12 @@ void CWorker::ProcessQueries()
 			Print(pThreadData->m_Ptr.m_Print.m_pConsole, pThreadData->m_Ptr.m_Print.m_Mode);
 			Success = true;
 			break;
+		case CSqlExecData::READ_ACCESS:
+			dbg_assert(false, "read queries are executed by the read workers");
+			break;
+		case CSqlExecData::WRITE_ACCESS:
+			dbg_assert(false, "unreachable");
+			break;
 		}
 		if(!Success)
 			dbg_msg("sql", "[%i] %s failed on all databases", JobNum, pThreadData->m_pName);
@@ -405,16 +404,95 @@ void CWorker::ProcessQueries()
 	}
 }
 
-void CWorker::Print(IConsole *pConsole, CDbConnectionPool::Mode DatabaseMode)
+std::unique_ptr<CSqlExecData> CWorker::TakeJob()
+{
+	m_pShared->m_NumWorker.Wait();
+	return std::move(m_pShared->m_aQueries[m_NextJob++ % std::size(m_pShared->m_aQueries)]);
+}
+
+bool CWorker::NextJobIsWrite()
 {
-	if(DatabaseMode == CDbConnectionPool::Mode::READ)
+	// the backup worker signals after it is done with a job, so the job can
+	// be looked at before taking it
+	if(m_pShared->m_NumWorker.GetApproximateValue() == 0)
+		return false;
+	const CSqlExecData *pNext = m_pShared->m_aQueries[m_NextJob % std::size(m_pShared->m_aQueries)].get();
+	return pNext != nullptr && pNext->m_Mode == CSqlExecData::WRITE_ACCESS;
+}
+
+void CWorker::CollectWrites(std::vector<std::unique_ptr<CSqlExecData>> *pvpBatch)
+{
+	// many finishes on busy servers arrive at once, waiting a bit for them
+	// saves a round trip to the database for each of them
+	const auto Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CDbConnectionPool::WRITE_BATCH_LATENCY_MS);
+	while(pvpBatch->size() < CDbConnectionPool::MAX_WRITE_BATCH)
 	{
-		for(auto &pReadConnection : m_vpReadConnections)
-			pReadConnection->Print(pConsole, "Read");
-		if(m_vpReadConnections.empty())
-			pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", "There are no read databases");
+		if(NextJobIsWrite())
+			pvpBatch->push_back(TakeJob());
+		else if(!m_pShared->m_Shutdown && m_pShared->m_NumWorker.GetApproximateValue() == 0 && std::chrono::steady_clock::now() < Deadline)
+			std::this_thread::sleep_for(1ms);
+		else
+			break;
 	}
-	else if(DatabaseMode == CDbConnectionPool::Mode::WRITE)
+}
+
+void CWorker::ProcessWrites(const std::vector<std::unique_ptr<CSqlExecData>> &vpBatch, int FirstJobNum, bool *pFailMode)
+{
+	const int Num = vpBatch.size();
+	Write aWrites[CDbConnectionPool::MAX_WRITE_BATCH];
+	std::fill_n(aWrites, Num, Write::NORMAL);
+	bool aSuccess[CDbConnectionPool::MAX_WRITE_BATCH] = {};
+	if(m_pShared->m_Shutdown && m_pWriteBackup != nullptr)
+	{
+		dbg_msg("sql", "[%i] %d writes skipped to backup database during shutdown", FirstJobNum, Num);
+	}
+	else if(*pFailMode && m_pWriteBackup != nullptr)
+	{
+		dbg_msg("sql", "[%i] %d writes skipped to backup database during FailMode", FirstJobNum, Num);
+	}
+	else
+	{
+		CDbConnectionPool::ExecSqlBatch(m_pWriteConnection.get(), vpBatch, aWrites, aSuccess);
+	}
+	for(int i = 0; i < Num; i++)
+	{
+		if(aSuccess[i])
+		{
+			dbg_msg("sql", "[%i] %s done on write database", FirstJobNum + i, vpBatch[i]->m_pName);
+			vpBatch[i]->m_pThreadData->OnCommitted();
+		}
+		// enter fail mode if not successful
+		*pFailMode = *pFailMode || !aSuccess[i];
+		aWrites[i] = aSuccess[i] ? Write::NORMAL_SUCCEEDED : Write::NORMAL_FAILED;
+	}
+	if(m_pWriteBackup)
+	{
+		bool aMoved[CDbConnectionPool::MAX_WRITE_BATCH] = {};
+		CDbConnectionPool::ExecSqlBatch(m_pWriteBackup.get(), vpBatch, aWrites, aMoved);
+		for(int i = 0; i < Num; i++)
+		{
+			if(aMoved[i])
+			{
+				dbg_msg("sql", "[%i] %s done move write on backup database to non-backup table", FirstJobNum + i, vpBatch[i]->m_pName);
+				aSuccess[i] = true;
+			}
+		}
+	}
+	for(int i = 0; i < Num; i++)
+	{
+		if(!aSuccess[i])
+			dbg_msg("sql", "[%i] %s failed on all databases", FirstJobNum + i, vpBatch[i]->m_pName);
+		if(vpBatch[i]->m_pThreadData != nullptr && vpBatch[i]->m_pThreadData->m_pResult != nullptr)
+		{
+			vpBatch[i]->m_pThreadData->m_pResult->m_Success = aSuccess[i];
+			vpBatch[i]->m_pThreadData->m_pResult->m_Completed.store(true);
+		}
+	}
+}
+
+void CWorker::Print(IConsole *pConsole, CDbConnectionPool::Mode DatabaseMode)
+{
+	if(DatabaseMode == CDbConnectionPool::Mode::WRITE)
 	{
 		if(m_pWriteConnection)
 			m_pWriteConnection->Print(pConsole, "Write");
@@ -430,6 +508,123 @@ void CWorker::Print(IConsole *pConsole, CDbConnectionPool::Mode DatabaseMode)
 	}
 }
 
+// The read workers execute read queries in parallel, so a slow read doesn't
+// delay the writes or other reads. Each worker has its own connection to
+// every read server.
+class CReadWorker
+{
+public:
+	CReadWorker(std::shared_ptr<CDbConnectionPool::CSharedData> pShared, int WorkerNum) :
+		m_pShared(std::move(pShared)), m_WorkerNum(WorkerNum) {}
+	static void Start(void *pUser);
+	void ProcessQueries();
+
+private:
+	// connects to the read servers registered since the last query
+	void UpdateConnections();
+
+	std::vector<std::unique_ptr<IDbConnection>> m_vpReadConnections;
+
+	std::shared_ptr<CDbConnectionPool::CSharedData> m_pShared;
+	int m_WorkerNum;
+};
+
+/* static */
+void CReadWorker::Start(void *pUser)
+{
+	CReadWorker *pThis = (CReadWorker *)pUser;
+	pThis->ProcessQueries();
+	delete pThis;
+}
+
+void CReadWorker::UpdateConnections()
+{
+	std::lock_guard<std::mutex> Lock(m_pShared->m_ReadLock);
+	while(m_vpReadConnections.size() < m_pShared->m_vpReadServers.size())
+	{
+		const CSqlExecData *pServer = m_pShared->m_vpReadServers[m_vpReadConnections.size()].get();
+		if(pServer->m_Mode == CSqlExecData::ADD_MYSQL)
+			m_vpReadConnections.push_back(CreateMysqlConnection(pServer->m_Ptr.m_MySql.m_Config));
+		else
+			m_vpReadConnections.push_back(CreateSqliteConnection(pServer->m_Ptr.m_Sqlite.m_FileName, true));
+	}
+}
+
+void CReadWorker::ProcessQueries()
+{
+	// remember last working server and try to connect to it first
+	int ReadServer = 0;
+	// enter fail mode when a read request fails on all servers, skip read
+	// requests during it until all queued requests are handled
+	bool FailMode = false;
+	for(int JobNum = 0;; JobNum++)
+	{
+		if(FailMode && m_pShared->m_NumRead.GetApproximateValue() == 0)
+		{
+			FailMode = false;
+		}
+		m_pShared->m_NumRead.Wait();
+		std::unique_ptr<CSqlExecData> pThreadData;
+		{
+			std::lock_guard<std::mutex> Lock(m_pShared->m_ReadLock);
+			pThreadData = std::move(m_pShared->m_ReadQueries.front());
+			m_pShared->m_ReadQueries.pop_front();
+		}
+		// work through all read jobs queued before OnShutdown before exiting the thread
+		if(pThreadData == nullptr)
+		{
+			m_pShared->m_NumReadWorkers.fetch_sub(1);
+			return;
+		}
+		UpdateConnections();
+
+		bool Success = false;
+		if(pThreadData->m_Mode == CSqlExecData::PRINT)
+		{
+			IConsole *pConsole = pThreadData->m_Ptr.m_Print.m_pConsole;
+			for(auto &pReadConnection : m_vpReadConnections)
+				pReadConnection->Print(pConsole, "Read");
+			if(m_vpReadConnections.empty())
+				pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", "There are no read databases");
+			Success = true;
+		}
+		else
+		{
+			for(size_t i = 0; i < m_vpReadConnections.size(); i++)
+			{
+				if(m_pShared->m_Shutdown)
+				{
+					dbg_msg("sql", "[%i:%i] %s dismissed read request during shutdown", m_WorkerNum, JobNum, pThreadData->m_pName);
+					break;
+				}
+				if(FailMode)
+				{
+					dbg_msg("sql", "[%i:%i] %s dismissed read request during FailMode", m_WorkerNum, JobNum, pThreadData->m_pName);
+					break;
+				}
+				int CurServer = (ReadServer + i) % (int)m_vpReadConnections.size();
+				if(CDbConnectionPool::ExecSqlFunc(m_vpReadConnections[CurServer].get(), pThreadData.get(), Write::NORMAL))
+				{
+					ReadServer = CurServer;
+					dbg_msg("sql", "[%i:%i] %s done on read database %d", m_WorkerNum, JobNum, pThreadData->m_pName, CurServer);
+					Success = true;
+					break;
+				}
+			}
+			if(!Success)
+			{
+				FailMode = true;
+				dbg_msg("sql", "[%i:%i] %s failed on all databases", m_WorkerNum, JobNum, pThreadData->m_pName);
+			}
+		}
+		if(pThreadData->m_pThreadData != nullptr && pThreadData->m_pThreadData->m_pResult != nullptr)
+		{
+			pThreadData->m_pThreadData->m_pResult->m_Success = Success;
+			pThreadData->m_pThreadData->m_pResult->m_Completed.store(true);
+		}
+	}
+}
+
 /* static */
 bool CDbConnectionPool::ExecSqlFunc(IDbConnection *pConnection, CSqlExecData *pData, Write w)
 {
@@ -464,11 +659,55 @@ bool CDbConnectionPool::ExecSqlFunc(IDbConnection *pConnection, CSqlExecData *pD
 	return Success;
 }
 
+/* static */
+void CDbConnectionPool::ExecSqlBatch(IDbConnection *pConnection, const std::vector<std::unique_ptr<CSqlExecData>> &vpData, const Write *pWrites, bool *pSuccess)
+{
+	if(pConnection == nullptr || vpData.size() == 1)
+	{
+		for(size_t i = 0; i < vpData.size(); i++)
+			pSuccess[i] = ExecSqlFunc(pConnection, vpData[i].get(), pWrites[i]);
+		return;
+	}
+	char aError[256] = "unknown error";
+	if(pConnection->Connect(aError, sizeof(aError)))
+	{
+		dbg_msg("sql", "failed connecting to db: %s", aError);
+		std::fill_n(pSuccess, vpData.size(), false);
+		return;
+	}
+	bool Failed = pConnection->BeginTransaction(aError, sizeof(aError));
+	for(size_t i = 0; i < vpData.size() && !Failed; i++)
+	{
+		dbg_assert(vpData[i]->m_Mode == CSqlExecData::WRITE_ACCESS, "only writes are batched");
+		Failed = vpData[i]->m_Ptr.m_pWriteFunc(pConnection, vpData[i]->m_pThreadData.get(), pWrites[i], aError, sizeof(aError));
+	}
+	if(!Failed)
+		Failed = pConnection->CommitTransaction(aError, sizeof(aError));
+	if(Failed)
+		pConnection->RollbackTransaction();
+	pConnection->Disconnect();
+	if(!Failed)
+	{
+		std::fill_n(pSuccess, vpData.size(), true);
+		return;
+	}
+
+	// a single failing write shouldn't take the others with it
+	dbg_msg("sql", "batch of %d writes failed: %s, executing them one by one", (int)vpData.size(), aError);
+	for(size_t i = 0; i < vpData.size(); i++)
+		pSuccess[i] = ExecSqlFunc(pConnection, vpData[i].get(), pWrites[i]);
+}
+
 CDbConnectionPool::CDbConnectionPool()
 {
 	m_pShared = std::make_shared<CSharedData>();
 	m_pWorkerThread = thread_init(CWorker::Start, new CWorker(m_pShared), "database worker thread");
 	m_pBackupThread = thread_init(CBackup::Start, new CBackup(m_pShared), "database backup worker thread");
+	for(int i = 0; i < NUM_READ_WORKERS; i++)
+	{
+		m_pShared->m_NumReadWorkers.fetch_add(1);
+		m_vpReadWorkerThreads.push_back(thread_init(CReadWorker::Start, new CReadWorker(m_pShared, i), "database read worker thread"));
+	}
 }
 
 CDbConnectionPool::~CDbConnectionPool()
@@ -478,4 +717,6 @@ CDbConnectionPool::~CDbConnectionPool()
 		thread_wait(m_pWorkerThread);
 	if(m_pBackupThread)
 		thread_wait(m_pBackupThread);
+	for(void *pThread : m_vpReadWorkerThreads)
+		thread_wait(pThread);
 }
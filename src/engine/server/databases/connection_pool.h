@@ -3,7 +3,9 @@
 
 #include <atomic>
 #include <base/tl/threading.h>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class IDbConnection;
@@ -28,6 +30,10 @@ struct ISqlData
 	}
 	virtual ~ISqlData() = default;
 
+	// called by the write worker once the write is committed on the write
+	// database, before that other connections still see the old data
+	virtual void OnCommitted() const {}
+
 	mutable std::shared_ptr<ISqlResult> m_pResult;
 };
 
@@ -76,17 +82,30 @@ public:
 		NUM_MODES,
 	};
 
+	enum
+	{
+		// threads executing read queries, each with its own connections
+		NUM_READ_WORKERS = 4,
+		// queued writes executed in one transaction on the write server
+		MAX_WRITE_BATCH = 16,
+		// how long the first write of a batch waits for more writes
+		WRITE_BATCH_LATENCY_MS = 10,
+	};
+
 	void Print(IConsole *pConsole, Mode DatabaseMode);
 
 	void RegisterSqliteDatabase(Mode DatabaseMode, const char FileName[64]);
 	void RegisterMysqlDatabase(Mode DatabaseMode, const CMysqlConfig *pMysqlConfig);
 
+	// read queries run in parallel on the read workers, they don't wait
+	// for queued writes
 	void Execute(
 		FRead pFunc,
 		std::unique_ptr<const ISqlData> pSqlRequestData,
 		const char *pName);
 	// writes to WRITE_BACKUP first and removes it from there when successfully
-	// executed on WRITE server
+	// executed on WRITE server. Writes queued close to each other share one
+	// transaction
 	void ExecuteWrite(
 		FWrite pFunc,
 		std::unique_ptr<const ISqlData> pSqlRequestData,
@@ -96,9 +115,13 @@ public:
 
 	friend class CWorker;
 	friend class CBackup;
+	friend class CReadWorker;
 
 private:
 	static bool ExecSqlFunc(IDbConnection *pConnection, struct CSqlExecData *pData, Write w);
+	// executes the writes in one transaction, falls back to executing them
+	// one by one if the transaction fails
+	static void ExecSqlBatch(IDbConnection *pConnection, const std::vector<std::unique_ptr<struct CSqlExecData>> &vpData, const Write *pWrites, bool *pSuccess);
 
 	// Only the main thread accesses this variable. It points to the index,
 	// where the next query is added to the queue.
@@ -123,11 +146,24 @@ private:
 
 		// spsc queue with additional backup worker to look at queries first.
 		std::unique_ptr<struct CSqlExecData> m_aQueries[512];
+
+		// Read queries and read server prints, taken by any read worker.
+		std::mutex m_ReadLock;
+		std::deque<std::unique_ptr<struct CSqlExecData>> m_ReadQueries;
+		// Registered read servers, every read worker connects to each of
+		// them on its own. Entries are only appended.
+		std::vector<std::unique_ptr<struct CSqlExecData>> m_vpReadServers;
+		CSemaphore m_NumRead;
+		// read workers that haven't exited yet
+		std::atomic_int m_NumReadWorkers{0};
 	};
 
+	void AddRead(std::unique_ptr<struct CSqlExecData> pData);
+
 	std::shared_ptr<CSharedData> m_pShared;
 	void *m_pWorkerThread = nullptr;
 	void *m_pBackupThread = nullptr;
+	std::vector<void *> m_vpReadWorkerThreads;
 };
 
 #endif // ENGINE_SERVER_DATABASES_CONNECTION_POOL_H
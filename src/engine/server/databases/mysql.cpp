@@ -9,7 +9,10 @@
 #include <engine/console.h>
 
 #include <atomic>
+#include <list>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 // MySQL >= 8.0.1 removed my_bool, 8.0.2 accidentally reintroduced it: https://bugs.mysql.com/bug.php?id=87337
@@ -82,6 +85,10 @@ public:
 	bool Connect(char *pError, int ErrorSize) override;
 	void Disconnect() override;
 
+	bool BeginTransaction(char *pError, int ErrorSize) override;
+	bool CommitTransaction(char *pError, int ErrorSize) override;
+	void RollbackTransaction() override;
+
 	bool PrepareStatement(const char *pStmt, char *pError, int ErrorSize) override;
 
 	void BindString(int Idx, const char *pString) override;
@@ -89,6 +96,7 @@ public:
 	void BindInt(int Idx, int Value) override;
 	void BindInt64(int Idx, int64_t Value) override;
 	void BindFloat(int Idx, float Value) override;
+	void BindDouble(int Idx, double Value) override;
 
 	void Print() override {}
 	bool Step(bool *pEnd, char *pError, int ErrorSize) override;
@@ -114,6 +122,9 @@ private:
 	void StoreErrorMysql(const char *pContext);
 	void StoreErrorStmt(const char *pContext);
 	bool ConnectImpl();
+	// selects the cached statement of the query or prepares it
+	bool PrepareCachedStatement(const char *pStmt);
+	void ClearStatementCache();
 	bool PrepareAndExecuteStatement(const char *pStmt);
 	//static void DeleteResult(MYSQL_RES *pResult);
 
@@ -122,12 +133,24 @@ private:
 		int i;
 		unsigned long ul;
 		float f;
+		double d;
+	};
+
+	enum
+	{
+		// the least recently used statements are closed beyond this
+		MAX_CACHED_STATEMENTS = 64,
 	};
 
 	bool m_NewQuery = false;
 	bool m_HaveConnection = false;
 	MYSQL m_Mysql;
-	std::unique_ptr<MYSQL_STMT, CStmtDeleter> m_pStmt = nullptr;
+	// the current statement, owned by the statement cache
+	MYSQL_STMT *m_pStmt = nullptr;
+	// prepared statements by query, most recently used first. They are
+	// reused as the same queries are executed again and again
+	std::list<std::pair<std::string, std::unique_ptr<MYSQL_STMT, CStmtDeleter>>> m_StmtCache;
+	std::unordered_map<std::string, std::list<std::pair<std::string, std::unique_ptr<MYSQL_STMT, CStmtDeleter>>>::iterator> m_StmtIndex;
 	std::vector<MYSQL_BIND> m_vStmtParameters;
 	std::vector<UParameterExtra> m_vStmtParameterExtras;
 
@@ -157,6 +180,7 @@ CMysqlConnection::CMysqlConnection(CMysqlConfig Config) :
 
 CMysqlConnection::~CMysqlConnection()
 {
+	ClearStatementCache();
 	mysql_close(&m_Mysql);
 	g_MysqlNumConnections -= 1;
 }
@@ -168,19 +192,67 @@ void CMysqlConnection::StoreErrorMysql(const char *pContext)
 
 void CMysqlConnection::StoreErrorStmt(const char *pContext)
 {
-	str_format(m_aErrorDetail, sizeof(m_aErrorDetail), "(%s:stmt:%d): %s", pContext, mysql_stmt_errno(m_pStmt.get()), mysql_stmt_error(m_pStmt.get()));
+	str_format(m_aErrorDetail, sizeof(m_aErrorDetail), "(%s:stmt:%d): %s", pContext, mysql_stmt_errno(m_pStmt), mysql_stmt_error(m_pStmt));
 }
 
-bool CMysqlConnection::PrepareAndExecuteStatement(const char *pStmt)
+bool CMysqlConnection::PrepareCachedStatement(const char *pStmt)
 {
-	if(mysql_stmt_prepare(m_pStmt.get(), pStmt, str_length(pStmt)))
+	// the rows of the last query have to be read before another one can be executed
+	if(m_pStmt && mysql_stmt_free_result(m_pStmt))
+	{
+		StoreErrorStmt("free_result");
+		dbg_msg("mysql", "can't free last result %s", m_aErrorDetail);
+	}
+	m_pStmt = nullptr;
+
+	auto Cached = m_StmtIndex.find(pStmt);
+	if(Cached != m_StmtIndex.end())
+	{
+		m_StmtCache.splice(m_StmtCache.begin(), m_StmtCache, Cached->second);
+		m_pStmt = Cached->second->second.get();
+		return false;
+	}
+
+	if(m_StmtCache.size() >= MAX_CACHED_STATEMENTS)
+	{
+		m_StmtIndex.erase(m_StmtCache.back().first);
+		m_StmtCache.pop_back();
+	}
+	std::unique_ptr<MYSQL_STMT, CStmtDeleter> pPrepared(mysql_stmt_init(&m_Mysql));
+	if(!pPrepared)
+	{
+		StoreErrorMysql("stmt_init");
+		return true;
+	}
+	m_pStmt = pPrepared.get();
+	if(mysql_stmt_prepare(m_pStmt, pStmt, str_length(pStmt)))
 	{
 		StoreErrorStmt("prepare");
+		m_pStmt = nullptr;
 		return true;
 	}
-	if(mysql_stmt_execute(m_pStmt.get()))
+	m_StmtCache.emplace_front(pStmt, std::move(pPrepared));
+	m_StmtIndex.emplace(pStmt, m_StmtCache.begin());
+	return false;
+}
+
+void CMysqlConnection::ClearStatementCache()
+{
+	m_pStmt = nullptr;
+	m_StmtIndex.clear();
+	m_StmtCache.clear();
+}
+
+bool CMysqlConnection::PrepareAndExecuteStatement(const char *pStmt)
+{
+	if(PrepareCachedStatement(pStmt))
+	{
+		return true;
+	}
+	if(mysql_stmt_execute(m_pStmt))
 	{
 		StoreErrorStmt("execute");
+		ClearStatementCache();
 		return true;
 	}
 	return false;
@@ -221,7 +293,7 @@ bool CMysqlConnection::ConnectImpl()
 {
 	if(m_HaveConnection)
 	{
-		if(m_pStmt && mysql_stmt_free_result(m_pStmt.get()))
+		if(m_pStmt && mysql_stmt_free_result(m_pStmt))
 		{
 			StoreErrorStmt("free_result");
 			dbg_msg("mysql", "can't free last result %s", m_aErrorDetail);
@@ -233,12 +305,13 @@ bool CMysqlConnection::ConnectImpl()
 		}
 		StoreErrorMysql("select_db");
 		dbg_msg("mysql", "ping error, trying to reconnect %s", m_aErrorDetail);
+		ClearStatementCache();
 		mysql_close(&m_Mysql);
 		mem_zero(&m_Mysql, sizeof(m_Mysql));
 		mysql_init(&m_Mysql);
 	}
 
-	m_pStmt = nullptr;
+	ClearStatementCache();
 	unsigned int OptConnectTimeout = 60;
 	unsigned int OptReadTimeout = 60;
 	unsigned int OptWriteTimeout = 120;
@@ -260,8 +333,6 @@ bool CMysqlConnection::ConnectImpl()
 	}
 	m_HaveConnection = true;
 
-	m_pStmt = std::unique_ptr<MYSQL_STMT, CStmtDeleter>(mysql_stmt_init(&m_Mysql));
-
 	// Apparently MYSQL_SET_CHARSET_NAME is not enough
 	if(PrepareAndExecuteStatement("SET CHARACTER SET utf8mb4"))
 	{
@@ -318,16 +389,58 @@ void CMysqlConnection::Disconnect()
 	m_InUse.store(false);
 }
 
+bool CMysqlConnection::BeginTransaction(char *pError, int ErrorSize)
+{
+	if(mysql_query(&m_Mysql, "START TRANSACTION"))
+	{
+		StoreErrorMysql("start_transaction");
+		str_copy(pError, m_aErrorDetail, ErrorSize);
+		return true;
+	}
+	return false;
+}
+
+bool CMysqlConnection::CommitTransaction(char *pError, int ErrorSize)
+{
+	// unread rows of the last statement would block the connection
+	if(m_pStmt && mysql_stmt_free_result(m_pStmt))
+	{
+		StoreErrorStmt("free_result");
+		str_copy(pError, m_aErrorDetail, ErrorSize);
+		return true;
+	}
+	if(mysql_commit(&m_Mysql))
+	{
+		StoreErrorMysql("commit");
+		str_copy(pError, m_aErrorDetail, ErrorSize);
+		return true;
+	}
+	return false;
+}
+
+void CMysqlConnection::RollbackTransaction()
+{
+	if(m_pStmt && mysql_stmt_free_result(m_pStmt))
+	{
+		StoreErrorStmt("free_result");
+		dbg_msg("mysql", "can't free last result %s", m_aErrorDetail);
+	}
+	if(mysql_rollback(&m_Mysql))
+	{
+		StoreErrorMysql("rollback");
+		dbg_msg("mysql", "failed rolling back transaction %s", m_aErrorDetail);
+	}
+}
+
 bool CMysqlConnection::PrepareStatement(const char *pStmt, char *pError, int ErrorSize)
 {
-	if(mysql_stmt_prepare(m_pStmt.get(), pStmt, str_length(pStmt)))
+	if(PrepareCachedStatement(pStmt))
 	{
-		StoreErrorStmt("prepare");
 		str_copy(pError, m_aErrorDetail, ErrorSize);
 		return true;
 	}
 	m_NewQuery = true;
-	unsigned NumParameters = mysql_stmt_param_count(m_pStmt.get());
+	unsigned NumParameters = mysql_stmt_param_count(m_pStmt);
 	m_vStmtParameters.resize(NumParameters);
 	m_vStmtParameterExtras.resize(NumParameters);
 	mem_zero(&m_vStmtParameters[0], sizeof(m_vStmtParameters[0]) * m_vStmtParameters.size());
@@ -421,25 +534,44 @@ void CMysqlConnection::BindFloat(int Idx, float Value)
 	pParam->error = nullptr;
 }
 
+void CMysqlConnection::BindDouble(int Idx, double Value)
+{
+	m_NewQuery = true;
+	Idx -= 1;
+	dbg_assert(0 <= Idx && Idx < (int)m_vStmtParameters.size(), "index out of bounds");
+
+	m_vStmtParameterExtras[Idx].d = Value;
+	MYSQL_BIND *pParam = &m_vStmtParameters[Idx];
+	pParam->buffer_type = MYSQL_TYPE_DOUBLE;
+	pParam->buffer = &m_vStmtParameterExtras[Idx].d;
+	pParam->buffer_length = sizeof(m_vStmtParameterExtras[Idx].d);
+	pParam->length = nullptr;
+	pParam->is_null = nullptr;
+	pParam->is_unsigned = false;
+	pParam->error = nullptr;
+}
+
 bool CMysqlConnection::Step(bool *pEnd, char *pError, int ErrorSize)
 {
 	if(m_NewQuery)
 	{
 		m_NewQuery = false;
-		if(mysql_stmt_bind_param(m_pStmt.get(), &m_vStmtParameters[0]))
+		if(mysql_stmt_bind_param(m_pStmt, &m_vStmtParameters[0]))
 		{
 			StoreErrorStmt("bind_param");
 			str_copy(pError, m_aErrorDetail, ErrorSize);
 			return true;
 		}
-		if(mysql_stmt_execute(m_pStmt.get()))
+		if(mysql_stmt_execute(m_pStmt))
 		{
 			StoreErrorStmt("execute");
 			str_copy(pError, m_aErrorDetail, ErrorSize);
+			// the statements are gone if the connection was reestablished
+			ClearStatementCache();
 			return true;
 		}
 	}
-	int Result = mysql_stmt_fetch(m_pStmt.get());
+	int Result = mysql_stmt_fetch(m_pStmt);
 	if(Result == 1)
 	{
 		StoreErrorStmt("fetch");
@@ -457,19 +589,21 @@ bool CMysqlConnection::ExecuteUpdate(int *pNumUpdated, char *pError, int ErrorSi
 	if(m_NewQuery)
 	{
 		m_NewQuery = false;
-		if(mysql_stmt_bind_param(m_pStmt.get(), &m_vStmtParameters[0]))
+		if(mysql_stmt_bind_param(m_pStmt, &m_vStmtParameters[0]))
 		{
 			StoreErrorStmt("bind_param");
 			str_copy(pError, m_aErrorDetail, ErrorSize);
 			return true;
 		}
-		if(mysql_stmt_execute(m_pStmt.get()))
+		if(mysql_stmt_execute(m_pStmt))
 		{
 			StoreErrorStmt("execute");
 			str_copy(pError, m_aErrorDetail, ErrorSize);
+			// the statements are gone if the connection was reestablished
+			ClearStatementCache();
 			return true;
 		}
-		*pNumUpdated = mysql_stmt_affected_rows(m_pStmt.get());
+		*pNumUpdated = mysql_stmt_affected_rows(m_pStmt);
 		return false;
 	}
 	str_copy(pError, "tried to execute update without query", ErrorSize);
@@ -490,7 +624,7 @@ bool CMysqlConnection::IsNull(int Col)
 	Bind.is_null = &IsNull;
 	Bind.is_unsigned = false;
 	Bind.error = nullptr;
-	if(mysql_stmt_fetch_column(m_pStmt.get(), &Bind, Col, 0))
+	if(mysql_stmt_fetch_column(m_pStmt, &Bind, Col, 0))
 	{
 		StoreErrorStmt("fetch_column:null");
 		dbg_msg("mysql", "error fetching column %s", m_aErrorDetail);
@@ -514,7 +648,7 @@ float CMysqlConnection::GetFloat(int Col)
 	Bind.is_null = &IsNull;
 	Bind.is_unsigned = false;
 	Bind.error = nullptr;
-	if(mysql_stmt_fetch_column(m_pStmt.get(), &Bind, Col, 0))
+	if(mysql_stmt_fetch_column(m_pStmt, &Bind, Col, 0))
 	{
 		StoreErrorStmt("fetch_column:float");
 		dbg_msg("mysql", "error fetching column %s", m_aErrorDetail);
@@ -542,7 +676,7 @@ int CMysqlConnection::GetInt(int Col)
 	Bind.is_null = &IsNull;
 	Bind.is_unsigned = false;
 	Bind.error = nullptr;
-	if(mysql_stmt_fetch_column(m_pStmt.get(), &Bind, Col, 0))
+	if(mysql_stmt_fetch_column(m_pStmt, &Bind, Col, 0))
 	{
 		StoreErrorStmt("fetch_column:int");
 		dbg_msg("mysql", "error fetching column %s", m_aErrorDetail);
@@ -570,7 +704,7 @@ int64_t CMysqlConnection::GetInt64(int Col)
 	Bind.is_null = &IsNull;
 	Bind.is_unsigned = false;
 	Bind.error = nullptr;
-	if(mysql_stmt_fetch_column(m_pStmt.get(), &Bind, Col, 0))
+	if(mysql_stmt_fetch_column(m_pStmt, &Bind, Col, 0))
 	{
 		StoreErrorStmt("fetch_column:int64");
 		dbg_msg("mysql", "error fetching column %s", m_aErrorDetail);
@@ -605,7 +739,7 @@ void CMysqlConnection::GetString(int Col, char *pBuffer, int BufferSize)
 	Bind.is_null = &IsNull;
 	Bind.is_unsigned = false;
 	Bind.error = &Error;
-	if(mysql_stmt_fetch_column(m_pStmt.get(), &Bind, Col, 0))
+	if(mysql_stmt_fetch_column(m_pStmt, &Bind, Col, 0))
 	{
 		StoreErrorStmt("fetch_column:string");
 		dbg_msg("mysql", "error fetching column %s", m_aErrorDetail);
@@ -637,7 +771,7 @@ int CMysqlConnection::GetBlob(int Col, unsigned char *pBuffer, int BufferSize)
 	Bind.is_null = &IsNull;
 	Bind.is_unsigned = false;
 	Bind.error = &Error;
-	if(mysql_stmt_fetch_column(m_pStmt.get(), &Bind, Col, 0))
+	if(mysql_stmt_fetch_column(m_pStmt, &Bind, Col, 0))
 	{
 		StoreErrorStmt("fetch_column:blob");
 		dbg_msg("mysql", "error fetching column %s", m_aErrorDetail);
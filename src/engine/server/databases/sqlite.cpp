@@ -6,6 +6,10 @@
 #include <engine/console.h>
 
 #include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 class CSqliteConnection : public IDbConnection
 {
@@ -30,6 +34,10 @@ public:
 	bool Connect(char *pError, int ErrorSize) override;
 	void Disconnect() override;
 
+	bool BeginTransaction(char *pError, int ErrorSize) override;
+	bool CommitTransaction(char *pError, int ErrorSize) override;
+	void RollbackTransaction() override;
+
 	bool PrepareStatement(const char *pStmt, char *pError, int ErrorSize) override;
 
 	void BindString(int Idx, const char *pString) override;
@@ -37,6 +45,7 @@ public:
 	void BindInt(int Idx, int Value) override;
 	void BindInt64(int Idx, int64_t Value) override;
 	void BindFloat(int Idx, float Value) override;
+	void BindDouble(int Idx, double Value) override;
 
 	void Print() override;
 	bool Step(bool *pEnd, char *pError, int ErrorSize) override;
@@ -60,14 +69,29 @@ private:
 	char m_aFilename[IO_MAX_PATH_LENGTH];
 	bool m_Setup;
 
+	enum
+	{
+		// the least recently used statements are finalized beyond this
+		MAX_CACHED_STATEMENTS = 64,
+	};
+
 	sqlite3 *m_pDb;
+	// the current statement, owned by the statement cache
 	sqlite3_stmt *m_pStmt;
+	// prepared statements by query, most recently used first. They are
+	// reused as the same queries are executed again and again
+	std::list<std::pair<std::string, sqlite3_stmt *>> m_StmtCache;
+	std::unordered_map<std::string, std::list<std::pair<std::string, sqlite3_stmt *>>::iterator> m_StmtIndex;
 	bool m_Done; // no more rows available for Step
 	// returns false, if the query succeeded
 	bool Execute(const char *pQuery, char *pError, int ErrorSize);
 	// returns true on failure
 	bool ConnectImpl(char *pError, int ErrorSize);
 
+	// makes the current statement available for the next query
+	void ResetStatement();
+	void ClearStatementCache();
+
 	// returns true if an error was formatted
 	bool FormatError(int Result, char *pError, int ErrorSize);
 	void AssertNoError(int Result);
@@ -88,12 +112,30 @@ CSqliteConnection::CSqliteConnection(const char *pFilename, bool Setup) :
 
 CSqliteConnection::~CSqliteConnection()
 {
-	if(m_pStmt != nullptr)
-		sqlite3_finalize(m_pStmt);
+	ClearStatementCache();
 	sqlite3_close(m_pDb);
 	m_pDb = nullptr;
 }
 
+void CSqliteConnection::ResetStatement()
+{
+	if(m_pStmt == nullptr)
+		return;
+	// releases the locks of the statement, the bound values may point to freed buffers
+	sqlite3_reset(m_pStmt);
+	sqlite3_clear_bindings(m_pStmt);
+	m_pStmt = nullptr;
+}
+
+void CSqliteConnection::ClearStatementCache()
+{
+	m_pStmt = nullptr;
+	for(auto &[Query, pStmt] : m_StmtCache)
+		sqlite3_finalize(pStmt);
+	m_StmtIndex.clear();
+	m_StmtCache.clear();
+}
+
 void CSqliteConnection::Print(IConsole *pConsole, const char *pMode)
 {
 	char aBuf[512];
@@ -146,6 +188,10 @@ bool CSqliteConnection::ConnectImpl(char *pError, int ErrorSize)
 
 	if(m_Setup)
 	{
+		// the read workers connect at the same time, switching the journal
+		// mode concurrently fails without waiting for the busy timeout
+		static std::mutex s_SetupLock;
+		std::lock_guard<std::mutex> SetupLock(s_SetupLock);
 		if(Execute("PRAGMA journal_mode=WAL", pError, ErrorSize))
 			return true;
 		char aBuf[1024];
@@ -181,27 +227,64 @@ bool CSqliteConnection::ConnectImpl(char *pError, int ErrorSize)
 
 void CSqliteConnection::Disconnect()
 {
-	if(m_pStmt != nullptr)
-		sqlite3_finalize(m_pStmt);
-	m_pStmt = nullptr;
+	ResetStatement();
 	m_InUse.store(false);
 }
 
+bool CSqliteConnection::BeginTransaction(char *pError, int ErrorSize)
+{
+	// take the write lock right away, a deferred transaction can't wait for
+	// it when it has to upgrade from reading
+	return Execute("BEGIN IMMEDIATE", pError, ErrorSize);
+}
+
+bool CSqliteConnection::CommitTransaction(char *pError, int ErrorSize)
+{
+	ResetStatement();
+	return Execute("COMMIT", pError, ErrorSize);
+}
+
+void CSqliteConnection::RollbackTransaction()
+{
+	ResetStatement();
+	char aError[256];
+	if(Execute("ROLLBACK", aError, sizeof(aError)))
+		dbg_msg("sql", "failed rolling back transaction: %s", aError);
+}
+
 bool CSqliteConnection::PrepareStatement(const char *pStmt, char *pError, int ErrorSize)
 {
-	if(m_pStmt != nullptr)
-		sqlite3_finalize(m_pStmt);
-	m_pStmt = nullptr;
+	ResetStatement();
+	auto Cached = m_StmtIndex.find(pStmt);
+	if(Cached != m_StmtIndex.end())
+	{
+		m_StmtCache.splice(m_StmtCache.begin(), m_StmtCache, Cached->second);
+		m_pStmt = Cached->second->second;
+		m_Done = false;
+		return false;
+	}
+
+	sqlite3_stmt *pPrepared = nullptr;
 	int Result = sqlite3_prepare_v2(
 		m_pDb,
 		pStmt,
 		-1, // pStmt can be any length
-		&m_pStmt,
+		&pPrepared,
 		NULL);
 	if(FormatError(Result, pError, ErrorSize))
 	{
+		sqlite3_finalize(pPrepared);
 		return true;
 	}
+	if(m_StmtCache.size() >= MAX_CACHED_STATEMENTS)
+	{
+		sqlite3_finalize(m_StmtCache.back().second);
+		m_StmtIndex.erase(m_StmtCache.back().first);
+		m_StmtCache.pop_back();
+	}
+	m_StmtCache.emplace_front(pStmt, pPrepared);
+	m_StmtIndex.emplace(pStmt, m_StmtCache.begin());
+	m_pStmt = pPrepared;
 	m_Done = false;
 	return false;
 }
@@ -241,6 +324,13 @@ void CSqliteConnection::BindFloat(int Idx, float Value)
 	m_Done = false;
 }
 
+void CSqliteConnection::BindDouble(int Idx, double Value)
+{
+	int Result = sqlite3_bind_double(m_pStmt, Idx, Value);
+	AssertNoError(Result);
+	m_Done = false;
+}
+
 // Keep support for SQLite < 3.14 on older Linux distributions. MinGW does not
 // support __attribute__((weak)): https://sourceware.org/bugzilla/show_bug.cgi?id=9687
 #if defined(__GNUC__) && !defined(__MINGW32__)
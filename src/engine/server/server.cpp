@@ -324,6 +324,23 @@ CServer::CServer()
 	m_CurrentGameTick = MIN_TICK;
 	m_RunServer = UNINITIALIZED;
 
+	m_NumSnapshotWorkers = 0;
+	sphore_init(&m_SnapshotWorkersDone);
+
+	mem_zero(&m_NetStatsStart, sizeof(m_NetStatsStart));
+	m_NetStatsStartTick = 0;
+
+	// a game tick taking longer than its period delays the following ones
+	m_aProfileZones[PROFILE_TICK] = m_Profiler.RegisterZone("tick", 1000000000 / SERVER_TICK_SPEED);
+	m_aProfileZones[PROFILE_INPUT] = m_Profiler.RegisterZone("input");
+	m_aProfileZones[PROFILE_GAME_TICK] = m_Profiler.RegisterZone("game_tick");
+	m_aProfileZones[PROFILE_SNAPSHOT] = m_Profiler.RegisterZone("snapshot");
+	m_aProfileZones[PROFILE_SNAPSHOT_DELTAS] = m_Profiler.RegisterZone("snapshot_deltas");
+	m_aProfileZones[PROFILE_REGISTER] = m_Profiler.RegisterZone("register");
+	m_aProfileZones[PROFILE_ANTIBOT] = m_Profiler.RegisterZone("antibot");
+	m_aProfileZones[PROFILE_NETWORK] = m_Profiler.RegisterZone("network");
+	m_aProfileZones[PROFILE_NET_FLUSH] = m_Profiler.RegisterZone("net_flush");
+
 	m_aShutdownReason[0] = 0;
 
 	for(int i = 0; i < NUM_MAP_TYPES; i++)
@@ -373,6 +390,8 @@ CServer::~CServer()
 
 	delete m_pRegister;
 	delete m_pConnectionPool;
+
+	sphore_destroy(&m_SnapshotWorkersDone);
 }
 
 bool CServer::IsClientNameAvailable(int ClientID, const char *pNameRequest)
@@ -937,6 +956,10 @@ void CServer::DoSnapshot()
 	// create snapshots for all clients
 	for(int i = 0; i < MaxClients(); i++)
 	{
+		// with snapshot workers, every client has its own output slot
+		CClientSnapshot *pSnapshot = &m_pClientSnapshots[m_NumSnapshotWorkers ? i : 0];
+		pSnapshot->m_Size = -1;
+
 		// client must be ingame to receive snapshots
 		if(m_aClients[i].m_State != CClient::STATE_INGAME)
 			continue;
@@ -955,95 +978,167 @@ void CServer::DoSnapshot()
 			GameServer()->OnSnap(i);
 
 			// finish snapshot
-			char aData[CSnapshot::MAX_SIZE];
-			CSnapshot *pData = (CSnapshot *)aData; // Fix compiler warning for strict-aliasing
-			int SnapshotSize = m_SnapshotBuilder.Finish(pData);
+			pSnapshot->m_Size = m_SnapshotBuilder.Finish(pSnapshot->m_aData);
 
 			if(m_aDemoRecorder[i].IsRecording())
 			{
 				// write snapshot
-				m_aDemoRecorder[i].RecordSnapshot(Tick(), aData, SnapshotSize);
+				m_aDemoRecorder[i].RecordSnapshot(Tick(), pSnapshot->m_aData, pSnapshot->m_Size);
 			}
 
-			int Crc = pData->Crc();
-
-			// remove old snapshots
-			// keep 3 seconds worth of snapshots
-			m_aClients[i].m_Snapshots.PurgeUntil(m_CurrentGameTick - SERVER_TICK_SPEED * 3);
+			if(!m_NumSnapshotWorkers)
+			{
+				CreateSnapshotDelta(i, &m_SnapshotDelta, pSnapshot);
+				SendSnapshot(i, pSnapshot);
+			}
+		}
+	}
 
-			// save the snapshot
-			m_aClients[i].m_Snapshots.Add(m_CurrentGameTick, time_get(), SnapshotSize, pData, 0, nullptr);
+	if(m_NumSnapshotWorkers)
+	{
+		class CJob : public IJob
+		{
+			CServer *m_pServer;
+			int m_Worker;
 
-			// find snapshot that we can perform delta against
-			int DeltaTick = -1;
-			const CSnapshot *pDeltashot = CSnapshot::EmptySnapshot();
+			void Run() override
 			{
-				int DeltashotSize = m_aClients[i].m_Snapshots.Get(m_aClients[i].m_LastAckedSnapshot, 0, &pDeltashot, 0);
-				if(DeltashotSize >= 0)
-					DeltaTick = m_aClients[i].m_LastAckedSnapshot;
-				else
-				{
-					// no acked package found, force client to recover rate
-					if(m_aClients[i].m_SnapRate == CClient::SNAPRATE_FULL)
-						m_aClients[i].m_SnapRate = CClient::SNAPRATE_RECOVER;
-				}
+				CProfileScope Profile(&m_pServer->m_Profiler, m_pServer->m_aProfileZones[PROFILE_SNAPSHOT_DELTAS]);
+				m_pServer->CreateSnapshotDeltas(m_Worker);
+				sphore_signal(&m_pServer->m_SnapshotWorkersDone);
 			}
 
-			// create delta
-			m_SnapshotDelta.SetStaticsize(protocol7::NETEVENTTYPE_SOUNDWORLD, m_aClients[i].m_Sixup);
-			m_SnapshotDelta.SetStaticsize(protocol7::NETEVENTTYPE_DAMAGE, m_aClients[i].m_Sixup);
-			char aDeltaData[CSnapshot::MAX_SIZE];
-			int DeltaSize = m_SnapshotDelta.CreateDelta(pDeltashot, pData, aDeltaData);
+		public:
+			CJob(CServer *pServer, int Worker) :
+				m_pServer(pServer), m_Worker(Worker) {}
+		};
 
-			if(DeltaSize)
-			{
-				// compress it
-				const int MaxSize = MAX_SNAPSHOT_PACKSIZE;
+		for(int Worker = 0; Worker < m_NumSnapshotWorkers; Worker++)
+			m_SnapshotJobPool.Add(std::make_shared<CJob>(this, Worker));
+		for(int Worker = 0; Worker < m_NumSnapshotWorkers; Worker++)
+			sphore_wait(&m_SnapshotWorkersDone);
+
+		// send in client order from the main thread
+		for(int i = 0; i < MaxClients(); i++)
+		{
+			if(m_pClientSnapshots[i].m_Size >= 0)
+				SendSnapshot(i, &m_pClientSnapshots[i]);
+		}
+	}
 
-				char aCompData[CSnapshot::MAX_SIZE];
-				SnapshotSize = CVariableInt::Compress(aDeltaData, DeltaSize, aCompData, sizeof(aCompData));
-				int NumPackets = (SnapshotSize + MaxSize - 1) / MaxSize;
+	GameServer()->OnPostSnap();
+}
 
-				for(int n = 0, Left = SnapshotSize; Left > 0; n++)
-				{
-					int Chunk = Left < MaxSize ? Left : MaxSize;
-					Left -= Chunk;
+void CServer::InitSnapshotWorkers()
+{
+	m_NumSnapshotWorkers = Config()->m_SvSnapshotThreads;
+	m_pClientSnapshots = std::make_unique<CClientSnapshot[]>(m_NumSnapshotWorkers ? MAX_CLIENTS : 1);
+	if(!m_NumSnapshotWorkers)
+		return;
 
-					if(NumPackets == 1)
-					{
-						CMsgPacker Msg(NETMSG_SNAPSINGLE, true);
-						Msg.AddInt(m_CurrentGameTick);
-						Msg.AddInt(m_CurrentGameTick - DeltaTick);
-						Msg.AddInt(Crc);
-						Msg.AddInt(Chunk);
-						Msg.AddRaw(&aCompData[n * MaxSize], Chunk);
-						SendMsg(&Msg, MSGFLAG_FLUSH, i);
-					}
-					else
-					{
-						CMsgPacker Msg(NETMSG_SNAP, true);
-						Msg.AddInt(m_CurrentGameTick);
-						Msg.AddInt(m_CurrentGameTick - DeltaTick);
-						Msg.AddInt(NumPackets);
-						Msg.AddInt(n);
-						Msg.AddInt(Crc);
-						Msg.AddInt(Chunk);
-						Msg.AddRaw(&aCompData[n * MaxSize], Chunk);
-						SendMsg(&Msg, MSGFLAG_FLUSH, i);
-					}
-				}
+	// copy the static item sizes registered by the game
+	for(int Worker = 0; Worker < m_NumSnapshotWorkers; Worker++)
+		m_vpSnapshotWorkerDeltas.push_back(std::make_unique<CSnapshotDelta>(m_SnapshotDelta));
+	m_SnapshotJobPool.Init(m_NumSnapshotWorkers);
+
+	char aBuf[64];
+	str_format(aBuf, sizeof(aBuf), "creating snapshot deltas on %d threads", m_NumSnapshotWorkers);
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+}
+
+void CServer::CreateSnapshotDelta(int ClientID, CSnapshotDelta *pSnapshotDelta, CClientSnapshot *pSnapshot)
+{
+	CSnapshot *pData = (CSnapshot *)pSnapshot->m_aData;
+	pSnapshot->m_Crc = pData->Crc();
+
+	// remove old snapshots
+	// keep 3 seconds worth of snapshots
+	m_aClients[ClientID].m_Snapshots.PurgeUntil(m_CurrentGameTick - SERVER_TICK_SPEED * 3);
+
+	// save the snapshot
+	m_aClients[ClientID].m_Snapshots.Add(m_CurrentGameTick, time_get(), pSnapshot->m_Size, pData, 0, nullptr);
+
+	// find snapshot that we can perform delta against
+	pSnapshot->m_DeltaTick = -1;
+	const CSnapshot *pDeltashot = CSnapshot::EmptySnapshot();
+	{
+		int DeltashotSize = m_aClients[ClientID].m_Snapshots.Get(m_aClients[ClientID].m_LastAckedSnapshot, 0, &pDeltashot, 0);
+		if(DeltashotSize >= 0)
+			pSnapshot->m_DeltaTick = m_aClients[ClientID].m_LastAckedSnapshot;
+		else
+		{
+			// no acked package found, force client to recover rate
+			if(m_aClients[ClientID].m_SnapRate == CClient::SNAPRATE_FULL)
+				m_aClients[ClientID].m_SnapRate = CClient::SNAPRATE_RECOVER;
+		}
+	}
+
+	// create delta
+	pSnapshotDelta->SetStaticsize(protocol7::NETEVENTTYPE_SOUNDWORLD, m_aClients[ClientID].m_Sixup);
+	pSnapshotDelta->SetStaticsize(protocol7::NETEVENTTYPE_DAMAGE, m_aClients[ClientID].m_Sixup);
+	char aDeltaData[CSnapshot::MAX_SIZE];
+	int DeltaSize = pSnapshotDelta->CreateDelta(pDeltashot, pData, aDeltaData);
+
+	// compress it
+	pSnapshot->m_CompSize = 0;
+	if(DeltaSize)
+		pSnapshot->m_CompSize = CVariableInt::Compress(aDeltaData, DeltaSize, pSnapshot->m_aCompData, sizeof(pSnapshot->m_aCompData));
+}
+
+void CServer::CreateSnapshotDeltas(int Worker)
+{
+	CSnapshotDelta *pSnapshotDelta = m_vpSnapshotWorkerDeltas[Worker].get();
+	for(int i = Worker; i < MaxClients(); i += m_NumSnapshotWorkers)
+	{
+		if(m_pClientSnapshots[i].m_Size >= 0)
+			CreateSnapshotDelta(i, pSnapshotDelta, &m_pClientSnapshots[i]);
+	}
+}
+
+void CServer::SendSnapshot(int ClientID, const CClientSnapshot *pSnapshot)
+{
+	if(pSnapshot->m_CompSize)
+	{
+		const int MaxSize = MAX_SNAPSHOT_PACKSIZE;
+		const char *pCompData = pSnapshot->m_aCompData;
+		int NumPackets = (pSnapshot->m_CompSize + MaxSize - 1) / MaxSize;
+
+		for(int n = 0, Left = pSnapshot->m_CompSize; Left > 0; n++)
+		{
+			int Chunk = Left < MaxSize ? Left : MaxSize;
+			Left -= Chunk;
+
+			if(NumPackets == 1)
+			{
+				CMsgPacker Msg(NETMSG_SNAPSINGLE, true);
+				Msg.AddInt(m_CurrentGameTick);
+				Msg.AddInt(m_CurrentGameTick - pSnapshot->m_DeltaTick);
+				Msg.AddInt(pSnapshot->m_Crc);
+				Msg.AddInt(Chunk);
+				Msg.AddRaw(&pCompData[n * MaxSize], Chunk);
+				SendMsg(&Msg, MSGFLAG_FLUSH, ClientID);
 			}
 			else
 			{
-				CMsgPacker Msg(NETMSG_SNAPEMPTY, true);
+				CMsgPacker Msg(NETMSG_SNAP, true);
 				Msg.AddInt(m_CurrentGameTick);
-				Msg.AddInt(m_CurrentGameTick - DeltaTick);
-				SendMsg(&Msg, MSGFLAG_FLUSH, i);
+				Msg.AddInt(m_CurrentGameTick - pSnapshot->m_DeltaTick);
+				Msg.AddInt(NumPackets);
+				Msg.AddInt(n);
+				Msg.AddInt(pSnapshot->m_Crc);
+				Msg.AddInt(Chunk);
+				Msg.AddRaw(&pCompData[n * MaxSize], Chunk);
+				SendMsg(&Msg, MSGFLAG_FLUSH, ClientID);
 			}
 		}
 	}
-
-	GameServer()->OnPostSnap();
+	else
+	{
+		CMsgPacker Msg(NETMSG_SNAPEMPTY, true);
+		Msg.AddInt(m_CurrentGameTick);
+		Msg.AddInt(m_CurrentGameTick - pSnapshot->m_DeltaTick);
+		SendMsg(&Msg, MSGFLAG_FLUSH, ClientID);
+	}
 }
 
 int CServer::ClientRejoinCallback(int ClientID, void *pUser)
@@ -2674,7 +2769,7 @@ int CServer::Run()
 	BindAddr.type = Config()->m_SvIpv4Only ? NETTYPE_IPV4 : NETTYPE_ALL;
 
 	int Port = Config()->m_SvPort;
-	for(BindAddr.port = Port != 0 ? Port : 8303; !m_NetServer.Open(BindAddr, &m_ServerBan, Config()->m_SvMaxClients, Config()->m_SvMaxClientsPerIP); BindAddr.port++)
+	for(BindAddr.port = Port != 0 ? Port : 8303; !m_NetServer.Open(BindAddr, &m_ServerBan, Config()->m_SvMaxClients, Config()->m_SvMaxClientsPerIP, Config()->m_SvNetThreads); BindAddr.port++)
 	{
 		if(Port != 0 || BindAddr.port >= 8310)
 		{
@@ -2686,6 +2781,12 @@ int CServer::Run()
 	if(Port == 0)
 		dbg_msg("server", "using port %d", BindAddr.port);
 
+	if(Config()->m_SvNetBatching)
+		net_udp_set_batching(m_NetServer.Socket(), 1);
+	m_Profiler.SetEnabled(Config()->m_SvProfiler);
+	net_stats(&m_NetStatsStart);
+	m_NetStatsStartTick = m_CurrentGameTick;
+
 #if defined(CONF_UPNP)
 	m_UPnP.Open(BindAddr);
 #endif
@@ -2709,6 +2810,7 @@ int CServer::Run()
 	{
 		m_RunServer = STOPPING;
 	}
+	InitSnapshotWorkers();
 	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", "version " GAME_RELEASE_VERSION " on " CONF_PLATFORM_STRING " " CONF_ARCH_STRING);
 	if(GIT_SHORTREV_HASH)
 	{
@@ -2738,7 +2840,10 @@ int CServer::Run()
 		while(m_RunServer < STOPPING)
 		{
 			if(NonActive)
+			{
+				CProfileScope Profile(&m_Profiler, m_aProfileZones[PROFILE_NETWORK]);
 				PumpNetwork(PacketWaiting);
+			}
 
 			set_new_tick();
 
@@ -2849,6 +2954,8 @@ int CServer::Run()
 
 			while(t > TickStartTime(m_CurrentGameTick + 1))
 			{
+				CProfileScope ProfileTick(&m_Profiler, m_aProfileZones[PROFILE_TICK]);
+				CProfileScope ProfileInput(&m_Profiler, m_aProfileZones[PROFILE_INPUT]);
 				GameServer()->OnPreTickTeehistorian();
 
 				for(int c = 0; c < MAX_CLIENTS; c++)
@@ -2889,8 +2996,12 @@ int CServer::Run()
 					if(!ClientHadInput)
 						GameServer()->OnClientPredictedInput(c, nullptr);
 				}
+				ProfileInput.End();
 
-				GameServer()->OnTick();
+				{
+					CProfileScope Profile(&m_Profiler, m_aProfileZones[PROFILE_GAME_TICK]);
+					GameServer()->OnTick();
+				}
 				if(ErrorShutdown())
 				{
 					break;
@@ -2901,7 +3012,10 @@ int CServer::Run()
 			if(NewTicks)
 			{
 				if(Config()->m_SvHighBandwidth || (m_CurrentGameTick % 2) == 0)
+				{
+					CProfileScope Profile(&m_Profiler, m_aProfileZones[PROFILE_SNAPSHOT]);
 					DoSnapshot();
+				}
 
 				UpdateClientRconCommands();
 
@@ -2909,15 +3023,24 @@ int CServer::Run()
 			}
 
 			// master server stuff
-			m_pRegister->Update();
+			{
+				CProfileScope Profile(&m_Profiler, m_aProfileZones[PROFILE_REGISTER]);
+				m_pRegister->Update();
+			}
 
 			if(m_ServerInfoNeedsUpdate)
 				UpdateServerInfo();
 
-			Antibot()->OnEngineTick();
+			{
+				CProfileScope Profile(&m_Profiler, m_aProfileZones[PROFILE_ANTIBOT]);
+				Antibot()->OnEngineTick();
+			}
 
 			if(!NonActive)
+			{
+				CProfileScope Profile(&m_Profiler, m_aProfileZones[PROFILE_NETWORK]);
 				PumpNetwork(PacketWaiting);
+			}
 
 			NonActive = true;
 
@@ -2933,6 +3056,12 @@ int CServer::Run()
 				}
 			}
 
+			// send everything queued during this iteration
+			{
+				CProfileScope Profile(&m_Profiler, m_aProfileZones[PROFILE_NET_FLUSH]);
+				net_udp_flush(m_NetServer.Socket());
+			}
+
 			// wait for incoming data
 			if(NonActive)
 			{
@@ -2950,7 +3079,7 @@ int CServer::Run()
 				if(Config()->m_SvShutdownWhenEmpty)
 					m_RunServer = STOPPING;
 				else
-					PacketWaiting = net_socket_read_wait(m_NetServer.Socket(), 1000000);
+					PacketWaiting = m_NetServer.Wait(1000000);
 			}
 			else
 			{
@@ -2960,7 +3089,7 @@ int CServer::Run()
 				t = time_get();
 				int x = (TickStartTime(m_CurrentGameTick + 1) - t) * 1000000 / time_freq() + 1;
 
-				PacketWaiting = x > 0 ? net_socket_read_wait(m_NetServer.Socket(), x) : true;
+				PacketWaiting = x > 0 ? m_NetServer.Wait(x) : true;
 			}
 			if(IsInterrupted())
 			{
@@ -3470,6 +3599,73 @@ void CServer::ConLogout(IConsole::IResult *pResult, void *pUser)
 	}
 }
 
+void CServer::ConDumpNetStats(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = (CServer *)pUser;
+
+	NETSTATS Stats;
+	net_stats(&Stats);
+	const int Ticks = maximum(pThis->m_CurrentGameTick - pThis->m_NetStatsStartTick, 1);
+	const NETSTATS &Start = pThis->m_NetStatsStart;
+
+	char aBuf[256];
+	str_format(aBuf, sizeof(aBuf), "over %d ticks, per tick: sent %.1f packets (%.1f KiB) with %.1f syscalls, received %.1f packets (%.1f KiB) with %.1f syscalls",
+		Ticks,
+		(Stats.sent_packets - Start.sent_packets) / (float)Ticks,
+		(Stats.sent_bytes - Start.sent_bytes) / 1024.0f / Ticks,
+		(Stats.send_calls - Start.send_calls) / (float)Ticks,
+		(Stats.recv_packets - Start.recv_packets) / (float)Ticks,
+		(Stats.recv_bytes - Start.recv_bytes) / 1024.0f / Ticks,
+		(Stats.recv_calls - Start.recv_calls) / (float)Ticks);
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+
+	pThis->m_NetStatsStart = Stats;
+	pThis->m_NetStatsStartTick = pThis->m_CurrentGameTick;
+}
+
+void CServer::ConProfilerStats(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = (CServer *)pUser;
+	if(!pThis->m_Profiler.Enabled())
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", "profiler is disabled, enable it with sv_profiler 1");
+	pThis->m_Profiler.PrintStats(pThis->Console());
+}
+
+void CServer::ConProfilerReset(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = (CServer *)pUser;
+	pThis->m_Profiler.Reset();
+}
+
+void CServer::ConProfilerTrace(IConsole::IResult *pResult, void *pUser)
+{
+	CServer *pThis = (CServer *)pUser;
+
+	char aFilename[IO_MAX_PATH_LENGTH];
+	if(pResult->NumArguments())
+	{
+		str_copy(aFilename, pResult->GetString(0));
+	}
+	else
+	{
+		char aDate[64];
+		str_timestamp(aDate, sizeof(aDate));
+		str_format(aFilename, sizeof(aFilename), "dumps/profiler_%s.json", aDate);
+		pThis->Storage()->CreateFolder("dumps", IStorage::TYPE_SAVE);
+	}
+
+	char aBuf[IO_MAX_PATH_LENGTH + 64];
+	IOHANDLE File = pThis->Storage()->OpenFile(aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	if(!pThis->m_Profiler.WriteTrace(File))
+	{
+		str_format(aBuf, sizeof(aBuf), "failed to open '%s' for writing", aFilename);
+		pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", aBuf);
+		return;
+	}
+	str_format(aBuf, sizeof(aBuf), "wrote trace to '%s'", aFilename);
+	pThis->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", aBuf);
+}
+
 void CServer::ConShowIps(IConsole::IResult *pResult, void *pUser)
 {
 	CServer *pServer = (CServer *)pUser;
@@ -3724,6 +3920,14 @@ void CServer::ConchainSixupUpdate(IConsole::IResult *pResult, void *pUserData, I
 		pThis->m_MapReload |= (pThis->m_apCurrentMapData[MAP_TYPE_SIXUP] != 0) != (pResult->GetInteger(0) != 0);
 }
 
+void CServer::ConchainProfilerUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
+{
+	pfnCallback(pResult, pCallbackUserData);
+	CServer *pThis = static_cast<CServer *>(pUserData);
+	if(pResult->NumArguments())
+		pThis->m_Profiler.SetEnabled(pThis->Config()->m_SvProfiler);
+}
+
 void CServer::ConchainLoglevel(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
 {
 	CServer *pSelf = (CServer *)pUserData;
@@ -3787,6 +3991,10 @@ void CServer::RegisterCommands()
 	Console()->Register("status", "?r[name]", CFGFLAG_SERVER, ConStatus, this, "List players containing name or all players");
 	Console()->Register("shutdown", "?r[reason]", CFGFLAG_SERVER, ConShutdown, this, "Shut down");
 	Console()->Register("logout", "", CFGFLAG_SERVER, ConLogout, this, "Logout of rcon");
+	Console()->Register("dump_netstats", "", CFGFLAG_SERVER, ConDumpNetStats, this, "Print the network packets and syscalls per tick since the last call");
+	Console()->Register("profiler_stats", "", CFGFLAG_SERVER, ConProfilerStats, this, "Print the timings of the server loop phases");
+	Console()->Register("profiler_reset", "", CFGFLAG_SERVER, ConProfilerReset, this, "Reset the timings of the server loop phases");
+	Console()->Register("profiler_trace", "?s[file]", CFGFLAG_SERVER, ConProfilerTrace, this, "Write the recent server loop phases as Chrome trace JSON");
 	Console()->Register("show_ips", "?i[show]", CFGFLAG_SERVER, ConShowIps, this, "Show IP addresses in rcon commands (1 = on, 0 = off)");
 
 	Console()->Register("record", "?s[file]", CFGFLAG_SERVER | CFGFLAG_STORE, ConRecord, this, "Record to a file");
@@ -3822,6 +4030,7 @@ void CServer::RegisterCommands()
 	Console()->Chain("sv_rcon_helper_password", ConchainRconHelperPasswordChange, this);
 	Console()->Chain("sv_map", ConchainMapUpdate, this);
 	Console()->Chain("sv_sixup", ConchainSixupUpdate, this);
+	Console()->Chain("sv_profiler", ConchainProfilerUpdate, this);
 
 	Console()->Chain("loglevel", ConchainLoglevel, this);
 	Console()->Chain("stdout_output_level", ConchainStdoutOutputLevel, this);
@@ -11,8 +11,10 @@
 #include <engine/shared/demo.h>
 #include <engine/shared/econ.h>
 #include <engine/shared/fifo.h>
+#include <engine/shared/jobs.h>
 #include <engine/shared/netban.h>
 #include <engine/shared/network.h>
+#include <engine/shared/profiler.h>
 #include <engine/shared/protocol.h>
 #include <engine/shared/snapshot.h>
 #include <engine/shared/uuid_manager.h>
@@ -223,7 +225,47 @@ public:
 	CSnapshotDelta m_SnapshotDelta;
 	CSnapshotBuilder m_SnapshotBuilder;
 	CSnapIDPool m_IDPool;
+
+	// a client's finished snapshot and its compressed delta
+	class CClientSnapshot
+	{
+	public:
+		char m_aData[CSnapshot::MAX_SIZE];
+		int m_Size; // -1 if the client gets no snapshot this tick
+		int m_Crc;
+		int m_DeltaTick;
+		char m_aCompData[CSnapshot::MAX_SIZE];
+		int m_CompSize;
+	};
+
+	// with sv_snapshot_threads the deltas are created on a dedicated pool,
+	// each worker with its own CSnapshotDelta
+	int m_NumSnapshotWorkers;
+	CJobPool m_SnapshotJobPool;
+	SEMAPHORE m_SnapshotWorkersDone;
+	std::vector<std::unique_ptr<CSnapshotDelta>> m_vpSnapshotWorkerDeltas;
+	std::unique_ptr<CClientSnapshot[]> m_pClientSnapshots;
+
 	CNetServer m_NetServer;
+	// network counters at the last dump_netstats, to report them per tick
+	NETSTATS m_NetStatsStart;
+	int m_NetStatsStartTick;
+
+	enum
+	{
+		PROFILE_TICK,
+		PROFILE_INPUT,
+		PROFILE_GAME_TICK,
+		PROFILE_SNAPSHOT,
+		PROFILE_SNAPSHOT_DELTAS,
+		PROFILE_REGISTER,
+		PROFILE_ANTIBOT,
+		PROFILE_NETWORK,
+		PROFILE_NET_FLUSH,
+		NUM_PROFILE_ZONES,
+	};
+	CProfiler m_Profiler;
+	int m_aProfileZones[NUM_PROFILE_ZONES];
 	CEcon m_Econ;
 	CFifo m_Fifo;
 	CServerBan m_ServerBan;
@@ -327,6 +369,10 @@ public:
 	int SendMsg(CMsgPacker *pMsg, int Flags, int ClientID) override;
 
 	void DoSnapshot();
+	void InitSnapshotWorkers();
+	void CreateSnapshotDelta(int ClientID, CSnapshotDelta *pSnapshotDelta, CClientSnapshot *pSnapshot);
+	void CreateSnapshotDeltas(int Worker);
+	void SendSnapshot(int ClientID, const CClientSnapshot *pSnapshot);
 
 	static int NewClientCallback(int ClientID, void *pUser, bool Sixup);
 	static int NewClientNoAuthCallback(int ClientID, void *pUser);
@@ -410,6 +456,10 @@ public:
 	static void ConMapReload(IConsole::IResult *pResult, void *pUser);
 	static void ConLogout(IConsole::IResult *pResult, void *pUser);
 	static void ConShowIps(IConsole::IResult *pResult, void *pUser);
+	static void ConDumpNetStats(IConsole::IResult *pResult, void *pUser);
+	static void ConProfilerStats(IConsole::IResult *pResult, void *pUser);
+	static void ConProfilerReset(IConsole::IResult *pResult, void *pUser);
+	static void ConProfilerTrace(IConsole::IResult *pResult, void *pUser);
 
 	static void ConAuthAdd(IConsole::IResult *pResult, void *pUser);
 	static void ConAuthAddHashed(IConsole::IResult *pResult, void *pUser);
@@ -439,6 +489,7 @@ public:
 	static void ConchainRconHelperPasswordChange(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainMapUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainSixupUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
+	static void ConchainProfilerUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainLoglevel(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainStdoutOutputLevel(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 
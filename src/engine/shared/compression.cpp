@@ -6,7 +6,18 @@
 
 #include <iterator> // std::size
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONF_COMPRESSION_SSE2 1
+#include <emmintrin.h>
+#endif
+
 // Format: ESDDDDDD EDDDDDDD EDD... Extended, Data, Sign
+int CVariableInt::PackedSize(int i)
+{
+	const unsigned Value = i < 0 ? ~(unsigned)i : (unsigned)i;
+	return 1 + (Value >= (1u << 6)) + (Value >= (1u << 13)) + (Value >= (1u << 20)) + (Value >= (1u << 27));
+}
+
 unsigned char *CVariableInt::Pack(unsigned char *pDst, int i, int DstSize)
 {
 	if(DstSize <= 0)
@@ -65,7 +76,37 @@ const unsigned char *CVariableInt::Unpack(const unsigned char *pSrc, int *pInOut
 	return pSrc;
 }
 
-long CVariableInt::Decompress(const void *pSrc_, int SrcSize, void *pDst_, int DstSize)
+// delta snapshots are mostly zeros, these move four of them at a time
+static bool IsZeroBytes4(const unsigned char *pSrc)
+{
+	unsigned Word;
+	mem_copy(&Word, pSrc, sizeof(Word));
+	return Word == 0;
+}
+
+static bool IsZeroInts4(const int *pSrc)
+{
+	return (pSrc[0] | pSrc[1] | pSrc[2] | pSrc[3]) == 0;
+}
+
+#if defined(CONF_COMPRESSION_SSE2)
+// and these sixteen
+static bool IsZeroBytes16(const unsigned char *pSrc)
+{
+	const __m128i Bytes = _mm_loadu_si128((const __m128i *)pSrc);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(Bytes, _mm_setzero_si128())) == 0xffff;
+}
+
+static bool IsZeroInts16(const int *pSrc)
+{
+	const __m128i *pVec = (const __m128i *)pSrc;
+	const __m128i Ints = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(pVec), _mm_loadu_si128(pVec + 1)), _mm_or_si128(_mm_loadu_si128(pVec + 2), _mm_loadu_si128(pVec + 3)));
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(Ints, _mm_setzero_si128())) == 0xffff;
+}
+#endif
+
+template<bool Simd>
+static long DecompressImpl(const void *pSrc_, int SrcSize, void *pDst_, int DstSize)
 {
 	dbg_assert(DstSize % sizeof(int) == 0, "invalid bounds");
 
@@ -75,6 +116,27 @@ long CVariableInt::Decompress(const void *pSrc_, int SrcSize, void *pDst_, int D
 	const int *pDstEnd = pDst + DstSize / sizeof(int);
 	while(pSrc < pSrcEnd)
 	{
+#if defined(CONF_COMPRESSION_SSE2)
+		if(Simd && pSrcEnd - pSrc >= 16 && pDstEnd - pDst >= 16 && IsZeroBytes16(pSrc))
+		{
+			const __m128i Zero = _mm_setzero_si128();
+			__m128i *pVec = (__m128i *)pDst;
+			_mm_storeu_si128(pVec, Zero);
+			_mm_storeu_si128(pVec + 1, Zero);
+			_mm_storeu_si128(pVec + 2, Zero);
+			_mm_storeu_si128(pVec + 3, Zero);
+			pSrc += 16;
+			pDst += 16;
+			continue;
+		}
+#endif
+		if(pSrcEnd - pSrc >= 4 && pDstEnd - pDst >= 4 && IsZeroBytes4(pSrc))
+		{
+			mem_zero(pDst, 4 * sizeof(int));
+			pSrc += 4;
+			pDst += 4;
+			continue;
+		}
 		if(pDst >= pDstEnd)
 			return -1;
 		pSrc = CVariableInt::Unpack(pSrc, pDst, pSrcEnd - pSrc);
@@ -85,7 +147,8 @@ long CVariableInt::Decompress(const void *pSrc_, int SrcSize, void *pDst_, int D
 	return (long)((unsigned char *)pDst - (unsigned char *)pDst_);
 }
 
-long CVariableInt::Compress(const void *pSrc_, int SrcSize, void *pDst_, int DstSize)
+template<bool Simd>
+static long CompressImpl(const void *pSrc_, int SrcSize, void *pDst_, int DstSize)
 {
 	dbg_assert(SrcSize % sizeof(int) == 0, "invalid bounds");
 
@@ -95,6 +158,24 @@ long CVariableInt::Compress(const void *pSrc_, int SrcSize, void *pDst_, int Dst
 	SrcSize /= sizeof(int);
 	while(SrcSize)
 	{
+#if defined(CONF_COMPRESSION_SSE2)
+		if(Simd && SrcSize >= 16 && pDstEnd - pDst >= 16 && IsZeroInts16(pSrc))
+		{
+			_mm_storeu_si128((__m128i *)pDst, _mm_setzero_si128());
+			pDst += 16;
+			SrcSize -= 16;
+			pSrc += 16;
+			continue;
+		}
+#endif
+		if(SrcSize >= 4 && pDstEnd - pDst >= 4 && IsZeroInts4(pSrc))
+		{
+			mem_zero(pDst, 4);
+			pDst += 4;
+			SrcSize -= 4;
+			pSrc += 4;
+			continue;
+		}
 		pDst = CVariableInt::Pack(pDst, *pSrc, pDstEnd - pDst);
 		if(!pDst)
 			return -1;
@@ -103,3 +184,23 @@ long CVariableInt::Compress(const void *pSrc_, int SrcSize, void *pDst_, int Dst
 	}
 	return (long)(pDst - (unsigned char *)pDst_);
 }
+
+long CVariableInt::Decompress(const void *pSrc, int SrcSize, void *pDst, int DstSize)
+{
+	return DecompressImpl<true>(pSrc, SrcSize, pDst, DstSize);
+}
+
+long CVariableInt::Compress(const void *pSrc, int SrcSize, void *pDst, int DstSize)
+{
+	return CompressImpl<true>(pSrc, SrcSize, pDst, DstSize);
+}
+
+long CVariableInt::DecompressScalar(const void *pSrc, int SrcSize, void *pDst, int DstSize)
+{
+	return DecompressImpl<false>(pSrc, SrcSize, pDst, DstSize);
+}
+
+long CVariableInt::CompressScalar(const void *pSrc, int SrcSize, void *pDst, int DstSize)
+{
+	return CompressImpl<false>(pSrc, SrcSize, pDst, DstSize);
+}
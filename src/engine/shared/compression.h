@@ -12,11 +12,16 @@ public:
 		MAX_BYTES_PACKED = 5, // maximum number of bytes in a packed int
 	};
 
+	static int PackedSize(int i);
 	static unsigned char *Pack(unsigned char *pDst, int i, int DstSize);
 	static const unsigned char *Unpack(const unsigned char *pSrc, int *pInOut, int SrcSize);
 
+	// vectorized with SSE2 where it is available
 	static long Compress(const void *pSrc, int SrcSize, void *pDst, int DstSize);
 	static long Decompress(const void *pSrc, int SrcSize, void *pDst, int DstSize);
+	// same output without SSE2, for tests and benchmarks
+	static long CompressScalar(const void *pSrc, int SrcSize, void *pDst, int DstSize);
+	static long DecompressScalar(const void *pSrc, int SrcSize, void *pDst, int DstSize);
 };
 
 #endif
@@ -11,8 +11,12 @@
 
 #include "uuid_manager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <limits>
+#include <numeric>
+#include <thread>
 
 static const int DEBUG = 0;
 
@@ -88,6 +92,11 @@ struct CDatafileInfo
 struct CDatafile
 {
 	IOHANDLE m_File;
+	// data of different indices can be loaded from several threads, they share the file position
+	LOCK m_FileLock;
+	// the whole file if it could be mapped, the items and uncompressed data are used in place then
+	char *m_pMapping;
+	size_t m_MappingSize;
 	SHA256_DIGEST m_Sha256;
 	unsigned m_Crc;
 	CDatafileInfo m_Info;
@@ -98,6 +107,27 @@ struct CDatafile
 	char *m_pData;
 };
 
+static bool IsMappedData(const CDatafile *pDataFile, const char *pData)
+{
+	return pDataFile->m_pMapping != nullptr && pData >= pDataFile->m_pMapping && pData < pDataFile->m_pMapping + pDataFile->m_MappingSize;
+}
+
+// the stored data of an index in the mapped file, nullptr if it is truncated
+static const char *MappedFileData(const CDatafile *pDataFile, int Index, unsigned DataSize)
+{
+	const int64_t Offset = (int64_t)pDataFile->m_DataStartOffset + pDataFile->m_Info.m_pDataOffsets[Index];
+	if(Offset < 0 || (uint64_t)Offset > pDataFile->m_MappingSize || DataSize > pDataFile->m_MappingSize - Offset)
+		return nullptr;
+	return pDataFile->m_pMapping + Offset;
+}
+
+static void FreeData(CDatafile *pDataFile, int Index)
+{
+	if(!IsMappedData(pDataFile, pDataFile->m_ppDataPtrs[Index]))
+		free(pDataFile->m_ppDataPtrs[Index]);
+	pDataFile->m_ppDataPtrs[Index] = nullptr;
+}
+
 bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int StorageType)
 {
 	log_trace("datafile", "loading. filename='%s'", pFilename);
@@ -109,9 +139,36 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 		return false;
 	}
 
+	// map the file if possible, otherwise it is read
+	void *pMapping = nullptr;
+	size_t MappingSize = 0;
+	if(!io_map(File, &pMapping, &MappingSize))
+		pMapping = nullptr;
+	const auto &&CloseFile = [&]() {
+		if(pMapping)
+			io_unmap(pMapping, MappingSize);
+		io_close(File);
+	};
+
 	// take the CRC of the file and store it
 	unsigned Crc = 0;
 	SHA256_DIGEST Sha256;
+	if(pMapping)
+	{
+		SHA256_CTX Sha256Ctxt;
+		sha256_init(&Sha256Ctxt);
+		sha256_update(&Sha256Ctxt, pMapping, MappingSize);
+		Sha256 = sha256_finish(&Sha256Ctxt);
+
+		// crc32 takes the size as 32 bit integer
+		for(size_t Offset = 0; Offset < MappingSize;)
+		{
+			const unsigned Bytes = minimum<size_t>(MappingSize - Offset, 1 << 30);
+			Crc = crc32(Crc, (const Bytef *)pMapping + Offset, Bytes);
+			Offset += Bytes;
+		}
+	}
+	else
 	{
 		enum
 		{
@@ -137,8 +194,13 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 
 	// TODO: change this header
 	CDatafileHeader Header;
-	if(sizeof(Header) != io_read(File, &Header, sizeof(Header)))
+	if(pMapping && MappingSize >= sizeof(Header))
+	{
+		mem_copy(&Header, pMapping, sizeof(Header));
+	}
+	else if(pMapping || sizeof(Header) != io_read(File, &Header, sizeof(Header)))
 	{
+		CloseFile();
 		dbg_msg("datafile", "couldn't load header");
 		return false;
 	}
@@ -146,6 +208,7 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 	{
 		if(Header.m_aID[0] != 'D' || Header.m_aID[1] != 'A' || Header.m_aID[2] != 'T' || Header.m_aID[3] != 'A')
 		{
+			CloseFile();
 			dbg_msg("datafile", "wrong signature. %x %x %x %x", Header.m_aID[0], Header.m_aID[1], Header.m_aID[2], Header.m_aID[3]);
 			return false;
 		}
@@ -156,6 +219,7 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 #endif
 	if(Header.m_Version != 3 && Header.m_Version != 4)
 	{
+		CloseFile();
 		dbg_msg("datafile", "wrong version. version=%x", Header.m_Version);
 		return false;
 	}
@@ -168,24 +232,42 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 		Size += Header.m_NumRawData * sizeof(int); // v4 has uncompressed data sizes as well
 	Size += Header.m_ItemSize;
 
-	unsigned AllocSize = Size;
+	unsigned AllocSize = 0;
+	if(!pMapping)
+		AllocSize += Size; // the mapped file is used in place
 	AllocSize += sizeof(CDatafile); // add space for info structure
 	AllocSize += Header.m_NumRawData * sizeof(void *); // add space for data pointers
 	AllocSize += Header.m_NumRawData * sizeof(int); // add space for data sizes
 	if(Size > (((int64_t)1) << 31) || Header.m_NumItemTypes < 0 || Header.m_NumItems < 0 || Header.m_NumRawData < 0 || Header.m_ItemSize < 0)
 	{
-		io_close(File);
+		CloseFile();
 		dbg_msg("datafile", "unable to load file, invalid file information");
 		return false;
 	}
 
+	// types, offsets, sizes and item data
+	unsigned ReadSize = Size;
+	if(pMapping)
+		ReadSize = minimum<size_t>(Size, MappingSize - sizeof(CDatafileHeader));
+	if(ReadSize != Size)
+	{
+		CloseFile();
+		dbg_msg("datafile", "couldn't load the whole thing, wanted=%d got=%d", Size, ReadSize);
+		return false;
+	}
+
 	CDatafile *pTmpDataFile = (CDatafile *)malloc(AllocSize);
 	pTmpDataFile->m_Header = Header;
 	pTmpDataFile->m_DataStartOffset = sizeof(CDatafileHeader) + Size;
 	pTmpDataFile->m_ppDataPtrs = (char **)(pTmpDataFile + 1);
 	pTmpDataFile->m_pDataSizes = (int *)(pTmpDataFile->m_ppDataPtrs + Header.m_NumRawData);
-	pTmpDataFile->m_pData = (char *)(pTmpDataFile->m_pDataSizes + Header.m_NumRawData);
+	if(pMapping)
+		pTmpDataFile->m_pData = static_cast<char *>(pMapping) + sizeof(CDatafileHeader);
+	else
+		pTmpDataFile->m_pData = (char *)(pTmpDataFile->m_pDataSizes + Header.m_NumRawData);
 	pTmpDataFile->m_File = File;
+	pTmpDataFile->m_pMapping = static_cast<char *>(pMapping);
+	pTmpDataFile->m_MappingSize = MappingSize;
 	pTmpDataFile->m_Sha256 = Sha256;
 	pTmpDataFile->m_Crc = Crc;
 
@@ -193,20 +275,24 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 	mem_zero(pTmpDataFile->m_ppDataPtrs, Header.m_NumRawData * sizeof(void *));
 	mem_zero(pTmpDataFile->m_pDataSizes, Header.m_NumRawData * sizeof(int));
 
-	// read types, offsets, sizes and item data
-	unsigned ReadSize = io_read(File, pTmpDataFile->m_pData, Size);
-	if(ReadSize != Size)
+	if(!pMapping)
 	{
-		io_close(pTmpDataFile->m_File);
-		free(pTmpDataFile);
-		dbg_msg("datafile", "couldn't load the whole thing, wanted=%d got=%d", Size, ReadSize);
-		return false;
+		ReadSize = io_read(File, pTmpDataFile->m_pData, Size);
+		if(ReadSize != Size)
+		{
+			io_close(pTmpDataFile->m_File);
+			free(pTmpDataFile);
+			dbg_msg("datafile", "couldn't load the whole thing, wanted=%d got=%d", Size, ReadSize);
+			return false;
+		}
 	}
 
 	Close();
 	m_pDataFile = pTmpDataFile;
+	m_pDataFile->m_FileLock = lock_create();
 
 #if defined(CONF_ARCH_ENDIAN_BIG)
+	// the pages of the mapping are copied on write
 	swap_endian(m_pDataFile->m_pData, sizeof(int), minimum(static_cast<unsigned>(Header.m_Swaplen), Size) / sizeof(int));
 #endif
 
@@ -214,6 +300,7 @@ bool CDataFileReader::Open(class IStorage *pStorage, const char *pFilename, int
 	{
 		dbg_msg("datafile", "allocsize=%d", AllocSize);
 		dbg_msg("datafile", "readsize=%d", ReadSize);
+		dbg_msg("datafile", "mapped=%d", pMapping != nullptr);
 		dbg_msg("datafile", "swaplen=%d", Header.m_Swaplen);
 		dbg_msg("datafile", "item_size=%d", m_pDataFile->m_Header.m_ItemSize);
 	}
@@ -242,12 +329,14 @@ bool CDataFileReader::Close()
 	// free the data that is loaded
 	for(int i = 0; i < m_pDataFile->m_Header.m_NumRawData; i++)
 	{
-		free(m_pDataFile->m_ppDataPtrs[i]);
-		m_pDataFile->m_ppDataPtrs[i] = nullptr;
+		FreeData(m_pDataFile, i);
 		m_pDataFile->m_pDataSizes[i] = 0;
 	}
 
+	if(m_pDataFile->m_pMapping)
+		io_unmap(m_pDataFile->m_pMapping, m_pDataFile->m_MappingSize);
 	io_close(m_pDataFile->m_File);
+	lock_destroy(m_pDataFile->m_FileLock);
 	free(m_pDataFile);
 	m_pDataFile = nullptr;
 	return true;
@@ -339,15 +428,29 @@ void *CDataFileReader::GetDataImpl(int Index, bool Swap)
 
 			log_trace("datafile", "loading data. index=%d size=%u uncompressed=%u", Index, DataSize, OriginalUncompressedSize);
 
-			// read the compressed data
-			void *pCompressedData = malloc(DataSize);
+			// read the compressed data, it is inflated straight from the mapped file
+			void *pReadData = nullptr;
+			const void *pCompressedData = nullptr;
 			unsigned ActualDataSize = 0;
-			if(io_seek(m_pDataFile->m_File, m_pDataFile->m_DataStartOffset + m_pDataFile->m_Info.m_pDataOffsets[Index], IOSEEK_START) == 0)
-				ActualDataSize = io_read(m_pDataFile->m_File, pCompressedData, DataSize);
+			if(m_pDataFile->m_pMapping)
+			{
+				pCompressedData = MappedFileData(m_pDataFile, Index, DataSize);
+				if(pCompressedData)
+					ActualDataSize = DataSize;
+			}
+			else
+			{
+				pReadData = malloc(DataSize);
+				pCompressedData = pReadData;
+				lock_wait(m_pDataFile->m_FileLock);
+				if(io_seek(m_pDataFile->m_File, m_pDataFile->m_DataStartOffset + m_pDataFile->m_Info.m_pDataOffsets[Index], IOSEEK_START) == 0)
+					ActualDataSize = io_read(m_pDataFile->m_File, pReadData, DataSize);
+				lock_unlock(m_pDataFile->m_FileLock);
+			}
 			if(DataSize != ActualDataSize)
 			{
 				log_error("datafile", "truncation error, could not read all data. index=%d wanted=%u got=%u", Index, DataSize, ActualDataSize);
-				free(pCompressedData);
+				free(pReadData);
 				m_pDataFile->m_ppDataPtrs[Index] = nullptr;
 				m_pDataFile->m_pDataSizes[Index] = -1;
 				return nullptr;
@@ -356,8 +459,8 @@ void *CDataFileReader::GetDataImpl(int Index, bool Swap)
 			// decompress the data
 			m_pDataFile->m_ppDataPtrs[Index] = (char *)malloc(UncompressedSize);
 			m_pDataFile->m_pDataSizes[Index] = UncompressedSize;
-			const int Result = uncompress((Bytef *)m_pDataFile->m_ppDataPtrs[Index], &UncompressedSize, (Bytef *)pCompressedData, DataSize);
-			free(pCompressedData);
+			const int Result = uncompress((Bytef *)m_pDataFile->m_ppDataPtrs[Index], &UncompressedSize, (const Bytef *)pCompressedData, DataSize);
+			free(pReadData);
 			if(Result != Z_OK || UncompressedSize != OriginalUncompressedSize)
 			{
 				log_error("datafile", "uncompress error. result=%d wanted=%u got=%lu", Result, OriginalUncompressedSize, UncompressedSize);
@@ -375,16 +478,43 @@ void *CDataFileReader::GetDataImpl(int Index, bool Swap)
 		{
 			// load the data
 			log_trace("datafile", "loading data. index=%d size=%d", Index, DataSize);
-			m_pDataFile->m_ppDataPtrs[Index] = static_cast<char *>(malloc(DataSize));
-			m_pDataFile->m_pDataSizes[Index] = DataSize;
 			unsigned ActualDataSize = 0;
-			if(io_seek(m_pDataFile->m_File, m_pDataFile->m_DataStartOffset + m_pDataFile->m_Info.m_pDataOffsets[Index], IOSEEK_START) == 0)
-				ActualDataSize = io_read(m_pDataFile->m_File, m_pDataFile->m_ppDataPtrs[Index], DataSize);
+#if defined(CONF_ARCH_ENDIAN_BIG)
+			// copied, the mapped data must not be swapped again after it was unloaded
+			const bool ZeroCopy = false;
+#else
+			const bool ZeroCopy = m_pDataFile->m_pMapping != nullptr && DataSize > 0;
+#endif
+			if(ZeroCopy)
+			{
+				// uncompressed data is used in place
+				m_pDataFile->m_ppDataPtrs[Index] = const_cast<char *>(MappedFileData(m_pDataFile, Index, DataSize));
+				if(m_pDataFile->m_ppDataPtrs[Index])
+					ActualDataSize = DataSize;
+			}
+			else if(m_pDataFile->m_pMapping)
+			{
+				m_pDataFile->m_ppDataPtrs[Index] = static_cast<char *>(malloc(DataSize));
+				const char *pMappedData = MappedFileData(m_pDataFile, Index, DataSize);
+				if(pMappedData)
+				{
+					mem_copy(m_pDataFile->m_ppDataPtrs[Index], pMappedData, DataSize);
+					ActualDataSize = DataSize;
+				}
+			}
+			else
+			{
+				m_pDataFile->m_ppDataPtrs[Index] = static_cast<char *>(malloc(DataSize));
+				lock_wait(m_pDataFile->m_FileLock);
+				if(io_seek(m_pDataFile->m_File, m_pDataFile->m_DataStartOffset + m_pDataFile->m_Info.m_pDataOffsets[Index], IOSEEK_START) == 0)
+					ActualDataSize = io_read(m_pDataFile->m_File, m_pDataFile->m_ppDataPtrs[Index], DataSize);
+				lock_unlock(m_pDataFile->m_FileLock);
+			}
+			m_pDataFile->m_pDataSizes[Index] = DataSize;
 			if(DataSize != ActualDataSize)
 			{
 				log_error("datafile", "truncation error, could not read all data. index=%d wanted=%u got=%u", Index, DataSize, ActualDataSize);
-				free(m_pDataFile->m_ppDataPtrs[Index]);
-				m_pDataFile->m_ppDataPtrs[Index] = nullptr;
+				FreeData(m_pDataFile, Index);
 				m_pDataFile->m_pDataSizes[Index] = -1;
 				return nullptr;
 			}
@@ -426,7 +556,7 @@ void CDataFileReader::ReplaceData(int Index, char *pData, size_t Size)
 {
 	dbg_assert(Index >= 0 && Index < m_pDataFile->m_Header.m_NumRawData, "Index invalid");
 
-	free(m_pDataFile->m_ppDataPtrs[Index]);
+	FreeData(m_pDataFile, Index);
 	m_pDataFile->m_ppDataPtrs[Index] = pData;
 	m_pDataFile->m_pDataSizes[Index] = Size;
 }
@@ -436,8 +566,7 @@ void CDataFileReader::UnloadData(int Index)
 	if(Index < 0 || Index >= m_pDataFile->m_Header.m_NumRawData)
 		return;
 
-	free(m_pDataFile->m_ppDataPtrs[Index]);
-	m_pDataFile->m_ppDataPtrs[Index] = nullptr;
+	FreeData(m_pDataFile, Index);
 	m_pDataFile->m_pDataSizes[Index] = 0;
 }
 
@@ -749,27 +878,74 @@ int CDataFileWriter::AddDataString(const char *pStr)
 	return AddData(str_length(pStr) + 1, pStr);
 }
 
+void CDataFileWriter::CompressData(CDataInfo &DataInfo)
+{
+	unsigned long CompressedSize = compressBound(DataInfo.m_UncompressedSize);
+	DataInfo.m_pCompressedData = malloc(CompressedSize);
+	const int Result = compress2((Bytef *)DataInfo.m_pCompressedData, &CompressedSize, (Bytef *)DataInfo.m_pUncompressedData, DataInfo.m_UncompressedSize, DataInfo.m_CompressionLevel);
+	DataInfo.m_CompressedSize = CompressedSize;
+	free(DataInfo.m_pUncompressedData);
+	DataInfo.m_pUncompressedData = nullptr;
+	if(Result != Z_OK)
+	{
+		char aError[32];
+		str_format(aError, sizeof(aError), "zlib compression error %d", Result);
+		dbg_assert(false, aError);
+	}
+}
+
+struct SCompressContext
+{
+	CDataFileWriter *m_pWriter;
+	// data indices, largest first so the threads finish at about the same time
+	std::vector<int> m_vOrder;
+	std::atomic<size_t> m_Next;
+};
+
+void CDataFileWriter::CompressThread(void *pUser)
+{
+	SCompressContext *pContext = static_cast<SCompressContext *>(pUser);
+	// every block is compressed on its own, the results don't depend on the thread
+	for(size_t Next = pContext->m_Next++; Next < pContext->m_vOrder.size(); Next = pContext->m_Next++)
+		pContext->m_pWriter->CompressData(pContext->m_pWriter->m_vDatas[pContext->m_vOrder[Next]]);
+}
+
+void CDataFileWriter::CompressDatas()
+{
+	// starting threads isn't worth it for small files
+	size_t TotalSize = 0;
+	for(const CDataInfo &DataInfo : m_vDatas)
+		TotalSize += DataInfo.m_UncompressedSize;
+	const size_t NumThreads = TotalSize < COMPRESS_THREAD_MIN_SIZE ? 1 : minimum<size_t>(m_vDatas.size(), maximum(1u, std::thread::hardware_concurrency()));
+
+	SCompressContext Context;
+	Context.m_pWriter = this;
+	Context.m_vOrder.resize(m_vDatas.size());
+	std::iota(Context.m_vOrder.begin(), Context.m_vOrder.end(), 0);
+	if(NumThreads > 1)
+	{
+		std::stable_sort(Context.m_vOrder.begin(), Context.m_vOrder.end(), [&](int Left, int Right) {
+			return m_vDatas[Left].m_UncompressedSize > m_vDatas[Right].m_UncompressedSize;
+		});
+	}
+	Context.m_Next = 0;
+
+	// the calling thread compresses as well
+	std::vector<void *> vpThreads;
+	for(size_t i = 1; i < NumThreads; i++)
+		vpThreads.push_back(thread_init(CompressThread, &Context, "datafile compress"));
+	CompressThread(&Context);
+	for(void *pThread : vpThreads)
+		thread_wait(pThread);
+}
+
 void CDataFileWriter::Finish()
 {
 	dbg_assert((bool)m_File, "File not open");
 
 	// Compress data. This takes the majority of the time when saving a datafile,
-	// so it's delayed until the end so it can be off-loaded to another thread.
-	for(CDataInfo &DataInfo : m_vDatas)
-	{
-		unsigned long CompressedSize = compressBound(DataInfo.m_UncompressedSize);
-		DataInfo.m_pCompressedData = malloc(CompressedSize);
-		const int Result = compress2((Bytef *)DataInfo.m_pCompressedData, &CompressedSize, (Bytef *)DataInfo.m_pUncompressedData, DataInfo.m_UncompressedSize, DataInfo.m_CompressionLevel);
-		DataInfo.m_CompressedSize = CompressedSize;
-		free(DataInfo.m_pUncompressedData);
-		DataInfo.m_pUncompressedData = nullptr;
-		if(Result != Z_OK)
-		{
-			char aError[32];
-			str_format(aError, sizeof(aError), "zlib compression error %d", Result);
-			dbg_assert(false, aError);
-		}
-	}
+	// so it's delayed until the end so it can be off-loaded to other threads.
+	CompressDatas();
 
 	// Calculate total size of items
 	size_t ItemSize = 0;
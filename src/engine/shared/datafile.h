@@ -19,6 +19,10 @@ enum
 };
 
 // raw datafile access
+// the file is mapped into memory if possible (not on Windows), then the items
+// and uncompressed data point into the mapping. Files must be replaced by
+// renaming while they are open, truncating a mapped file in place crashes the
+// reader.
 class CDataFileReader
 {
 	struct CDatafile *m_pDataFile;
@@ -46,6 +50,7 @@ public:
 	IOHANDLE File() const;
 
 	int GetDataSize(int Index) const;
+	// can be called from several threads at once, as long as they load different indices
 	void *GetData(int Index);
 	void *GetDataSwapped(int Index); // makes sure that the data is 32bit LE ints when saved
 	const char *GetDataString(int Index);
@@ -97,6 +102,8 @@ class CDataFileWriter
 	enum
 	{
 		MAX_ITEM_TYPES = 0x10000,
+		// total uncompressed data size from which the data is compressed on several threads
+		COMPRESS_THREAD_MIN_SIZE = 256 * 1024,
 	};
 
 	IOHANDLE m_File;
@@ -108,6 +115,10 @@ class CDataFileWriter
 	int GetTypeFromIndex(int Index) const;
 	int GetExtendedItemTypeIndex(int Type);
 
+	static void CompressData(CDataInfo &DataInfo);
+	static void CompressThread(void *pUser);
+	void CompressDatas();
+
 public:
 	CDataFileWriter();
 	CDataFileWriter(CDataFileWriter &&Other)
@@ -123,9 +134,11 @@ public:
 
 	bool Open(class IStorage *pStorage, const char *pFilename, int StorageType = IStorage::TYPE_SAVE);
 	int AddItem(int Type, int ID, size_t Size, const void *pData);
+	// the data is compressed with the given zlib level in Finish
 	int AddData(size_t Size, const void *pData, int CompressionLevel = Z_DEFAULT_COMPRESSION);
 	int AddDataSwapped(size_t Size, const void *pData);
 	int AddDataString(const char *pStr);
+	// compresses the data on all cores, the file doesn't depend on the number of threads
 	void Finish();
 };
 
@@ -2,6 +2,7 @@
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 #include "huffman.h"
 #include <algorithm>
+#include <base/math.h>
 #include <base/system.h>
 
 const unsigned CHuffman::ms_aFreqTable[HUFFMAN_MAX_SYMBOLS] = {
@@ -125,79 +126,106 @@ void CHuffman::Init(const unsigned *pFrequencies)
 		if(k == HUFFMAN_LUTBITS)
 			m_apDecodeLut[i] = pNode;
 	}
+
+	ConstructMultiLut();
+}
+
+void CHuffman::ConstructMultiLut()
+{
+	m_MaxCodeBits = 0;
+	for(int i = 0; i < HUFFMAN_MAX_SYMBOLS; i++)
+		m_MaxCodeBits = maximum(m_MaxCodeBits, m_aNodes[i].m_NumBits);
+
+	const CNode *pEof = &m_aNodes[HUFFMAN_EOF_SYMBOL];
+	for(int i = 0; i < HUFFMAN_MULTI_LUTSIZE; i++)
+	{
+		CMultiEntry *pEntry = &m_aMultiDecodeLut[i];
+		mem_zero(pEntry, sizeof(*pEntry));
+
+		unsigned Bits = i;
+		unsigned Bitcount = HUFFMAN_MULTI_LUTBITS;
+		while(pEntry->m_NumSymbols < HUFFMAN_MULTI_SYMBOLS)
+		{
+			// walk the tree as far as the bits of the index go
+			const CNode *pNode = m_pStartNode;
+			unsigned Used = 0;
+			while(!pNode->m_NumBits && Used < Bitcount)
+			{
+				pNode = &m_aNodes[pNode->m_aLeafs[(Bits >> Used) & 1]];
+				Used++;
+			}
+
+			// the code continues past the index
+			if(!pNode->m_NumBits)
+				break;
+
+			Bits >>= Used;
+			Bitcount -= Used;
+			pEntry->m_NumBits += Used;
+
+			if(pNode == pEof)
+			{
+				pEntry->m_Eof = true;
+				break;
+			}
+			pEntry->m_aSymbols[pEntry->m_NumSymbols++] = pNode->m_Symbol;
+		}
+	}
 }
 
 //***************************************************************
 int CHuffman::Compress(const void *pInput, int InputSize, void *pOutput, int OutputSize) const
 {
-	// this macro loads a symbol for a byte into bits and bitcount
-#define HUFFMAN_MACRO_LOADSYMBOL(Sym) \
-	do \
-	{ \
-		Bits |= m_aNodes[Sym].m_Bits << Bitcount; \
-		Bitcount += m_aNodes[Sym].m_NumBits; \
-	} while(0)
-
-	// this macro writes the symbol stored in bits and bitcount to the dst pointer
-#define HUFFMAN_MACRO_WRITE() \
-	do \
-	{ \
-		while(Bitcount >= 8) \
-		{ \
-			*pDst++ = (unsigned char)(Bits & 0xff); \
-			if(pDst == pDstEnd) \
-				return -1; \
-			Bits >>= 8; \
-			Bitcount -= 8; \
-		} \
-	} while(0)
-
 	// setup buffer pointers
 	const unsigned char *pSrc = (const unsigned char *)pInput;
 	const unsigned char *pSrcEnd = pSrc + InputSize;
 	unsigned char *pDst = (unsigned char *)pOutput;
 	unsigned char *pDstEnd = pDst + OutputSize;
 
-	// symbol variables
-	unsigned Bits = 0;
+	// the codes are collected in a 64-bit word and written 32 bits at a
+	// time, there must always be room for the final byte
+	uint64_t Bits = 0;
 	unsigned Bitcount = 0;
 
-	// make sure that we have data that we want to compress
-	if(InputSize)
+	for(; pSrc != pSrcEnd; pSrc++)
 	{
-		// {A} load the first symbol
-		int Symbol = *pSrc++;
+		const CNode *pNode = &m_aNodes[*pSrc];
+		Bits |= (uint64_t)pNode->m_Bits << Bitcount;
+		Bitcount += pNode->m_NumBits;
 
-		while(pSrc != pSrcEnd)
+		if(Bitcount >= 32)
 		{
-			// {B} load the symbol
-			HUFFMAN_MACRO_LOADSYMBOL(Symbol);
-
-			// {C} fetch next symbol, this is done here because it will reduce dependency in the code
-			Symbol = *pSrc++;
-
-			// {B} write the symbol loaded at
-			HUFFMAN_MACRO_WRITE();
+			if(pDstEnd - pDst <= 4)
+				return -1;
+			pDst[0] = (unsigned char)Bits;
+			pDst[1] = (unsigned char)(Bits >> 8);
+			pDst[2] = (unsigned char)(Bits >> 16);
+			pDst[3] = (unsigned char)(Bits >> 24);
+			pDst += 4;
+			Bits >>= 32;
+			Bitcount -= 32;
 		}
-
-		// write the last symbol loaded from {C} or {A} in the case of only 1 byte input buffer
-		HUFFMAN_MACRO_LOADSYMBOL(Symbol);
-		HUFFMAN_MACRO_WRITE();
 	}
 
 	// write EOF symbol
-	HUFFMAN_MACRO_LOADSYMBOL(HUFFMAN_EOF_SYMBOL);
-	HUFFMAN_MACRO_WRITE();
+	Bits |= (uint64_t)m_aNodes[HUFFMAN_EOF_SYMBOL].m_Bits << Bitcount;
+	Bitcount += m_aNodes[HUFFMAN_EOF_SYMBOL].m_NumBits;
+	while(Bitcount >= 8)
+	{
+		if(pDstEnd - pDst <= 1)
+			return -1;
+		*pDst++ = (unsigned char)Bits;
+		Bits >>= 8;
+		Bitcount -= 8;
+	}
 
 	// write out the last bits
-	*pDst++ = Bits;
+	if(pDst == pDstEnd)
+		return -1;
+	*pDst++ = (unsigned char)Bits;
 
 	// return the size of the output
 	return (int)(pDst - (const unsigned char *)pOutput);
-
-	// remove macros
-#undef HUFFMAN_MACRO_LOADSYMBOL
-#undef HUFFMAN_MACRO_WRITE
 }
 
 //***************************************************************
@@ -205,13 +233,90 @@ int CHuffman::Decompress(const void *pInput, int InputSize, void *pOutput, int O
 {
 	// setup buffer pointers
 	unsigned char *pDst = (unsigned char *)pOutput;
-	unsigned char *pSrc = (unsigned char *)pInput;
+	const unsigned char *pSrc = (const unsigned char *)pInput;
 	unsigned char *pDstEnd = pDst + OutputSize;
-	unsigned char *pSrcEnd = pSrc + InputSize;
+	const unsigned char *pSrcEnd = pSrc + InputSize;
 
-	unsigned Bits = 0;
+	uint64_t Bits = 0;
 	unsigned Bitcount = 0;
 
+	// decode several symbols per lookup while the next code is completely
+	// in the bit buffer and there is room for all of them. the end is
+	// decoded symbol by symbol to keep the exact behavior on broken input
+	if(m_MaxCodeBits <= HUFFMAN_MULTI_MAX_CODEBITS)
+	{
+		const CNode *pEof = &m_aNodes[HUFFMAN_EOF_SYMBOL];
+		while(true)
+		{
+			if(pSrcEnd - pSrc >= 8)
+			{
+				// load 8 bytes, bytes that don't fit anymore are loaded again by the next refill
+				uint64_t Word = 0;
+				for(int i = 7; i >= 0; i--)
+					Word = (Word << 8) | pSrc[i];
+				Bits |= Word << Bitcount;
+				pSrc += (63 - Bitcount) >> 3;
+				Bitcount |= 56;
+			}
+			else
+			{
+				while(Bitcount <= 56 && pSrc != pSrcEnd)
+				{
+					Bits |= (uint64_t)(*pSrc++) << Bitcount;
+					Bitcount += 8;
+				}
+			}
+
+			if(Bitcount < m_MaxCodeBits || Bitcount < HUFFMAN_MULTI_LUTBITS || pDstEnd - pDst < HUFFMAN_MULTI_SYMBOLS)
+				break;
+
+			const CMultiEntry *pEntry = &m_aMultiDecodeLut[Bits & HUFFMAN_MULTI_LUTMASK];
+			if(!pEntry->m_NumSymbols && !pEntry->m_Eof)
+			{
+				// the code is longer than the LUT, walk the tree
+				const CNode *pNode = m_pStartNode;
+				do
+				{
+					pNode = &m_aNodes[pNode->m_aLeafs[Bits & 1]];
+					Bits >>= 1;
+					Bitcount--;
+				} while(!pNode->m_NumBits);
+
+				if(pNode == pEof)
+					return (int)(pDst - (const unsigned char *)pOutput);
+				*pDst++ = pNode->m_Symbol;
+				continue;
+			}
+
+			// always copy all symbols, there is room for them
+			pDst[0] = pEntry->m_aSymbols[0];
+			pDst[1] = pEntry->m_aSymbols[1];
+			pDst[2] = pEntry->m_aSymbols[2];
+			pDst += pEntry->m_NumSymbols;
+			Bits >>= pEntry->m_NumBits;
+			Bitcount -= pEntry->m_NumBits;
+
+			if(pEntry->m_Eof)
+				return (int)(pDst - (const unsigned char *)pOutput);
+		}
+
+		// give the whole bytes back to the input
+		pSrc -= Bitcount / 8;
+		Bitcount %= 8;
+		Bits &= (1u << Bitcount) - 1;
+	}
+
+	int Size = DecompressTail(pSrc, pSrcEnd, pDst, pDstEnd, (unsigned)Bits, Bitcount);
+	if(Size < 0)
+		return -1;
+	return (int)(pDst - (const unsigned char *)pOutput) + Size;
+}
+
+//***************************************************************
+int CHuffman::DecompressTail(const unsigned char *pSrc, const unsigned char *pSrcEnd, unsigned char *pDst, unsigned char *pDstEnd, unsigned Bits, unsigned Bitcount) const
+{
+	unsigned char *pDstStart = pDst;
+
 	const CNode *pEof = &m_aNodes[HUFFMAN_EOF_SYMBOL];
 
 	while(true)
@@ -278,6 +383,6 @@ int CHuffman::Decompress(const void *pInput, int InputSize, void *pOutput, int O
 		*pDst++ = pNode->m_Symbol;
 	}
 
-	// return the size of the decompressed buffer
-	return (int)(pDst - (const unsigned char *)pOutput);
+	// return the size of the decompressed data
+	return (int)(pDst - pDstStart);
 }
@@ -14,7 +14,16 @@ class CHuffman
 
 		HUFFMAN_LUTBITS = 10,
 		HUFFMAN_LUTSIZE = (1 << HUFFMAN_LUTBITS),
-		HUFFMAN_LUTMASK = (HUFFMAN_LUTSIZE - 1)
+		HUFFMAN_LUTMASK = (HUFFMAN_LUTSIZE - 1),
+
+		// the multi-symbol LUT decodes up to HUFFMAN_MULTI_SYMBOLS symbols per lookup
+		HUFFMAN_MULTI_LUTBITS = 11,
+		HUFFMAN_MULTI_LUTSIZE = (1 << HUFFMAN_MULTI_LUTBITS),
+		HUFFMAN_MULTI_LUTMASK = (HUFFMAN_MULTI_LUTSIZE - 1),
+		HUFFMAN_MULTI_SYMBOLS = 3,
+
+		// longest code that still allows the multi-symbol decoding
+		HUFFMAN_MULTI_MAX_CODEBITS = 24,
 	};
 
 	struct CNode
@@ -30,17 +39,33 @@ class CHuffman
 		unsigned char m_Symbol;
 	};
 
-	static const unsigned ms_aFreqTable[HUFFMAN_MAX_SYMBOLS];
+	struct CMultiEntry
+	{
+		unsigned char m_aSymbols[HUFFMAN_MULTI_SYMBOLS];
+		// 0 if the first code is longer than the LUT
+		unsigned char m_NumSymbols;
+		unsigned char m_NumBits;
+		// the symbols are followed by the EOF symbol
+		bool m_Eof;
+	};
 
 	CNode m_aNodes[HUFFMAN_MAX_NODES];
 	CNode *m_apDecodeLut[HUFFMAN_LUTSIZE];
 	CNode *m_pStartNode;
 	int m_NumNodes;
 
+	CMultiEntry m_aMultiDecodeLut[HUFFMAN_MULTI_LUTSIZE];
+	unsigned m_MaxCodeBits;
+
 	void Setbits_r(CNode *pNode, int Bits, unsigned Depth);
 	void ConstructTree(const unsigned *pFrequencies);
+	void ConstructMultiLut();
+	int DecompressTail(const unsigned char *pSrc, const unsigned char *pSrcEnd, unsigned char *pDst, unsigned char *pDstEnd, unsigned Bits, unsigned Bitcount) const;
 
 public:
+	// byte frequencies of the network traffic, used by default
+	static const unsigned ms_aFreqTable[HUFFMAN_MAX_SYMBOLS];
+
 	/*
 		Function: Init
 			Inits the compressor/decompressor.
@@ -0,0 +1,266 @@
+#include "imagecache.h"
+
+#include <engine/storage.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+static const char IMAGE_CACHE_MAGIC[4] = {'I', 'M', 'G', 'C'};
+
+enum
+{
+	IMAGE_CACHE_VERSION = 2,
+	// larger images are likely broken entries
+	IMAGE_CACHE_MAX_SIZE = 16384,
+	// temporary files this old are left over from interrupted writes
+	IMAGE_CACHE_TMP_MAX_AGE = 60 * 60,
+};
+
+// followed by the image data, the size keeps the data 8 byte aligned
+struct CImageCacheHeader
+{
+	char m_aMagic[sizeof(IMAGE_CACHE_MAGIC)];
+	int32_t m_Version;
+	int64_t m_SourceSize;
+	int64_t m_SourceModified;
+	unsigned char m_aSourceHash[SHA256_DIGEST_LENGTH];
+	int32_t m_Width;
+	int32_t m_Height;
+	int32_t m_Format;
+	int32_t m_Flags;
+	// to find the entries of deleted sources
+	char m_aSourcePath[IO_MAX_PATH_LENGTH];
+};
+static_assert(sizeof(CImageCacheHeader) % 8 == 0, "image data must stay 8 byte aligned");
+
+// reads the header and checks that the entry is complete, returns the size of the image data or 0
+static size_t ReadHeader(IOHANDLE File, CImageCacheHeader *pHeader)
+{
+	const long Length = io_length(File);
+	if(Length < 0 || io_read(File, pHeader, sizeof(*pHeader)) != sizeof(*pHeader) ||
+		mem_comp(pHeader->m_aMagic, IMAGE_CACHE_MAGIC, sizeof(pHeader->m_aMagic)) != 0 ||
+		pHeader->m_Version != IMAGE_CACHE_VERSION ||
+		CImageInfo::ImageFormatFromInt(pHeader->m_Format) == CImageInfo::FORMAT_ERROR ||
+		pHeader->m_Width <= 0 || pHeader->m_Width > IMAGE_CACHE_MAX_SIZE ||
+		pHeader->m_Height <= 0 || pHeader->m_Height > IMAGE_CACHE_MAX_SIZE)
+		return 0;
+	pHeader->m_aSourcePath[sizeof(pHeader->m_aSourcePath) - 1] = '\0';
+	const size_t DataSize = (size_t)pHeader->m_Width * pHeader->m_Height * CImageInfo::PixelSize(CImageInfo::ImageFormatFromInt(pHeader->m_Format));
+	return (size_t)Length == sizeof(*pHeader) + DataSize ? DataSize : 0;
+}
+
+void CImageCache::CSource::Init(const char *pCompletePath, IOHANDLE File)
+{
+	str_copy(m_aPath, pCompletePath);
+	m_Size = io_length(File);
+	time_t Created, Modified;
+	m_Modified = fs_file_time(pCompletePath, &Created, &Modified) == 0 ? (int64_t)Modified : -1;
+	m_Hash = SHA256_ZEROED;
+}
+
+bool CImageCache::CSource::ReadHash()
+{
+	IOHANDLE File = io_open(m_aPath, IOFLAG_READ);
+	if(!File)
+		return false;
+	void *pData;
+	unsigned Size;
+	io_read_all(File, &pData, &Size);
+	io_close(File);
+	m_Hash = sha256(pData, Size);
+	free(pData);
+	return true;
+}
+
+void CImageCache::Init(IStorage *pStorage)
+{
+	m_pStorage = pStorage;
+	m_pStorage->CreateFolder("cache", IStorage::TYPE_SAVE);
+	m_pStorage->CreateFolder("cache/images", IStorage::TYPE_SAVE);
+}
+
+void CImageCache::EntryPath(const CSource &Source, const char *pVariant, char *pBuffer, int BufferSize) const
+{
+	char aKey[IO_MAX_PATH_LENGTH + 64];
+	str_format(aKey, sizeof(aKey), "%s\n%s", Source.m_aPath, pVariant);
+	char aHash[SHA256_MAXSTRSIZE];
+	sha256_str(sha256(aKey, str_length(aKey)), aHash, sizeof(aHash));
+	str_format(pBuffer, BufferSize, "cache/images/%s.img", aHash);
+}
+
+bool CImageCache::Load(const CSource &Source, const char *pVariant, CImageInfo *pImg, int *pFlags)
+{
+	if(!m_pStorage || Source.m_Modified < 0)
+		return false;
+
+	char aPath[IO_MAX_PATH_LENGTH];
+	EntryPath(Source, pVariant, aPath, sizeof(aPath));
+	IOHANDLE File = m_pStorage->OpenFile(aPath, IOFLAG_READ, IStorage::TYPE_SAVE);
+	if(!File)
+		return false;
+
+	CImageCacheHeader Header;
+	const size_t DataSize = ReadHeader(File, &Header);
+	if(DataSize == 0)
+	{
+		io_close(File);
+		return false;
+	}
+
+	const bool SameFile = Header.m_SourceSize == Source.m_Size && Header.m_SourceModified == Source.m_Modified;
+	const bool SameContent = Source.m_Hash != SHA256_ZEROED && mem_comp(Header.m_aSourceHash, Source.m_Hash.data, sizeof(Header.m_aSourceHash)) == 0;
+	if(!SameFile && !SameContent)
+	{
+		io_close(File);
+		return false;
+	}
+
+	void *pData = malloc(DataSize);
+	const bool Read = io_read(File, pData, DataSize) == DataSize;
+	io_close(File);
+	if(!Read)
+	{
+		free(pData);
+		return false;
+	}
+
+	pImg->m_Width = Header.m_Width;
+	pImg->m_Height = Header.m_Height;
+	pImg->m_Format = CImageInfo::ImageFormatFromInt(Header.m_Format);
+	pImg->m_pData = pData;
+	if(pFlags)
+		*pFlags = Header.m_Flags;
+
+	// the source was touched but has the same content, remember its new size and time
+	if(!SameFile)
+		Store(Source, pVariant, *pImg, Header.m_Flags);
+	return true;
+}
+
+bool CImageCache::Store(const CSource &Source, const char *pVariant, const CImageInfo &Img, int Flags)
+{
+	if(!m_pStorage || Source.m_Modified < 0 || !Img.m_pData || Img.m_Format == CImageInfo::FORMAT_ERROR)
+		return false;
+
+	CImageCacheHeader Header;
+	mem_zero(&Header, sizeof(Header));
+	mem_copy(Header.m_aMagic, IMAGE_CACHE_MAGIC, sizeof(Header.m_aMagic));
+	Header.m_Version = IMAGE_CACHE_VERSION;
+	Header.m_SourceSize = Source.m_Size;
+	Header.m_SourceModified = Source.m_Modified;
+	mem_copy(Header.m_aSourceHash, Source.m_Hash.data, sizeof(Header.m_aSourceHash));
+	Header.m_Width = Img.m_Width;
+	Header.m_Height = Img.m_Height;
+	Header.m_Format = Img.m_Format;
+	Header.m_Flags = Flags;
+	str_copy(Header.m_aSourcePath, Source.m_aPath);
+
+	// images can be stored from several threads, never let a reader see a partial entry
+	static std::atomic<int> s_NextTmp{0};
+	char aPath[IO_MAX_PATH_LENGTH];
+	EntryPath(Source, pVariant, aPath, sizeof(aPath));
+	char aTmpPath[IO_MAX_PATH_LENGTH];
+	str_format(aTmpPath, sizeof(aTmpPath), "%s.%d.%d.tmp", aPath, pid(), s_NextTmp.fetch_add(1));
+
+	IOHANDLE File = m_pStorage->OpenFile(aTmpPath, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	if(!File)
+		return false;
+	const size_t DataSize = (size_t)Img.m_Width * Img.m_Height * Img.PixelSize();
+	const bool Written = io_write(File, &Header, sizeof(Header)) == sizeof(Header) && io_write(File, Img.m_pData, DataSize) == DataSize;
+	io_close(File);
+	if(!Written || !m_pStorage->RenameFile(aTmpPath, aPath, IStorage::TYPE_SAVE))
+	{
+		m_pStorage->RemoveFile(aTmpPath, IStorage::TYPE_SAVE);
+		return false;
+	}
+	return true;
+}
+
+bool CImageCache::FindSource(const char *pFilename, int StorageType, CSource *pSource)
+{
+	if(!m_pStorage)
+		return false;
+
+	char aCompletePath[IO_MAX_PATH_LENGTH];
+	IOHANDLE File = m_pStorage->OpenFile(pFilename, IOFLAG_READ, StorageType, aCompletePath, sizeof(aCompletePath));
+	if(!File)
+		return false;
+	pSource->Init(aCompletePath, File);
+	io_close(File);
+	return true;
+}
+
+struct SImageCacheEntry
+{
+	std::string m_Name;
+	time_t m_Modified;
+	int64_t m_Size;
+};
+
+void CImageCache::Prune(int64_t MaxSize)
+{
+	if(!m_pStorage)
+		return;
+
+	std::vector<SImageCacheEntry> vEntries;
+	m_pStorage->ListDirectoryInfo(
+		IStorage::TYPE_SAVE, "cache/images", [](const CFsFileInfo *pInfo, int IsDir, int DirType, void *pUser) {
+			if(!IsDir)
+				((std::vector<SImageCacheEntry> *)pUser)->push_back({pInfo->m_pName, pInfo->m_TimeModified, 0});
+			return 0;
+		},
+		&vEntries);
+
+	const time_t Now = time_timestamp();
+	int64_t TotalSize = 0;
+	for(auto It = vEntries.begin(); It != vEntries.end();)
+	{
+		char aPath[IO_MAX_PATH_LENGTH];
+		str_format(aPath, sizeof(aPath), "cache/images/%s", It->m_Name.c_str());
+		bool Keep = false;
+		if(str_endswith(aPath, ".img"))
+		{
+			IOHANDLE File = m_pStorage->OpenFile(aPath, IOFLAG_READ, IStorage::TYPE_SAVE);
+			if(File)
+			{
+				CImageCacheHeader Header;
+				const size_t DataSize = ReadHeader(File, &Header);
+				io_close(File);
+				Keep = DataSize > 0 && fs_is_file(Header.m_aSourcePath);
+				It->m_Size = sizeof(Header) + DataSize;
+			}
+		}
+		else if(str_endswith(aPath, ".tmp"))
+		{
+			// another client could still be writing it
+			Keep = Now - It->m_Modified < IMAGE_CACHE_TMP_MAX_AGE;
+		}
+
+		if(Keep)
+		{
+			TotalSize += It->m_Size;
+			++It;
+		}
+		else
+		{
+			m_pStorage->RemoveFile(aPath, IStorage::TYPE_SAVE);
+			It = vEntries.erase(It);
+		}
+	}
+
+	// entries are rewritten when their source changes, so the oldest ones are the least recently written
+	std::sort(vEntries.begin(), vEntries.end(), [](const SImageCacheEntry &A, const SImageCacheEntry &B) { return A.m_Modified < B.m_Modified; });
+	for(const SImageCacheEntry &Entry : vEntries)
+	{
+		if(TotalSize <= MaxSize)
+			break;
+		if(Entry.m_Size == 0)
+			continue;
+		char aPath[IO_MAX_PATH_LENGTH];
+		str_format(aPath, sizeof(aPath), "cache/images/%s", Entry.m_Name.c_str());
+		if(m_pStorage->RemoveFile(aPath, IStorage::TYPE_SAVE))
+			TotalSize -= Entry.m_Size;
+	}
+}
@@ -0,0 +1,79 @@
+#ifndef ENGINE_SHARED_IMAGECACHE_H
+#define ENGINE_SHARED_IMAGECACHE_H
+
+#include <base/hash.h>
+#include <base/system.h>
+
+#include <engine/graphics.h>
+
+class IStorage;
+
+/*
+	Class: Image Cache
+		Keeps decoded and processed images in the save directory, so that
+		they don't have to be decoded again on every start.
+
+		An entry is the raw image data behind a fixed size header, so it
+		can be read straight into the image buffer. Entries are keyed by
+		the complete path of the source file and a variant name. They are
+		valid while the size and modification time of the source match, or
+		otherwise while its content hash matches. Prune bounds the size of
+		the cache.
+*/
+class CImageCache
+{
+public:
+	// the file an image was loaded from
+	struct CSource
+	{
+		char m_aPath[IO_MAX_PATH_LENGTH];
+		int64_t m_Size;
+		int64_t m_Modified;
+		// SHA256_ZEROED if the content was not read
+		SHA256_DIGEST m_Hash;
+
+		void Init(const char *pCompletePath, IOHANDLE File);
+		// reads the file to fill m_Hash
+		bool ReadHash();
+	};
+
+private:
+	IStorage *m_pStorage = nullptr;
+
+	void EntryPath(const CSource &Source, const char *pVariant, char *pBuffer, int BufferSize) const;
+
+public:
+	void Init(IStorage *pStorage);
+	bool Enabled() const { return m_pStorage != nullptr; }
+
+	/*
+		Function: Load
+			Reads the cached image, the returned data has to be freed
+			with free.
+
+		Arguments:
+			Source - The file the image was loaded from.
+			pVariant - Name of the processed variant, "" for the plain image.
+			pImg - Receives the image.
+			pFlags - Receives the flags the entry was stored with.
+
+		Returns:
+			Whether the cache had a valid entry.
+	*/
+	bool Load(const CSource &Source, const char *pVariant, CImageInfo *pImg, int *pFlags = nullptr);
+	// Flags are returned by Load, e.g. the pnglite incompatibilities of the source
+	bool Store(const CSource &Source, const char *pVariant, const CImageInfo &Img, int Flags = 0);
+
+	/*
+		Function: Prune
+			Removes invalid entries, entries of deleted sources and
+			leftovers of interrupted writes, then the least recently
+			written entries until the cache fits into MaxSize bytes.
+	*/
+	void Prune(int64_t MaxSize);
+
+	// opens the file to find its size and modification time, without hashing it
+	bool FindSource(const char *pFilename, int StorageType, CSource *pSource);
+};
+
+#endif
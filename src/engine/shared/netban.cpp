@@ -169,6 +169,7 @@ void CNetBan::CBanPool<T, HashCount>::Update(CBan<CDataType> *pBan, const CBanIn
 
 void CNetBan::UnbanAll()
 {
+	const std::lock_guard<std::mutex> Lock(m_PoolLock);
 	m_BanAddrPool.Reset();
 	m_BanRangePool.Reset();
 }
@@ -225,6 +226,7 @@ int CNetBan::Ban(T *pBanPool, const typename T::CDataType *pData, int Seconds, c
 	str_copy(Info.m_aReason, pReason);
 
 	// check if it already exists
+	const std::lock_guard<std::mutex> Lock(m_PoolLock);
 	CNetHash NetHash(pData);
 	CBan<typename T::CDataType> *pBan = pBanPool->Find(pData, &NetHash);
 	if(pBan)
@@ -254,6 +256,7 @@ int CNetBan::Ban(T *pBanPool, const typename T::CDataType *pData, int Seconds, c
 template<class T>
 int CNetBan::Unban(T *pBanPool, const typename T::CDataType *pData)
 {
+	const std::lock_guard<std::mutex> Lock(m_PoolLock);
 	CNetHash NetHash(pData);
 	CBan<typename T::CDataType> *pBan = pBanPool->Find(pData, &NetHash);
 	if(pBan)
@@ -293,6 +296,7 @@ void CNetBan::Update()
 	int Now = time_timestamp();
 
 	// remove expired bans
+	const std::lock_guard<std::mutex> Lock(m_PoolLock);
 	char aBuf[256], aNetStr[256];
 	while(m_BanAddrPool.First() && m_BanAddrPool.First()->m_Info.m_Expires != CBanInfo::EXPIRES_NEVER && m_BanAddrPool.First()->m_Info.m_Expires < Now)
 	{
@@ -340,6 +344,7 @@ int CNetBan::UnbanByIndex(int Index)
 {
 	int Result;
 	char aBuf[256];
+	std::unique_lock<std::mutex> Lock(m_PoolLock);
 	CBanAddr *pBan = m_BanAddrPool.Get(Index);
 	if(pBan)
 	{
@@ -360,6 +365,7 @@ int CNetBan::UnbanByIndex(int Index)
 			return -1;
 		}
 	}
+	Lock.unlock();
 
 	char aMsg[256];
 	str_format(aMsg, sizeof(aMsg), "unbanned index %i (%s)", Index, aBuf);
@@ -380,6 +386,8 @@ bool CNetBan::IsBanned(const NETADDR *pOrigAddr, char *pBuf, unsigned BufferSize
 	CNetHash aHash[17];
 	int Length = CNetHash::MakeHashArray(pAddr, aHash);
 
+	const std::lock_guard<std::mutex> Lock(m_PoolLock);
+
 	// check ban addresses
 	CBanAddr *pBan = m_BanAddrPool.Find(pAddr, &aHash[Length]);
 	if(pBan)
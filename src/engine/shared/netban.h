@@ -5,6 +5,8 @@
 
 #include <base/system.h>
 
+#include <mutex>
+
 inline int NetComp(const NETADDR *pAddr1, const NETADDR *pAddr2)
 {
 	return mem_comp(pAddr1, pAddr2, pAddr1->type == NETTYPE_IPV4 ? 8 : 20);
@@ -161,6 +163,10 @@ protected:
 	CBanRangePool m_BanRangePool;
 	NETADDR m_LocalhostIPV4, m_LocalhostIPV6;
 
+	// the pools are only changed on the main thread, but IsBanned is also
+	// called from the server's network threads
+	mutable std::mutex m_PoolLock;
+
 public:
 	enum
 	{
@@ -11,6 +11,7 @@
 
 class CHuffman;
 class CNetBan;
+class CNetServerFrontend;
 class CPacker;
 
 /*
@@ -344,6 +345,20 @@ public:
 	int FetchChunk(CNetChunk *pChunk);
 };
 
+// packet that was received, ban checked and unpacked on a front-end thread
+class CNetRecvPacket
+{
+public:
+	NETADDR m_Addr;
+	bool m_Banned; // m_aData holds the ban message
+	bool m_Sixup;
+	SECURITY_TOKEN m_Token;
+	SECURITY_TOKEN m_ResponseToken;
+	int m_Bytes;
+	unsigned char m_aData[NET_MAX_PACKETSIZE];
+	CNetPacketConstruct m_Packet;
+};
+
 // server side
 class CNetServer
 {
@@ -385,6 +400,11 @@ class CNetServer
 
 	CNetRecvUnpacker m_RecvUnpacker;
 
+	// with front-end threads, the packets are received on several
+	// SO_REUSEPORT sockets and only the parsed packets reach Recv
+	CNetServerFrontend *m_pFrontend;
+	CNetRecvPacket m_FrontendPacket;
+
 	void OnTokenCtrlMsg(NETADDR &Addr, int ControlMsg, const CNetPacketConstruct &Packet);
 	int OnSixupCtrlMsg(NETADDR &Addr, CNetChunk *pChunk, int ControlMsg, const CNetPacketConstruct &Packet, SECURITY_TOKEN &ResponseToken, SECURITY_TOKEN Token);
 	void OnPreConnMsg(NETADDR &Addr, CNetPacketConstruct &Packet);
@@ -403,13 +423,15 @@ public:
 	int SetCallbacks(NETFUNC_NEWCLIENT pfnNewClient, NETFUNC_NEWCLIENT_NOAUTH pfnNewClientNoAuth, NETFUNC_CLIENTREJOIN pfnClientRejoin, NETFUNC_DELCLIENT pfnDelClient, void *pUser);
 
 	//
-	bool Open(NETADDR BindAddr, CNetBan *pNetBan, int MaxClients, int MaxClientsPerIP);
+	bool Open(NETADDR BindAddr, CNetBan *pNetBan, int MaxClients, int MaxClientsPerIP, int NumFrontendThreads = 0);
 	int Close();
 
 	//
 	int Recv(CNetChunk *pChunk, SECURITY_TOKEN *pResponseToken);
 	int Send(CNetChunk *pChunk);
 	int Update();
+	// waits up to Microseconds for incoming packets, returns whether there are any
+	bool Wait(int Microseconds);
 
 	//
 	int Drop(int ClientID, const char *pReason);
@@ -2,6 +2,7 @@
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 #include <base/hash_ctxt.h>
 #include <base/system.h>
+#include <base/tl/threading.h>
 
 #include "config.h"
 #include "netban.h"
@@ -10,6 +11,12 @@
 #include <engine/shared/packer.h>
 #include <engine/shared/protocol.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 const int g_DummyMapCrc = 0xD6909B17;
 const unsigned char g_aDummyMapData[] = {
 	0x44, 0x41, 0x54, 0x41, 0x04, 0x00, 0x00, 0x00, 0xFA, 0x00, 0x00, 0x00,
@@ -41,13 +48,180 @@ static SECURITY_TOKEN ToSecurityToken(const unsigned char *pData)
 	return (int)pData[0] | (pData[1] << 8) | (pData[2] << 16) | (pData[3] << 24);
 }
 
-bool CNetServer::Open(NETADDR BindAddr, CNetBan *pNetBan, int MaxClients, int MaxClientsPerIP)
+// receives the packets on one thread per SO_REUSEPORT socket, so that
+// floods of connless or banned traffic don't cost tick time
+class CNetServerFrontend
+{
+	enum
+	{
+		QUEUE_SIZE = 256,
+	};
+
+	struct CWorker
+	{
+		CNetServerFrontend *m_pFrontend;
+		NETSOCKET m_Socket;
+		void *m_pThread;
+		CSpscQueue<CNetRecvPacket, QUEUE_SIZE> m_Queue;
+	};
+
+	CNetServer *m_pNetServer;
+	std::vector<std::unique_ptr<CWorker>> m_vpWorkers;
+	unsigned m_NextWorker = 0;
+	std::atomic_bool m_Shutdown{false};
+	std::atomic_bool m_PacketsPending{false};
+	std::mutex m_WaitMutex;
+	std::condition_variable m_WaitCondition;
+
+	static void WorkerThread(void *pUser);
+	bool ReceivePacket(CWorker *pWorker, CNetRecvPacket *pPacket);
+
+public:
+	CNetServerFrontend(CNetServer *pNetServer) :
+		m_pNetServer(pNetServer) {}
+	~CNetServerFrontend();
+
+	// the first worker receives on the server's socket, the others get
+	// their own sockets bound to the same address
+	bool Start(NETADDR BindAddr, int NumThreads);
+	bool Fetch(CNetRecvPacket *pPacket);
+	bool Wait(int Microseconds);
+};
+
+CNetServerFrontend::~CNetServerFrontend()
+{
+	m_Shutdown.store(true);
+	for(size_t i = 0; i < m_vpWorkers.size(); i++)
+	{
+		if(m_vpWorkers[i]->m_pThread)
+			thread_wait(m_vpWorkers[i]->m_pThread);
+		if(i > 0)
+			net_udp_close(m_vpWorkers[i]->m_Socket);
+	}
+}
+
+bool CNetServerFrontend::Start(NETADDR BindAddr, int NumThreads)
+{
+	for(int i = 0; i < NumThreads; i++)
+	{
+		std::unique_ptr<CWorker> pWorker = std::make_unique<CWorker>();
+		pWorker->m_pFrontend = this;
+		pWorker->m_Socket = i == 0 ? m_pNetServer->Socket() : net_udp_create(BindAddr, 1);
+		pWorker->m_pThread = nullptr;
+		if(!pWorker->m_Socket)
+			return false;
+		m_vpWorkers.push_back(std::move(pWorker));
+	}
+
+	for(auto &pWorker : m_vpWorkers)
+		pWorker->m_pThread = thread_init(WorkerThread, pWorker.get(), "net recv");
+	return true;
+}
+
+void CNetServerFrontend::WorkerThread(void *pUser)
+{
+	CWorker *pWorker = (CWorker *)pUser;
+	CNetServerFrontend *pThis = pWorker->m_pFrontend;
+
+	while(!pThis->m_Shutdown.load())
+	{
+		CNetRecvPacket *pPacket = pWorker->m_Queue.Back();
+		if(!pPacket)
+		{
+			// the tick thread can't keep up, make room by dropping packets
+			CNetRecvPacket Dropped;
+			while(pThis->ReceivePacket(pWorker, &Dropped))
+				;
+			net_socket_read_wait(pWorker->m_Socket, 1000);
+			continue;
+		}
+
+		if(!pThis->ReceivePacket(pWorker, pPacket))
+		{
+			// wake up regularly to check for shutdown
+			net_socket_read_wait(pWorker->m_Socket, 100000);
+			continue;
+		}
+
+		pWorker->m_Queue.Push();
+		if(!pThis->m_PacketsPending.exchange(true))
+		{
+			const std::lock_guard<std::mutex> Lock(pThis->m_WaitMutex);
+			pThis->m_WaitCondition.notify_one();
+		}
+	}
+}
+
+bool CNetServerFrontend::ReceivePacket(CWorker *pWorker, CNetRecvPacket *pPacket)
+{
+	while(true)
+	{
+		unsigned char *pData;
+		int Bytes = net_udp_recv(pWorker->m_Socket, &pPacket->m_Addr, &pData);
+
+		// no more packets for now
+		if(Bytes <= 0)
+			return false;
+
+		// check if we just should drop the packet
+		CNetBan *pNetBan = m_pNetServer->NetBan();
+		if(pNetBan && pNetBan->IsBanned(&pPacket->m_Addr, (char *)pPacket->m_aData, sizeof(pPacket->m_aData)))
+		{
+			// the reply is sent from the tick thread which owns the send queue
+			pPacket->m_Banned = true;
+			return true;
+		}
+
+		// keep the raw data in case it has to be unpacked again for 0.7 clients
+		pPacket->m_Banned = false;
+		pPacket->m_Bytes = minimum(Bytes, (int)sizeof(pPacket->m_aData));
+		mem_copy(pPacket->m_aData, pData, pPacket->m_Bytes);
+
+		pPacket->m_Sixup = false;
+		pPacket->m_ResponseToken = NET_SECURITY_TOKEN_UNKNOWN;
+		if(CNetBase::UnpackPacket(pData, Bytes, &pPacket->m_Packet, pPacket->m_Sixup, &pPacket->m_Token, &pPacket->m_ResponseToken) != 0)
+			continue;
+
+		if(pPacket->m_Packet.m_Flags & NET_PACKETFLAG_CONNLESS && pPacket->m_Sixup &&
+			pPacket->m_Token != m_pNetServer->GetToken(pPacket->m_Addr) && pPacket->m_Token != m_pNetServer->GetGlobalToken())
+			continue;
+
+		return true;
+	}
+}
+
+bool CNetServerFrontend::Fetch(CNetRecvPacket *pPacket)
+{
+	for(size_t i = 0; i < m_vpWorkers.size(); i++)
+	{
+		CWorker *pWorker = m_vpWorkers[m_NextWorker].get();
+		m_NextWorker = (m_NextWorker + 1) % m_vpWorkers.size();
+
+		CNetRecvPacket *pFront = pWorker->m_Queue.Front();
+		if(pFront)
+		{
+			*pPacket = *pFront;
+			pWorker->m_Queue.Pop();
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CNetServerFrontend::Wait(int Microseconds)
+{
+	std::unique_lock<std::mutex> Lock(m_WaitMutex);
+	m_WaitCondition.wait_for(Lock, std::chrono::microseconds(Microseconds), [this]() { return m_PacketsPending.load(); });
+	return m_PacketsPending.exchange(false);
+}
+
+bool CNetServer::Open(NETADDR BindAddr, CNetBan *pNetBan, int MaxClients, int MaxClientsPerIP, int NumFrontendThreads)
 {
 	// zero out the whole structure
 	mem_zero(this, sizeof(*this));
 
 	// open socket
-	m_Socket = net_udp_create(BindAddr);
+	m_Socket = net_udp_create(BindAddr, NumFrontendThreads > 0);
 	if(!m_Socket)
 		return false;
 
@@ -68,6 +242,17 @@ bool CNetServer::Open(NETADDR BindAddr, CNetBan *pNetBan, int MaxClients, int Ma
 	for(auto &Slot : m_aSlots)
 		Slot.m_Connection.Init(m_Socket, true);
 
+	if(NumFrontendThreads > 0)
+	{
+		m_pFrontend = new CNetServerFrontend(this);
+		if(!m_pFrontend->Start(BindAddr, NumFrontendThreads))
+		{
+			dbg_msg("netserver", "couldn't start the network threads, receiving on the main thread");
+			delete m_pFrontend;
+			m_pFrontend = nullptr;
+		}
+	}
+
 	return true;
 }
 
@@ -93,6 +278,8 @@ int CNetServer::Close()
 {
 	if(!m_Socket)
 		return 0;
+	delete m_pFrontend;
+	m_pFrontend = nullptr;
 	return net_udp_close(m_Socket);
 }
 
@@ -625,96 +812,122 @@ int CNetServer::Recv(CNetChunk *pChunk, SECURITY_TOKEN *pResponseToken)
 		if(m_RecvUnpacker.FetchChunk(pChunk))
 			return 1;
 
-		// TODO: empty the recvinfo
 		unsigned char *pData;
-		int Bytes = net_udp_recv(m_Socket, &Addr, &pData);
+		int Bytes;
+		SECURITY_TOKEN Token;
+		bool Sixup = false;
+		*pResponseToken = NET_SECURITY_TOKEN_UNKNOWN;
 
-		// no more packets for now
-		if(Bytes <= 0)
-			break;
+		if(m_pFrontend)
+		{
+			// received, ban checked and unpacked on a front-end thread
+			if(!m_pFrontend->Fetch(&m_FrontendPacket))
+				break;
 
-		// check if we just should drop the packet
-		char aBuf[128];
-		if(NetBan() && NetBan()->IsBanned(&Addr, aBuf, sizeof(aBuf)))
+			Addr = m_FrontendPacket.m_Addr;
+			if(m_FrontendPacket.m_Banned)
+			{
+				const char *pReason = (const char *)m_FrontendPacket.m_aData;
+				CNetBase::SendControlMsg(m_Socket, &Addr, 0, NET_CTRLMSG_CLOSE, pReason, str_length(pReason) + 1, NET_SECURITY_TOKEN_UNSUPPORTED);
+				continue;
+			}
+
+			pData = m_FrontendPacket.m_aData;
+			Bytes = m_FrontendPacket.m_Bytes;
+			Sixup = m_FrontendPacket.m_Sixup;
+			Token = m_FrontendPacket.m_Token;
+			*pResponseToken = m_FrontendPacket.m_ResponseToken;
+			m_RecvUnpacker.m_Data = m_FrontendPacket.m_Packet;
+		}
+		else
 		{
-			// banned, reply with a message
-			CNetBase::SendControlMsg(m_Socket, &Addr, 0, NET_CTRLMSG_CLOSE, aBuf, str_length(aBuf) + 1, NET_SECURITY_TOKEN_UNSUPPORTED);
-			continue;
+			// TODO: empty the recvinfo
+			Bytes = net_udp_recv(m_Socket, &Addr, &pData);
+
+			// no more packets for now
+			if(Bytes <= 0)
+				break;
+
+			// check if we just should drop the packet
+			char aBuf[128];
+			if(NetBan() && NetBan()->IsBanned(&Addr, aBuf, sizeof(aBuf)))
+			{
+				// banned, reply with a message
+				CNetBase::SendControlMsg(m_Socket, &Addr, 0, NET_CTRLMSG_CLOSE, aBuf, str_length(aBuf) + 1, NET_SECURITY_TOKEN_UNSUPPORTED);
+				continue;
+			}
+
+			if(CNetBase::UnpackPacket(pData, Bytes, &m_RecvUnpacker.m_Data, Sixup, &Token, pResponseToken) != 0)
+				continue;
+
+			if(m_RecvUnpacker.m_Data.m_Flags & NET_PACKETFLAG_CONNLESS && Sixup && Token != GetToken(Addr) && Token != GetGlobalToken())
+				continue;
 		}
 
-		SECURITY_TOKEN Token;
-		bool Sixup = false;
-		*pResponseToken = NET_SECURITY_TOKEN_UNKNOWN;
-		if(CNetBase::UnpackPacket(pData, Bytes, &m_RecvUnpacker.m_Data, Sixup, &Token, pResponseToken) == 0)
+		if(m_RecvUnpacker.m_Data.m_Flags & NET_PACKETFLAG_CONNLESS)
 		{
-			if(m_RecvUnpacker.m_Data.m_Flags & NET_PACKETFLAG_CONNLESS)
+			pChunk->m_Flags = NETSENDFLAG_CONNLESS;
+			pChunk->m_ClientID = -1;
+			pChunk->m_Address = Addr;
+			pChunk->m_DataSize = m_RecvUnpacker.m_Data.m_DataSize;
+			pChunk->m_pData = m_RecvUnpacker.m_Data.m_aChunkData;
+			if(m_RecvUnpacker.m_Data.m_Flags & NET_PACKETFLAG_EXTENDED)
 			{
-				if(Sixup && Token != GetToken(Addr) && Token != GetGlobalToken())
+				pChunk->m_Flags |= NETSENDFLAG_EXTENDED;
+				mem_copy(pChunk->m_aExtraData, m_RecvUnpacker.m_Data.m_aExtraData, sizeof(pChunk->m_aExtraData));
+			}
+			return 1;
+		}
+		else
+		{
+			// drop invalid ctrl packets
+			if(m_RecvUnpacker.m_Data.m_Flags & NET_PACKETFLAG_CONTROL &&
+				m_RecvUnpacker.m_Data.m_DataSize == 0)
+				continue;
+
+			// normal packet, find matching slot
+			int Slot = GetClientSlot(Addr);
+
+			if(!Sixup && Slot != -1 && m_aSlots[Slot].m_Connection.m_Sixup)
+			{
+				Sixup = true;
+				if(CNetBase::UnpackPacket(pData, Bytes, &m_RecvUnpacker.m_Data, Sixup, &Token))
 					continue;
+			}
 
-				pChunk->m_Flags = NETSENDFLAG_CONNLESS;
-				pChunk->m_ClientID = -1;
-				pChunk->m_Address = Addr;
-				pChunk->m_DataSize = m_RecvUnpacker.m_Data.m_DataSize;
-				pChunk->m_pData = m_RecvUnpacker.m_Data.m_aChunkData;
-				if(m_RecvUnpacker.m_Data.m_Flags & NET_PACKETFLAG_EXTENDED)
+			if(Slot != -1)
+			{
+				// found
+
+				// control
+				if(m_RecvUnpacker.m_Data.m_Flags & NET_PACKETFLAG_CONTROL)
+					OnConnCtrlMsg(Addr, Slot, m_RecvUnpacker.m_Data.m_aChunkData[0], m_RecvUnpacker.m_Data);
+
+				if(m_aSlots[Slot].m_Connection.Feed(&m_RecvUnpacker.m_Data, &Addr, Token))
 				{
-					pChunk->m_Flags |= NETSENDFLAG_EXTENDED;
-					mem_copy(pChunk->m_aExtraData, m_RecvUnpacker.m_Data.m_aExtraData, sizeof(pChunk->m_aExtraData));
+					if(m_RecvUnpacker.m_Data.m_DataSize)
+						m_RecvUnpacker.Start(&Addr, &m_aSlots[Slot].m_Connection, Slot);
 				}
-				return 1;
 			}
 			else
 			{
-				// drop invalid ctrl packets
-				if(m_RecvUnpacker.m_Data.m_Flags & NET_PACKETFLAG_CONTROL &&
-					m_RecvUnpacker.m_Data.m_DataSize == 0)
-					continue;
+				// not found, client that wants to connect
 
-				// normal packet, find matching slot
-				int Slot = GetClientSlot(Addr);
-
-				if(!Sixup && Slot != -1 && m_aSlots[Slot].m_Connection.m_Sixup)
+				if(Sixup)
 				{
-					Sixup = true;
-					if(CNetBase::UnpackPacket(pData, Bytes, &m_RecvUnpacker.m_Data, Sixup, &Token))
-						continue;
+					// got 0.7 control msg
+					if(OnSixupCtrlMsg(Addr, pChunk, m_RecvUnpacker.m_Data.m_aChunkData[0], m_RecvUnpacker.m_Data, *pResponseToken, Token) == 1)
+						return 1;
 				}
-
-				if(Slot != -1)
+				else if(IsDDNetControlMsg(&m_RecvUnpacker.m_Data))
 				{
-					// found
-
-					// control
-					if(m_RecvUnpacker.m_Data.m_Flags & NET_PACKETFLAG_CONTROL)
-						OnConnCtrlMsg(Addr, Slot, m_RecvUnpacker.m_Data.m_aChunkData[0], m_RecvUnpacker.m_Data);
-
-					if(m_aSlots[Slot].m_Connection.Feed(&m_RecvUnpacker.m_Data, &Addr, Token))
-					{
-						if(m_RecvUnpacker.m_Data.m_DataSize)
-							m_RecvUnpacker.Start(&Addr, &m_aSlots[Slot].m_Connection, Slot);
-					}
+					// got ddnet control msg
+					OnTokenCtrlMsg(Addr, m_RecvUnpacker.m_Data.m_aChunkData[0], m_RecvUnpacker.m_Data);
 				}
 				else
 				{
-					// not found, client that wants to connect
-
-					if(Sixup)
-					{
-						// got 0.7 control msg
-						if(OnSixupCtrlMsg(Addr, pChunk, m_RecvUnpacker.m_Data.m_aChunkData[0], m_RecvUnpacker.m_Data, *pResponseToken, Token) == 1)
-							return 1;
-					}
-					else if(IsDDNetControlMsg(&m_RecvUnpacker.m_Data))
-					{
-						// got ddnet control msg
-						OnTokenCtrlMsg(Addr, m_RecvUnpacker.m_Data.m_aChunkData[0], m_RecvUnpacker.m_Data);
-					}
-					else
-					{
-						// got connection-less ctrl or sys msg
-						OnPreConnMsg(Addr, m_RecvUnpacker.m_Data);
-					}
+					// got connection-less ctrl or sys msg
+					OnPreConnMsg(Addr, m_RecvUnpacker.m_Data);
 				}
 			}
 		}
@@ -722,6 +935,13 @@ int CNetServer::Recv(CNetChunk *pChunk, SECURITY_TOKEN *pResponseToken)
 	return 0;
 }
 
+bool CNetServer::Wait(int Microseconds)
+{
+	if(m_pFrontend)
+		return m_pFrontend->Wait(Microseconds);
+	return net_socket_read_wait(m_Socket, Microseconds) > 0;
+}
+
 int CNetServer::Send(CNetChunk *pChunk)
 {
 	if(pChunk->m_DataSize >= NET_MAX_PAYLOAD)
@@ -0,0 +1,205 @@
+#include "profiler.h"
+#include "jsonwriter.h"
+
+#include <base/math.h>
+#include <engine/console.h>
+
+#include <unordered_map>
+
+CProfiler::CProfiler()
+{
+	static std::atomic<uint64_t> s_NextId{1};
+	m_Id = s_NextId.fetch_add(1);
+}
+
+int CProfiler::RegisterZone(const char *pName, int64_t BudgetNs)
+{
+	const int Zone = m_NumZones.load();
+	if(Zone == MAX_ZONES)
+	{
+		dbg_msg("profiler", "too many zones, not recording '%s'", pName);
+		return -1;
+	}
+	m_aZones[Zone].m_pName = pName;
+	m_aZones[Zone].m_BudgetNs = BudgetNs;
+	m_NumZones.store(Zone + 1);
+	return Zone;
+}
+
+CProfiler::CThreadRing *CProfiler::ThreadRing()
+{
+	// the last used ring is cached separately, usually there is only one profiler per thread
+	static thread_local uint64_t s_LastId = 0;
+	static thread_local CThreadRing *s_pLastRing = nullptr;
+	if(s_LastId == m_Id)
+		return s_pLastRing;
+
+	// the ids aren't reused, so entries of destroyed profilers are never looked up again
+	static thread_local std::unordered_map<uint64_t, CThreadRing *> s_Rings;
+	CThreadRing *&pRing = s_Rings[m_Id];
+	if(!pRing)
+	{
+		const std::lock_guard<std::mutex> Lock(m_RingsMutex);
+		m_vpRings.push_back(std::make_unique<CThreadRing>());
+		m_vpRings.back()->m_ThreadIndex = m_vpRings.size() - 1;
+		pRing = m_vpRings.back().get();
+	}
+	s_LastId = m_Id;
+	s_pLastRing = pRing;
+	return pRing;
+}
+
+void CProfiler::Record(int Zone, int64_t Start, int64_t End)
+{
+	if(Zone < 0)
+		return;
+
+	CZone *pZone = &m_aZones[Zone];
+	const int64_t Duration = End - Start;
+	pZone->m_Count.fetch_add(1, std::memory_order_relaxed);
+	pZone->m_TotalNs.fetch_add(Duration, std::memory_order_relaxed);
+	int64_t Max = pZone->m_MaxNs.load(std::memory_order_relaxed);
+	while(Duration > Max && !pZone->m_MaxNs.compare_exchange_weak(Max, Duration, std::memory_order_relaxed))
+		;
+	if(pZone->m_BudgetNs && Duration > pZone->m_BudgetNs)
+		pZone->m_Overruns.fetch_add(1, std::memory_order_relaxed);
+
+	int Bucket = 0;
+	for(int64_t Us = Duration / 1000; Us >= 2 && Bucket < NUM_BUCKETS - 1; Us >>= 1)
+		Bucket++;
+	pZone->m_aBuckets[Bucket].fetch_add(1, std::memory_order_relaxed);
+
+	CThreadRing *pRing = ThreadRing();
+	const uint64_t Count = pRing->m_Count.load(std::memory_order_relaxed);
+	CEventSlot *pSlot = &pRing->m_aEvents[Count % RING_SIZE];
+	pSlot->m_Sequence.store(2 * Count + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	pSlot->m_Zone.store(Zone, std::memory_order_relaxed);
+	pSlot->m_Start.store(Start, std::memory_order_relaxed);
+	pSlot->m_End.store(End, std::memory_order_relaxed);
+	pSlot->m_Sequence.store(2 * Count + 2, std::memory_order_release);
+	pRing->m_Count.store(Count + 1, std::memory_order_release);
+}
+
+void CProfiler::Reset()
+{
+	for(int i = 0; i < m_NumZones.load(); i++)
+	{
+		CZone *pZone = &m_aZones[i];
+		pZone->m_Count.store(0);
+		pZone->m_TotalNs.store(0);
+		pZone->m_MaxNs.store(0);
+		pZone->m_Overruns.store(0);
+		for(auto &Bucket : pZone->m_aBuckets)
+			Bucket.store(0);
+	}
+}
+
+void CProfiler::PrintStats(IConsole *pConsole) const
+{
+	char aBuf[256];
+	for(int i = 0; i < m_NumZones.load(); i++)
+	{
+		const CZone *pZone = &m_aZones[i];
+		const int64_t Count = pZone->m_Count.load(std::memory_order_relaxed);
+		if(!Count)
+			continue;
+
+		// upper bounds of the buckets that contain the percentiles
+		int64_t aPercentiles[2] = {0, 0};
+		const float aFractions[2] = {0.5f, 0.99f};
+		for(int p = 0; p < 2; p++)
+		{
+			int64_t Sum = 0;
+			for(int b = 0; b < NUM_BUCKETS; b++)
+			{
+				Sum += pZone->m_aBuckets[b].load(std::memory_order_relaxed);
+				if(Sum >= Count * aFractions[p])
+				{
+					aPercentiles[p] = (int64_t)2 << b;
+					break;
+				}
+			}
+		}
+
+		str_format(aBuf, sizeof(aBuf), "%s: count=%lld avg=%.3fms max=%.3fms p50<%lldus p99<%lldus",
+			pZone->m_pName, (long long)Count,
+			pZone->m_TotalNs.load(std::memory_order_relaxed) / (double)Count / 1000000.0,
+			pZone->m_MaxNs.load(std::memory_order_relaxed) / 1000000.0,
+			(long long)aPercentiles[0], (long long)aPercentiles[1]);
+		if(pZone->m_BudgetNs)
+			str_format(aBuf + str_length(aBuf), sizeof(aBuf) - str_length(aBuf), " overruns=%lld", (long long)pZone->m_Overruns.load(std::memory_order_relaxed));
+		pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", aBuf);
+	}
+}
+
+bool CProfiler::WriteTrace(IOHANDLE File)
+{
+	if(!File)
+		return false;
+
+	struct CThreadEvents
+	{
+		int m_ThreadIndex;
+		std::vector<CEvent> m_vEvents;
+	};
+	std::vector<CThreadEvents> vThreads;
+	int64_t Base = -1;
+	{
+		const std::lock_guard<std::mutex> Lock(m_RingsMutex);
+		for(const auto &pRing : m_vpRings)
+		{
+			const uint64_t Count = pRing->m_Count.load(std::memory_order_acquire);
+			const uint64_t First = Count > RING_SIZE ? Count - RING_SIZE : 0;
+			CThreadEvents Thread;
+			Thread.m_ThreadIndex = pRing->m_ThreadIndex;
+			for(uint64_t i = First; i < Count; i++)
+			{
+				// the thread keeps recording, skip slots that were overwritten during the copy
+				const CEventSlot &Slot = pRing->m_aEvents[i % RING_SIZE];
+				const uint64_t Sequence = Slot.m_Sequence.load(std::memory_order_acquire);
+				if(Sequence != 2 * i + 2)
+					continue;
+				CEvent Event;
+				Event.m_Zone = Slot.m_Zone.load(std::memory_order_relaxed);
+				Event.m_Start = Slot.m_Start.load(std::memory_order_relaxed);
+				Event.m_End = Slot.m_End.load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if(Slot.m_Sequence.load(std::memory_order_relaxed) != Sequence)
+					continue;
+				Thread.m_vEvents.push_back(Event);
+				if(Base < 0 || Event.m_Start < Base)
+					Base = Event.m_Start;
+			}
+			vThreads.push_back(std::move(Thread));
+		}
+	}
+
+	CJsonFileWriter Writer(File);
+	Writer.BeginObject();
+	Writer.WriteAttribute("traceEvents");
+	Writer.BeginArray();
+	for(const auto &Thread : vThreads)
+	{
+		for(const auto &Event : Thread.m_vEvents)
+		{
+			Writer.BeginObject();
+			Writer.WriteAttribute("name");
+			Writer.WriteStrValue(m_aZones[Event.m_Zone].m_pName);
+			Writer.WriteAttribute("ph");
+			Writer.WriteStrValue("X");
+			Writer.WriteAttribute("ts");
+			Writer.WriteIntValue((Event.m_Start - Base) / 1000);
+			Writer.WriteAttribute("dur");
+			Writer.WriteIntValue(maximum((Event.m_End - Event.m_Start) / 1000, (int64_t)1));
+			Writer.WriteAttribute("pid");
+			Writer.WriteIntValue(0);
+			Writer.WriteAttribute("tid");
+			Writer.WriteIntValue(Thread.m_ThreadIndex);
+			Writer.EndObject();
+		}
+	}
+	Writer.EndArray();
+	Writer.EndObject();
+	return true;
+}
@@ -0,0 +1,134 @@
+#ifndef ENGINE_SHARED_PROFILER_H
+#define ENGINE_SHARED_PROFILER_H
+
+#include <base/system.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class IConsole;
+
+/**
+ * Low overhead timing of named zones.
+ *
+ * The statistics of every zone are shared atomics, so zones can be recorded
+ * from any thread. Additionally, every thread keeps its last events in its
+ * own ring buffer, which can be written out as Chrome trace-event JSON
+ * (chrome://tracing, https://ui.perfetto.dev).
+ */
+class CProfiler
+{
+public:
+	enum
+	{
+		MAX_ZONES = 64,
+		// bucket i counts durations below 2^(i+1) microseconds
+		NUM_BUCKETS = 20,
+		RING_SIZE = 16384,
+	};
+
+private:
+	struct CZone
+	{
+		const char *m_pName;
+		int64_t m_BudgetNs;
+
+		std::atomic<int64_t> m_Count{0};
+		std::atomic<int64_t> m_TotalNs{0};
+		std::atomic<int64_t> m_MaxNs{0};
+		std::atomic<int64_t> m_Overruns{0};
+		std::atomic<int64_t> m_aBuckets[NUM_BUCKETS] = {};
+	};
+
+	struct CEvent
+	{
+		int m_Zone;
+		int64_t m_Start;
+		int64_t m_End;
+	};
+
+	// seqlock, the sequence is odd while the slot is written and 2 * (event number + 1) after
+	struct CEventSlot
+	{
+		std::atomic<uint64_t> m_Sequence{0};
+		std::atomic<int> m_Zone{0};
+		std::atomic<int64_t> m_Start{0};
+		std::atomic<int64_t> m_End{0};
+	};
+
+	// only written by its thread, the count is published after each event
+	struct CThreadRing
+	{
+		int m_ThreadIndex;
+		std::atomic<uint64_t> m_Count{0};
+		CEventSlot m_aEvents[RING_SIZE];
+	};
+
+	std::atomic_bool m_Enabled{true};
+	std::atomic<int> m_NumZones{0};
+	CZone m_aZones[MAX_ZONES];
+
+	// unique per instance, a destroyed profiler's address may be reused
+	uint64_t m_Id;
+	std::mutex m_RingsMutex;
+	std::vector<std::unique_ptr<CThreadRing>> m_vpRings;
+
+	CThreadRing *ThreadRing();
+
+public:
+	CProfiler();
+
+	/**
+	 * Registers a zone, should be done before recording from other threads.
+	 *
+	 * @param pName Name of the zone, must stay valid.
+	 * @param BudgetNs Durations above this count as overruns, 0 for none.
+	 *
+	 * @return The zone index, -1 if there are too many zones.
+	 */
+	int RegisterZone(const char *pName, int64_t BudgetNs = 0);
+
+	void SetEnabled(bool Enabled) { m_Enabled.store(Enabled, std::memory_order_relaxed); }
+	bool Enabled() const { return m_Enabled.load(std::memory_order_relaxed); }
+
+	// times are from time_get_impl, in nanoseconds
+	void Record(int Zone, int64_t Start, int64_t End);
+
+	void Reset();
+	void PrintStats(IConsole *pConsole) const;
+	// closes the file
+	bool WriteTrace(IOHANDLE File);
+
+	int NumZones() const { return m_NumZones.load(); }
+	const char *ZoneName(int Zone) const { return m_aZones[Zone].m_pName; }
+	int64_t Count(int Zone) const { return m_aZones[Zone].m_Count.load(std::memory_order_relaxed); }
+	int64_t TotalNs(int Zone) const { return m_aZones[Zone].m_TotalNs.load(std::memory_order_relaxed); }
+	int64_t Overruns(int Zone) const { return m_aZones[Zone].m_Overruns.load(std::memory_order_relaxed); }
+};
+
+// records the lifetime of the scope as zone
+class CProfileScope
+{
+	CProfiler *m_pProfiler;
+	int m_Zone;
+	int64_t m_Start;
+
+public:
+	CProfileScope(CProfiler *pProfiler, int Zone) :
+		m_pProfiler(pProfiler), m_Zone(Zone), m_Start(pProfiler->Enabled() ? time_get_impl() : -1)
+	{
+	}
+	~CProfileScope() { End(); }
+
+	// ends the zone before the end of the scope
+	void End()
+	{
+		if(m_Start >= 0)
+			m_pProfiler->Record(m_Zone, m_Start, time_get_impl());
+		m_Start = -1;
+	}
+};
+
+#endif
@@ -12,6 +12,11 @@
 
 #include <game/generated/protocolglue.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONF_SNAPSHOT_SSE2 1
+#include <emmintrin.h>
+#endif
+
 // CSnapshot
 
 const CSnapshotItem *CSnapshot::GetItem(int Index) const
@@ -56,7 +61,7 @@ int CSnapshot::GetExternalItemType(int InternalType) const
 
 int CSnapshot::GetItemIndex(int Key) const
 {
-	// TODO: OPT: this should not be a linear search. very bad
+	// linear search, use CSnapshotIndex for repeated lookups
 	for(int i = 0; i < m_NumItems; i++)
 	{
 		if(GetItem(i)->Key() == Key)
@@ -65,21 +70,31 @@ int CSnapshot::GetItemIndex(int Key) const
 	return -1;
 }
 
+static void GetTypeUuidItem(int Type, int *pTypeUuidItem)
+{
+	CUuid TypeUuid = g_UuidManager.GetUuid(Type);
+	for(size_t i = 0; i < sizeof(CUuid) / sizeof(int32_t); i++)
+		pTypeUuidItem[i] = bytes_be_to_uint(&TypeUuid.m_aData[i * sizeof(int32_t)]);
+}
+
+static bool IsExtendedTypeItem(const CSnapshotItem *pItem)
+{
+	return pItem->Type() == 0 && pItem->ID() >= CSnapshot::OFFSET_UUID_TYPE; // NETOBJTYPE_EX
+}
+
 const void *CSnapshot::FindItem(int Type, int ID) const
 {
 	int InternalType = Type;
 	if(Type >= OFFSET_UUID)
 	{
-		CUuid TypeUuid = g_UuidManager.GetUuid(Type);
 		int aTypeUuidItem[sizeof(CUuid) / sizeof(int32_t)];
-		for(size_t i = 0; i < sizeof(CUuid) / sizeof(int32_t); i++)
-			aTypeUuidItem[i] = bytes_be_to_uint(&TypeUuid.m_aData[i * sizeof(int32_t)]);
+		GetTypeUuidItem(Type, aTypeUuidItem);
 
 		bool Found = false;
 		for(int i = 0; i < m_NumItems; i++)
 		{
 			const CSnapshotItem *pItem = GetItem(i);
-			if(pItem->Type() == 0 && pItem->ID() >= OFFSET_UUID_TYPE) // NETOBJTYPE_EX
+			if(IsExtendedTypeItem(pItem))
 			{
 				if(mem_comp(pItem->Data(), aTypeUuidItem, sizeof(CUuid)) == 0)
 				{
@@ -146,6 +161,100 @@ bool CSnapshot::IsValid(size_t ActualSize) const
 	return true;
 }
 
+// CSnapshotIndex
+
+void CSnapshotIndex::Build(const CSnapshot *pSnapshot)
+{
+	m_pSnapshot = pSnapshot;
+	m_NumExtendedTypes = 0;
+
+	// snapshots not made by CSnapshotBuilder (e.g. from demos) may exceed the limit
+	if(pSnapshot->NumItems() > CSnapshot::MAX_ITEMS)
+	{
+		m_HashShift = -1;
+		return;
+	}
+
+	// keep the load factor at or below 1/2
+	int HashSize = 16;
+	m_HashShift = 32 - 4;
+	while(HashSize < 2 * pSnapshot->NumItems())
+	{
+		HashSize *= 2;
+		m_HashShift--;
+	}
+	for(int i = 0; i < HashSize; i++)
+		m_aIndices[i] = -1;
+
+	for(int i = 0; i < pSnapshot->NumItems(); i++)
+	{
+		const CSnapshotItem *pItem = pSnapshot->GetItem(i);
+		const int Key = pItem->Key();
+		unsigned Slot = HashSlot(Key);
+		while(m_aIndices[Slot] != -1 && m_aKeys[Slot] != Key)
+			Slot = (Slot + 1) & (HashSize - 1);
+		// on duplicate keys the first item wins, like in CSnapshot::GetItemIndex
+		if(m_aIndices[Slot] == -1)
+		{
+			m_aKeys[Slot] = Key;
+			m_aIndices[Slot] = i;
+		}
+
+		if(IsExtendedTypeItem(pItem))
+		{
+			// if there are too many, FindItem falls back to scanning the snapshot
+			if(m_NumExtendedTypes < MAX_EXTENDED_TYPES)
+				m_aExtendedTypeIndices[m_NumExtendedTypes] = i;
+			m_NumExtendedTypes++;
+		}
+	}
+}
+
+int CSnapshotIndex::GetItemIndex(int Key) const
+{
+	if(m_HashShift < 0)
+		return m_pSnapshot->GetItemIndex(Key);
+
+	const unsigned HashMask = (1u << (32 - m_HashShift)) - 1;
+	for(unsigned Slot = HashSlot(Key); m_aIndices[Slot] != -1; Slot = (Slot + 1) & HashMask)
+	{
+		if(m_aKeys[Slot] == Key)
+			return m_aIndices[Slot];
+	}
+	return -1;
+}
+
+const void *CSnapshotIndex::FindItem(int Type, int ID) const
+{
+	int InternalType = Type;
+	if(Type >= OFFSET_UUID)
+	{
+		if(m_HashShift < 0 || m_NumExtendedTypes > MAX_EXTENDED_TYPES)
+			return m_pSnapshot->FindItem(Type, ID);
+
+		int aTypeUuidItem[sizeof(CUuid) / sizeof(int32_t)];
+		GetTypeUuidItem(Type, aTypeUuidItem);
+
+		bool Found = false;
+		for(int i = 0; i < m_NumExtendedTypes; i++)
+		{
+			const CSnapshotItem *pItem = m_pSnapshot->GetItem(m_aExtendedTypeIndices[i]);
+			if(mem_comp(pItem->Data(), aTypeUuidItem, sizeof(CUuid)) == 0)
+			{
+				InternalType = pItem->ID();
+				Found = true;
+				break;
+			}
+		}
+		if(!Found)
+		{
+			return nullptr;
+		}
+	}
+	int Index = GetItemIndex((InternalType << 16) | ID);
+	return Index < 0 ? nullptr : m_pSnapshot->GetItem(Index)->Data();
+}
+
 // CSnapshotDelta
 
 enum
@@ -200,44 +309,93 @@ static int GetItemIndexHashed(int Key, const CItemList *pHashlist)
 	return -1;
 }
 
-int CSnapshotDelta::DiffItem(const int *pPast, const int *pCurrent, int *pOut, int Size)
+int CSnapshotDelta::DiffItemScalar(const int *pPast, const int *pCurrent, int *pOut, int Size)
 {
-	int Needed = 0;
-	while(Size)
+	unsigned Needed = 0;
+	for(int i = 0; i < Size; i++)
 	{
-		// subtraction with wrapping by casting to unsigned
-		*pOut = (unsigned)*pCurrent - (unsigned)*pPast;
-		Needed |= *pOut;
-		pOut++;
-		pPast++;
-		pCurrent++;
-		Size--;
+		// subtraction with wrapping by using unsigned
+		const unsigned Diff = (unsigned)pCurrent[i] - (unsigned)pPast[i];
+		pOut[i] = (int)Diff;
+		Needed |= Diff;
 	}
 
-	return Needed;
+	return (int)Needed;
 }
 
-void CSnapshotDelta::UndiffItem(const int *pPast, const int *pDiff, int *pOut, int Size, int *pDataRate)
+void CSnapshotDelta::UndiffItemScalar(const int *pPast, const int *pDiff, int *pOut, int Size, int *pDataRate)
 {
-	while(Size)
+	int DataRate = 0;
+	for(int i = 0; i < Size; i++)
 	{
-		// addition with wrapping by casting to unsigned
-		*pOut = (unsigned)*pPast + (unsigned)*pDiff;
+		// addition with wrapping by using unsigned
+		pOut[i] = (int)((unsigned)pPast[i] + (unsigned)pDiff[i]);
 
-		if(*pDiff == 0)
-			*pDataRate += 1;
-		else
-		{
-			unsigned char aBuf[CVariableInt::MAX_BYTES_PACKED];
-			unsigned char *pEnd = CVariableInt::Pack(aBuf, *pDiff, sizeof(aBuf));
-			*pDataRate += (int)(pEnd - (unsigned char *)aBuf) * 8;
-		}
+		// unchanged values are sent as one bit, others as their packed size
+		DataRate += pDiff[i] == 0 ? 1 : CVariableInt::PackedSize(pDiff[i]) * 8;
+	}
+	*pDataRate += DataRate;
+}
+
+#if defined(CONF_SNAPSHOT_SSE2)
+static int HorizontalOr(__m128i Value)
+{
+	Value = _mm_or_si128(Value, _mm_shuffle_epi32(Value, _MM_SHUFFLE(1, 0, 3, 2)));
+	Value = _mm_or_si128(Value, _mm_shuffle_epi32(Value, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(Value);
+}
+
+static int HorizontalAdd(__m128i Value)
+{
+	Value = _mm_add_epi32(Value, _mm_shuffle_epi32(Value, _MM_SHUFFLE(1, 0, 3, 2)));
+	Value = _mm_add_epi32(Value, _mm_shuffle_epi32(Value, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(Value);
+}
+#endif
+
+int CSnapshotDelta::DiffItem(const int *pPast, const int *pCurrent, int *pOut, int Size)
+{
+	int i = 0;
+	int Needed = 0;
+#if defined(CONF_SNAPSHOT_SSE2)
+	__m128i NeededVec = _mm_setzero_si128();
+	for(; i + 4 <= Size; i += 4)
+	{
+		const __m128i Diff = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(pCurrent + i)), _mm_loadu_si128((const __m128i *)(pPast + i)));
+		_mm_storeu_si128((__m128i *)(pOut + i), Diff);
+		NeededVec = _mm_or_si128(NeededVec, Diff);
+	}
+	Needed = HorizontalOr(NeededVec);
+#endif
+	return Needed | DiffItemScalar(pPast + i, pCurrent + i, pOut + i, Size - i);
+}
 
-		pOut++;
-		pPast++;
-		pDiff++;
-		Size--;
+void CSnapshotDelta::UndiffItem(const int *pPast, const int *pDiff, int *pOut, int Size, int *pDataRate)
+{
+	int i = 0;
+#if defined(CONF_SNAPSHOT_SSE2)
+	const __m128i Zero = _mm_setzero_si128();
+	const __m128i One = _mm_set1_epi32(1);
+	__m128i DataRate = Zero;
+	for(; i + 4 <= Size; i += 4)
+	{
+		const __m128i Diff = _mm_loadu_si128((const __m128i *)(pDiff + i));
+		_mm_storeu_si128((__m128i *)(pOut + i), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(pPast + i)), Diff));
+
+		// the packed size is one byte plus one for every 7 bits above the first 6, like CVariableInt::PackedSize
+		const __m128i Value = _mm_xor_si128(Diff, _mm_srai_epi32(Diff, 31));
+		__m128i Bytes = _mm_sub_epi32(One, _mm_cmpgt_epi32(Value, _mm_set1_epi32((1 << 6) - 1)));
+		Bytes = _mm_sub_epi32(Bytes, _mm_cmpgt_epi32(Value, _mm_set1_epi32((1 << 13) - 1)));
+		Bytes = _mm_sub_epi32(Bytes, _mm_cmpgt_epi32(Value, _mm_set1_epi32((1 << 20) - 1)));
+		Bytes = _mm_sub_epi32(Bytes, _mm_cmpgt_epi32(Value, _mm_set1_epi32((1 << 27) - 1)));
+
+		// unchanged values are sent as one bit
+		const __m128i Unchanged = _mm_cmpeq_epi32(Diff, Zero);
+		DataRate = _mm_add_epi32(DataRate, _mm_or_si128(_mm_and_si128(Unchanged, One), _mm_andnot_si128(Unchanged, _mm_slli_epi32(Bytes, 3))));
 	}
+	*pDataRate += HorizontalAdd(DataRate);
+#endif
+	UndiffItemScalar(pPast + i, pDiff + i, pOut + i, Size - i, pDataRate);
 }
 
 CSnapshotDelta::CSnapshotDelta()
@@ -368,6 +526,9 @@ int CSnapshotDelta::UnpackDelta(const CSnapshot *pFrom, CSnapshot *pTo, const vo
 	CSnapshotBuilder Builder;
 	Builder.Init();
 
+	CSnapshotIndex FromIndex;
+	FromIndex.Build(pFrom);
+
 	// unpack deleted stuff
 	int *pDeleted = pData;
 	if(pDelta->m_NumDeletedItems < 0)
@@ -441,11 +602,11 @@ int CSnapshotDelta::UnpackDelta(const CSnapshot *pFrom, CSnapshot *pTo, const vo
 		if(!pNewData)
 			return -302;
 
-		const int FromIndex = pFrom->GetItemIndex(Key);
-		if(FromIndex != -1)
+		const int FromItemIndex = FromIndex.GetItemIndex(Key);
+		if(FromItemIndex != -1)
 		{
 			// we got an update so we need to apply the diff
-			UndiffItem(pFrom->GetItem(FromIndex)->Data(), pData, pNewData, ItemSize / sizeof(int32_t), &m_aSnapshotDataRate[Type]);
+			UndiffItem(pFrom->GetItem(FromItemIndex)->Data(), pData, pNewData, ItemSize / sizeof(int32_t), &m_aSnapshotDataRate[Type]);
 		}
 		else // no previous, just copy the pData
 		{
@@ -513,12 +674,12 @@ void CSnapshotStorage::PurgeUntil(int Tick)
 
 void CSnapshotStorage::Add(int Tick, int64_t Tagtime, int DataSize, const void *pData, int AltDataSize, const void *pAltData)
 {
-	// allocate memory for holder + snapshot_data
+	// allocate memory for holder + index + snapshot_data
 	int TotalSize = sizeof(CHolder) + DataSize;
 
 	if(AltDataSize > 0)
 	{
-		TotalSize += AltDataSize;
+		TotalSize += sizeof(CSnapshotIndex) + AltDataSize;
 	}
 
 	CHolder *pHolder = (CHolder *)malloc(TotalSize);
@@ -527,7 +688,8 @@ void CSnapshotStorage::Add(int Tick, int64_t Tagtime, int DataSize, const void *
 	pHolder->m_Tick = Tick;
 	pHolder->m_Tagtime = Tagtime;
 	pHolder->m_SnapSize = DataSize;
-	pHolder->m_pSnap = (CSnapshot *)(pHolder + 1);
+	pHolder->m_pAltIndex = AltDataSize > 0 ? (CSnapshotIndex *)(pHolder + 1) : 0;
+	pHolder->m_pSnap = (CSnapshot *)(AltDataSize > 0 ? (char *)(pHolder->m_pAltIndex + 1) : (char *)(pHolder + 1));
 	mem_copy(pHolder->m_pSnap, pData, DataSize);
 
 	if(AltDataSize > 0) // create alternative if wanted
@@ -535,6 +697,7 @@ void CSnapshotStorage::Add(int Tick, int64_t Tagtime, int DataSize, const void *
 		pHolder->m_pAltSnap = (CSnapshot *)(((char *)pHolder->m_pSnap) + DataSize);
 		mem_copy(pHolder->m_pAltSnap, pAltData, AltDataSize);
 		pHolder->m_AltSnapSize = AltDataSize;
+		pHolder->m_pAltIndex->Build(pHolder->m_pAltSnap);
 	}
 	else
 	{
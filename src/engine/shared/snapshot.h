@@ -63,6 +63,37 @@ public:
 	static const CSnapshot *EmptySnapshot() { return &ms_EmptySnapshot; }
 };
 
+// CSnapshotIndex
+
+// Hashed item lookup for a snapshot, turns FindItem/GetItemIndex into O(1).
+// The index refers to the snapshot and must be rebuilt if its items change.
+class CSnapshotIndex
+{
+	enum
+	{
+		MAX_HASH_SIZE = 2 * CSnapshot::MAX_ITEMS, // power of two
+		MAX_EXTENDED_TYPES = 64,
+	};
+
+	const CSnapshot *m_pSnapshot;
+	int m_HashShift;
+
+	int m_aKeys[MAX_HASH_SIZE];
+	short m_aIndices[MAX_HASH_SIZE];
+
+	// indices of the NETOBJTYPE_EX items mapping uuids to internal types
+	int m_NumExtendedTypes;
+	short m_aExtendedTypeIndices[MAX_EXTENDED_TYPES];
+
+	unsigned HashSlot(int Key) const { return ((unsigned)Key * 2654435761u) >> m_HashShift; }
+
+public:
+	void Build(const CSnapshot *pSnapshot);
+
+	int GetItemIndex(int Key) const;
+	const void *FindItem(int Type, int ID) const;
+};
+
 // CSnapshotDelta
 
 class CSnapshotDelta
@@ -87,10 +118,14 @@ private:
 	int m_aSnapshotDataUpdates[CSnapshot::MAX_TYPE + 1];
 	CData m_Empty;
 
-	static void UndiffItem(const int *pPast, const int *pDiff, int *pOut, int Size, int *pDataRate);
-
 public:
+	// vectorized with SSE2 where it is available
 	static int DiffItem(const int *pPast, const int *pCurrent, int *pOut, int Size);
+	static void UndiffItem(const int *pPast, const int *pDiff, int *pOut, int Size, int *pDataRate);
+	// same output without SSE2, for tests and benchmarks
+	static int DiffItemScalar(const int *pPast, const int *pCurrent, int *pOut, int Size);
+	static void UndiffItemScalar(const int *pPast, const int *pDiff, int *pOut, int Size, int *pDataRate);
+
 	CSnapshotDelta();
 	CSnapshotDelta(const CSnapshotDelta &Old);
 	int GetDataRate(int Index) const { return m_aSnapshotDataRate[Index]; }
@@ -120,6 +155,9 @@ public:
 
 		CSnapshot *m_pSnap;
 		CSnapshot *m_pAltSnap;
+
+		// only present if an alternative snapshot is stored
+		CSnapshotIndex *m_pAltIndex;
 	};
 
 	CHolder *m_pFirst;
@@ -0,0 +1,93 @@
+#include "soundmix.h"
+
+#include <base/math.h>
+
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONF_SOUNDMIX_SSE2 1
+#include <emmintrin.h>
+#endif
+
+enum
+{
+	// the gains are fixed point with 15 fractional bits for the ramps, the
+	// multiplication uses the upper bits as signed 16 bit value of Volume * 128
+	GAIN_SHIFT = 15,
+	GAIN_MUL_SHIFT = 8,
+	GAIN_OUT_SHIFT = GAIN_SHIFT - GAIN_MUL_SHIFT,
+};
+
+void SoundMixVoice(int *pMix, const short *pIn, int Channels, unsigned NumFrames, int StartVolumeL, int StartVolumeR, int EndVolumeL, int EndVolumeR)
+{
+	if(NumFrames == 0)
+		return;
+
+	int GainL = StartVolumeL << GAIN_SHIFT;
+	int GainR = StartVolumeR << GAIN_SHIFT;
+	// rounded towards the start volume, so the gains never leave the volume range
+	const int StepL = ((EndVolumeL - StartVolumeL) << GAIN_SHIFT) / (int)NumFrames;
+	const int StepR = ((EndVolumeR - StartVolumeR) << GAIN_SHIFT) / (int)NumFrames;
+
+	unsigned i = 0;
+#if defined(CONF_SOUNDMIX_SSE2)
+	const __m128i Zero = _mm_setzero_si128();
+	__m128i Gain01 = _mm_setr_epi32(GainL, GainR, GainL + StepL, GainR + StepR);
+	__m128i Gain23 = _mm_setr_epi32(GainL + 2 * StepL, GainR + 2 * StepR, GainL + 3 * StepL, GainR + 3 * StepR);
+	const __m128i Step = _mm_setr_epi32(4 * StepL, 4 * StepR, 4 * StepL, 4 * StepR);
+	for(; i + 4 <= NumFrames; i += 4)
+	{
+		__m128i In;
+		if(Channels == 1)
+		{
+			In = _mm_loadl_epi64((const __m128i *)(pIn + i));
+			In = _mm_unpacklo_epi16(In, In);
+		}
+		else
+			In = _mm_loadu_si128((const __m128i *)(pIn + i * 2));
+
+		// the upper halves of the samples and gains are zero, so madd is a plain 16 bit multiplication
+		const __m128i Out01 = _mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(In, Zero), _mm_srai_epi32(Gain01, GAIN_MUL_SHIFT)), GAIN_OUT_SHIFT);
+		const __m128i Out23 = _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(In, Zero), _mm_srai_epi32(Gain23, GAIN_MUL_SHIFT)), GAIN_OUT_SHIFT);
+
+		__m128i *pOut = (__m128i *)(pMix + i * 2);
+		_mm_storeu_si128(pOut, _mm_add_epi32(_mm_loadu_si128(pOut), Out01));
+		_mm_storeu_si128(pOut + 1, _mm_add_epi32(_mm_loadu_si128(pOut + 1), Out23));
+
+		Gain01 = _mm_add_epi32(Gain01, Step);
+		Gain23 = _mm_add_epi32(Gain23, Step);
+	}
+	GainL += (int)i * StepL;
+	GainR += (int)i * StepR;
+#endif
+
+	for(; i < NumFrames; i++)
+	{
+		const short *pFrame = pIn + i * Channels;
+		pMix[i * 2] += (pFrame[0] * (GainL >> GAIN_MUL_SHIFT)) >> GAIN_OUT_SHIFT;
+		pMix[i * 2 + 1] += (pFrame[Channels - 1] * (GainR >> GAIN_MUL_SHIFT)) >> GAIN_OUT_SHIFT;
+		GainL += StepL;
+		GainR += StepR;
+	}
+}
+
+void SoundMixFinish(short *pOut, const int *pMix, unsigned NumSamples, int MasterVolume)
+{
+	// the mix buffer holds Sample * Volume, the master volume is 0 - 100 with a bit of headroom
+	const float Scale = MasterVolume / (101.0f * 256.0f);
+
+	unsigned i = 0;
+#if defined(CONF_SOUNDMIX_SSE2)
+	// the scaled values stay far below the int limits, so packing saturates them
+	const __m128 ScaleVec = _mm_set1_ps(Scale);
+	for(; i + 8 <= NumSamples; i += 8)
+	{
+		const __m128 Low = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(pMix + i))), ScaleVec);
+		const __m128 High = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(pMix + i + 4))), ScaleVec);
+		_mm_storeu_si128((__m128i *)(pOut + i), _mm_packs_epi32(_mm_cvttps_epi32(Low), _mm_cvttps_epi32(High)));
+	}
+#endif
+
+	for(; i < NumSamples; i++)
+		pOut[i] = clamp<int>((int)(pMix[i] * Scale), std::numeric_limits<short>::min(), std::numeric_limits<short>::max());
+}
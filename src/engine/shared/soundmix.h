@@ -0,0 +1,31 @@
+#ifndef ENGINE_SHARED_SOUNDMIX_H
+#define ENGINE_SHARED_SOUNDMIX_H
+
+/*
+	Mixing kernels of the sound engine, vectorized with SSE2 where it is
+	available.
+
+	Voices are accumulated into a buffer of interleaved stereo ints, which
+	is converted to the 16 bit output once all voices are mixed. Volumes
+	are in the range 0 - 255.
+*/
+
+/*
+	Function: SoundMixVoice
+		Adds the frames of a voice to the mix buffer.
+
+	Arguments:
+		pMix - Interleaved stereo mix buffer.
+		pIn - 16 bit frames of the voice.
+		Channels - 1 for mono, 2 for interleaved stereo input.
+		NumFrames - Number of frames to mix.
+		StartVolumeL, StartVolumeR - Volumes of the first frame.
+		EndVolumeL, EndVolumeR - Volumes after the last frame, the volumes
+			ramp linearly so changes don't click.
+*/
+void SoundMixVoice(int *pMix, const short *pIn, int Channels, unsigned NumFrames, int StartVolumeL, int StartVolumeR, int EndVolumeL, int EndVolumeR);
+
+// scales the mix buffer by the master volume (0 - 100) and saturates it to 16 bit
+void SoundMixFinish(short *pOut, const int *pMix, unsigned NumSamples, int MasterVolume);
+
+#endif
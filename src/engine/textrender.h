@@ -269,6 +269,9 @@ public:
 	virtual void SetRenderFlags(unsigned Flags) = 0;
 	virtual unsigned GetRenderFlags() const = 0;
 
+	// renders the glyphs of the text in the background, so they are ready when it is rendered the first time
+	virtual void PrewarmGlyphs(float Size, const char *pText) = 0;
+
 	ColorRGBA DefaultTextColor() const { return ColorRGBA(1, 1, 1, 1); }
 	ColorRGBA DefaultTextOutlineColor() const { return ColorRGBA(0, 0, 0, 0.3f); }
 	ColorRGBA DefaultTextSelectionColor() const { return ColorRGBA(1.0f, 1.0f, 1.0f, 0.5f); }
@@ -12,6 +12,8 @@
 
 #include "debughud.h"
 
+#include <algorithm>
+
 void CDebugHud::RenderNetCorrections()
 {
 	if(!g_Config.m_Debug || g_Config.m_DbgGraphs || !m_pClient->m_Snap.m_pLocalCharacter || !m_pClient->m_Snap.m_pLocalPrevCharacter)
@@ -251,9 +253,74 @@ void CDebugHud::RenderHint()
 	TextRender()->Text(Spacing, Height - FontSize - Spacing, FontSize, Localize("Debug mode enabled. Press Ctrl+Shift+D to disable debug mode."));
 }
 
+void CDebugHud::RenderProfiler()
+{
+	if(!g_Config.m_DbgProfiler)
+		return;
+
+	const CProfiler &Profiler = m_pClient->m_RenderProfiler;
+	const int NumZones = Profiler.NumZones();
+	if(time_get() - m_ProfilerUpdateTime > time_freq())
+	{
+		m_ProfilerUpdateTime = time_get();
+		for(int i = 0; i < NumZones; i++)
+		{
+			CProfilerZoneSnapshot Snapshot;
+			Snapshot.m_Count = Profiler.Count(i);
+			Snapshot.m_TotalNs = Profiler.TotalNs(i);
+			// the counts go back after profiler_reset
+			const int64_t Count = Snapshot.m_Count - m_aProfilerSnapshots[i].m_Count;
+			m_aProfilerAverageMs[i] = Count > 0 ? (Snapshot.m_TotalNs - m_aProfilerSnapshots[i].m_TotalNs) / (float)Count / 1000000.0f : 0.0f;
+			m_aProfilerSnapshots[i] = Snapshot;
+		}
+	}
+
+	const float Height = 300.0f;
+	const float Width = Height * Graphics()->ScreenAspect();
+	Graphics()->MapScreen(0.0f, 0.0f, Width, Height);
+
+	const float FontSize = 5.0f;
+	const float LineHeight = FontSize + 1.0f;
+
+	float y = 50.0f;
+	char aBuf[128];
+	const auto &&RenderRow = [&](const char *pLabel, const char *pValue) {
+		TextRender()->Text(10.0f, y, FontSize, pLabel);
+		TextRender()->Text(110.0f - TextRender()->TextWidth(FontSize, pValue), y, FontSize, pValue);
+		y += LineHeight;
+	};
+
+	TextRender()->TextColor(TextRender()->DefaultTextColor());
+
+	const IGraphics::CCommandBufferStats &Stats = Graphics()->LastFrameCommandStats();
+	str_format(aBuf, sizeof(aBuf), "%d", Stats.m_NumBuffers);
+	RenderRow("Command buffers:", aBuf);
+	str_format(aBuf, sizeof(aBuf), "%d", (int)Stats.m_NumCommands);
+	RenderRow("Commands:", aBuf);
+	str_format(aBuf, sizeof(aBuf), "%d", (int)Stats.m_NumRenderCalls);
+	RenderRow("Render calls:", aBuf);
+	str_format(aBuf, sizeof(aBuf), "%d KiB", (int)((Stats.m_CommandBytes + Stats.m_DataBytes) / 1024));
+	RenderRow("Command data:", aBuf);
+	y += LineHeight;
+
+	// the slowest zones first
+	int aZones[CProfiler::MAX_ZONES];
+	for(int i = 0; i < NumZones; i++)
+		aZones[i] = i;
+	std::sort(aZones, aZones + NumZones, [this](int a, int b) { return m_aProfilerAverageMs[a] > m_aProfilerAverageMs[b]; });
+	for(int i = 0; i < NumZones && y < Height - 2 * LineHeight; i++)
+	{
+		if(m_aProfilerAverageMs[aZones[i]] <= 0.0f)
+			break;
+		str_format(aBuf, sizeof(aBuf), "%.3f ms", m_aProfilerAverageMs[aZones[i]]);
+		RenderRow(Profiler.ZoneName(aZones[i]), aBuf);
+	}
+}
+
 void CDebugHud::OnRender()
 {
 	RenderTuning();
 	RenderNetCorrections();
+	RenderProfiler();
 	RenderHint();
 }
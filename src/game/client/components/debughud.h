@@ -3,6 +3,7 @@
 #ifndef GAME_CLIENT_COMPONENTS_DEBUGHUD_H
 #define GAME_CLIENT_COMPONENTS_DEBUGHUD_H
 #include <engine/client/client.h>
+#include <engine/shared/profiler.h>
 
 #include <game/client/component.h>
 
@@ -11,6 +12,7 @@ class CDebugHud : public CComponent
 	void RenderNetCorrections();
 	void RenderTuning();
 	void RenderHint();
+	void RenderProfiler();
 
 	CGraph m_RampGraph;
 	CGraph m_ZoomedInGraph;
@@ -20,6 +22,16 @@ class CDebugHud : public CComponent
 	float m_OldVelrampRange;
 	float m_OldVelrampCurvature;
 
+	// the render profiler's zones at the last update, the overlay shows the averages since then
+	struct CProfilerZoneSnapshot
+	{
+		int64_t m_Count = 0;
+		int64_t m_TotalNs = 0;
+	};
+	CProfilerZoneSnapshot m_aProfilerSnapshots[CProfiler::MAX_ZONES];
+	float m_aProfilerAverageMs[CProfiler::MAX_ZONES] = {};
+	int64_t m_ProfilerUpdateTime = 0;
+
 public:
 	virtual int Sizeof() const override { return sizeof(*this); }
 	virtual void OnRender() override;
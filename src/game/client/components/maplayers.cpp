@@ -1,6 +1,7 @@
 /* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 #include <engine/demo.h>
+#include <engine/engine.h>
 #include <engine/graphics.h>
 #include <engine/keys.h>
 #include <engine/serverbrowser.h>
@@ -67,6 +68,16 @@ void CMapLayers::EnvelopeEval(int TimeOffsetMillis, int Env, ColorRGBA &Channels
 	if(Env < 0 || Env >= EnvNum)
 		return;
 
+	if((int)pThis->m_vEnvelopeCache.size() < EnvNum)
+		pThis->m_vEnvelopeCache.resize(EnvNum);
+	CEnvelopeCacheEntry &Cached = pThis->m_vEnvelopeCache[Env];
+	const int64_t Frame = pThis->m_pClient->m_RenderFrame;
+	if(Cached.m_Frame == Frame && Cached.m_TimeOffsetMillis == TimeOffsetMillis)
+	{
+		Channels = Cached.m_Result;
+		return;
+	}
+
 	const CMapItemEnvelope *pItem = (CMapItemEnvelope *)pThis->m_pLayers->Map()->GetItem(EnvStart + Env);
 
 	CMapBasedEnvelopePointAccess EnvelopePoints(pThis->m_pLayers->Map());
@@ -141,6 +152,10 @@ void CMapLayers::EnvelopeEval(int TimeOffsetMillis, int Env, ColorRGBA &Channels
 		}
 		CRenderTools::RenderEvalEnvelope(&EnvelopePoints, 4, s_Time + std::chrono::nanoseconds(std::chrono::milliseconds(TimeOffsetMillis)), Channels);
 	}
+
+	Cached.m_Frame = Frame;
+	Cached.m_TimeOffsetMillis = TimeOffsetMillis;
+	Cached.m_Result = Channels;
 }
 
 void FillTmpTileSpeedup(SGraphicTile *pTmpTile, SGraphicTileTexureCoords *pTmpTex, bool As3DTextureCoord, unsigned char Flags, unsigned char Index, int x, int y, int Scale, CMapItemGroup *pGroup, short AngleRotate)
@@ -410,6 +425,8 @@ CMapLayers::~CMapLayers()
 
 void CMapLayers::OnMapLoad()
 {
+	m_vEnvelopeCache.clear();
+
 	if(!Graphics()->IsTileBufferingEnabled() && !Graphics()->IsQuadBufferingEnabled())
 		return;
 
@@ -449,19 +466,8 @@ void CMapLayers::OnMapLoad()
 	}
 
 	bool PassedGameLayer = false;
-	//prepare all visuals for all tile layers
-	std::vector<SGraphicTile> vtmpTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpTileTexCoords;
-	std::vector<SGraphicTile> vtmpBorderTopTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderTopTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderLeftTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderLeftTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderRightTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderRightTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderBottomTiles;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderBottomTilesTexCoords;
-	std::vector<SGraphicTile> vtmpBorderCorners;
-	std::vector<SGraphicTileTexureCoords> vtmpBorderCornersTexCoords;
+	//prepare all visuals for all tile layers, their vertices are built on the job pool
+	std::vector<std::shared_ptr<CTileLayerJob>> vpTileLayerJobs;
 
 	std::vector<STmpQuad> vtmpQuads;
 	std::vector<STmpQuadTextured> vtmpQuadsTextured;
@@ -470,6 +476,9 @@ void CMapLayers::OnMapLoad()
 
 	for(int g = 0; g < m_pLayers->NumGroups(); g++)
 	{
+		if(m_Type <= TYPE_BACKGROUND_FORCE && PassedGameLayer)
+			break;
+
 		CMapItemGroup *pGroup = m_pLayers->GetGroup(g);
 		if(!pGroup)
 		{
@@ -515,7 +524,7 @@ void CMapLayers::OnMapLoad()
 			if(m_Type <= TYPE_BACKGROUND_FORCE)
 			{
 				if(PassedGameLayer)
-					return;
+					break;
 			}
 			else if(m_Type == TYPE_FOREGROUND)
 			{
@@ -572,316 +581,31 @@ void CMapLayers::OnMapLoad()
 					TileSize = sizeof(CTile);
 				}
 				unsigned int Size = m_pLayers->Map()->GetDataSize(DataIndex);
-				void *pTiles = m_pLayers->Map()->GetData(DataIndex);
 
 				if(Size >= pTMap->m_Width * pTMap->m_Height * TileSize)
 				{
-					int CurOverlay = 0;
-					while(CurOverlay < OverlayCount + 1)
+					auto pJob = std::make_shared<CTileLayerJob>();
+					pJob->m_pMap = m_pLayers->Map();
+					pJob->m_DataIndex = DataIndex;
+					pJob->m_pTMap = pTMap;
+					pJob->m_pGroup = pGroup;
+					pJob->m_IsGameLayer = IsGameLayer;
+					pJob->m_IsEntityLayer = IsEntityLayer;
+					pJob->m_IsFrontLayer = IsFrontLayer;
+					pJob->m_IsSwitchLayer = IsSwitchLayer;
+					pJob->m_IsTeleLayer = IsTeleLayer;
+					pJob->m_IsSpeedupLayer = IsSpeedupLayer;
+					pJob->m_IsTuneLayer = IsTuneLayer;
+					pJob->m_DoTextureCoords = DoTextureCoords;
+					pJob->m_As3DTextureCoords = As3DTextureCoords;
+					pJob->m_OverlayCount = OverlayCount;
+					for(int CurOverlay = 0; CurOverlay < OverlayCount + 1; ++CurOverlay)
 					{
 						// We can later just count the tile layers to get the idx in the vector
 						m_vpTileLayerVisuals.push_back(new STileLayerVisuals());
-						STileLayerVisuals &Visuals = *m_vpTileLayerVisuals.back();
-						if(!Visuals.Init(pTMap->m_Width, pTMap->m_Height))
-						{
-							++CurOverlay;
-							continue;
-						}
-						Visuals.m_IsTextured = DoTextureCoords;
-
-						vtmpTiles.clear();
-						vtmpTileTexCoords.clear();
-
-						vtmpBorderTopTiles.clear();
-						vtmpBorderLeftTiles.clear();
-						vtmpBorderRightTiles.clear();
-						vtmpBorderBottomTiles.clear();
-						vtmpBorderCorners.clear();
-						vtmpBorderTopTilesTexCoords.clear();
-						vtmpBorderLeftTilesTexCoords.clear();
-						vtmpBorderRightTilesTexCoords.clear();
-						vtmpBorderBottomTilesTexCoords.clear();
-						vtmpBorderCornersTexCoords.clear();
-
-						if(!DoTextureCoords)
-						{
-							vtmpTiles.reserve((size_t)pTMap->m_Width * pTMap->m_Height);
-							vtmpBorderTopTiles.reserve((size_t)pTMap->m_Width);
-							vtmpBorderBottomTiles.reserve((size_t)pTMap->m_Width);
-							vtmpBorderLeftTiles.reserve((size_t)pTMap->m_Height);
-							vtmpBorderRightTiles.reserve((size_t)pTMap->m_Height);
-							vtmpBorderCorners.reserve((size_t)4);
-						}
-						else
-						{
-							vtmpTileTexCoords.reserve((size_t)pTMap->m_Width * pTMap->m_Height);
-							vtmpBorderTopTilesTexCoords.reserve((size_t)pTMap->m_Width);
-							vtmpBorderBottomTilesTexCoords.reserve((size_t)pTMap->m_Width);
-							vtmpBorderLeftTilesTexCoords.reserve((size_t)pTMap->m_Height);
-							vtmpBorderRightTilesTexCoords.reserve((size_t)pTMap->m_Height);
-							vtmpBorderCornersTexCoords.reserve((size_t)4);
-						}
-
-						int x = 0;
-						int y = 0;
-						for(y = 0; y < pTMap->m_Height; ++y)
-						{
-							for(x = 0; x < pTMap->m_Width; ++x)
-							{
-								unsigned char Index = 0;
-								unsigned char Flags = 0;
-								int AngleRotate = -1;
-								if(IsEntityLayer)
-								{
-									if(IsGameLayer)
-									{
-										Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
-										Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-									}
-									if(IsFrontLayer)
-									{
-										Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
-										Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-									}
-									if(IsSwitchLayer)
-									{
-										Flags = 0;
-										Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										if(CurOverlay == 0)
-										{
-											Flags = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-											if(Index == TILE_SWITCHTIMEDOPEN)
-												Index = 8;
-										}
-										else if(CurOverlay == 1)
-											Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Number;
-										else if(CurOverlay == 2)
-											Index = ((CSwitchTile *)pTiles)[y * pTMap->m_Width + x].m_Delay;
-									}
-									if(IsTeleLayer)
-									{
-										Index = ((CTeleTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										Flags = 0;
-										if(CurOverlay == 1)
-										{
-											if(IsTeleTileNumberUsed(Index))
-												Index = ((CTeleTile *)pTiles)[y * pTMap->m_Width + x].m_Number;
-											else
-												Index = 0;
-										}
-									}
-									if(IsSpeedupLayer)
-									{
-										Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										Flags = 0;
-										AngleRotate = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Angle;
-										if(((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Force == 0)
-											Index = 0;
-										else if(CurOverlay == 1)
-											Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_Force;
-										else if(CurOverlay == 2)
-											Index = ((CSpeedupTile *)pTiles)[y * pTMap->m_Width + x].m_MaxSpeed;
-									}
-									if(IsTuneLayer)
-									{
-										Index = ((CTuneTile *)pTiles)[y * pTMap->m_Width + x].m_Type;
-										Flags = 0;
-									}
-								}
-								else
-								{
-									Index = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Index;
-									Flags = ((CTile *)pTiles)[y * pTMap->m_Width + x].m_Flags;
-								}
-
-								//the amount of tiles handled before this tile
-								int TilesHandledCount = vtmpTiles.size();
-								Visuals.m_pTilesOfLayer[y * pTMap->m_Width + x].SetIndexBufferByteOffset((offset_ptr32)(TilesHandledCount * 6 * sizeof(unsigned int)));
-
-								bool AddAsSpeedup = false;
-								if(IsSpeedupLayer && CurOverlay == 0)
-									AddAsSpeedup = true;
-
-								if(AddTile(vtmpTiles, vtmpTileTexCoords, As3DTextureCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-									Visuals.m_pTilesOfLayer[y * pTMap->m_Width + x].Draw(true);
-
-								//do the border tiles
-								if(x == 0)
-								{
-									if(y == 0)
-									{
-										Visuals.m_BorderTopLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size() * 6 * sizeof(unsigned int)));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, As3DTextureCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-											Visuals.m_BorderTopLeft.Draw(true);
-									}
-									else if(y == pTMap->m_Height - 1)
-									{
-										Visuals.m_BorderBottomLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size() * 6 * sizeof(unsigned int)));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, As3DTextureCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-											Visuals.m_BorderBottomLeft.Draw(true);
-									}
-									else
-									{
-										Visuals.m_pBorderLeft[y - 1].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderLeftTiles.size() * 6 * sizeof(unsigned int)));
-										if(AddTile(vtmpBorderLeftTiles, vtmpBorderLeftTilesTexCoords, As3DTextureCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-											Visuals.m_pBorderLeft[y - 1].Draw(true);
-									}
-								}
-								else if(x == pTMap->m_Width - 1)
-								{
-									if(y == 0)
-									{
-										Visuals.m_BorderTopRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size() * 6 * sizeof(unsigned int)));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, As3DTextureCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-											Visuals.m_BorderTopRight.Draw(true);
-									}
-									else if(y == pTMap->m_Height - 1)
-									{
-										Visuals.m_BorderBottomRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size() * 6 * sizeof(unsigned int)));
-										if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, As3DTextureCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-											Visuals.m_BorderBottomRight.Draw(true);
-									}
-									else
-									{
-										Visuals.m_pBorderRight[y - 1].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderRightTiles.size() * 6 * sizeof(unsigned int)));
-										if(AddTile(vtmpBorderRightTiles, vtmpBorderRightTilesTexCoords, As3DTextureCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-											Visuals.m_pBorderRight[y - 1].Draw(true);
-									}
-								}
-								else if(y == 0)
-								{
-									if(x > 0 && x < pTMap->m_Width - 1)
-									{
-										Visuals.m_pBorderTop[x - 1].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderTopTiles.size() * 6 * sizeof(unsigned int)));
-										if(AddTile(vtmpBorderTopTiles, vtmpBorderTopTilesTexCoords, As3DTextureCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-											Visuals.m_pBorderTop[x - 1].Draw(true);
-									}
-								}
-								else if(y == pTMap->m_Height - 1)
-								{
-									if(x > 0 && x < pTMap->m_Width - 1)
-									{
-										Visuals.m_pBorderBottom[x - 1].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderBottomTiles.size() * 6 * sizeof(unsigned int)));
-										if(AddTile(vtmpBorderBottomTiles, vtmpBorderBottomTilesTexCoords, As3DTextureCoords, Index, Flags, x, y, pGroup, DoTextureCoords, AddAsSpeedup, AngleRotate))
-											Visuals.m_pBorderBottom[x - 1].Draw(true);
-									}
-								}
-							}
-						}
-
-						//append one kill tile to the gamelayer
-						if(IsGameLayer)
-						{
-							Visuals.m_BorderKillTile.SetIndexBufferByteOffset((offset_ptr32)(vtmpTiles.size() * 6 * sizeof(unsigned int)));
-							if(AddTile(vtmpTiles, vtmpTileTexCoords, As3DTextureCoords, TILE_DEATH, 0, 0, 0, pGroup, DoTextureCoords))
-								Visuals.m_BorderKillTile.Draw(true);
-						}
-
-						//add the border corners, then the borders and fix their byte offsets
-						int TilesHandledCount = vtmpTiles.size();
-						Visuals.m_BorderTopLeft.AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
-						Visuals.m_BorderTopRight.AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
-						Visuals.m_BorderBottomLeft.AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
-						Visuals.m_BorderBottomRight.AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
-						//add the Corners to the tiles
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderCorners.begin(), vtmpBorderCorners.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderCornersTexCoords.begin(), vtmpBorderCornersTexCoords.end());
-
-						//now the borders
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Width > 2)
-						{
-							for(int i = 0; i < pTMap->m_Width - 2; ++i)
-							{
-								Visuals.m_pBorderTop[i].AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderTopTiles.begin(), vtmpBorderTopTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderTopTilesTexCoords.begin(), vtmpBorderTopTilesTexCoords.end());
-
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Width > 2)
-						{
-							for(int i = 0; i < pTMap->m_Width - 2; ++i)
-							{
-								Visuals.m_pBorderBottom[i].AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderBottomTiles.begin(), vtmpBorderBottomTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderBottomTilesTexCoords.begin(), vtmpBorderBottomTilesTexCoords.end());
-
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Height > 2)
-						{
-							for(int i = 0; i < pTMap->m_Height - 2; ++i)
-							{
-								Visuals.m_pBorderLeft[i].AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderLeftTiles.begin(), vtmpBorderLeftTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderLeftTilesTexCoords.begin(), vtmpBorderLeftTilesTexCoords.end());
-
-						TilesHandledCount = vtmpTiles.size();
-						if(pTMap->m_Height > 2)
-						{
-							for(int i = 0; i < pTMap->m_Height - 2; ++i)
-							{
-								Visuals.m_pBorderRight[i].AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
-							}
-						}
-						vtmpTiles.insert(vtmpTiles.end(), vtmpBorderRightTiles.begin(), vtmpBorderRightTiles.end());
-						vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderRightTilesTexCoords.begin(), vtmpBorderRightTilesTexCoords.end());
-
-						//setup params
-						float *pTmpTiles = vtmpTiles.empty() ? NULL : (float *)vtmpTiles.data();
-						unsigned char *pTmpTileTexCoords = vtmpTileTexCoords.empty() ? NULL : (unsigned char *)vtmpTileTexCoords.data();
-
-						Visuals.m_BufferContainerIndex = -1;
-						size_t UploadDataSize = vtmpTileTexCoords.size() * sizeof(SGraphicTileTexureCoords) + vtmpTiles.size() * sizeof(SGraphicTile);
-						if(UploadDataSize > 0)
-						{
-							char *pUploadData = (char *)malloc(sizeof(char) * UploadDataSize);
-
-							mem_copy_special(pUploadData, pTmpTiles, sizeof(vec2), vtmpTiles.size() * 4, (DoTextureCoords ? sizeof(vec3) : 0));
-							if(DoTextureCoords)
-							{
-								mem_copy_special(pUploadData + sizeof(vec2), pTmpTileTexCoords, sizeof(vec3), vtmpTiles.size() * 4, sizeof(vec2));
-							}
-
-							// first create the buffer object
-							int BufferObjectIndex = Graphics()->CreateBufferObject(UploadDataSize, pUploadData, 0, true);
-
-							// then create the buffer container
-							SBufferContainerInfo ContainerInfo;
-							ContainerInfo.m_Stride = (DoTextureCoords ? (sizeof(float) * 2 + sizeof(vec3)) : 0);
-							ContainerInfo.m_VertBufferBindingIndex = BufferObjectIndex;
-							ContainerInfo.m_vAttributes.emplace_back();
-							SBufferContainerInfo::SAttribute *pAttr = &ContainerInfo.m_vAttributes.back();
-							pAttr->m_DataTypeCount = 2;
-							pAttr->m_Type = GRAPHICS_TYPE_FLOAT;
-							pAttr->m_Normalized = false;
-							pAttr->m_pOffset = 0;
-							pAttr->m_FuncType = 0;
-							if(DoTextureCoords)
-							{
-								ContainerInfo.m_vAttributes.emplace_back();
-								pAttr = &ContainerInfo.m_vAttributes.back();
-								pAttr->m_DataTypeCount = 3;
-								pAttr->m_Type = GRAPHICS_TYPE_FLOAT;
-								pAttr->m_Normalized = false;
-								pAttr->m_pOffset = (void *)(sizeof(vec2));
-								pAttr->m_FuncType = 0;
-							}
-
-							Visuals.m_BufferContainerIndex = Graphics()->CreateBufferContainer(&ContainerInfo);
-							// and finally inform the backend how many indices are required
-							Graphics()->IndicesNumRequiredNotify(vtmpTiles.size() * 6);
-
-							RenderLoading();
-						}
-
-						++CurOverlay;
+						pJob->m_apVisuals[CurOverlay] = m_vpTileLayerVisuals.back();
 					}
+					vpTileLayerJobs.push_back(pJob);
 				}
 			}
 			else if(pLayer->m_Type == LAYERTYPE_QUADS && Graphics()->IsQuadBufferingEnabled())
@@ -994,6 +718,364 @@ void CMapLayers::OnMapLoad()
 			}
 		}
 	}
+
+	// data used by several layers is loaded here, the jobs may only load distinct data at once
+	std::vector<int> vDataUsers(m_pLayers->Map()->NumData(), 0);
+	for(const auto &pJob : vpTileLayerJobs)
+		if(pJob->m_DataIndex >= 0 && pJob->m_DataIndex < (int)vDataUsers.size())
+			vDataUsers[pJob->m_DataIndex]++;
+	for(const auto &pJob : vpTileLayerJobs)
+		if(pJob->m_DataIndex >= 0 && pJob->m_DataIndex < (int)vDataUsers.size() && vDataUsers[pJob->m_DataIndex] > 1)
+			m_pLayers->Map()->GetData(pJob->m_DataIndex);
+	for(const auto &pJob : vpTileLayerJobs)
+		m_pClient->Engine()->AddJob(pJob);
+
+	// create the buffers in the order of the layers, while the later layers are still being built
+	for(const auto &pJob : vpTileLayerJobs)
+	{
+		while(pJob->Status() != IJob::STATE_DONE)
+		{
+			RenderLoading();
+			thread_yield();
+		}
+
+		const bool DoTextureCoords = pJob->m_DoTextureCoords;
+		for(int CurOverlay = 0; CurOverlay < pJob->m_OverlayCount + 1; ++CurOverlay)
+		{
+			CTileLayerJob::SUpload &Upload = pJob->m_aUploads[CurOverlay];
+			if(Upload.m_Size == 0)
+				continue;
+
+			// first create the buffer object, it takes the data
+			int BufferObjectIndex = Graphics()->CreateBufferObject(Upload.m_Size, Upload.m_pData, 0, true);
+			Upload.m_pData = nullptr;
+
+			// then create the buffer container
+			SBufferContainerInfo ContainerInfo;
+			ContainerInfo.m_Stride = (DoTextureCoords ? (sizeof(float) * 2 + sizeof(vec3)) : 0);
+			ContainerInfo.m_VertBufferBindingIndex = BufferObjectIndex;
+			ContainerInfo.m_vAttributes.emplace_back();
+			SBufferContainerInfo::SAttribute *pAttr = &ContainerInfo.m_vAttributes.back();
+			pAttr->m_DataTypeCount = 2;
+			pAttr->m_Type = GRAPHICS_TYPE_FLOAT;
+			pAttr->m_Normalized = false;
+			pAttr->m_pOffset = 0;
+			pAttr->m_FuncType = 0;
+			if(DoTextureCoords)
+			{
+				ContainerInfo.m_vAttributes.emplace_back();
+				pAttr = &ContainerInfo.m_vAttributes.back();
+				pAttr->m_DataTypeCount = 3;
+				pAttr->m_Type = GRAPHICS_TYPE_FLOAT;
+				pAttr->m_Normalized = false;
+				pAttr->m_pOffset = (void *)(sizeof(vec2));
+				pAttr->m_FuncType = 0;
+			}
+
+			pJob->m_apVisuals[CurOverlay]->m_BufferContainerIndex = Graphics()->CreateBufferContainer(&ContainerInfo);
+			// and finally inform the backend how many indices are required
+			Graphics()->IndicesNumRequiredNotify(Upload.m_NumTiles * 6);
+
+			RenderLoading();
+		}
+	}
+}
+
+CMapLayers::CTileLayerJob::~CTileLayerJob()
+{
+	for(auto &Upload : m_aUploads)
+		free(Upload.m_pData);
+}
+
+void CMapLayers::CTileLayerJob::Run()
+{
+	void *pTiles = m_pMap->GetData(m_DataIndex);
+	if(!pTiles)
+		return;
+
+	std::vector<SGraphicTile> vtmpTiles;
+	std::vector<SGraphicTileTexureCoords> vtmpTileTexCoords;
+	std::vector<SGraphicTile> vtmpBorderTopTiles;
+	std::vector<SGraphicTileTexureCoords> vtmpBorderTopTilesTexCoords;
+	std::vector<SGraphicTile> vtmpBorderLeftTiles;
+	std::vector<SGraphicTileTexureCoords> vtmpBorderLeftTilesTexCoords;
+	std::vector<SGraphicTile> vtmpBorderRightTiles;
+	std::vector<SGraphicTileTexureCoords> vtmpBorderRightTilesTexCoords;
+	std::vector<SGraphicTile> vtmpBorderBottomTiles;
+	std::vector<SGraphicTileTexureCoords> vtmpBorderBottomTilesTexCoords;
+	std::vector<SGraphicTile> vtmpBorderCorners;
+	std::vector<SGraphicTileTexureCoords> vtmpBorderCornersTexCoords;
+
+	for(int CurOverlay = 0; CurOverlay < m_OverlayCount + 1; ++CurOverlay)
+	{
+		STileLayerVisuals &Visuals = *m_apVisuals[CurOverlay];
+		if(!Visuals.Init(m_pTMap->m_Width, m_pTMap->m_Height))
+			continue;
+		Visuals.m_IsTextured = m_DoTextureCoords;
+
+		vtmpTiles.clear();
+		vtmpTileTexCoords.clear();
+
+		vtmpBorderTopTiles.clear();
+		vtmpBorderLeftTiles.clear();
+		vtmpBorderRightTiles.clear();
+		vtmpBorderBottomTiles.clear();
+		vtmpBorderCorners.clear();
+		vtmpBorderTopTilesTexCoords.clear();
+		vtmpBorderLeftTilesTexCoords.clear();
+		vtmpBorderRightTilesTexCoords.clear();
+		vtmpBorderBottomTilesTexCoords.clear();
+		vtmpBorderCornersTexCoords.clear();
+
+		if(!m_DoTextureCoords)
+		{
+			vtmpTiles.reserve((size_t)m_pTMap->m_Width * m_pTMap->m_Height);
+			vtmpBorderTopTiles.reserve((size_t)m_pTMap->m_Width);
+			vtmpBorderBottomTiles.reserve((size_t)m_pTMap->m_Width);
+			vtmpBorderLeftTiles.reserve((size_t)m_pTMap->m_Height);
+			vtmpBorderRightTiles.reserve((size_t)m_pTMap->m_Height);
+			vtmpBorderCorners.reserve((size_t)4);
+		}
+		else
+		{
+			vtmpTileTexCoords.reserve((size_t)m_pTMap->m_Width * m_pTMap->m_Height);
+			vtmpBorderTopTilesTexCoords.reserve((size_t)m_pTMap->m_Width);
+			vtmpBorderBottomTilesTexCoords.reserve((size_t)m_pTMap->m_Width);
+			vtmpBorderLeftTilesTexCoords.reserve((size_t)m_pTMap->m_Height);
+			vtmpBorderRightTilesTexCoords.reserve((size_t)m_pTMap->m_Height);
+			vtmpBorderCornersTexCoords.reserve((size_t)4);
+		}
+
+		int x = 0;
+		int y = 0;
+		for(y = 0; y < m_pTMap->m_Height; ++y)
+		{
+			for(x = 0; x < m_pTMap->m_Width; ++x)
+			{
+				unsigned char Index = 0;
+				unsigned char Flags = 0;
+				int AngleRotate = -1;
+				if(m_IsEntityLayer)
+				{
+					if(m_IsGameLayer)
+					{
+						Index = ((CTile *)pTiles)[y * m_pTMap->m_Width + x].m_Index;
+						Flags = ((CTile *)pTiles)[y * m_pTMap->m_Width + x].m_Flags;
+					}
+					if(m_IsFrontLayer)
+					{
+						Index = ((CTile *)pTiles)[y * m_pTMap->m_Width + x].m_Index;
+						Flags = ((CTile *)pTiles)[y * m_pTMap->m_Width + x].m_Flags;
+					}
+					if(m_IsSwitchLayer)
+					{
+						Flags = 0;
+						Index = ((CSwitchTile *)pTiles)[y * m_pTMap->m_Width + x].m_Type;
+						if(CurOverlay == 0)
+						{
+							Flags = ((CSwitchTile *)pTiles)[y * m_pTMap->m_Width + x].m_Flags;
+							if(Index == TILE_SWITCHTIMEDOPEN)
+								Index = 8;
+						}
+						else if(CurOverlay == 1)
+							Index = ((CSwitchTile *)pTiles)[y * m_pTMap->m_Width + x].m_Number;
+						else if(CurOverlay == 2)
+							Index = ((CSwitchTile *)pTiles)[y * m_pTMap->m_Width + x].m_Delay;
+					}
+					if(m_IsTeleLayer)
+					{
+						Index = ((CTeleTile *)pTiles)[y * m_pTMap->m_Width + x].m_Type;
+						Flags = 0;
+						if(CurOverlay == 1)
+						{
+							if(IsTeleTileNumberUsed(Index))
+								Index = ((CTeleTile *)pTiles)[y * m_pTMap->m_Width + x].m_Number;
+							else
+								Index = 0;
+						}
+					}
+					if(m_IsSpeedupLayer)
+					{
+						Index = ((CSpeedupTile *)pTiles)[y * m_pTMap->m_Width + x].m_Type;
+						Flags = 0;
+						AngleRotate = ((CSpeedupTile *)pTiles)[y * m_pTMap->m_Width + x].m_Angle;
+						if(((CSpeedupTile *)pTiles)[y * m_pTMap->m_Width + x].m_Force == 0)
+							Index = 0;
+						else if(CurOverlay == 1)
+							Index = ((CSpeedupTile *)pTiles)[y * m_pTMap->m_Width + x].m_Force;
+						else if(CurOverlay == 2)
+							Index = ((CSpeedupTile *)pTiles)[y * m_pTMap->m_Width + x].m_MaxSpeed;
+					}
+					if(m_IsTuneLayer)
+					{
+						Index = ((CTuneTile *)pTiles)[y * m_pTMap->m_Width + x].m_Type;
+						Flags = 0;
+					}
+				}
+				else
+				{
+					Index = ((CTile *)pTiles)[y * m_pTMap->m_Width + x].m_Index;
+					Flags = ((CTile *)pTiles)[y * m_pTMap->m_Width + x].m_Flags;
+				}
+
+				//the amount of tiles handled before this tile
+				int TilesHandledCount = vtmpTiles.size();
+				Visuals.m_pTilesOfLayer[y * m_pTMap->m_Width + x].SetIndexBufferByteOffset((offset_ptr32)(TilesHandledCount * 6 * sizeof(unsigned int)));
+
+				bool AddAsSpeedup = false;
+				if(m_IsSpeedupLayer && CurOverlay == 0)
+					AddAsSpeedup = true;
+
+				if(AddTile(vtmpTiles, vtmpTileTexCoords, m_As3DTextureCoords, Index, Flags, x, y, m_pGroup, m_DoTextureCoords, AddAsSpeedup, AngleRotate))
+					Visuals.m_pTilesOfLayer[y * m_pTMap->m_Width + x].Draw(true);
+
+				//do the border tiles
+				if(x == 0)
+				{
+					if(y == 0)
+					{
+						Visuals.m_BorderTopLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size() * 6 * sizeof(unsigned int)));
+						if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, m_As3DTextureCoords, Index, Flags, x, y, m_pGroup, m_DoTextureCoords, AddAsSpeedup, AngleRotate))
+							Visuals.m_BorderTopLeft.Draw(true);
+					}
+					else if(y == m_pTMap->m_Height - 1)
+					{
+						Visuals.m_BorderBottomLeft.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size() * 6 * sizeof(unsigned int)));
+						if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, m_As3DTextureCoords, Index, Flags, x, y, m_pGroup, m_DoTextureCoords, AddAsSpeedup, AngleRotate))
+							Visuals.m_BorderBottomLeft.Draw(true);
+					}
+					else
+					{
+						Visuals.m_pBorderLeft[y - 1].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderLeftTiles.size() * 6 * sizeof(unsigned int)));
+						if(AddTile(vtmpBorderLeftTiles, vtmpBorderLeftTilesTexCoords, m_As3DTextureCoords, Index, Flags, x, y, m_pGroup, m_DoTextureCoords, AddAsSpeedup, AngleRotate))
+							Visuals.m_pBorderLeft[y - 1].Draw(true);
+					}
+				}
+				else if(x == m_pTMap->m_Width - 1)
+				{
+					if(y == 0)
+					{
+						Visuals.m_BorderTopRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size() * 6 * sizeof(unsigned int)));
+						if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, m_As3DTextureCoords, Index, Flags, x, y, m_pGroup, m_DoTextureCoords, AddAsSpeedup, AngleRotate))
+							Visuals.m_BorderTopRight.Draw(true);
+					}
+					else if(y == m_pTMap->m_Height - 1)
+					{
+						Visuals.m_BorderBottomRight.SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderCorners.size() * 6 * sizeof(unsigned int)));
+						if(AddTile(vtmpBorderCorners, vtmpBorderCornersTexCoords, m_As3DTextureCoords, Index, Flags, x, y, m_pGroup, m_DoTextureCoords, AddAsSpeedup, AngleRotate))
+							Visuals.m_BorderBottomRight.Draw(true);
+					}
+					else
+					{
+						Visuals.m_pBorderRight[y - 1].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderRightTiles.size() * 6 * sizeof(unsigned int)));
+						if(AddTile(vtmpBorderRightTiles, vtmpBorderRightTilesTexCoords, m_As3DTextureCoords, Index, Flags, x, y, m_pGroup, m_DoTextureCoords, AddAsSpeedup, AngleRotate))
+							Visuals.m_pBorderRight[y - 1].Draw(true);
+					}
+				}
+				else if(y == 0)
+				{
+					if(x > 0 && x < m_pTMap->m_Width - 1)
+					{
+						Visuals.m_pBorderTop[x - 1].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderTopTiles.size() * 6 * sizeof(unsigned int)));
+						if(AddTile(vtmpBorderTopTiles, vtmpBorderTopTilesTexCoords, m_As3DTextureCoords, Index, Flags, x, y, m_pGroup, m_DoTextureCoords, AddAsSpeedup, AngleRotate))
+							Visuals.m_pBorderTop[x - 1].Draw(true);
+					}
+				}
+				else if(y == m_pTMap->m_Height - 1)
+				{
+					if(x > 0 && x < m_pTMap->m_Width - 1)
+					{
+						Visuals.m_pBorderBottom[x - 1].SetIndexBufferByteOffset((offset_ptr32)(vtmpBorderBottomTiles.size() * 6 * sizeof(unsigned int)));
+						if(AddTile(vtmpBorderBottomTiles, vtmpBorderBottomTilesTexCoords, m_As3DTextureCoords, Index, Flags, x, y, m_pGroup, m_DoTextureCoords, AddAsSpeedup, AngleRotate))
+							Visuals.m_pBorderBottom[x - 1].Draw(true);
+					}
+				}
+			}
+		}
+
+		//append one kill tile to the gamelayer
+		if(m_IsGameLayer)
+		{
+			Visuals.m_BorderKillTile.SetIndexBufferByteOffset((offset_ptr32)(vtmpTiles.size() * 6 * sizeof(unsigned int)));
+			if(AddTile(vtmpTiles, vtmpTileTexCoords, m_As3DTextureCoords, TILE_DEATH, 0, 0, 0, m_pGroup, m_DoTextureCoords))
+				Visuals.m_BorderKillTile.Draw(true);
+		}
+
+		//add the border corners, then the borders and fix their byte offsets
+		int TilesHandledCount = vtmpTiles.size();
+		Visuals.m_BorderTopLeft.AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
+		Visuals.m_BorderTopRight.AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
+		Visuals.m_BorderBottomLeft.AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
+		Visuals.m_BorderBottomRight.AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
+		//add the Corners to the tiles
+		vtmpTiles.insert(vtmpTiles.end(), vtmpBorderCorners.begin(), vtmpBorderCorners.end());
+		vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderCornersTexCoords.begin(), vtmpBorderCornersTexCoords.end());
+
+		//now the borders
+		TilesHandledCount = vtmpTiles.size();
+		if(m_pTMap->m_Width > 2)
+		{
+			for(int i = 0; i < m_pTMap->m_Width - 2; ++i)
+			{
+				Visuals.m_pBorderTop[i].AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
+			}
+		}
+		vtmpTiles.insert(vtmpTiles.end(), vtmpBorderTopTiles.begin(), vtmpBorderTopTiles.end());
+		vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderTopTilesTexCoords.begin(), vtmpBorderTopTilesTexCoords.end());
+
+		TilesHandledCount = vtmpTiles.size();
+		if(m_pTMap->m_Width > 2)
+		{
+			for(int i = 0; i < m_pTMap->m_Width - 2; ++i)
+			{
+				Visuals.m_pBorderBottom[i].AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
+			}
+		}
+		vtmpTiles.insert(vtmpTiles.end(), vtmpBorderBottomTiles.begin(), vtmpBorderBottomTiles.end());
+		vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderBottomTilesTexCoords.begin(), vtmpBorderBottomTilesTexCoords.end());
+
+		TilesHandledCount = vtmpTiles.size();
+		if(m_pTMap->m_Height > 2)
+		{
+			for(int i = 0; i < m_pTMap->m_Height - 2; ++i)
+			{
+				Visuals.m_pBorderLeft[i].AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
+			}
+		}
+		vtmpTiles.insert(vtmpTiles.end(), vtmpBorderLeftTiles.begin(), vtmpBorderLeftTiles.end());
+		vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderLeftTilesTexCoords.begin(), vtmpBorderLeftTilesTexCoords.end());
+
+		TilesHandledCount = vtmpTiles.size();
+		if(m_pTMap->m_Height > 2)
+		{
+			for(int i = 0; i < m_pTMap->m_Height - 2; ++i)
+			{
+				Visuals.m_pBorderRight[i].AddIndexBufferByteOffset(TilesHandledCount * 6 * sizeof(unsigned int));
+			}
+		}
+		vtmpTiles.insert(vtmpTiles.end(), vtmpBorderRightTiles.begin(), vtmpBorderRightTiles.end());
+		vtmpTileTexCoords.insert(vtmpTileTexCoords.end(), vtmpBorderRightTilesTexCoords.begin(), vtmpBorderRightTilesTexCoords.end());
+
+		//setup params
+		float *pTmpTiles = vtmpTiles.empty() ? NULL : (float *)vtmpTiles.data();
+		unsigned char *pTmpTileTexCoords = vtmpTileTexCoords.empty() ? NULL : (unsigned char *)vtmpTileTexCoords.data();
+
+		size_t UploadDataSize = vtmpTileTexCoords.size() * sizeof(SGraphicTileTexureCoords) + vtmpTiles.size() * sizeof(SGraphicTile);
+		if(UploadDataSize > 0)
+		{
+			char *pUploadData = (char *)malloc(sizeof(char) * UploadDataSize);
+
+			mem_copy_special(pUploadData, pTmpTiles, sizeof(vec2), vtmpTiles.size() * 4, (m_DoTextureCoords ? sizeof(vec3) : 0));
+			if(m_DoTextureCoords)
+			{
+				mem_copy_special(pUploadData + sizeof(vec2), pTmpTileTexCoords, sizeof(vec3), vtmpTiles.size() * 4, sizeof(vec2));
+			}
+
+			m_aUploads[CurOverlay].m_pData = pUploadData;
+			m_aUploads[CurOverlay].m_Size = UploadDataSize;
+			m_aUploads[CurOverlay].m_NumTiles = vtmpTiles.size();
+		}
+	}
 }
 
 void CMapLayers::RenderTileLayer(int LayerIndex, ColorRGBA &Color, CMapItemLayerTilemap *pTileLayer, CMapItemGroup *pGroup)
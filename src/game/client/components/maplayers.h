@@ -2,9 +2,14 @@
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 #ifndef GAME_CLIENT_COMPONENTS_MAPLAYERS_H
 #define GAME_CLIENT_COMPONENTS_MAPLAYERS_H
+#include <base/color.h>
+
+#include <engine/shared/jobs.h>
+
 #include <game/client/component.h>
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #define INDEX_BUFFER_GROUP_WIDTH 12
@@ -18,7 +23,7 @@ typedef unsigned int offset_ptr32;
 class CCamera;
 class CLayers;
 class CMapImages;
-class ColorRGBA;
+class IMap;
 struct CMapItemGroup;
 struct CMapItemLayerTilemap;
 struct CMapItemLayerQuads;
@@ -37,6 +42,15 @@ class CMapLayers : public CComponent
 
 	bool m_OnlineOnly;
 
+	// the envelopes evaluated in the current frame, quads and sounds sharing an envelope reuse them
+	struct CEnvelopeCacheEntry
+	{
+		int64_t m_Frame = -1;
+		int m_TimeOffsetMillis = 0;
+		ColorRGBA m_Result;
+	};
+	std::vector<CEnvelopeCacheEntry> m_vEnvelopeCache;
+
 	struct STileLayerVisuals
 	{
 		STileLayerVisuals() :
@@ -107,6 +121,39 @@ class CMapLayers : public CComponent
 	};
 	std::vector<STileLayerVisuals *> m_vpTileLayerVisuals;
 
+	// builds the vertices of a tile layer and its overlays on the job pool, the buffers are created on the main thread
+	class CTileLayerJob : public IJob
+	{
+		void Run() override;
+
+	public:
+		~CTileLayerJob();
+
+		IMap *m_pMap;
+		int m_DataIndex;
+		CMapItemLayerTilemap *m_pTMap;
+		CMapItemGroup *m_pGroup;
+		bool m_IsGameLayer;
+		bool m_IsEntityLayer;
+		bool m_IsFrontLayer;
+		bool m_IsSwitchLayer;
+		bool m_IsTeleLayer;
+		bool m_IsSpeedupLayer;
+		bool m_IsTuneLayer;
+		bool m_DoTextureCoords;
+		bool m_As3DTextureCoords;
+		int m_OverlayCount;
+
+		STileLayerVisuals *m_apVisuals[3] = {};
+		// vertex data of each overlay, passed to the graphics on the main thread
+		struct SUpload
+		{
+			char *m_pData = nullptr;
+			size_t m_Size = 0;
+			size_t m_NumTiles = 0;
+		} m_aUploads[3];
+	};
+
 	struct SQuadLayerVisuals
 	{
 		SQuadLayerVisuals() :
@@ -36,8 +36,8 @@ void CNamePlates::RenderNameplatePos(vec2 Position, const CNetObj_PlayerInfo *pP
 
 	bool OtherTeam = m_pClient->IsOtherTeam(ClientID);
 
-	float FontSize = 18.0f + 20.0f * g_Config.m_ClNameplatesSize / 100.0f;
-	float FontSizeClan = 18.0f + 20.0f * g_Config.m_ClNameplatesClanSize / 100.0f;
+	float FontSize = NameFontSize();
+	float FontSizeClan = ClanFontSize();
 
 	TextRender()->SetRenderFlags(ETextRenderFlags::TEXT_RENDER_FLAG_NO_FIRST_CHARACTER_X_BEARING | ETextRenderFlags::TEXT_RENDER_FLAG_NO_LAST_CHARACTER_ADVANCE);
 	float YOffset = Position.y - 38;
@@ -295,6 +295,9 @@ void CNamePlates::OnRender()
 	if(!g_Config.m_ClNameplates && ShowDirection == 0)
 		return;
 
+	if(g_Config.m_ClNameplates)
+		PrewarmGlyphs();
+
 	// get screen edges to avoid rendering offscreen
 	float ScreenX0, ScreenY0, ScreenX1, ScreenY1;
 	Graphics()->GetScreen(&ScreenX0, &ScreenY0, &ScreenX1, &ScreenY1);
@@ -342,6 +345,62 @@ void CNamePlates::OnRender()
 	}
 }
 
+float CNamePlates::NameFontSize()
+{
+	return 18.0f + 20.0f * g_Config.m_ClNameplatesSize / 100.0f;
+}
+
+float CNamePlates::ClanFontSize()
+{
+	return 18.0f + 20.0f * g_Config.m_ClNameplatesClanSize / 100.0f;
+}
+
+void CNamePlates::PrewarmGlyphs()
+{
+	// the glyphs of players outside of the view are rendered in the background, so they don't stall once they come into view
+	const float FontSize = NameFontSize();
+	const float FontSizeClan = ClanFontSize();
+
+	bool MappedScreen = false;
+	float ScreenX0, ScreenY0, ScreenX1, ScreenY1;
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		if(!m_pClient->m_Snap.m_apPlayerInfos[i])
+			continue;
+
+		SPlayerNamePlate &NamePlate = m_aNamePlates[i];
+		const char *pName = m_pClient->m_aClients[i].m_aName;
+		const char *pClan = m_pClient->m_aClients[i].m_aClan;
+		const bool PrewarmName = FontSize != NamePlate.m_PrewarmedFontSize || str_comp(pName, NamePlate.m_aPrewarmedName) != 0;
+		const bool PrewarmClan = g_Config.m_ClNameplatesClan && (FontSizeClan != NamePlate.m_PrewarmedClanFontSize || str_comp(pClan, NamePlate.m_aPrewarmedClanName) != 0);
+		if(!PrewarmName && !PrewarmClan)
+			continue;
+
+		// the same mapping as the text containers
+		if(!MappedScreen)
+		{
+			Graphics()->GetScreen(&ScreenX0, &ScreenY0, &ScreenX1, &ScreenY1);
+			RenderTools()->MapScreenToInterface(m_pClient->m_Camera.m_Center.x, m_pClient->m_Camera.m_Center.y);
+			MappedScreen = true;
+		}
+		if(PrewarmName)
+		{
+			TextRender()->PrewarmGlyphs(FontSize, pName);
+			str_copy(NamePlate.m_aPrewarmedName, pName);
+			NamePlate.m_PrewarmedFontSize = FontSize;
+		}
+		if(PrewarmClan)
+		{
+			TextRender()->PrewarmGlyphs(FontSizeClan, pClan);
+			str_copy(NamePlate.m_aPrewarmedClanName, pClan);
+			NamePlate.m_PrewarmedClanFontSize = FontSizeClan;
+		}
+	}
+
+	if(MappedScreen)
+		Graphics()->MapScreen(ScreenX0, ScreenY0, ScreenX1, ScreenY1);
+}
+
 void CNamePlates::SetPlayers(CPlayers *pPlayers)
 {
 	m_pPlayers = pPlayers;
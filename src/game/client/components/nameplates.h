@@ -26,6 +26,9 @@ struct SPlayerNamePlate
 		m_aClanName[0] = 0;
 		m_NameTextWidth = m_ClanNameTextWidth = 0.f;
 		m_NameTextFontSize = m_ClanNameTextFontSize = 0;
+		m_aPrewarmedName[0] = 0;
+		m_aPrewarmedClanName[0] = 0;
+		m_PrewarmedFontSize = m_PrewarmedClanFontSize = 0;
 	}
 
 	char m_aName[MAX_NAME_LENGTH];
@@ -37,6 +40,12 @@ struct SPlayerNamePlate
 	float m_ClanNameTextWidth;
 	STextContainerIndex m_ClanNameTextContainerIndex;
 	float m_ClanNameTextFontSize;
+
+	// the texts and font sizes the glyphs were prewarmed for
+	char m_aPrewarmedName[MAX_NAME_LENGTH];
+	char m_aPrewarmedClanName[MAX_CLAN_LENGTH];
+	float m_PrewarmedFontSize;
+	float m_PrewarmedClanFontSize;
 };
 
 class CNamePlates : public CComponent
@@ -51,6 +60,9 @@ class CNamePlates : public CComponent
 	class CPlayers *m_pPlayers;
 
 	void ResetNamePlates();
+	static float NameFontSize();
+	static float ClanFontSize();
+	void PrewarmGlyphs();
 
 	int m_DirectionQuadContainerIndex;
 
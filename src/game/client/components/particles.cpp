@@ -10,6 +10,84 @@
 
 #include <game/client/gameclient.h>
 
+void CParticleGroup::Clear()
+{
+	Resize(0);
+}
+
+void CParticleGroup::Add(const CParticle &Part, float Life)
+{
+	m_vPosX.push_back(Part.m_Pos.x);
+	m_vPosY.push_back(Part.m_Pos.y);
+	m_vVelX.push_back(Part.m_Vel.x);
+	m_vVelY.push_back(Part.m_Vel.y);
+	m_vGravity.push_back(Part.m_Gravity);
+	m_vFriction.push_back(Part.m_Friction);
+	m_vLife.push_back(Life);
+	m_vLifeSpan.push_back(Part.m_LifeSpan);
+	m_vRot.push_back(Part.m_Rot);
+	m_vRotspeed.push_back(Part.m_Rotspeed);
+	m_vCollides.push_back(Part.m_Collides);
+
+	CParticleLook Look;
+	Look.m_Spr = Part.m_Spr;
+	Look.m_StartSize = Part.m_StartSize;
+	Look.m_EndSize = Part.m_EndSize;
+	Look.m_UseAlphaFading = Part.m_UseAlphaFading;
+	Look.m_StartAlpha = Part.m_StartAlpha;
+	Look.m_EndAlpha = Part.m_EndAlpha;
+	Look.m_Color = Part.m_Color;
+	m_vLooks.push_back(Look);
+}
+
+void CParticleGroup::Move(int From, int To)
+{
+	m_vPosX[To] = m_vPosX[From];
+	m_vPosY[To] = m_vPosY[From];
+	m_vVelX[To] = m_vVelX[From];
+	m_vVelY[To] = m_vVelY[From];
+	m_vGravity[To] = m_vGravity[From];
+	m_vFriction[To] = m_vFriction[From];
+	m_vLife[To] = m_vLife[From];
+	m_vLifeSpan[To] = m_vLifeSpan[From];
+	m_vRot[To] = m_vRot[From];
+	m_vRotspeed[To] = m_vRotspeed[From];
+	m_vCollides[To] = m_vCollides[From];
+	m_vLooks[To] = m_vLooks[From];
+}
+
+void CParticleGroup::Resize(int Num)
+{
+	m_vPosX.resize(Num);
+	m_vPosY.resize(Num);
+	m_vVelX.resize(Num);
+	m_vVelY.resize(Num);
+	m_vGravity.resize(Num);
+	m_vFriction.resize(Num);
+	m_vLife.resize(Num);
+	m_vLifeSpan.resize(Num);
+	m_vRot.resize(Num);
+	m_vRotspeed.resize(Num);
+	m_vCollides.resize(Num);
+	m_vLooks.resize(Num);
+}
+
+int CParticleGroup::RemoveDead()
+{
+	const int OldNum = Num();
+	int NewNum = 0;
+	for(int i = 0; i < OldNum; i++)
+	{
+		if(m_vLife[i] > m_vLifeSpan[i])
+			continue;
+		if(i != NewNum)
+			Move(i, NewNum);
+		NewNum++;
+	}
+	Resize(NewNum);
+	return OldNum - NewNum;
+}
+
 CParticles::CParticles()
 {
 	OnReset();
@@ -22,18 +100,9 @@ CParticles::CParticles()
 void CParticles::OnReset()
 {
 	// reset particles
-	for(int i = 0; i < MAX_PARTICLES; i++)
-	{
-		m_aParticles[i].m_PrevPart = i - 1;
-		m_aParticles[i].m_NextPart = i + 1;
-	}
-
-	m_aParticles[0].m_PrevPart = 0;
-	m_aParticles[MAX_PARTICLES - 1].m_NextPart = -1;
-	m_FirstFree = 0;
-
-	for(int &FirstPart : m_aFirstPart)
-		FirstPart = -1;
+	for(auto &Group : m_aGroups)
+		Group.Clear();
+	m_NumParticles = 0;
 }
 
 void CParticles::Add(int Group, CParticle *pPart, float TimePassed)
@@ -50,27 +119,11 @@ void CParticles::Add(int Group, CParticle *pPart, float TimePassed)
 			return;
 	}
 
-	if(m_FirstFree == -1)
+	if(m_NumParticles == MAX_PARTICLES)
 		return;
 
-	// remove from the free list
-	int Id = m_FirstFree;
-	m_FirstFree = m_aParticles[Id].m_NextPart;
-	if(m_FirstFree != -1)
-		m_aParticles[m_FirstFree].m_PrevPart = -1;
-
-	// copy data
-	m_aParticles[Id] = *pPart;
-
-	// insert to the group list
-	m_aParticles[Id].m_PrevPart = -1;
-	m_aParticles[Id].m_NextPart = m_aFirstPart[Group];
-	if(m_aFirstPart[Group] != -1)
-		m_aParticles[m_aFirstPart[Group]].m_PrevPart = Id;
-	m_aFirstPart[Group] = Id;
-
-	// set some parameters
-	m_aParticles[Id].m_Life = TimePassed;
+	m_aGroups[Group].Add(*pPart, TimePassed);
+	m_NumParticles++;
 }
 
 void CParticles::Update(float TimePassed)
@@ -91,55 +144,73 @@ void CParticles::Update(float TimePassed)
 		FrictionFraction -= 0.05f;
 	}
 
-	for(int &FirstPart : m_aFirstPart)
+	for(auto &Group : m_aGroups)
 	{
-		int i = FirstPart;
-		while(i != -1)
+		const int Num = Group.Num();
+		float *pPosX = Group.m_vPosX.data();
+		float *pPosY = Group.m_vPosY.data();
+		float *pVelX = Group.m_vVelX.data();
+		float *pVelY = Group.m_vVelY.data();
+		const float *pGravity = Group.m_vGravity.data();
+		const float *pFriction = Group.m_vFriction.data();
+		float *pLife = Group.m_vLife.data();
+		float *pRot = Group.m_vRot.data();
+		const float *pRotspeed = Group.m_vRotspeed.data();
+
+		for(int i = 0; i < Num; i++)
+			pVelY[i] += pGravity[i] * TimePassed;
+
+		// apply friction once for every 50ms passed
+		if(FrictionCount == 1)
 		{
-			int Next = m_aParticles[i].m_NextPart;
-			//m_aParticles[i].vel += flow_get(m_aParticles[i].pos)*time_passed * m_aParticles[i].flow_affected;
-			m_aParticles[i].m_Vel.y += m_aParticles[i].m_Gravity * TimePassed;
-
-			for(int f = 0; f < FrictionCount; f++) // apply friction
-				m_aParticles[i].m_Vel *= m_aParticles[i].m_Friction;
-
-			// move the point
-			vec2 Vel = m_aParticles[i].m_Vel * TimePassed;
-			if(m_aParticles[i].m_Collides)
+			for(int i = 0; i < Num; i++)
 			{
-				Collision()->MovePoint(&m_aParticles[i].m_Pos, &Vel, random_float(0.1f, 1.0f), NULL);
+				pVelX[i] *= pFriction[i];
+				pVelY[i] *= pFriction[i];
 			}
-			else
+		}
+		else if(FrictionCount > 1)
+		{
+			for(int i = 0; i < Num; i++)
 			{
-				m_aParticles[i].m_Pos += Vel;
+				const float Friction = std::pow(pFriction[i], FrictionCount);
+				pVelX[i] *= Friction;
+				pVelY[i] *= Friction;
 			}
-			m_aParticles[i].m_Vel = Vel * (1.0f / TimePassed);
-
-			m_aParticles[i].m_Life += TimePassed;
-			m_aParticles[i].m_Rot += TimePassed * m_aParticles[i].m_Rotspeed;
+		}
 
-			// check particle death
-			if(m_aParticles[i].m_Life > m_aParticles[i].m_LifeSpan)
-			{
-				// remove it from the group list
-				if(m_aParticles[i].m_PrevPart != -1)
-					m_aParticles[m_aParticles[i].m_PrevPart].m_NextPart = m_aParticles[i].m_NextPart;
-				else
-					FirstPart = m_aParticles[i].m_NextPart;
-
-				if(m_aParticles[i].m_NextPart != -1)
-					m_aParticles[m_aParticles[i].m_NextPart].m_PrevPart = m_aParticles[i].m_PrevPart;
-
-				// insert to the free list
-				if(m_FirstFree != -1)
-					m_aParticles[m_FirstFree].m_PrevPart = i;
-				m_aParticles[i].m_PrevPart = -1;
-				m_aParticles[i].m_NextPart = m_FirstFree;
-				m_FirstFree = i;
-			}
+		// move the points, only the ones that hit a solid tile need the bounce
+		m_vCollidingPos.clear();
+		for(int i = 0; i < Num; i++)
+		{
+			if(Group.m_vCollides[i])
+				m_vCollidingPos.emplace_back(i, vec2(pPosX[i], pPosY[i]));
+		}
+		for(int i = 0; i < Num; i++)
+		{
+			pPosX[i] += pVelX[i] * TimePassed;
+			pPosY[i] += pVelY[i] * TimePassed;
+		}
+		for(auto &[Index, Pos] : m_vCollidingPos)
+		{
+			vec2 Vel = vec2(pVelX[Index], pVelY[Index]) * TimePassed;
+			if(!Collision()->CheckPoint(Pos + Vel))
+				continue;
+			Collision()->MovePoint(&Pos, &Vel, random_float(0.1f, 1.0f), NULL);
+			pPosX[Index] = Pos.x;
+			pPosY[Index] = Pos.y;
+			pVelX[Index] = Vel.x * (1.0f / TimePassed);
+			pVelY[Index] = Vel.y * (1.0f / TimePassed);
+		}
 
-			i = Next;
+		for(int i = 0; i < Num; i++)
+		{
+			pLife[i] += TimePassed;
+			pRot[i] += TimePassed * pRotspeed[i];
 		}
+
+		// check particle death
+		m_NumParticles -= Group.RemoveDead();
 	}
 }
 
@@ -216,11 +287,12 @@ void CParticles::RenderGroup(int Group)
 		ParticleQuadContainerIndex = m_ExtraParticleQuadContainerIndex;
 	}
 
+	const CParticleGroup &Particles = m_aGroups[Group];
+	const int Num = Particles.Num();
+
 	// don't use the buffer methods here, else the old renderer gets many draw calls
 	if(Graphics()->IsQuadContainerBufferingEnabled())
 	{
-		int i = m_aFirstPart[Group];
-
 		static IGraphics::SRenderSpriteInfo s_aParticleRenderInfo[MAX_PARTICLES];
 
 		int CurParticleRenderCount = 0;
@@ -229,44 +301,48 @@ void CParticles::RenderGroup(int Group)
 		ColorRGBA LastColor;
 		int LastQuadOffset = 0;
 
-		if(i != -1)
+		// newest particles first
+		int i = Num - 1;
+		if(i >= 0)
 		{
-			float Alpha = m_aParticles[i].m_Color.a;
-			if(m_aParticles[i].m_UseAlphaFading)
+			const CParticleLook &Look = Particles.m_vLooks[i];
+			float Alpha = Look.m_Color.a;
+			if(Look.m_UseAlphaFading)
 			{
-				float a = m_aParticles[i].m_Life / m_aParticles[i].m_LifeSpan;
-				Alpha = mix(m_aParticles[i].m_StartAlpha, m_aParticles[i].m_EndAlpha, a);
+				float a = Particles.m_vLife[i] / Particles.m_vLifeSpan[i];
+				Alpha = mix(Look.m_StartAlpha, Look.m_EndAlpha, a);
 			}
-			LastColor.r = m_aParticles[i].m_Color.r;
-			LastColor.g = m_aParticles[i].m_Color.g;
-			LastColor.b = m_aParticles[i].m_Color.b;
+			LastColor.r = Look.m_Color.r;
+			LastColor.g = Look.m_Color.g;
+			LastColor.b = Look.m_Color.b;
 			LastColor.a = Alpha;
 
 			Graphics()->SetColor(
-				m_aParticles[i].m_Color.r,
-				m_aParticles[i].m_Color.g,
-				m_aParticles[i].m_Color.b,
+				Look.m_Color.r,
+				Look.m_Color.g,
+				Look.m_Color.b,
 				Alpha);
 
-			LastQuadOffset = m_aParticles[i].m_Spr;
+			LastQuadOffset = Look.m_Spr;
 		}
 
-		while(i != -1)
+		for(; i >= 0; i--)
 		{
-			int QuadOffset = m_aParticles[i].m_Spr;
-			float a = m_aParticles[i].m_Life / m_aParticles[i].m_LifeSpan;
-			vec2 p = m_aParticles[i].m_Pos;
-			float Size = mix(m_aParticles[i].m_StartSize, m_aParticles[i].m_EndSize, a);
-			float Alpha = m_aParticles[i].m_Color.a;
-			if(m_aParticles[i].m_UseAlphaFading)
+			const CParticleLook &Look = Particles.m_vLooks[i];
+			int QuadOffset = Look.m_Spr;
+			float a = Particles.m_vLife[i] / Particles.m_vLifeSpan[i];
+			vec2 p = vec2(Particles.m_vPosX[i], Particles.m_vPosY[i]);
+			float Size = mix(Look.m_StartSize, Look.m_EndSize, a);
+			float Alpha = Look.m_Color.a;
+			if(Look.m_UseAlphaFading)
 			{
-				Alpha = mix(m_aParticles[i].m_StartAlpha, m_aParticles[i].m_EndAlpha, a);
+				Alpha = mix(Look.m_StartAlpha, Look.m_EndAlpha, a);
 			}
 
 			// the current position, respecting the size, is inside the viewport, render it, else ignore
 			if(ParticleIsVisibleOnScreen(p, Size))
 			{
-				if((size_t)CurParticleRenderCount == gs_GraphicsMaxParticlesRenderCount || LastColor.r != m_aParticles[i].m_Color.r || LastColor.g != m_aParticles[i].m_Color.g || LastColor.b != m_aParticles[i].m_Color.b || LastColor.a != Alpha || LastQuadOffset != QuadOffset)
+				if((size_t)CurParticleRenderCount == gs_GraphicsMaxParticlesRenderCount || LastColor.r != Look.m_Color.r || LastColor.g != Look.m_Color.g || LastColor.b != Look.m_Color.b || LastColor.a != Alpha || LastQuadOffset != QuadOffset)
 				{
 					Graphics()->TextureSet(aParticles[LastQuadOffset - FirstParticleOffset]);
 					Graphics()->RenderQuadContainerAsSpriteMultiple(ParticleQuadContainerIndex, LastQuadOffset - FirstParticleOffset, CurParticleRenderCount, s_aParticleRenderInfo);
@@ -274,26 +350,24 @@ void CParticles::RenderGroup(int Group)
 					LastQuadOffset = QuadOffset;
 
 					Graphics()->SetColor(
-						m_aParticles[i].m_Color.r,
-						m_aParticles[i].m_Color.g,
-						m_aParticles[i].m_Color.b,
+						Look.m_Color.r,
+						Look.m_Color.g,
+						Look.m_Color.b,
 						Alpha);
 
-					LastColor.r = m_aParticles[i].m_Color.r;
-					LastColor.g = m_aParticles[i].m_Color.g;
-					LastColor.b = m_aParticles[i].m_Color.b;
+					LastColor.r = Look.m_Color.r;
+					LastColor.g = Look.m_Color.g;
+					LastColor.b = Look.m_Color.b;
 					LastColor.a = Alpha;
 				}
 
 				s_aParticleRenderInfo[CurParticleRenderCount].m_Pos[0] = p.x;
 				s_aParticleRenderInfo[CurParticleRenderCount].m_Pos[1] = p.y;
 				s_aParticleRenderInfo[CurParticleRenderCount].m_Scale = Size;
-				s_aParticleRenderInfo[CurParticleRenderCount].m_Rotation = m_aParticles[i].m_Rot;
+				s_aParticleRenderInfo[CurParticleRenderCount].m_Rotation = Particles.m_vRot[i];
 
 				++CurParticleRenderCount;
 			}
-
-			i = m_aParticles[i].m_NextPart;
 		}
 
 		Graphics()->TextureSet(aParticles[LastQuadOffset - FirstParticleOffset]);
@@ -301,42 +375,39 @@ void CParticles::RenderGroup(int Group)
 	}
 	else
 	{
-		int i = m_aFirstPart[Group];
-
 		Graphics()->BlendNormal();
 		Graphics()->WrapClamp();
 
-		while(i != -1)
+		for(int i = Num - 1; i >= 0; i--)
 		{
-			float a = m_aParticles[i].m_Life / m_aParticles[i].m_LifeSpan;
-			vec2 p = m_aParticles[i].m_Pos;
-			float Size = mix(m_aParticles[i].m_StartSize, m_aParticles[i].m_EndSize, a);
-			float Alpha = m_aParticles[i].m_Color.a;
-			if(m_aParticles[i].m_UseAlphaFading)
+			const CParticleLook &Look = Particles.m_vLooks[i];
+			float a = Particles.m_vLife[i] / Particles.m_vLifeSpan[i];
+			vec2 p = vec2(Particles.m_vPosX[i], Particles.m_vPosY[i]);
+			float Size = mix(Look.m_StartSize, Look.m_EndSize, a);
+			float Alpha = Look.m_Color.a;
+			if(Look.m_UseAlphaFading)
 			{
-				Alpha = mix(m_aParticles[i].m_StartAlpha, m_aParticles[i].m_EndAlpha, a);
+				Alpha = mix(Look.m_StartAlpha, Look.m_EndAlpha, a);
 			}
 
 			// the current position, respecting the size, is inside the viewport, render it, else ignore
 			if(ParticleIsVisibleOnScreen(p, Size))
 			{
-				Graphics()->TextureSet(aParticles[m_aParticles[i].m_Spr - FirstParticleOffset]);
+				Graphics()->TextureSet(aParticles[Look.m_Spr - FirstParticleOffset]);
 				Graphics()->QuadsBegin();
 
-				Graphics()->QuadsSetRotation(m_aParticles[i].m_Rot);
+				Graphics()->QuadsSetRotation(Particles.m_vRot[i]);
 
 				Graphics()->SetColor(
-					m_aParticles[i].m_Color.r,
-					m_aParticles[i].m_Color.g,
-					m_aParticles[i].m_Color.b,
+					Look.m_Color.r,
+					Look.m_Color.g,
+					Look.m_Color.b,
 					Alpha);
 
 				IGraphics::CQuadItem QuadItem(p.x, p.y, Size, Size);
 				Graphics()->QuadsDraw(&QuadItem, 1);
 				Graphics()->QuadsEnd();
 			}
-
-			i = m_aParticles[i].m_NextPart;
 		}
 		Graphics()->WrapNormal();
 		Graphics()->BlendNormal();
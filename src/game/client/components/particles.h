@@ -5,6 +5,9 @@
 #include <base/vmath.h>
 #include <game/client/component.h>
 
+#include <utility>
+#include <vector>
+
 // particles
 struct CParticle
 {
@@ -51,11 +54,46 @@ struct CParticle
 	ColorRGBA m_Color;
 
 	bool m_Collides;
+};
 
-	// set by the particle system
-	float m_Life;
-	int m_PrevPart;
-	int m_NextPart;
+// the parts of a particle that are only needed for rendering
+struct CParticleLook
+{
+	int m_Spr;
+	float m_StartSize;
+	float m_EndSize;
+	bool m_UseAlphaFading;
+	float m_StartAlpha;
+	float m_EndAlpha;
+	ColorRGBA m_Color;
+};
+
+// the particles of a group, oldest first, stored as structure of arrays
+// so the simulation can run over plain float arrays
+class CParticleGroup
+{
+	void Move(int From, int To);
+	void Resize(int Num);
+
+public:
+	std::vector<float> m_vPosX;
+	std::vector<float> m_vPosY;
+	std::vector<float> m_vVelX;
+	std::vector<float> m_vVelY;
+	std::vector<float> m_vGravity;
+	std::vector<float> m_vFriction;
+	std::vector<float> m_vLife;
+	std::vector<float> m_vLifeSpan;
+	std::vector<float> m_vRot;
+	std::vector<float> m_vRotspeed;
+	std::vector<bool> m_vCollides;
+	std::vector<CParticleLook> m_vLooks;
+
+	int Num() const { return m_vPosX.size(); }
+	void Clear();
+	void Add(const CParticle &Part, float Life);
+	// removes the particles past their life span, the others keep their order, returns the number of removed ones
+	int RemoveDead();
 };
 
 class CParticles : public CComponent
@@ -90,9 +128,10 @@ private:
 		MAX_PARTICLES = 1024 * 8,
 	};
 
-	CParticle m_aParticles[MAX_PARTICLES];
-	int m_FirstFree;
-	int m_aFirstPart[NUM_GROUPS];
+	CParticleGroup m_aGroups[NUM_GROUPS];
+	int m_NumParticles;
+	// positions of the colliding particles before they are moved
+	std::vector<std::pair<int, vec2>> m_vCollidingPos;
 
 	void RenderGroup(int Group);
 	void Update(float TimePassed);
@@ -32,6 +32,12 @@ void CScoreboard::OnReset()
 {
 	m_Active = false;
 	m_ServerRecord = -1.0f;
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		m_aaPrewarmedNames[i][0] = '\0';
+		m_aaPrewarmedClans[i][0] = '\0';
+	}
+	m_PrewarmedFontSize = 0.0f;
 }
 
 void CScoreboard::OnRelease()
@@ -263,14 +269,13 @@ void CScoreboard::RenderScoreboard(float x, float y, float w, int Team, const ch
 	float TeeSizeMod = 1.0f;
 	float Spacing = 16.0f;
 	float RoundRadius = 15.0f;
-	float FontSize = 24.0f;
+	const float FontSize = PlayerFontSize(NumPlayers);
 	if(NumPlayers > 48)
 	{
 		LineHeight = 20.0f;
 		TeeSizeMod = 0.4f;
 		Spacing = 0.0f;
 		RoundRadius = 5.0f;
-		FontSize = 16.0f;
 	}
 	else if(NumPlayers > 32)
 	{
@@ -278,7 +283,6 @@ void CScoreboard::RenderScoreboard(float x, float y, float w, int Team, const ch
 		TeeSizeMod = 0.6f;
 		Spacing = 0.0f;
 		RoundRadius = 5.0f;
-		FontSize = 20.0f;
 	}
 	else if(NumPlayers > 12)
 	{
@@ -589,8 +593,72 @@ void CScoreboard::RenderRecordingNotification(float x)
 	TextRender()->Text(x + 50.0f, (50.f - 20.f) / 2.f, 20.0f, aBuf, -1.0f);
 }
 
+int CScoreboard::NumPlayerLines() const
+{
+	// team games show both teams with the size of the larger one
+	if(m_pClient->IsTeamPlay())
+		return maximum(m_pClient->m_Snap.m_aTeamSize[TEAM_RED], m_pClient->m_Snap.m_aTeamSize[TEAM_BLUE]);
+	return m_pClient->m_Snap.m_aTeamSize[0];
+}
+
+float CScoreboard::PlayerFontSize(int NumPlayers)
+{
+	if(NumPlayers > 48)
+		return 16.0f;
+	else if(NumPlayers > 32)
+		return 20.0f;
+	return 24.0f;
+}
+
+void CScoreboard::PrewarmGlyphs()
+{
+	const float FontSize = PlayerFontSize(NumPlayerLines());
+	const bool NewFontSize = FontSize != m_PrewarmedFontSize;
+
+	bool MappedScreen = false;
+	float ScreenX0, ScreenY0, ScreenX1, ScreenY1;
+	auto &&Prewarm = [&](const char *pText) {
+		if(!MappedScreen)
+		{
+			Graphics()->GetScreen(&ScreenX0, &ScreenY0, &ScreenX1, &ScreenY1);
+			Graphics()->MapScreen(0, 0, 400 * 3.0f * Graphics()->ScreenAspect(), 400 * 3.0f);
+			MappedScreen = true;
+		}
+		TextRender()->PrewarmGlyphs(FontSize, pText);
+	};
+
+	if(NewFontSize)
+	{
+		// scores, times and pings
+		Prewarm("0123456789:.-");
+		m_PrewarmedFontSize = FontSize;
+	}
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		const CGameClient::CClientData &ClientData = m_pClient->m_aClients[i];
+		if(!ClientData.m_Active)
+			continue;
+		if(NewFontSize || str_comp(ClientData.m_aName, m_aaPrewarmedNames[i]) != 0)
+		{
+			Prewarm(ClientData.m_aName);
+			str_copy(m_aaPrewarmedNames[i], ClientData.m_aName);
+		}
+		if(NewFontSize || str_comp(ClientData.m_aClan, m_aaPrewarmedClans[i]) != 0)
+		{
+			Prewarm(ClientData.m_aClan);
+			str_copy(m_aaPrewarmedClans[i], ClientData.m_aClan);
+		}
+	}
+
+	if(MappedScreen)
+		Graphics()->MapScreen(ScreenX0, ScreenY0, ScreenX1, ScreenY1);
+}
+
 void CScoreboard::OnRender()
 {
+	// the glyphs of new players are rendered in the background, so opening the scoreboard doesn't stall
+	PrewarmGlyphs();
+
 	if(!Active())
 		return;
 
@@ -663,7 +731,7 @@ void CScoreboard::OnRender()
 			//decrease width, because team games use additional offsets
 			w -= 10.0f;
 
-			int NumPlayers = maximum(m_pClient->m_Snap.m_aTeamSize[TEAM_RED], m_pClient->m_Snap.m_aTeamSize[TEAM_BLUE]);
+			const int NumPlayers = NumPlayerLines();
 			RenderScoreboard(Width / 2 - w - 5.0f, 150.0f, w, TEAM_RED, pRedClanName ? pRedClanName : Localize("Red team"), NumPlayers);
 			RenderScoreboard(Width / 2 + 5.0f, 150.0f, w, TEAM_BLUE, pBlueClanName ? pBlueClanName : Localize("Blue team"), NumPlayers);
 		}
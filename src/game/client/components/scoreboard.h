@@ -4,6 +4,7 @@
 #define GAME_CLIENT_COMPONENTS_SCOREBOARD_H
 
 #include <engine/console.h>
+#include <engine/shared/protocol.h>
 
 #include <game/client/component.h>
 
@@ -13,6 +14,10 @@ class CScoreboard : public CComponent
 	void RenderSpectators(float x, float y, float w, float h);
 	void RenderScoreboard(float x, float y, float w, int Team, const char *pTitle, int NumPlayers = -1);
 	void RenderRecordingNotification(float x);
+	// the number of players RenderScoreboard sizes the lines for
+	int NumPlayerLines() const;
+	static float PlayerFontSize(int NumPlayers);
+	void PrewarmGlyphs();
 
 	static void ConKeyScoreboard(IConsole::IResult *pResult, void *pUserData);
 
@@ -36,6 +41,11 @@ public:
 
 private:
 	float m_ServerRecord;
+
+	// the names and font size the glyphs were prewarmed for
+	char m_aaPrewarmedNames[MAX_CLIENTS][MAX_NAME_LENGTH];
+	char m_aaPrewarmedClans[MAX_CLIENTS][MAX_CLAN_LENGTH];
+	float m_PrewarmedFontSize;
 };
 
 #endif
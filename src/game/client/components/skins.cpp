@@ -16,6 +16,10 @@
 
 #include "skins.h"
 
+#include <chrono>
+
+using namespace std::chrono_literals;
+
 bool CSkins::IsVanillaSkin(const char *pName)
 {
 	return std::any_of(std::begin(VANILLA_SKINS), std::end(VANILLA_SKINS), [pName](const char *pVanillaSkin) { return str_comp(pName, pVanillaSkin) == 0; });
@@ -41,6 +45,42 @@ CSkins::CGetPngFile::CGetPngFile(CSkins *pSkins, const char *pUrl, IStorage *pSt
 	LogProgress(HTTPLOG::NONE);
 }
 
+CSkins::CSkinLoadJob::CSkinLoadJob(CSkins *pSkins, const char *pName, const char *pPath, int DirType) :
+	m_pSkins(pSkins),
+	m_DirType(DirType)
+{
+	str_copy(m_aName, pName);
+	str_copy(m_aPath, pPath);
+	sphore_init(&m_Done);
+}
+
+CSkins::CSkinLoadJob::~CSkinLoadJob()
+{
+	// not uploaded, e.g. aborted by a refresh
+	free(m_Skin.m_Info.m_pData);
+	free(m_Skin.m_ColorableInfo.m_pData);
+	sphore_destroy(&m_Done);
+}
+
+void CSkins::CSkinLoadJob::Run()
+{
+	if(!m_Abort)
+	{
+		// warnings and console output are left to the render thread
+		m_Loaded = m_pSkins->Graphics()->LoadPNG(&m_Skin.m_Info, m_aPath, m_DirType, m_PngliteIncompatible);
+		// so are images that need fixing up
+		if(m_Loaded && IsSkinImageValid(m_Skin.m_Info))
+			m_Prepared = m_pSkins->PrepareSkinCached(m_Skin, m_aPath, m_DirType);
+	}
+	sphore_signal(&m_Done);
+}
+
+void CSkins::CSkinLoadJob::Wait()
+{
+	if(Status() != IJob::STATE_DONE)
+		sphore_wait(&m_Done);
+}
+
 struct SSkinScanUser
 {
 	CSkins *m_pThis;
@@ -67,10 +107,21 @@ int CSkins::SkinScan(const char *pName, int IsDir, int DirType, void *pUser)
 	if(pSelf->m_Skins.find(aNameWithoutPng) != pSelf->m_Skins.end())
 		return 0;
 
+	if(pSelf->m_LoadingSkins.find(aNameWithoutPng) != pSelf->m_LoadingSkins.end())
+		return 0;
+
 	char aBuf[IO_MAX_PATH_LENGTH];
 	str_format(aBuf, sizeof(aBuf), "skins/%s", pName);
-	pSelf->LoadSkin(aNameWithoutPng, aBuf, DirType);
-	pUserReal->m_SkinLoadedFunc((int)pSelf->m_Skins.size());
+	// the default skin is the fallback for all others, so it has to be there right away
+	if(g_Config.m_ClThreadskinloading && str_comp(aNameWithoutPng, "default") != 0)
+	{
+		auto pJob = std::make_shared<CSkinLoadJob>(pSelf, aNameWithoutPng, aBuf, DirType);
+		pSelf->m_pClient->Engine()->AddJob(pJob);
+		pSelf->m_LoadingSkins.insert({pJob->m_aName, pJob});
+	}
+	else
+		pSelf->LoadSkin(aNameWithoutPng, aBuf, DirType);
+	pUserReal->m_SkinLoadedFunc((int)(pSelf->m_Skins.size() + pSelf->m_LoadingSkins.size()));
 	return 0;
 }
 
@@ -114,7 +165,18 @@ const CSkin *CSkins::LoadSkin(const char *pName, const char *pPath, int DirType)
 	CImageInfo Info;
 	if(!LoadSkinPNG(Info, pName, pPath, DirType))
 		return 0;
-	return LoadSkin(pName, Info);
+	if(!IsSkinImageValid(Info))
+		return LoadSkin(pName, Info);
+
+	CPreparedSkin Skin;
+	Skin.m_Info = Info;
+	if(!PrepareSkinCached(Skin, pPath, DirType))
+	{
+		Graphics()->FreePNG(&Skin.m_Info);
+		Graphics()->FreePNG(&Skin.m_ColorableInfo);
+		return nullptr;
+	}
+	return UploadSkin(pName, Skin);
 }
 
 bool CSkins::LoadSkinPNG(CImageInfo &Info, const char *pName, const char *pPath, int DirType)
@@ -146,17 +208,23 @@ const CSkin *CSkins::LoadSkin(const char *pName, CImageInfo &Info)
 		return nullptr;
 	}
 
-	CSkin Skin{pName};
-	Skin.m_OriginalSkin.m_Body = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_BODY]);
-	Skin.m_OriginalSkin.m_BodyOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_BODY_OUTLINE]);
-	Skin.m_OriginalSkin.m_Feet = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT]);
-	Skin.m_OriginalSkin.m_FeetOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT_OUTLINE]);
-	Skin.m_OriginalSkin.m_Hands = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_HAND]);
-	Skin.m_OriginalSkin.m_HandsOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_HAND_OUTLINE]);
+	CPreparedSkin Skin;
+	Skin.m_Info = Info;
+	if(!PrepareSkin(Skin))
+		return nullptr;
+	Info.m_pData = nullptr;
+	return UploadSkin(pName, Skin);
+}
 
-	for(int i = 0; i < 6; ++i)
-		Skin.m_OriginalSkin.m_aEyes[i] = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_EYE_NORMAL + i]);
+bool CSkins::IsSkinImageValid(const CImageInfo &Info)
+{
+	const CDataSpriteset *pSet = g_pData->m_aSprites[SPRITE_TEE_BODY].m_pSet;
+	return Info.m_Format == CImageInfo::FORMAT_RGBA && Info.m_Width > 0 && Info.m_Height > 0 && Info.m_Width % pSet->m_Gridx == 0 && Info.m_Height % pSet->m_Gridy == 0;
+}
 
+bool CSkins::PrepareSkin(CPreparedSkin &Skin)
+{
+	const CImageInfo &Info = Skin.m_Info;
 	int FeetGridPixelsWidth = (Info.m_Width / g_pData->m_aSprites[SPRITE_TEE_FOOT].m_pSet->m_Gridx);
 	int FeetGridPixelsHeight = (Info.m_Height / g_pData->m_aSprites[SPRITE_TEE_FOOT].m_pSet->m_Gridy);
 	int FeetWidth = g_pData->m_aSprites[SPRITE_TEE_FOOT].m_W * FeetGridPixelsWidth;
@@ -184,7 +252,7 @@ const CSkin *CSkins::LoadSkin(const char *pName, CImageInfo &Info)
 	int BodyWidth = g_pData->m_aSprites[SPRITE_TEE_BODY].m_W * (Info.m_Width / g_pData->m_aSprites[SPRITE_TEE_BODY].m_pSet->m_Gridx); // body width
 	int BodyHeight = g_pData->m_aSprites[SPRITE_TEE_BODY].m_H * (Info.m_Height / g_pData->m_aSprites[SPRITE_TEE_BODY].m_pSet->m_Gridy); // body height
 	if(BodyWidth > Info.m_Width || BodyHeight > Info.m_Height)
-		return nullptr;
+		return false;
 	unsigned char *pData = (unsigned char *)Info.m_pData;
 	const int PixelStep = 4;
 	int Pitch = Info.m_Width * PixelStep;
@@ -220,7 +288,16 @@ const CSkin *CSkins::LoadSkin(const char *pName, CImageInfo &Info)
 	// get feet outline size
 	CheckMetrics(Skin.m_Metrics.m_Feet, pData, Pitch, FeetOutlineOffsetX, FeetOutlineOffsetY, FeetOutlineWidth, FeetOutlineHeight);
 
-	// make the texture gray scale
+	// the colorable image can come from the image cache
+	if(Skin.m_ColorableInfo.m_pData)
+		return true;
+
+	// make a gray scale copy of the texture
+	const size_t DataSize = (size_t)Info.m_Width * Info.m_Height * PixelStep;
+	Skin.m_ColorableInfo = Info;
+	Skin.m_ColorableInfo.m_pData = malloc(DataSize);
+	mem_copy(Skin.m_ColorableInfo.m_pData, Info.m_pData, DataSize);
+	pData = (unsigned char *)Skin.m_ColorableInfo.m_pData;
 	for(int i = 0; i < Info.m_Width * Info.m_Height; i++)
 	{
 		int v = (pData[i * PixelStep] + pData[i * PixelStep + 1] + pData[i * PixelStep + 2]) / 3;
@@ -267,35 +344,137 @@ const CSkin *CSkins::LoadSkin(const char *pName, CImageInfo &Info)
 			pData[y * Pitch + x * PixelStep + 2] = v;
 		}
 
-	Skin.m_ColorableSkin.m_Body = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_BODY]);
-	Skin.m_ColorableSkin.m_BodyOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_BODY_OUTLINE]);
-	Skin.m_ColorableSkin.m_Feet = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT]);
-	Skin.m_ColorableSkin.m_FeetOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT_OUTLINE]);
-	Skin.m_ColorableSkin.m_Hands = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_HAND]);
-	Skin.m_ColorableSkin.m_HandsOutline = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_HAND_OUTLINE]);
+	return true;
+}
+
+bool CSkins::PrepareSkinCached(CPreparedSkin &Skin, const char *pPath, int DirType)
+{
+	CImageCache::CSource Source;
+	if(!m_ImageCache.Enabled() || !m_ImageCache.FindSource(pPath, DirType, &Source))
+		return PrepareSkin(Skin);
+
+	// like LoadPNG, fall back to the content hash if the skin was touched
+	CImageInfo &Colorable = Skin.m_ColorableInfo;
+	bool Cached = m_ImageCache.Load(Source, "colorable", &Colorable);
+	if(!Cached && Source.ReadHash())
+		Cached = m_ImageCache.Load(Source, "colorable", &Colorable);
+	if(Cached && (Colorable.m_Width != Skin.m_Info.m_Width || Colorable.m_Height != Skin.m_Info.m_Height || Colorable.m_Format != Skin.m_Info.m_Format))
+	{
+		free(Colorable.m_pData);
+		Colorable.m_pData = nullptr;
+		Cached = false;
+	}
+	if(!PrepareSkin(Skin))
+		return false;
+	if(!Cached)
+		m_ImageCache.Store(Source, "colorable", Colorable);
+	return true;
+}
+
+const CSkin *CSkins::UploadSkin(const char *pName, CPreparedSkin &Skin)
+{
+	CSkin NewSkin{pName};
+	NewSkin.m_OriginalSkin.m_Body = Graphics()->LoadSpriteTexture(Skin.m_Info, &g_pData->m_aSprites[SPRITE_TEE_BODY]);
+	NewSkin.m_OriginalSkin.m_BodyOutline = Graphics()->LoadSpriteTexture(Skin.m_Info, &g_pData->m_aSprites[SPRITE_TEE_BODY_OUTLINE]);
+	NewSkin.m_OriginalSkin.m_Feet = Graphics()->LoadSpriteTexture(Skin.m_Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT]);
+	NewSkin.m_OriginalSkin.m_FeetOutline = Graphics()->LoadSpriteTexture(Skin.m_Info, &g_pData->m_aSprites[SPRITE_TEE_FOOT_OUTLINE]);
+	NewSkin.m_OriginalSkin.m_Hands = Graphics()->LoadSpriteTexture(Skin.m_Info, &g_pData->m_aSprites[SPRITE_TEE_HAND]);
+	NewSkin.m_OriginalSkin.m_HandsOutline = Graphics()->LoadSpriteTexture(Skin.m_Info, &g_pData->m_aSprites[SPRITE_TEE_HAND_OUTLINE]);
 
 	for(int i = 0; i < 6; ++i)
-		Skin.m_ColorableSkin.m_aEyes[i] = Graphics()->LoadSpriteTexture(Info, &g_pData->m_aSprites[SPRITE_TEE_EYE_NORMAL + i]);
+		NewSkin.m_OriginalSkin.m_aEyes[i] = Graphics()->LoadSpriteTexture(Skin.m_Info, &g_pData->m_aSprites[SPRITE_TEE_EYE_NORMAL + i]);
 
-	Graphics()->FreePNG(&Info);
+	NewSkin.m_ColorableSkin.m_Body = Graphics()->LoadSpriteTexture(Skin.m_ColorableInfo, &g_pData->m_aSprites[SPRITE_TEE_BODY]);
+	NewSkin.m_ColorableSkin.m_BodyOutline = Graphics()->LoadSpriteTexture(Skin.m_ColorableInfo, &g_pData->m_aSprites[SPRITE_TEE_BODY_OUTLINE]);
+	NewSkin.m_ColorableSkin.m_Feet = Graphics()->LoadSpriteTexture(Skin.m_ColorableInfo, &g_pData->m_aSprites[SPRITE_TEE_FOOT]);
+	NewSkin.m_ColorableSkin.m_FeetOutline = Graphics()->LoadSpriteTexture(Skin.m_ColorableInfo, &g_pData->m_aSprites[SPRITE_TEE_FOOT_OUTLINE]);
+	NewSkin.m_ColorableSkin.m_Hands = Graphics()->LoadSpriteTexture(Skin.m_ColorableInfo, &g_pData->m_aSprites[SPRITE_TEE_HAND]);
+	NewSkin.m_ColorableSkin.m_HandsOutline = Graphics()->LoadSpriteTexture(Skin.m_ColorableInfo, &g_pData->m_aSprites[SPRITE_TEE_HAND_OUTLINE]);
+
+	for(int i = 0; i < 6; ++i)
+		NewSkin.m_ColorableSkin.m_aEyes[i] = Graphics()->LoadSpriteTexture(Skin.m_ColorableInfo, &g_pData->m_aSprites[SPRITE_TEE_EYE_NORMAL + i]);
+
+	NewSkin.m_BloodColor = Skin.m_BloodColor;
+	NewSkin.m_Metrics = Skin.m_Metrics;
+
+	Graphics()->FreePNG(&Skin.m_Info);
+	Graphics()->FreePNG(&Skin.m_ColorableInfo);
 
 	// set skin data
 	if(g_Config.m_Debug)
 	{
-		str_format(aBuf, sizeof(aBuf), "load skin %s", Skin.GetName());
+		char aBuf[512];
+		str_format(aBuf, sizeof(aBuf), "load skin %s", NewSkin.GetName());
 		Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "game", aBuf);
 	}
 
-	auto &&pSkin = std::make_unique<CSkin>(std::move(Skin));
+	auto &&pSkin = std::make_unique<CSkin>(std::move(NewSkin));
 	const auto SkinInsertIt = m_Skins.insert({pSkin->GetName(), std::move(pSkin)});
 
 	return SkinInsertIt.first->second.get();
 }
 
+void CSkins::UpdateLoadingSkins(bool Wait)
+{
+	if(m_LoadingSkins.empty())
+		return;
+
+	// spread the texture uploads over several frames
+	const auto StartTime = time_get_nanoseconds();
+	for(auto It = m_LoadingSkins.begin(); It != m_LoadingSkins.end();)
+	{
+		if(!Wait && time_get_nanoseconds() - StartTime > 5ms)
+			break;
+
+		CSkinLoadJob *pJob = It->second.get();
+		if(pJob->Status() != IJob::STATE_DONE)
+		{
+			if(!Wait)
+			{
+				++It;
+				continue;
+			}
+			pJob->Wait();
+		}
+
+		if(!pJob->m_Loaded)
+		{
+			char aBuf[512];
+			str_format(aBuf, sizeof(aBuf), "failed to load skin from %s", pJob->m_aName);
+			Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "game", aBuf);
+		}
+		else
+			Graphics()->WarnPngliteIncompatible(pJob->m_aPath, pJob->m_PngliteIncompatible);
+
+		if(pJob->m_Prepared)
+			UploadSkin(pJob->m_aName, pJob->m_Skin);
+		else if(pJob->m_Loaded)
+			LoadSkin(pJob->m_aName, pJob->m_Skin.m_Info);
+		It = m_LoadingSkins.erase(It);
+	}
+
+	// update the skins that fell back to the default skin
+	if(m_LoadingSkins.empty() && (Client()->State() == IClient::STATE_ONLINE || Client()->State() == IClient::STATE_DEMOPLAYBACK))
+		GameClient()->RefindSkins();
+}
+
+void CSkins::AbortLoadingSkins()
+{
+	// the jobs reference this component, so they have to be finished before they are dropped
+	for(auto &LoadingIt : m_LoadingSkins)
+		LoadingIt.second->m_Abort = true;
+	for(auto &LoadingIt : m_LoadingSkins)
+		LoadingIt.second->Wait();
+	m_LoadingSkins.clear();
+}
+
 void CSkins::OnInit()
 {
 	m_aEventSkinPrefix[0] = '\0';
 
+	if(g_Config.m_GfxImageCache)
+		m_ImageCache.Init(Storage());
+
 	if(g_Config.m_Events)
 	{
 		if(time_season() == SEASON_XMAS)
@@ -339,10 +518,14 @@ void CSkins::Refresh(TSkinLoadedCBFunc &&SkinLoadedFunc)
 	m_Skins.clear();
 	m_DownloadSkins.clear();
 	m_DownloadingSkins = 0;
+	AbortLoadingSkins();
 	SSkinScanUser SkinScanUser;
 	SkinScanUser.m_pThis = this;
 	SkinScanUser.m_SkinLoadedFunc = SkinLoadedFunc;
 	Storage()->ListDirectory(IStorage::TYPE_ALL, "skins", SkinScan, &SkinScanUser);
+	// without the default skin, the others are needed as fallback
+	if(m_Skins.empty())
+		UpdateLoadingSkins(true);
 	if(m_Skins.empty())
 	{
 		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "gameclient", "failed to load skins. folder='skins/'");
@@ -353,6 +536,16 @@ void CSkins::Refresh(TSkinLoadedCBFunc &&SkinLoadedFunc)
 	}
 }
 
+void CSkins::OnRender()
+{
+	UpdateLoadingSkins(false);
+}
+
+void CSkins::OnShutdown()
+{
+	AbortLoadingSkins();
+}
+
 int CSkins::Num()
 {
 	return m_Skins.size();
@@ -405,6 +598,10 @@ const CSkin *CSkins::FindImpl(const char *pName)
 	if(SkinIt != m_Skins.end())
 		return SkinIt->second.get();
 
+	// still loading from disk, don't download it
+	if(m_LoadingSkins.find(pName) != m_LoadingSkins.end())
+		return nullptr;
+
 	if(str_comp(pName, "default") == 0)
 		return nullptr;
 
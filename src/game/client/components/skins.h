@@ -5,6 +5,8 @@
 
 #include <base/system.h>
 #include <engine/shared/http.h>
+#include <engine/shared/imagecache.h>
+#include <engine/shared/jobs.h>
 #include <game/client/component.h>
 #include <game/client/skin.h>
 #include <string_view>
@@ -56,10 +58,47 @@ public:
 		const char *GetName() const { return m_aName; }
 	};
 
+	// a decoded skin with everything but the textures, can be prepared on any thread
+	struct CPreparedSkin
+	{
+		CImageInfo m_Info;
+		CImageInfo m_ColorableInfo;
+		ColorRGBA m_BloodColor;
+		CSkin::SSkinMetrics m_Metrics;
+	};
+
+	class CSkinLoadJob : public IJob
+	{
+		CSkins *m_pSkins;
+
+		void Run() override;
+
+	public:
+		CSkinLoadJob(CSkins *pSkins, const char *pName, const char *pPath, int DirType);
+		~CSkinLoadJob();
+
+		// blocks until Run returned, call it at most once
+		void Wait();
+
+		char m_aName[24];
+		char m_aPath[IO_MAX_PATH_LENGTH];
+		int m_DirType;
+		std::atomic<bool> m_Abort = false;
+		bool m_Loaded = false;
+		bool m_Prepared = false;
+		int m_PngliteIncompatible = 0;
+		CPreparedSkin m_Skin;
+
+	private:
+		SEMAPHORE m_Done;
+	};
+
 	typedef std::function<void(int)> TSkinLoadedCBFunc;
 
 	virtual int Sizeof() const override { return sizeof(*this); }
 	void OnInit() override;
+	void OnRender() override;
+	void OnShutdown() override;
 
 	void Refresh(TSkinLoadedCBFunc &&SkinLoadedFunc);
 	int Num();
@@ -80,11 +119,21 @@ private:
 	std::unordered_map<std::string_view, std::unique_ptr<CSkin>> m_Skins;
 	std::unordered_map<std::string_view, std::unique_ptr<CDownloadSkin>> m_DownloadSkins;
 	size_t m_DownloadingSkins = 0;
+	// skins decoded by the job pool, waiting for their textures
+	std::unordered_map<std::string_view, std::shared_ptr<CSkinLoadJob>> m_LoadingSkins;
+	// caches the colorable images, the graphics cache the decoded skins
+	CImageCache m_ImageCache;
 	char m_aEventSkinPrefix[24];
 
 	bool LoadSkinPNG(CImageInfo &Info, const char *pName, const char *pPath, int DirType);
 	const CSkin *LoadSkin(const char *pName, const char *pPath, int DirType);
 	const CSkin *LoadSkin(const char *pName, CImageInfo &Info);
+	static bool IsSkinImageValid(const CImageInfo &Info);
+	static bool PrepareSkin(CPreparedSkin &Skin);
+	bool PrepareSkinCached(CPreparedSkin &Skin, const char *pPath, int DirType);
+	const CSkin *UploadSkin(const char *pName, CPreparedSkin &Skin);
+	void UpdateLoadingSkins(bool Wait);
+	void AbortLoadingSkins();
 	const CSkin *FindImpl(const char *pName);
 	static int SkinScan(const char *pName, int IsDir, int DirType, void *pUser);
 };
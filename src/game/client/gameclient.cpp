@@ -109,51 +109,61 @@ void CGameClient::OnConsoleInit()
 
 	m_NamePlates.SetPlayers(&m_Players);
 
-	// make a list of all the systems, make sure to add them in the correct render order
-	m_vpAll.insert(m_vpAll.end(), {&m_Skins,
-					      &m_CountryFlags,
-					      &m_MapImages,
-					      &m_Effects, // doesn't render anything, just updates effects
-					      &m_InfCBinds,
-					      &m_InfCBinds.m_SpecialBinds,
-					      &m_Binds,
-					      &m_Binds.m_SpecialBinds,
-					      &m_Controls,
-					      &m_Camera,
-					      &m_Sounds,
-					      &m_Voting,
-					      &m_Particles, // doesn't render anything, just updates all the particles
-					      &m_RaceDemo,
-					      &m_MapSounds,
-					      &m_Background, // render instead of m_MapLayersBackground when g_Config.m_ClOverlayEntities == 100
-					      &m_MapLayersBackground, // first to render
-					      &m_Particles.m_RenderTrail,
-					      &m_Items,
-					      &m_Ghost,
-					      &m_Players,
-					      &m_MapLayersForeground,
-					      &m_Particles.m_RenderExplosions,
-					      &m_NamePlates,
-					      &m_Particles.m_RenderExtra,
-					      &m_Particles.m_RenderGeneral,
-					      &m_FreezeBars,
-					      &m_DamageInd,
-					      &m_Hud,
-					      &m_Spectator,
-					      &m_Emoticon,
-					      &m_KillMessages,
-					      &m_Chat,
-					      &m_InfCCommands,
-					      &m_Broadcast,
-					      &m_DebugHud,
-					      &m_Scoreboard,
-					      &m_Statboard,
-					      &m_Motd,
-					      &m_Menus,
-					      &m_Tooltips,
-					      &CMenus::m_Binder,
-					      &m_GameConsole,
-					      &m_MenuBackground});
+	// make a list of all the systems, make sure to add them in the correct render order,
+	// the names are the zones of the render profiler
+	const std::pair<CComponent *, const char *> aComponents[] = {
+		{&m_Skins, "skins"},
+		{&m_CountryFlags, "countryflags"},
+		{&m_MapImages, "mapimages"},
+		{&m_Effects, "effects"}, // doesn't render anything, just updates effects
+		{&m_InfCBinds, "infc_binds"},
+		{&m_InfCBinds.m_SpecialBinds, "infc_specialbinds"},
+		{&m_Binds, "binds"},
+		{&m_Binds.m_SpecialBinds, "specialbinds"},
+		{&m_Controls, "controls"},
+		{&m_Camera, "camera"},
+		{&m_Sounds, "sounds"},
+		{&m_Voting, "voting"},
+		{&m_Particles, "particles"}, // doesn't render anything, just updates all the particles
+		{&m_RaceDemo, "race_demo"},
+		{&m_MapSounds, "mapsounds"},
+		{&m_Background, "background"}, // render instead of m_MapLayersBackground when g_Config.m_ClOverlayEntities == 100
+		{&m_MapLayersBackground, "maplayers_background"}, // first to render
+		{&m_Particles.m_RenderTrail, "particles_trail"},
+		{&m_Items, "items"},
+		{&m_Ghost, "ghost"},
+		{&m_Players, "players"},
+		{&m_MapLayersForeground, "maplayers_foreground"},
+		{&m_Particles.m_RenderExplosions, "particles_explosions"},
+		{&m_NamePlates, "nameplates"},
+		{&m_Particles.m_RenderExtra, "particles_extra"},
+		{&m_Particles.m_RenderGeneral, "particles_general"},
+		{&m_FreezeBars, "freezebars"},
+		{&m_DamageInd, "damageind"},
+		{&m_Hud, "hud"},
+		{&m_Spectator, "spectator"},
+		{&m_Emoticon, "emoticon"},
+		{&m_KillMessages, "killmessages"},
+		{&m_Chat, "chat"},
+		{&m_InfCCommands, "infc_commands"},
+		{&m_Broadcast, "broadcast"},
+		{&m_DebugHud, "debughud"},
+		{&m_Scoreboard, "scoreboard"},
+		{&m_Statboard, "statboard"},
+		{&m_Motd, "motd"},
+		{&m_Menus, "menus"},
+		{&m_Tooltips, "tooltips"},
+		{&CMenus::m_Binder, "binder"},
+		{&m_GameConsole, "console"},
+		{&m_MenuBackground, "menu_background"},
+	};
+	for(const auto &[pComponent, pName] : aComponents)
+	{
+		m_vpAll.push_back(pComponent);
+		m_vRenderZones.push_back(m_RenderProfiler.RegisterZone(pName));
+	}
+	m_RenderFrameZone = m_RenderProfiler.RegisterZone("frame");
+	m_GpuFrameZone = m_RenderProfiler.RegisterZone("gpu");
 
 	// build the input stack
 	m_vpInput.insert(m_vpInput.end(), {&CMenus::m_Binder, // this will take over all input when we want to bind a key
@@ -172,6 +182,9 @@ void CGameClient::OnConsoleInit()
 	// add the some console commands
 	Console()->Register("team", "i[team-id]", CFGFLAG_CLIENT, ConTeam, this, "Switch team");
 	Console()->Register("kill", "", CFGFLAG_CLIENT, ConKill, this, "Kill yourself to restart");
+	Console()->Register("profiler_stats", "", CFGFLAG_CLIENT, ConProfilerStats, this, "Print the render timings of the client components");
+	Console()->Register("profiler_reset", "", CFGFLAG_CLIENT, ConProfilerReset, this, "Reset the render timings of the client components");
+	Console()->Register("profiler_trace", "?s[file]", CFGFLAG_CLIENT, ConProfilerTrace, this, "Write the recent render timings as Chrome trace JSON");
 
 	// register server dummy commands for tab completion
 	Console()->Register("tune", "s[tuning] ?i[value]", CFGFLAG_SERVER, 0, 0, "Tune variable to value or show current value");
@@ -554,6 +567,7 @@ void CGameClient::OnReset()
 {
 	m_aLastNewPredictedTick[0] = -1;
 	m_aLastNewPredictedTick[1] = -1;
+	m_PredictionState.m_Valid = false;
 
 	m_aLocalTuneZone[0] = 0;
 	m_aLocalTuneZone[1] = 0;
@@ -667,6 +681,8 @@ void CGameClient::UpdatePositions()
 
 void CGameClient::OnRender()
 {
+	m_RenderFrame++;
+
 	// check if multi view got activated
 	if(!m_MultiView.m_IsInit && m_MultiViewActivated)
 	{
@@ -698,8 +714,22 @@ void CGameClient::OnRender()
 	}
 
 	// render all systems
-	for(auto &pComponent : m_vpAll)
-		pComponent->OnRender();
+	m_RenderProfiler.SetEnabled(g_Config.m_DbgProfiler);
+	{
+		CProfileScope ProfileFrame(&m_RenderProfiler, m_RenderFrameZone);
+		for(size_t i = 0; i < m_vpAll.size(); i++)
+		{
+			CProfileScope Profile(&m_RenderProfiler, m_vRenderZones[i]);
+			m_vpAll[i]->OnRender();
+		}
+	}
+	// the GPU time is of a frame that finished a few frames ago, each measurement ends now in the trace
+	const int64_t GpuFrameTime = Graphics()->TakeGpuFrameTime();
+	if(m_RenderProfiler.Enabled() && GpuFrameTime >= 0)
+	{
+		const int64_t Now = time_get_impl();
+		m_RenderProfiler.Record(m_GpuFrameZone, Now - GpuFrameTime, Now);
+	}
 
 	// clear all events/input for this frame
 	Input()->Clear();
@@ -1989,33 +2019,46 @@ void CGameClient::OnPredict()
 
 	// init
 	bool Dummy = g_Config.m_ClDummy ^ m_IsDummySwapping;
-	m_PredictedWorld.CopyWorld(&m_GameWorld);
+	const int GameTick = Client()->GameTick(g_Config.m_ClDummy);
+	const int DummyID = PredictDummy() ? m_PredictedDummyID : -1;
 
-	// don't predict inactive players, or entities from other teams
-	for(int i = 0; i < MAX_CLIENTS; i++)
-		if(CCharacter *pChar = m_PredictedWorld.GetCharacterByID(i))
-			if((!m_Snap.m_aCharacters[i].m_Active && pChar->m_SnapTicks > 10) || IsOtherTeam(i))
-				pChar->Destroy();
-
-	CProjectile *pProjNext = 0;
-	for(CProjectile *pProj = (CProjectile *)m_PredictedWorld.FindFirst(CGameWorld::ENTTYPE_PROJECTILE); pProj; pProj = pProjNext)
+	// only simulate the new ticks if the last prediction started from the same snapshot with the same inputs
+	int FirstTick = GameTick + 1;
+	if(CanContinuePrediction(GameTick, Client()->PredGameTick(g_Config.m_ClDummy), DummyID))
 	{
-		pProjNext = (CProjectile *)pProj->TypeNext();
-		if(IsOtherTeam(pProj->GetOwner()))
+		FirstTick = m_PredictionState.m_PredictedTick + 1;
+	}
+	else
+	{
+		m_PredictedWorld.CopyWorld(&m_GameWorld);
+
+		// don't predict inactive players, or entities from other teams
+		for(int i = 0; i < MAX_CLIENTS; i++)
+			if(CCharacter *pChar = m_PredictedWorld.GetCharacterByID(i))
+				if((!m_Snap.m_aCharacters[i].m_Active && pChar->m_SnapTicks > 10) || IsOtherTeam(i))
+					pChar->Destroy();
+
+		CProjectile *pProjNext = 0;
+		for(CProjectile *pProj = (CProjectile *)m_PredictedWorld.FindFirst(CGameWorld::ENTTYPE_PROJECTILE); pProj; pProj = pProjNext)
 		{
-			pProj->Destroy();
+			pProjNext = (CProjectile *)pProj->TypeNext();
+			if(IsOtherTeam(pProj->GetOwner()))
+			{
+				pProj->Destroy();
+			}
 		}
 	}
+	m_PredictionState.m_Valid = false;
 
 	CCharacter *pLocalChar = m_PredictedWorld.GetCharacterByID(m_Snap.m_LocalClientID);
 	if(!pLocalChar)
 		return;
 	CCharacter *pDummyChar = 0;
-	if(PredictDummy())
-		pDummyChar = m_PredictedWorld.GetCharacterByID(m_PredictedDummyID);
+	if(DummyID >= 0)
+		pDummyChar = m_PredictedWorld.GetCharacterByID(DummyID);
 
 	// predict
-	for(int Tick = Client()->GameTick(g_Config.m_ClDummy) + 1; Tick <= Client()->PredGameTick(g_Config.m_ClDummy); Tick++)
+	for(int Tick = FirstTick; Tick <= Client()->PredGameTick(g_Config.m_ClDummy); Tick++)
 	{
 		// fetch the previous characters
 		if(Tick == Client()->PredGameTick(g_Config.m_ClDummy))
@@ -2035,6 +2078,8 @@ void CGameClient::OnPredict()
 		CNetObj_PlayerInput *pInputData = (CNetObj_PlayerInput *)Client()->GetInput(Tick, m_IsDummySwapping);
 		CNetObj_PlayerInput *pDummyInputData = !pDummyChar ? 0 : (CNetObj_PlayerInput *)Client()->GetInput(Tick, m_IsDummySwapping ^ 1);
 		bool DummyFirst = pInputData && pDummyInputData && pDummyChar->GetCID() < pLocalChar->GetCID();
+		m_PredictionState.StoreInput(Tick, 0, pInputData);
+		m_PredictionState.StoreInput(Tick, 1, pDummyInputData);
 
 		if(DummyFirst)
 			pDummyChar->OnDirectInput(pDummyInputData);
@@ -2098,6 +2143,14 @@ void CGameClient::OnPredict()
 		}
 	}
 
+	m_PredictionState.m_Valid = true;
+	m_PredictionState.m_GameTick = GameTick;
+	m_PredictionState.m_PredictedTick = Client()->PredGameTick(g_Config.m_ClDummy);
+	m_PredictionState.m_Dummy = g_Config.m_ClDummy;
+	m_PredictionState.m_IsDummySwapping = m_IsDummySwapping;
+	m_PredictionState.m_LocalClientID = m_Snap.m_LocalClientID;
+	m_PredictionState.m_DummyID = DummyID;
+
 	// detect mispredictions of other players and make corrections smoother when possible
 	if(g_Config.m_ClAntiPingSmooth && Predict() && AntiPingPlayers() && m_NewTick && absolute(m_PredictedTick - Client()->PredGameTick(g_Config.m_ClDummy)) <= 1 && absolute(Client()->GameTick(g_Config.m_ClDummy) - Client()->PrevGameTick(g_Config.m_ClDummy)) <= 2)
 	{
@@ -2193,6 +2246,55 @@ void CGameClient::OnPredict()
 		m_Ghost.OnNewPredictedSnapshot();
 }
 
+void CGameClient::CPredictionState::StoreInput(int Tick, int Dummy, const CNetObj_PlayerInput *pInput)
+{
+	const int Index = Tick % HISTORY_SIZE;
+	if(Dummy == 0)
+		m_aInputTick[Index] = Tick;
+	m_aaHasInput[Index][Dummy] = pInput != nullptr;
+	if(pInput)
+		m_aaInputs[Index][Dummy] = *pInput;
+}
+
+bool CGameClient::CPredictionState::SameInput(int Tick, int Dummy, const CNetObj_PlayerInput *pInput) const
+{
+	const int Index = Tick % HISTORY_SIZE;
+	if(m_aInputTick[Index] != Tick || m_aaHasInput[Index][Dummy] != (pInput != nullptr))
+		return false;
+	return !pInput || mem_comp(&m_aaInputs[Index][Dummy], pInput, sizeof(*pInput)) == 0;
+}
+
+bool CGameClient::CanContinuePrediction(int GameTick, int PredGameTick, int DummyID) const
+{
+	const CPredictionState &State = m_PredictionState;
+	if(!State.m_Valid || State.m_GameTick != GameTick || PredGameTick <= State.m_PredictedTick)
+		return false;
+	if(State.m_PredictedTick - GameTick >= CPredictionState::HISTORY_SIZE)
+		return false;
+
+	// the authoritative world was modified since it was copied
+	if(!m_PredictedWorld.m_IsValidCopy || m_PredictedWorld.m_pParent != &m_GameWorld)
+		return false;
+
+	if(State.m_Dummy != g_Config.m_ClDummy || State.m_IsDummySwapping != m_IsDummySwapping || State.m_LocalClientID != m_Snap.m_LocalClientID || State.m_DummyID != DummyID)
+		return false;
+
+	// partial freeze prediction depends on the last predicted tick
+	if(g_Config.m_ClPredictFreeze == 2)
+		return false;
+
+	// inputs for already predicted ticks can still arrive or be resent
+	for(int Tick = GameTick + 1; Tick <= State.m_PredictedTick; Tick++)
+	{
+		if(!State.SameInput(Tick, 0, (const CNetObj_PlayerInput *)Client()->GetInput(Tick, m_IsDummySwapping)))
+			return false;
+		const CNetObj_PlayerInput *pDummyInput = DummyID < 0 ? nullptr : (const CNetObj_PlayerInput *)Client()->GetInput(Tick, m_IsDummySwapping ^ 1);
+		if(!State.SameInput(Tick, 1, pDummyInput))
+			return false;
+	}
+	return true;
+}
+
 void CGameClient::OnActivateEditor()
 {
 	OnRelease();
@@ -2407,6 +2509,48 @@ void CGameClient::ConKill(IConsole::IResult *pResult, void *pUserData)
 	((CGameClient *)pUserData)->SendKill(-1);
 }
 
+void CGameClient::ConProfilerStats(IConsole::IResult *pResult, void *pUserData)
+{
+	CGameClient *pSelf = (CGameClient *)pUserData;
+	if(!pSelf->m_RenderProfiler.Enabled())
+		pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", "profiler is disabled, enable it with dbg_profiler 1");
+	pSelf->m_RenderProfiler.PrintStats(pSelf->Console());
+}
+
+void CGameClient::ConProfilerReset(IConsole::IResult *pResult, void *pUserData)
+{
+	((CGameClient *)pUserData)->m_RenderProfiler.Reset();
+}
+
+void CGameClient::ConProfilerTrace(IConsole::IResult *pResult, void *pUserData)
+{
+	CGameClient *pSelf = (CGameClient *)pUserData;
+
+	char aFilename[IO_MAX_PATH_LENGTH];
+	if(pResult->NumArguments())
+	{
+		str_copy(aFilename, pResult->GetString(0));
+	}
+	else
+	{
+		char aDate[64];
+		str_timestamp(aDate, sizeof(aDate));
+		str_format(aFilename, sizeof(aFilename), "dumps/profiler_client_%s.json", aDate);
+		pSelf->Storage()->CreateFolder("dumps", IStorage::TYPE_SAVE);
+	}
+
+	char aBuf[IO_MAX_PATH_LENGTH + 64];
+	IOHANDLE File = pSelf->Storage()->OpenFile(aFilename, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	if(!pSelf->m_RenderProfiler.WriteTrace(File))
+	{
+		str_format(aBuf, sizeof(aBuf), "failed to open '%s' for writing", aFilename);
+		pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", aBuf);
+		return;
+	}
+	str_format(aBuf, sizeof(aBuf), "wrote trace to '%s'", aFilename);
+	pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "profiler", aBuf);
+}
+
 void CGameClient::ConchainLanguageUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData)
 {
 	pfnCallback(pResult, pCallbackUserData);
@@ -9,6 +9,7 @@
 #include <engine/client.h>
 #include <engine/console.h>
 #include <engine/shared/config.h>
+#include <engine/shared/profiler.h>
 
 #include <game/collision.h>
 #include <game/gamecore.h>
@@ -161,8 +162,16 @@ public:
 
 	CTooltips m_Tooltips;
 
+	// render time of every component, enabled by dbg_profiler
+	CProfiler m_RenderProfiler;
+	// counts the rendered frames, identifies results that are cached for one frame
+	int64_t m_RenderFrame = 0;
+
 private:
 	std::vector<class CComponent *> m_vpAll;
+	std::vector<int> m_vRenderZones;
+	int m_RenderFrameZone;
+	int m_GpuFrameZone;
 	std::vector<class CComponent *> m_vpInput;
 	CNetObjHandler m_NetObjHandler;
 
@@ -199,6 +208,32 @@ private:
 	int m_PredictedTick;
 	int m_aLastNewPredictedTick[NUM_DUMMIES];
 
+	// what m_PredictedWorld was simulated from, to continue it while nothing changed
+	struct CPredictionState
+	{
+		enum
+		{
+			HISTORY_SIZE = 200,
+		};
+
+		bool m_Valid = false;
+		int m_GameTick;
+		int m_PredictedTick;
+		int m_Dummy;
+		bool m_IsDummySwapping;
+		int m_LocalClientID;
+		int m_DummyID;
+		// inputs of the local player and the dummy for every predicted tick
+		int m_aInputTick[HISTORY_SIZE];
+		bool m_aaHasInput[HISTORY_SIZE][NUM_DUMMIES];
+		CNetObj_PlayerInput m_aaInputs[HISTORY_SIZE][NUM_DUMMIES];
+
+		void StoreInput(int Tick, int Dummy, const CNetObj_PlayerInput *pInput);
+		bool SameInput(int Tick, int Dummy, const CNetObj_PlayerInput *pInput) const;
+	};
+	CPredictionState m_PredictionState;
+	bool CanContinuePrediction(int GameTick, int PredGameTick, int DummyID) const;
+
 	int m_LastRoundStartTick;
 
 	int m_LastFlagCarrierRed;
@@ -210,6 +245,9 @@ private:
 
 	static void ConTeam(IConsole::IResult *pResult, void *pUserData);
 	static void ConKill(IConsole::IResult *pResult, void *pUserData);
+	static void ConProfilerStats(IConsole::IResult *pResult, void *pUserData);
+	static void ConProfilerReset(IConsole::IResult *pResult, void *pUserData);
+	static void ConProfilerTrace(IConsole::IResult *pResult, void *pUserData);
 
 	static void ConchainLanguageUpdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
 	static void ConchainSpecialInfoupdate(IConsole::IResult *pResult, void *pUserData, IConsole::FCommandCallback pfnCallback, void *pCallbackUserData);
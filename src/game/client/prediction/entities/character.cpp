@@ -1167,11 +1167,11 @@ void CCharacter::DDRacePostCoreTick()
 	HandleSkippableTiles(CurrentIndex);
 
 	// handle Anti-Skip tiles
-	std::vector<int> vIndices = Collision()->GetMapIndices(m_PrevPos, m_Pos);
-	if(!vIndices.empty())
-		for(int Index : vIndices)
-			HandleTiles(Index);
-	else
+	int NumIndices = Collision()->ForEachMapIndex(m_PrevPos, m_Pos, [&](int Index) {
+		HandleTiles(Index);
+		return true;
+	});
+	if(!NumIndices)
 	{
 		HandleTiles(CurrentIndex);
 	}
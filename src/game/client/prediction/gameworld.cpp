@@ -586,6 +586,23 @@ void CGameWorld::NetObjEnd()
 	}
 }
 
+// the entity types CopyWorld copies
+static bool IsCopiedType(int Type)
+{
+	return Type == CGameWorld::ENTTYPE_PROJECTILE || Type == CGameWorld::ENTTYPE_LASER || Type == CGameWorld::ENTTYPE_DRAGGER ||
+	       Type == CGameWorld::ENTTYPE_CHARACTER || Type == CGameWorld::ENTTYPE_PICKUP;
+}
+
+// copies into a released entity of the same class if there is one
+template<class T>
+static CEntity *CopyEntity(CEntity *pSlot, CEntity *pFrom)
+{
+	if(!pSlot)
+		return new T(*(T *)pFrom);
+	*(T *)pSlot = *(T *)pFrom;
+	return pSlot;
+}
+
 void CGameWorld::CopyWorld(CGameWorld *pFrom)
 {
 	if(pFrom == this || !pFrom)
@@ -607,8 +624,8 @@ void CGameWorld::CopyWorld(CGameWorld *pFrom)
 	m_pTuningList = pFrom->m_pTuningList;
 	m_Teams = pFrom->m_Teams;
 	m_Core.m_vSwitchers = pFrom->m_Core.m_vSwitchers;
-	// delete the previous entities
-	Clear();
+	// release the previous entities to copy into
+	ReleaseEntities(pFrom);
 	for(int i = 0; i < MAX_CLIENTS; i++)
 	{
 		m_apCharacters[i] = 0;
@@ -617,28 +634,93 @@ void CGameWorld::CopyWorld(CGameWorld *pFrom)
 	// copy and add the new entities
 	for(int Type = 0; Type < NUM_ENTTYPES; Type++)
 	{
+		if(!IsCopiedType(Type))
+			continue;
+
+		std::vector<CEntity *> &vpPool = m_avpEntityPool[Type];
 		for(CEntity *pEnt = pFrom->FindLast(Type); pEnt; pEnt = pEnt->TypePrev())
 		{
+			// prefer the previous copy of the same entity
+			CEntity *pSlot = nullptr;
+			if(pEnt->m_pChild && pEnt->m_pChild->m_pGameWorld == this && pEnt->m_pChild->m_pParent == pEnt)
+			{
+				pSlot = pEnt->m_pChild;
+			}
+			else if(!vpPool.empty())
+			{
+				pSlot = vpPool.back();
+				vpPool.pop_back();
+			}
+
 			CEntity *pCopy = 0;
 			if(Type == ENTTYPE_PROJECTILE)
-				pCopy = new CProjectile(*((CProjectile *)pEnt));
+				pCopy = CopyEntity<CProjectile>(pSlot, pEnt);
 			else if(Type == ENTTYPE_LASER)
-				pCopy = new CLaser(*((CLaser *)pEnt));
+				pCopy = CopyEntity<CLaser>(pSlot, pEnt);
 			else if(Type == ENTTYPE_DRAGGER)
-				pCopy = new CDragger(*((CDragger *)pEnt));
+				pCopy = CopyEntity<CDragger>(pSlot, pEnt);
 			else if(Type == ENTTYPE_CHARACTER)
-				pCopy = new CCharacter(*((CCharacter *)pEnt));
+				pCopy = CopyEntity<CCharacter>(pSlot, pEnt);
 			else if(Type == ENTTYPE_PICKUP)
-				pCopy = new CPickup(*((CPickup *)pEnt));
-			if(pCopy)
+				pCopy = CopyEntity<CPickup>(pSlot, pEnt);
+			pCopy->m_pParent = pEnt;
+			pCopy->m_pChild = nullptr;
+			pEnt->m_pChild = pCopy;
+			this->InsertEntity(pCopy);
+		}
+	}
+	m_IsValidCopy = true;
+}
+
+void CGameWorld::ReleaseEntities(CGameWorld *pFrom)
+{
+	for(int Type = 0; Type < NUM_ENTTYPES; Type++)
+	{
+		if(!IsCopiedType(Type))
+		{
+			while(m_apFirstEntityTypes[Type])
+				delete m_apFirstEntityTypes[Type]; // NOLINT(clang-analyzer-cplusplus.NewDelete)
+			continue;
+		}
+
+		for(CEntity *pEnt = m_apFirstEntityTypes[Type]; pEnt;)
+		{
+			CEntity *pNext = pEnt->m_pNextTypeEntity;
+			pEnt->m_pPrevTypeEntity = 0;
+			pEnt->m_pNextTypeEntity = 0;
+			if(pEnt->m_pChild)
 			{
-				pCopy->m_pParent = pEnt;
-				pEnt->m_pChild = pCopy;
-				this->InsertEntity(pCopy);
+				pEnt->m_pChild->m_pParent = nullptr;
+				pEnt->m_pChild = nullptr;
 			}
+
+			// copies of entities still in the source world are reused by
+			// their parent, the others by any entity of the same type
+			if(!pEnt->m_pParent || pEnt->m_pParent->m_pChild != pEnt || pEnt->m_pParent->m_pGameWorld != pFrom)
+			{
+				if(pEnt->m_pParent && pEnt->m_pParent->m_pChild == pEnt)
+					pEnt->m_pParent->m_pChild = nullptr;
+				pEnt->m_pParent = nullptr;
+				m_avpEntityPool[Type].push_back(pEnt);
+			}
+			pEnt = pNext;
 		}
+		m_apFirstEntityTypes[Type] = 0;
+	}
+}
+
+void CGameWorld::ClearEntityPool()
+{
+	for(auto &vpPool : m_avpEntityPool)
+	{
+		for(CEntity *pEnt : vpPool)
+		{
+			// not in the world anymore, don't unregister from it
+			pEnt->m_pGameWorld = nullptr;
+			delete pEnt;
+		}
+		vpPool.clear();
 	}
-	m_IsValidCopy = true;
 }
 
 CEntity *CGameWorld::FindMatch(int ObjID, int ObjType, const void *pObjData)
@@ -715,4 +797,5 @@ void CGameWorld::Clear()
 	for(auto &pFirstEntityType : m_apFirstEntityTypes)
 		while(pFirstEntityType)
 			delete pFirstEntityType; // NOLINT(clang-analyzer-cplusplus.NewDelete)
+	ClearEntityPool();
 }
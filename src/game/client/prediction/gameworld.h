@@ -107,10 +107,15 @@ public:
 
 private:
 	void RemoveEntities();
+	void ReleaseEntities(CGameWorld *pFrom);
+	void ClearEntityPool();
 
 	CEntity *m_pNextTraverseEntity = nullptr;
 	CEntity *m_apFirstEntityTypes[NUM_ENTTYPES];
 
+	// entities released by CopyWorld, to copy into instead of reallocating
+	std::vector<CEntity *> m_avpEntityPool[NUM_ENTTYPES];
+
 	CCharacter *m_apCharacters[MAX_CLIENTS];
 };
 
@@ -76,15 +76,13 @@ bool CRaceHelper::IsStart(CGameClient *pClient, vec2 Prev, vec2 Pos)
 	}
 	else
 	{
-		std::vector<int> vIndices = pCollision->GetMapIndices(Prev, Pos);
-		if(!vIndices.empty())
-			for(int &Indice : vIndices)
-			{
-				if(pCollision->GetTileIndex(Indice) == TILE_START)
-					return true;
-				if(pCollision->GetFTileIndex(Indice) == TILE_START)
-					return true;
-			}
+		bool Start = false;
+		int NumIndices = pCollision->ForEachMapIndex(Prev, Pos, [&](int Index) {
+			Start = pCollision->GetTileIndex(Index) == TILE_START || pCollision->GetFTileIndex(Index) == TILE_START;
+			return !Start;
+		});
+		if(NumIndices)
+			return Start;
 		else
 		{
 			if(pCollision->GetTileIndex(pCollision->GetPureMapIndex(Pos)) == TILE_START)
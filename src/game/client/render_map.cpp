@@ -264,8 +264,22 @@ void CRenderTools::RenderEvalEnvelope(const IEnvelopePointAccess *pPoints, int C
 		TimeNanos = decltype(TimeNanos)::zero();
 
 	const double TimeMillis = TimeNanos.count() / (double)std::chrono::nanoseconds(1ms).count();
-	for(int i = 0; i < NumPoints - 1; i++)
+
+	// the points are sorted by time, find the first segment that ends at or after the time
+	int First = 0;
+	int Last = NumPoints - 1;
+	while(First < Last)
+	{
+		const int Mid = (First + Last) / 2;
+		if(pPoints->GetPoint(Mid + 1)->m_Time < TimeMillis)
+			First = Mid + 1;
+		else
+			Last = Mid;
+	}
+
+	if(First < NumPoints - 1)
 	{
+		const int i = First;
 		const CEnvPoint *pCurrentPoint = pPoints->GetPoint(i);
 		const CEnvPoint *pNextPoint = pPoints->GetPoint(i + 1);
 		if(TimeMillis >= pCurrentPoint->m_Time && TimeMillis <= pNextPoint->m_Time)
@@ -890,43 +890,13 @@ int CCollision::GetMapIndex(vec2 Pos) const
 std::vector<int> CCollision::GetMapIndices(vec2 PrevPos, vec2 Pos, unsigned MaxIndices) const
 {
 	std::vector<int> vIndices;
-	float d = distance(PrevPos, Pos);
-	int End(d + 1);
-	if(!d)
-	{
-		int Nx = clamp((int)Pos.x / 32, 0, m_Width - 1);
-		int Ny = clamp((int)Pos.y / 32, 0, m_Height - 1);
-		int Index = Ny * m_Width + Nx;
-
-		if(TileExists(Index))
-		{
+	ForEachMapIndex(
+		PrevPos, Pos, [&](int Index) {
 			vIndices.push_back(Index);
-			return vIndices;
-		}
-		else
-			return vIndices;
-	}
-	else
-	{
-		int LastIndex = 0;
-		for(int i = 0; i < End; i++)
-		{
-			float a = i / d;
-			vec2 Tmp = mix(PrevPos, Pos, a);
-			int Nx = clamp((int)Tmp.x / 32, 0, m_Width - 1);
-			int Ny = clamp((int)Tmp.y / 32, 0, m_Height - 1);
-			int Index = Ny * m_Width + Nx;
-			if(TileExists(Index) && LastIndex != Index)
-			{
-				if(MaxIndices && vIndices.size() > MaxIndices)
-					return vIndices;
-				vIndices.push_back(Index);
-				LastIndex = Index;
-			}
-		}
-
-		return vIndices;
-	}
+			return true;
+		},
+		MaxIndices);
+	return vIndices;
 }
 
 vec2 CCollision::GetPos(int Index) const
@@ -74,6 +74,52 @@ public:
 	int GetPureMapIndex(float x, float y) const;
 	int GetPureMapIndex(vec2 Pos) const { return GetPureMapIndex(Pos.x, Pos.y); }
 	std::vector<int> GetMapIndices(vec2 PrevPos, vec2 Pos, unsigned MaxIndices = 0) const;
+	// calls Callback(int Index) for the tiles GetMapIndices would return, in
+	// order and without allocating, until it returns false. returns the
+	// number of visited tiles
+	template<class F>
+	int ForEachMapIndex(vec2 PrevPos, vec2 Pos, F &&Callback, unsigned MaxIndices = 0) const
+	{
+		float d = distance(PrevPos, Pos);
+		int End(d + 1);
+		if(!d)
+		{
+			int Nx = clamp((int)Pos.x / 32, 0, m_Width - 1);
+			int Ny = clamp((int)Pos.y / 32, 0, m_Height - 1);
+			int Index = Ny * m_Width + Nx;
+
+			if(!TileExists(Index))
+				return 0;
+			Callback(Index);
+			return 1;
+		}
+
+		unsigned Num = 0;
+		int LastIndex = 0;
+		int LastTestedIndex = -1;
+		for(int i = 0; i < End; i++)
+		{
+			float a = i / d;
+			vec2 Tmp = mix(PrevPos, Pos, a);
+			int Nx = clamp((int)Tmp.x / 32, 0, m_Width - 1);
+			int Ny = clamp((int)Tmp.y / 32, 0, m_Height - 1);
+			int Index = Ny * m_Width + Nx;
+			// the line takes many steps per tile, only test each tile once
+			if(Index == LastTestedIndex)
+				continue;
+			LastTestedIndex = Index;
+			if(TileExists(Index) && LastIndex != Index)
+			{
+				if(MaxIndices && Num > MaxIndices)
+					break;
+				Num++;
+				LastIndex = Index;
+				if(!Callback(Index))
+					break;
+			}
+		}
+		return Num;
+	}
 	int GetMapIndex(vec2 Pos) const;
 	bool TileExists(int Index) const;
 	bool TileExistsNext(int Index) const;
@@ -349,7 +349,7 @@ void CGameContext::ModifyWeapons(IConsole::IResult *pResult, void *pUserData,
 void CGameContext::Teleport(CCharacter *pChr, vec2 Pos)
 {
 	pChr->Core()->m_Pos = Pos;
-	pChr->m_Pos = Pos;
+	pChr->SetPos(Pos);
 	pChr->m_PrevPos = Pos;
 	pChr->m_DDRaceState = DDRACE_CHEAT;
 }
@@ -65,7 +65,7 @@ bool CCharacter::Spawn(CPlayer *pPlayer, vec2 Pos)
 	m_IsBlueTeleGunTeleport = false;
 
 	m_pPlayer = pPlayer;
-	m_Pos = Pos;
+	SetPos(Pos);
 
 	mem_zero(&m_LatestPrevPrevInput, sizeof(m_LatestPrevPrevInput));
 	m_LatestPrevPrevInput.m_TargetY = -1;
@@ -805,7 +805,7 @@ void CCharacter::TickDeferred()
 	bool StuckAfterMove = Collision()->TestBox(m_Core.m_Pos, CCharacterCore::PhysicalSizeVec2());
 	m_Core.Quantize();
 	bool StuckAfterQuant = Collision()->TestBox(m_Core.m_Pos, CCharacterCore::PhysicalSizeVec2());
-	m_Pos = m_Core.m_Pos;
+	SetPos(m_Core.m_Pos);
 
 	if(!StuckBefore && (StuckAfterMove || StuckAfterQuant))
 	{
@@ -859,8 +859,7 @@ void CCharacter::TickDeferred()
 
 	if(m_pPlayer->GetTeam() == TEAM_SPECTATORS)
 	{
-		m_Pos.x = m_Input.m_TargetX;
-		m_Pos.y = m_Input.m_TargetY;
+		SetPos(vec2(m_Input.m_TargetX, m_Input.m_TargetY));
 	}
 
 	// update the m_SendCore if needed
@@ -979,12 +978,10 @@ bool CCharacter::TakeDamage(vec2 Force, int Dmg, int From, int Weapon)
 }
 
 //TODO: Move the emote stuff to a function
-void CCharacter::SnapCharacter(int SnappingClient, int ID)
+void CCharacter::FillSnapCharacter(CSnapCharacter *pSnap)
 {
-	int SnappingClientVersion = GameServer()->GetClientVersion(SnappingClient);
+	int Tick, Emote = m_EmoteType, Weapon = m_Core.m_ActiveWeapon, AmmoCount = 0;
 	CCharacterCore *pCore;
-	int Tick, Emote = m_EmoteType, Weapon = m_Core.m_ActiveWeapon, AmmoCount = 0,
-		  Health = 0, Armor = 0;
 	if(!m_ReckoningTick || GameServer()->m_World.m_Paused)
 	{
 		Tick = 0;
@@ -995,16 +992,70 @@ void CCharacter::SnapCharacter(int SnappingClient, int ID)
 		Tick = m_ReckoningTick;
 		pCore = &m_SendCore;
 	}
+	pCore->Write(&pSnap->m_Core);
+	pSnap->m_Core.m_Tick = Tick;
 
 	// change eyes and use ninja graphic if player is frozen
+	pSnap->m_FrozenNinja = false;
 	if(m_Core.m_DeepFrozen || m_FreezeTime > 0 || m_Core.m_LiveFrozen)
 	{
 		if(Emote == EMOTE_NORMAL)
 			Emote = (m_Core.m_DeepFrozen || m_Core.m_LiveFrozen) ? EMOTE_PAIN : EMOTE_BLINK;
 
-		if((m_Core.m_DeepFrozen || m_FreezeTime > 0) && SnappingClientVersion < VERSION_DDNET_NEW_HUD)
-			Weapon = WEAPON_NINJA;
+		pSnap->m_FrozenNinja = m_Core.m_DeepFrozen || m_FreezeTime > 0;
+	}
+
+	// change eyes, use ninja graphic and set ammo count if player has ninjajetpack
+	if(m_pPlayer->m_NinjaJetpack && m_Core.m_Jetpack && m_Core.m_ActiveWeapon == WEAPON_GUN && !m_Core.m_DeepFrozen && m_FreezeTime == 0 && !m_Core.m_HasTelegunGun)
+	{
+		if(Emote == EMOTE_NORMAL)
+			Emote = EMOTE_HAPPY;
+		Weapon = WEAPON_NINJA;
+		AmmoCount = 10;
 	}
+	pSnap->m_AmmoCount = AmmoCount;
+	pSnap->m_VisibleAmmoCount = AmmoCount;
+	if(m_Core.m_aWeapons[m_Core.m_ActiveWeapon].m_Ammo > 0)
+		pSnap->m_VisibleAmmoCount = (m_FreezeTime == 0) ? m_Core.m_aWeapons[m_Core.m_ActiveWeapon].m_Ammo : 0;
+
+	if(GetPlayer()->IsAfk() || GetPlayer()->IsPaused())
+	{
+		if(m_FreezeTime > 0 || m_Core.m_DeepFrozen || m_Core.m_LiveFrozen)
+			Emote = EMOTE_NORMAL;
+		else
+			Emote = EMOTE_BLINK;
+	}
+
+	if(Emote == EMOTE_NORMAL)
+	{
+		if(250 - ((Server()->Tick() - m_LastAction) % (250)) < 5)
+			Emote = EMOTE_BLINK;
+	}
+	pSnap->m_Emote = Emote;
+	pSnap->m_Weapon = Weapon;
+
+	int TriggeredEvents7 = 0;
+	if(m_Core.m_TriggeredEvents & COREEVENT_GROUND_JUMP)
+		TriggeredEvents7 |= protocol7::COREEVENTFLAG_GROUND_JUMP;
+	if(m_Core.m_TriggeredEvents & COREEVENT_AIR_JUMP)
+		TriggeredEvents7 |= protocol7::COREEVENTFLAG_AIR_JUMP;
+	if(m_Core.m_TriggeredEvents & COREEVENT_HOOK_ATTACH_PLAYER)
+		TriggeredEvents7 |= protocol7::COREEVENTFLAG_HOOK_ATTACH_PLAYER;
+	if(m_Core.m_TriggeredEvents & COREEVENT_HOOK_ATTACH_GROUND)
+		TriggeredEvents7 |= protocol7::COREEVENTFLAG_HOOK_ATTACH_GROUND;
+	if(m_Core.m_TriggeredEvents & COREEVENT_HOOK_HIT_NOHOOK)
+		TriggeredEvents7 |= protocol7::COREEVENTFLAG_HOOK_HIT_NOHOOK;
+	pSnap->m_TriggeredEvents7 = TriggeredEvents7;
+}
+
+void CCharacter::SnapCharacter(int SnappingClient, int ID)
+{
+	const CSnapCharacter &Snap = m_SnapCharacter.Get(Server()->Tick(), [this](CSnapCharacter *pSnap) { FillSnapCharacter(pSnap); });
+
+	int SnappingClientVersion = GameServer()->GetClientVersion(SnappingClient);
+	int Weapon = Snap.m_Weapon, AmmoCount = Snap.m_AmmoCount, Health = 0, Armor = 0;
+	if(Snap.m_FrozenNinja && SnappingClientVersion < VERSION_DDNET_NEW_HUD)
+		Weapon = WEAPON_NINJA;
 
 	// solo, collision, jetpack and ninjajetpack prediction
 	if(m_pPlayer->GetCID() == SnappingClient)
@@ -1032,36 +1083,12 @@ void CCharacter::SnapCharacter(int SnappingClient, int ID)
 		}
 	}
 
-	// change eyes, use ninja graphic and set ammo count if player has ninjajetpack
-	if(m_pPlayer->m_NinjaJetpack && m_Core.m_Jetpack && m_Core.m_ActiveWeapon == WEAPON_GUN && !m_Core.m_DeepFrozen && m_FreezeTime == 0 && !m_Core.m_HasTelegunGun)
-	{
-		if(Emote == EMOTE_NORMAL)
-			Emote = EMOTE_HAPPY;
-		Weapon = WEAPON_NINJA;
-		AmmoCount = 10;
-	}
-
 	if(m_pPlayer->GetCID() == SnappingClient || SnappingClient == SERVER_DEMO_CLIENT ||
 		(!g_Config.m_SvStrictSpectateMode && m_pPlayer->GetCID() == GameServer()->m_apPlayers[SnappingClient]->m_SpectatorID))
 	{
 		Health = m_Health;
 		Armor = m_Armor;
-		if(m_Core.m_aWeapons[m_Core.m_ActiveWeapon].m_Ammo > 0)
-			AmmoCount = (m_FreezeTime == 0) ? m_Core.m_aWeapons[m_Core.m_ActiveWeapon].m_Ammo : 0;
-	}
-
-	if(GetPlayer()->IsAfk() || GetPlayer()->IsPaused())
-	{
-		if(m_FreezeTime > 0 || m_Core.m_DeepFrozen || m_Core.m_LiveFrozen)
-			Emote = EMOTE_NORMAL;
-		else
-			Emote = EMOTE_BLINK;
-	}
-
-	if(Emote == EMOTE_NORMAL)
-	{
-		if(250 - ((Server()->Tick() - m_LastAction) % (250)) < 5)
-			Emote = EMOTE_BLINK;
+		AmmoCount = Snap.m_VisibleAmmoCount;
 	}
 
 	if(!Server()->IsSixup(SnappingClient))
@@ -1070,10 +1097,8 @@ void CCharacter::SnapCharacter(int SnappingClient, int ID)
 		if(!pCharacter)
 			return;
 
-		pCore->Write(pCharacter);
-
-		pCharacter->m_Tick = Tick;
-		pCharacter->m_Emote = Emote;
+		static_cast<CNetObj_CharacterCore &>(*pCharacter) = Snap.m_Core;
+		pCharacter->m_Emote = Snap.m_Emote;
 
 		if(pCharacter->m_HookedPlayer != -1)
 		{
@@ -1095,14 +1120,14 @@ void CCharacter::SnapCharacter(int SnappingClient, int ID)
 		if(!pCharacter)
 			return;
 
-		pCore->Write(reinterpret_cast<CNetObj_CharacterCore *>(static_cast<protocol7::CNetObj_CharacterCore *>(pCharacter)));
+		static_assert(sizeof(protocol7::CNetObj_CharacterCore) == sizeof(CNetObj_CharacterCore), "the cores are written the same way");
+		mem_copy(static_cast<protocol7::CNetObj_CharacterCore *>(pCharacter), &Snap.m_Core, sizeof(Snap.m_Core));
 		if(pCharacter->m_Angle > (int)(pi * 256.0f))
 		{
 			pCharacter->m_Angle -= (int)(2.0f * pi * 256.0f);
 		}
 
-		pCharacter->m_Tick = Tick;
-		pCharacter->m_Emote = Emote;
+		pCharacter->m_Emote = Snap.m_Emote;
 		pCharacter->m_AttackTick = m_AttackTick;
 		pCharacter->m_Direction = m_Input.m_Direction;
 		pCharacter->m_Weapon = Weapon;
@@ -1115,18 +1140,7 @@ void CCharacter::SnapCharacter(int SnappingClient, int ID)
 
 		pCharacter->m_Health = Health;
 		pCharacter->m_Armor = Armor;
-		int TriggeredEvents7 = 0;
-		if(m_Core.m_TriggeredEvents & COREEVENT_GROUND_JUMP)
-			TriggeredEvents7 |= protocol7::COREEVENTFLAG_GROUND_JUMP;
-		if(m_Core.m_TriggeredEvents & COREEVENT_AIR_JUMP)
-			TriggeredEvents7 |= protocol7::COREEVENTFLAG_AIR_JUMP;
-		if(m_Core.m_TriggeredEvents & COREEVENT_HOOK_ATTACH_PLAYER)
-			TriggeredEvents7 |= protocol7::COREEVENTFLAG_HOOK_ATTACH_PLAYER;
-		if(m_Core.m_TriggeredEvents & COREEVENT_HOOK_ATTACH_GROUND)
-			TriggeredEvents7 |= protocol7::COREEVENTFLAG_HOOK_ATTACH_GROUND;
-		if(m_Core.m_TriggeredEvents & COREEVENT_HOOK_HIT_NOHOOK)
-			TriggeredEvents7 |= protocol7::COREEVENTFLAG_HOOK_HIT_NOHOOK;
-		pCharacter->m_TriggeredEvents = TriggeredEvents7;
+		pCharacter->m_TriggeredEvents = Snap.m_TriggeredEvents7;
 	}
 }
 
@@ -1201,6 +1215,12 @@ void CCharacter::Snap(int SnappingClient)
 	if(!pDDNetCharacter)
 		return;
 
+	// the DDNet character is the same for every snapping client
+	*pDDNetCharacter = m_SnapDDNetCharacter.Get(Server()->Tick(), [this](CNetObj_DDNetCharacter *pSnap) { FillDDNetCharacter(pSnap); });
+}
+
+void CCharacter::FillDDNetCharacter(CNetObj_DDNetCharacter *pDDNetCharacter)
+{
 	pDDNetCharacter->m_Flags = 0;
 	if(m_Core.m_Solo)
 		pDDNetCharacter->m_Flags |= CHARACTERFLAG_SOLO;
@@ -2126,17 +2146,13 @@ void CCharacter::DDRacePostCoreTick()
 		return;
 
 	// handle Anti-Skip tiles
-	std::vector<int> vIndices = Collision()->GetMapIndices(m_PrevPos, m_Pos);
-	if(!vIndices.empty())
-	{
-		for(int &Index : vIndices)
-		{
-			HandleTiles(Index);
-			if(!m_Alive)
-				return;
-		}
-	}
-	else
+	int NumIndices = Collision()->ForEachMapIndex(m_PrevPos, m_Pos, [&](int Index) {
+		HandleTiles(Index);
+		return m_Alive;
+	});
+	if(!m_Alive)
+		return;
+	if(!NumIndices)
 	{
 		HandleTiles(CurrentIndex);
 		if(!m_Alive)
@@ -145,7 +145,24 @@ private:
 
 	// DDRace
 
+	// the character item without the fields that depend on the snapping client
+	struct CSnapCharacter
+	{
+		CNetObj_CharacterCore m_Core;
+		int m_Emote;
+		int m_Weapon;
+		// frozen characters are shown with the ninja to clients without the new HUD
+		bool m_FrozenNinja;
+		int m_AmmoCount;
+		// for the character's own and spectating clients
+		int m_VisibleAmmoCount;
+		int m_TriggeredEvents7;
+	};
+	CSnapCache<CSnapCharacter> m_SnapCharacter;
+	CSnapCache<CNetObj_DDNetCharacter> m_SnapDDNetCharacter;
+	void FillSnapCharacter(CSnapCharacter *pSnap);
 	void SnapCharacter(int SnappingClient, int ID);
+	void FillDDNetCharacter(CNetObj_DDNetCharacter *pDDNetCharacter);
 	static bool IsSwitchActiveCb(int Number, void *pUser);
 	void SetTimeCheckpoint(int TimeCheckpoint);
 	void HandleTiles(int Index);
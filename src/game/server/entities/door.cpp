@@ -14,7 +14,7 @@ CDoor::CDoor(CGameWorld *pGameWorld, vec2 Pos, float Rotation, int Length,
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
 {
 	m_Number = Number;
-	m_Pos = Pos;
+	SetPos(Pos);
 	m_Length = Length;
 	m_Direction = vec2(std::sin(Rotation), std::cos(Rotation));
 	vec2 To = Pos + normalize(m_Direction) * m_Length;
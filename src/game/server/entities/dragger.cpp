@@ -16,7 +16,7 @@
 CDragger::CDragger(CGameWorld *pGameWorld, vec2 Pos, float Strength, bool IgnoreWalls, int Layer, int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
 {
-	m_Pos = Pos;
+	SetPos(Pos);
 	m_Strength = Strength;
 	m_IgnoreWalls = IgnoreWalls;
 	m_Layer = Layer;
@@ -42,7 +42,7 @@ void CDragger::Tick()
 		{
 			m_Core = GameServer()->Collision()->CpSpeed(index, Flags);
 		}
-		m_Pos += m_Core;
+		SetPos(m_Pos + m_Core);
 
 		// Adopt the new position for all outgoing laser beams
 		for(auto &DraggerBeam : m_apDraggerBeam)
@@ -16,7 +16,7 @@
 CGun::CGun(CGameWorld *pGameWorld, vec2 Pos, bool Freeze, bool Explosive, int Layer, int Number) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
 {
-	m_Pos = Pos;
+	SetPos(Pos);
 	m_Freeze = Freeze;
 	m_Explosive = Explosive;
 	m_Layer = Layer;
@@ -39,7 +39,7 @@ void CGun::Tick()
 		{
 			m_Core = GameServer()->Collision()->CpSpeed(index, Flags);
 		}
-		m_Pos += m_Core;
+		SetPos(m_Pos + m_Core);
 	}
 	if(g_Config.m_SvPlasmaPerSec > 0)
 	{
@@ -14,7 +14,7 @@
 CLaser::CLaser(CGameWorld *pGameWorld, vec2 Pos, vec2 Direction, float StartEnergy, int Owner, int Type) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
 {
-	m_Pos = Pos;
+	SetPos(Pos);
 	m_Owner = Owner;
 	m_Energy = StartEnergy;
 	m_Dir = Direction;
@@ -50,7 +50,7 @@ bool CLaser::HitCharacter(vec2 From, vec2 To)
 	if(!pHit || (pHit == pOwnerChar && g_Config.m_SvOldLaser) || (pHit != pOwnerChar && pOwnerChar ? (pOwnerChar->LaserHitDisabled() && m_Type == WEAPON_LASER) || (pOwnerChar->ShotgunHitDisabled() && m_Type == WEAPON_SHOTGUN) : !g_Config.m_SvHit))
 		return false;
 	m_From = From;
-	m_Pos = At;
+	SetPos(At);
 	m_Energy = -1;
 	if(m_Type == WEAPON_SHOTGUN)
 	{
@@ -117,7 +117,7 @@ void CLaser::DoBounce()
 	if(m_WasTele)
 	{
 		m_PrevPos = m_TelePos;
-		m_Pos = m_TelePos;
+		SetPos(m_TelePos);
 		m_TelePos = vec2(0, 0);
 	}
 
@@ -131,7 +131,7 @@ void CLaser::DoBounce()
 		{
 			// intersected
 			m_From = m_Pos;
-			m_Pos = To;
+			SetPos(To);
 
 			vec2 TempPos = m_Pos;
 			vec2 TempDir = m_Dir * 4.0f;
@@ -147,7 +147,7 @@ void CLaser::DoBounce()
 			{
 				GameServer()->Collision()->SetCollisionAt(round_to_int(Coltile.x), round_to_int(Coltile.y), f);
 			}
-			m_Pos = TempPos;
+			SetPos(TempPos);
 			m_Dir = normalize(TempDir);
 
 			const float Distance = distance(m_From, m_Pos);
@@ -194,7 +194,7 @@ void CLaser::DoBounce()
 		if(!HitCharacter(m_Pos, To))
 		{
 			m_From = m_Pos;
-			m_Pos = To;
+			SetPos(To);
 			m_Energy = -1;
 		}
 	}
@@ -292,33 +292,44 @@ void CLaser::TickPaused()
 	++m_EvalTick;
 }
 
-void CLaser::Snap(int SnappingClient)
+void CLaser::FillSnap(CSnapLaser *pSnap)
 {
-	if(NetworkClipped(SnappingClient) && NetworkClipped(SnappingClient, m_From))
-		return;
-	CCharacter *pOwnerChar = 0;
+	CCharacter *pOwnerChar = nullptr;
 	if(m_Owner >= 0)
 		pOwnerChar = GameServer()->GetPlayerChar(m_Owner);
-	if(!pOwnerChar)
-		return;
-
-	pOwnerChar = nullptr;
-	CClientMask TeamMask = CClientMask().set();
+	pSnap->m_HasOwner = pOwnerChar != nullptr;
+	pSnap->m_TeamMask = pOwnerChar && pOwnerChar->IsAlive() ? pOwnerChar->TeamMask() : CClientMask().set();
 
-	if(m_Owner >= 0)
-		pOwnerChar = GameServer()->GetPlayerChar(m_Owner);
+	int LaserType = m_Type == WEAPON_LASER ? LASERTYPE_RIFLE : m_Type == WEAPON_SHOTGUN ? LASERTYPE_SHOTGUN : -1;
+	CGameContext::FillLaserObject(&pSnap->m_DDNetLaser, m_Pos, m_From, m_EvalTick, m_Owner, LaserType, 0, m_Number);
+	CGameContext::FillLaserObject(&pSnap->m_Laser, m_Pos, m_From, m_EvalTick);
+}
 
-	if(pOwnerChar && pOwnerChar->IsAlive())
-		TeamMask = pOwnerChar->TeamMask();
+void CLaser::Snap(int SnappingClient)
+{
+	if(NetworkClipped(SnappingClient) && NetworkClipped(SnappingClient, m_From))
+		return;
 
-	if(SnappingClient != SERVER_DEMO_CLIENT && !TeamMask.test(SnappingClient))
+	// the owner's team mask and the laser objects are the same for every snapping client
+	const CSnapLaser &Snap = m_Snap.Get(Server()->Tick(), [this](CSnapLaser *pSnap) { FillSnap(pSnap); });
+	if(!Snap.m_HasOwner)
 		return;
 
-	int SnappingClientVersion = GameServer()->GetClientVersion(SnappingClient);
-	int LaserType = m_Type == WEAPON_LASER ? LASERTYPE_RIFLE : m_Type == WEAPON_SHOTGUN ? LASERTYPE_SHOTGUN : -1;
+	if(SnappingClient != SERVER_DEMO_CLIENT && !Snap.m_TeamMask.test(SnappingClient))
+		return;
 
-	GameServer()->SnapLaserObject(CSnapContext(SnappingClientVersion), GetID(),
-		m_Pos, m_From, m_EvalTick, m_Owner, LaserType, 0, m_Number);
+	if(GameServer()->GetClientVersion(SnappingClient) >= VERSION_DDNET_MULTI_LASER)
+	{
+		CNetObj_DDNetLaser *pObj = Server()->SnapNewItem<CNetObj_DDNetLaser>(GetID());
+		if(pObj)
+			*pObj = Snap.m_DDNetLaser;
+	}
+	else
+	{
+		CNetObj_Laser *pObj = Server()->SnapNewItem<CNetObj_Laser>(GetID());
+		if(pObj)
+			*pObj = Snap.m_Laser;
+	}
 }
 
 void CLaser::SwapClients(int Client1, int Client2)
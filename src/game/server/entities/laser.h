@@ -3,6 +3,7 @@
 #ifndef GAME_SERVER_ENTITIES_LASER_H
 #define GAME_SERVER_ENTITIES_LASER_H
 
+#include <game/generated/protocol.h>
 #include <game/server/entity.h>
 
 class CLaser : public CEntity
@@ -42,6 +43,16 @@ private:
 	bool m_TeleportCancelled;
 	bool m_IsBlueTeleport;
 	bool m_BelongsToPracticeTeam;
+
+	struct CSnapLaser
+	{
+		bool m_HasOwner;
+		CClientMask m_TeamMask;
+		CNetObj_DDNetLaser m_DDNetLaser;
+		CNetObj_Laser m_Laser;
+	};
+	CSnapCache<CSnapLaser> m_Snap;
+	void FillSnap(CSnapLaser *pSnap);
 };
 
 #endif
@@ -18,7 +18,7 @@ CLight::CLight(CGameWorld *pGameWorld, vec2 Pos, float Rotation, int Length,
 	m_Layer = Layer;
 	m_Number = Number;
 	m_Tick = (Server()->TickSpeed() * 0.15f);
-	m_Pos = Pos;
+	SetPos(Pos);
 	m_Rotation = Rotation;
 	m_Length = Length;
 	m_EvalTick = Server()->Tick();
@@ -92,7 +92,7 @@ void CLight::Tick()
 		{
 			m_Core = GameServer()->Collision()->CpSpeed(index, Flags);
 		}
-		m_Pos += m_Core;
+		SetPos(m_Pos + m_Core);
 		Step();
 	}
 
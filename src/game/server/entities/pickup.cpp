@@ -182,7 +182,37 @@ void CPickup::Snap(int SnappingClient)
 			return;
 	}
 
-	GameServer()->SnapPickup(CSnapContext(SnappingClientVersion, Sixup), GetID(), m_Pos, m_Type, m_Subtype, m_Number);
+	// the items only depend on the client version, build them once for all clients
+	const CSnapPickup &Snap = m_Snap.Get(Server()->Tick(), [this](CSnapPickup *pSnap) { FillSnap(pSnap); });
+	if(Sixup)
+	{
+		protocol7::CNetObj_Pickup *pPickup = Server()->SnapNewItem<protocol7::CNetObj_Pickup>(GetID());
+		if(pPickup)
+			*pPickup = Snap.m_Pickup7;
+	}
+	else if(SnappingClientVersion >= VERSION_DDNET_ENTITY_NETOBJS)
+	{
+		CNetObj_DDNetPickup *pPickup = Server()->SnapNewItem<CNetObj_DDNetPickup>(GetID());
+		if(pPickup)
+			*pPickup = Snap.m_DDNetPickup;
+	}
+	else
+	{
+		CNetObj_Pickup *pPickup = Server()->SnapNewItem<CNetObj_Pickup>(GetID());
+		if(!pPickup)
+			return;
+		if(SnappingClientVersion >= VERSION_DDNET_WEAPON_SHIELDS)
+			*pPickup = Snap.m_Pickup;
+		else
+			CGameContext::FillPickup(pPickup, m_Pos, m_Type, m_Subtype, SnappingClientVersion);
+	}
+}
+
+void CPickup::FillSnap(CSnapPickup *pSnap)
+{
+	CGameContext::FillPickup(&pSnap->m_Pickup7, m_Pos, m_Type, m_Subtype);
+	CGameContext::FillPickup(&pSnap->m_DDNetPickup, m_Pos, m_Type, m_Subtype, m_Number);
+	CGameContext::FillPickup(&pSnap->m_Pickup, m_Pos, m_Type, m_Subtype, VERSION_DDNET_WEAPON_SHIELDS);
 }
 
 void CPickup::Move()
@@ -195,6 +225,6 @@ void CPickup::Move()
 		{
 			m_Core = GameServer()->Collision()->CpSpeed(index, Flags);
 		}
-		m_Pos += m_Core;
+		SetPos(m_Pos + m_Core);
 	}
 }
@@ -3,6 +3,8 @@
 #ifndef GAME_SERVER_ENTITIES_PICKUP_H
 #define GAME_SERVER_ENTITIES_PICKUP_H
 
+#include <game/generated/protocol.h>
+#include <game/generated/protocol7.h>
 #include <game/server/entity.h>
 
 class CPickup : public CEntity
@@ -28,6 +30,16 @@ private:
 
 	void Move();
 	vec2 m_Core;
+
+	struct CSnapPickup
+	{
+		protocol7::CNetObj_Pickup m_Pickup7;
+		CNetObj_DDNetPickup m_DDNetPickup;
+		// for clients that know the weapon shields
+		CNetObj_Pickup m_Pickup;
+	};
+	CSnapCache<CSnapPickup> m_Snap;
+	void FillSnap(CSnapPickup *pSnap);
 };
 
 #endif
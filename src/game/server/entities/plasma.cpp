@@ -15,7 +15,7 @@ CPlasma::CPlasma(CGameWorld *pGameWorld, vec2 Pos, vec2 Dir, bool Freeze,
 	bool Explosive, int ForClientID) :
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_LASER)
 {
-	m_Pos = Pos;
+	SetPos(Pos);
 	m_Core = Dir;
 	m_Freeze = Freeze;
 	m_Explosive = Explosive;
@@ -50,7 +50,7 @@ void CPlasma::Tick()
 
 void CPlasma::Move()
 {
-	m_Pos += m_Core;
+	SetPos(m_Pos + m_Core);
 	m_Core *= PLASMA_ACCEL;
 }
 
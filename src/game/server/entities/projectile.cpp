@@ -27,7 +27,7 @@ CProjectile::CProjectile(
 	CEntity(pGameWorld, CGameWorld::ENTTYPE_PROJECTILE)
 {
 	m_Type = Type;
-	m_Pos = Pos;
+	SetPos(Pos);
 	m_Direction = Dir;
 	m_LifeSpan = Span;
 	m_Owner = Owner;
@@ -222,7 +222,7 @@ void CProjectile::Tick()
 		if(Collide && m_Bouncing != 0)
 		{
 			m_StartTick = Server()->Tick();
-			m_Pos = NewPos + (-(m_Direction * 4));
+			SetPos(NewPos + (-(m_Direction * 4)));
 			if(m_Bouncing == 1)
 				m_Direction.x = -m_Direction.x;
 			else if(m_Bouncing == 2)
@@ -231,7 +231,7 @@ void CProjectile::Tick()
 				m_Direction.x = 0;
 			if(absolute(m_Direction.y) < 1e-6f)
 				m_Direction.y = 0;
-			m_Pos += m_Direction;
+			SetPos(m_Pos + m_Direction);
 		}
 		else if(m_Type == WEAPON_GUN)
 		{
@@ -280,7 +280,7 @@ void CProjectile::Tick()
 	if(z && !pControllerDDRace->m_TeleOuts[z - 1].empty())
 	{
 		int TeleOut = GameServer()->m_World.m_Core.RandomOr0(pControllerDDRace->m_TeleOuts[z - 1].size());
-		m_Pos = pControllerDDRace->m_TeleOuts[z - 1][TeleOut];
+		SetPos(pControllerDDRace->m_TeleOuts[z - 1][TeleOut]);
 		m_StartTick = Server()->Tick();
 	}
 }
@@ -300,11 +300,25 @@ void CProjectile::FillInfo(CNetObj_Projectile *pProj)
 	pProj->m_Type = m_Type;
 }
 
-void CProjectile::Snap(int SnappingClient)
+void CProjectile::FillSnap(CSnapProjectile *pSnap)
 {
 	float Ct = (Server()->Tick() - m_StartTick) / (float)Server()->TickSpeed();
+	pSnap->m_Pos = GetPos(Ct);
+
+	CCharacter *pOwnerChar = nullptr;
+	if(m_Owner >= 0)
+		pOwnerChar = GameServer()->GetPlayerChar(m_Owner);
+	pSnap->m_TeamMask = pOwnerChar && pOwnerChar->IsAlive() ? pOwnerChar->TeamMask() : CClientMask().set();
+
+	FillExtraInfo(&pSnap->m_DDNetProjectile);
+}
+
+void CProjectile::Snap(int SnappingClient)
+{
+	// position, owner's team mask and DDNet projectile are the same for every snapping client
+	const CSnapProjectile &Snap = m_Snap.Get(Server()->Tick(), [this](CSnapProjectile *pSnap) { FillSnap(pSnap); });
 
-	if(NetworkClipped(SnappingClient, GetPos(Ct)))
+	if(NetworkClipped(SnappingClient, Snap.m_Pos))
 		return;
 
 	int SnappingClientVersion = GameServer()->GetClientVersion(SnappingClient);
@@ -316,16 +330,7 @@ void CProjectile::Snap(int SnappingClient)
 			return;
 	}
 
-	CCharacter *pOwnerChar = 0;
-	CClientMask TeamMask = CClientMask().set();
-
-	if(m_Owner >= 0)
-		pOwnerChar = GameServer()->GetPlayerChar(m_Owner);
-
-	if(pOwnerChar && pOwnerChar->IsAlive())
-		TeamMask = pOwnerChar->TeamMask();
-
-	if(SnappingClient != SERVER_DEMO_CLIENT && m_Owner != -1 && !TeamMask.test(SnappingClient))
+	if(SnappingClient != SERVER_DEMO_CLIENT && m_Owner != -1 && !Snap.m_TeamMask.test(SnappingClient))
 		return;
 
 	CNetObj_DDRaceProjectile DDRaceProjectile;
@@ -337,7 +342,7 @@ void CProjectile::Snap(int SnappingClient)
 		{
 			return;
 		}
-		FillExtraInfo(pDDNetProjectile);
+		*pDDNetProjectile = Snap.m_DDNetProjectile;
 	}
 	else if(SnappingClientVersion >= VERSION_DDNET_ANTIPING_PROJECTILE && FillExtraInfoLegacy(&DDRaceProjectile))
 	{
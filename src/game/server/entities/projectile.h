@@ -49,6 +49,15 @@ private:
 	bool m_BelongsToPracticeTeam;
 	vec2 m_InitDir;
 
+	struct CSnapProjectile
+	{
+		vec2 m_Pos;
+		CClientMask m_TeamMask;
+		CNetObj_DDNetProjectile m_DDNetProjectile;
+	};
+	CSnapCache<CSnapProjectile> m_Snap;
+	void FillSnap(CSnapProjectile *pSnap);
+
 public:
 	void SetBouncing(int Value);
 	bool FillExtraInfoLegacy(CNetObj_DDRaceProjectile *pProj);
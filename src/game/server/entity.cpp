@@ -22,6 +22,8 @@ CEntity::CEntity(CGameWorld *pGameWorld, int ObjType, vec2 Pos, int ProximityRad
 
 	m_pPrevTypeEntity = 0;
 	m_pNextTypeEntity = 0;
+	m_GridHandle = -1;
+	m_InsertOrder = 0;
 }
 
 CEntity::~CEntity()
@@ -30,6 +32,13 @@ CEntity::~CEntity()
 	Server()->SnapFreeID(m_ID);
 }
 
+void CEntity::SetPos(vec2 Pos)
+{
+	m_Pos = Pos;
+	if(m_GridHandle >= 0)
+		m_pGameWorld->m_aGrids[m_ObjType].Move(m_GridHandle, m_Pos);
+}
+
 bool CEntity::NetworkClipped(int SnappingClient) const
 {
 	return ::NetworkClipped(m_pGameWorld->GameServer(), SnappingClient, m_Pos);
@@ -24,6 +24,10 @@ private:
 	friend CGameWorld; // entity list handling
 	CEntity *m_pPrevTypeEntity;
 	CEntity *m_pNextTypeEntity;
+	// handle in the world's spatial grid, -1 if not in the world
+	int m_GridHandle;
+	// order of insertion into the world, the type list is sorted by it descending
+	int64_t m_InsertOrder;
 
 	/* Identity */
 	CGameWorld *m_pGameWorld;
@@ -45,7 +49,8 @@ protected:
 public: // TODO: Maybe make protected
 	/*
 		Variable: m_Pos
-			Contains the current posititon of the entity.
+			Contains the current posititon of the entity, only change
+			it with SetPos.
 	*/
 	vec2 m_Pos;
 
@@ -73,6 +78,13 @@ public: // TODO: Maybe make protected
 	CEntity *TypeNext() { return m_pNextTypeEntity; }
 	CEntity *TypePrev() { return m_pPrevTypeEntity; }
 	const vec2 &GetPos() const { return m_Pos; }
+	/*
+		Function: SetPos
+			Moves the entity, also in the world's spatial grid so that
+			range queries find it at the new position right away.
+	*/
+	void SetPos(vec2 Pos);
+	int64_t InsertOrder() const { return m_InsertOrder; }
 	float GetProximityRadius() const { return m_ProximityRadius; }
 
 	/* Other functions */
@@ -174,4 +186,32 @@ public: // TODO: Maybe make protected
 bool NetworkClipped(const CGameContext *pGameServer, int SnappingClient, vec2 CheckPos);
 bool NetworkClippedLine(const CGameContext *pGameServer, int SnappingClient, vec2 StartPos, vec2 EndPos);
 
+/*
+	Class: CSnapCache
+		Holds the part of an entity's snap items that is the same for
+		every snapping client. It is built by the first client snapped
+		in a tick, the others only copy it and patch their own fields.
+		Like the items returned by SnapNewItem, it is zeroed before it
+		is built.
+*/
+template<typename T>
+class CSnapCache
+{
+	int m_Tick = -1;
+	T m_Data;
+
+public:
+	template<typename FBuild>
+	const T &Get(int Tick, FBuild &&Build)
+	{
+		if(m_Tick != Tick)
+		{
+			m_Data = T{};
+			Build(&m_Data);
+			m_Tick = Tick;
+		}
+		return m_Data;
+	}
+};
+
 #endif
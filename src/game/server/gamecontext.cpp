@@ -379,6 +379,29 @@ void CGameContext::CreateSoundGlobal(int Sound, int Target)
 	}
 }
 
+void CGameContext::FillLaserObject(CNetObj_DDNetLaser *pObj, const vec2 &To, const vec2 &From, int StartTick, int Owner, int LaserType, int Subtype, int SwitchNumber)
+{
+	pObj->m_ToX = (int)To.x;
+	pObj->m_ToY = (int)To.y;
+	pObj->m_FromX = (int)From.x;
+	pObj->m_FromY = (int)From.y;
+	pObj->m_StartTick = StartTick;
+	pObj->m_Owner = Owner;
+	pObj->m_Type = LaserType;
+	pObj->m_Subtype = Subtype;
+	pObj->m_SwitchNumber = SwitchNumber;
+	pObj->m_Flags = 0;
+}
+
+void CGameContext::FillLaserObject(CNetObj_Laser *pObj, const vec2 &To, const vec2 &From, int StartTick)
+{
+	pObj->m_X = (int)To.x;
+	pObj->m_Y = (int)To.y;
+	pObj->m_FromX = (int)From.x;
+	pObj->m_FromY = (int)From.y;
+	pObj->m_StartTick = StartTick;
+}
+
 bool CGameContext::SnapLaserObject(const CSnapContext &Context, int SnapID, const vec2 &To, const vec2 &From, int StartTick, int Owner, int LaserType, int Subtype, int SwitchNumber)
 {
 	if(Context.GetClientVersion() >= VERSION_DDNET_MULTI_LASER)
@@ -387,16 +410,7 @@ bool CGameContext::SnapLaserObject(const CSnapContext &Context, int SnapID, cons
 		if(!pObj)
 			return false;
 
-		pObj->m_ToX = (int)To.x;
-		pObj->m_ToY = (int)To.y;
-		pObj->m_FromX = (int)From.x;
-		pObj->m_FromY = (int)From.y;
-		pObj->m_StartTick = StartTick;
-		pObj->m_Owner = Owner;
-		pObj->m_Type = LaserType;
-		pObj->m_Subtype = Subtype;
-		pObj->m_SwitchNumber = SwitchNumber;
-		pObj->m_Flags = 0;
+		FillLaserObject(pObj, To, From, StartTick, Owner, LaserType, Subtype, SwitchNumber);
 	}
 	else
 	{
@@ -404,16 +418,48 @@ bool CGameContext::SnapLaserObject(const CSnapContext &Context, int SnapID, cons
 		if(!pObj)
 			return false;
 
-		pObj->m_X = (int)To.x;
-		pObj->m_Y = (int)To.y;
-		pObj->m_FromX = (int)From.x;
-		pObj->m_FromY = (int)From.y;
-		pObj->m_StartTick = StartTick;
+		FillLaserObject(pObj, To, From, StartTick);
 	}
 
 	return true;
 }
 
+void CGameContext::FillPickup(protocol7::CNetObj_Pickup *pPickup, const vec2 &Pos, int Type, int SubType)
+{
+	pPickup->m_X = (int)Pos.x;
+	pPickup->m_Y = (int)Pos.y;
+
+	if(Type == POWERUP_WEAPON)
+		pPickup->m_Type = SubType == WEAPON_SHOTGUN ? protocol7::PICKUP_SHOTGUN : SubType == WEAPON_GRENADE ? protocol7::PICKUP_GRENADE : protocol7::PICKUP_LASER;
+	else if(Type == POWERUP_NINJA)
+		pPickup->m_Type = protocol7::PICKUP_NINJA;
+}
+
+void CGameContext::FillPickup(CNetObj_DDNetPickup *pPickup, const vec2 &Pos, int Type, int SubType, int SwitchNumber)
+{
+	pPickup->m_X = (int)Pos.x;
+	pPickup->m_Y = (int)Pos.y;
+	pPickup->m_Type = Type;
+	pPickup->m_Subtype = SubType;
+	pPickup->m_SwitchNumber = SwitchNumber;
+}
+
+void CGameContext::FillPickup(CNetObj_Pickup *pPickup, const vec2 &Pos, int Type, int SubType, int ClientVersion)
+{
+	pPickup->m_X = (int)Pos.x;
+	pPickup->m_Y = (int)Pos.y;
+
+	pPickup->m_Type = Type;
+	if(ClientVersion < VERSION_DDNET_WEAPON_SHIELDS)
+	{
+		if(Type >= POWERUP_ARMOR_SHOTGUN && Type <= POWERUP_ARMOR_LASER)
+		{
+			pPickup->m_Type = POWERUP_ARMOR;
+		}
+	}
+	pPickup->m_Subtype = SubType;
+}
+
 bool CGameContext::SnapPickup(const CSnapContext &Context, int SnapID, const vec2 &Pos, int Type, int SubType, int SwitchNumber)
 {
 	if(Context.IsSixup())
@@ -422,13 +468,7 @@ bool CGameContext::SnapPickup(const CSnapContext &Context, int SnapID, const vec
 		if(!pPickup)
 			return false;
 
-		pPickup->m_X = (int)Pos.x;
-		pPickup->m_Y = (int)Pos.y;
-
-		if(Type == POWERUP_WEAPON)
-			pPickup->m_Type = SubType == WEAPON_SHOTGUN ? protocol7::PICKUP_SHOTGUN : SubType == WEAPON_GRENADE ? protocol7::PICKUP_GRENADE : protocol7::PICKUP_LASER;
-		else if(Type == POWERUP_NINJA)
-			pPickup->m_Type = protocol7::PICKUP_NINJA;
+		FillPickup(pPickup, Pos, Type, SubType);
 	}
 	else if(Context.GetClientVersion() >= VERSION_DDNET_ENTITY_NETOBJS)
 	{
@@ -436,11 +476,7 @@ bool CGameContext::SnapPickup(const CSnapContext &Context, int SnapID, const vec
 		if(!pPickup)
 			return false;
 
-		pPickup->m_X = (int)Pos.x;
-		pPickup->m_Y = (int)Pos.y;
-		pPickup->m_Type = Type;
-		pPickup->m_Subtype = SubType;
-		pPickup->m_SwitchNumber = SwitchNumber;
+		FillPickup(pPickup, Pos, Type, SubType, SwitchNumber);
 	}
 	else
 	{
@@ -448,18 +484,7 @@ bool CGameContext::SnapPickup(const CSnapContext &Context, int SnapID, const vec
 		if(!pPickup)
 			return false;
 
-		pPickup->m_X = (int)Pos.x;
-		pPickup->m_Y = (int)Pos.y;
-
-		pPickup->m_Type = Type;
-		if(Context.GetClientVersion() < VERSION_DDNET_WEAPON_SHIELDS)
-		{
-			if(Type >= POWERUP_ARMOR_SHOTGUN && Type <= POWERUP_ARMOR_LASER)
-			{
-				pPickup->m_Type = POWERUP_ARMOR;
-			}
-		}
-		pPickup->m_Subtype = SubType;
+		FillPickup(pPickup, Pos, Type, SubType, Context.GetClientVersion());
 	}
 
 	return true;
@@ -237,6 +237,12 @@ public:
 
 	bool SnapLaserObject(const CSnapContext &Context, int SnapID, const vec2 &To, const vec2 &From, int StartTick, int Owner = -1, int LaserType = -1, int Subtype = -1, int SwitchNumber = -1);
 	bool SnapPickup(const CSnapContext &Context, int SnapID, const vec2 &Pos, int Type, int SubType, int SwitchNumber);
+	// the items written by SnapLaserObject and SnapPickup, for entities that build them once for all clients
+	static void FillLaserObject(CNetObj_DDNetLaser *pObj, const vec2 &To, const vec2 &From, int StartTick, int Owner, int LaserType, int Subtype, int SwitchNumber);
+	static void FillLaserObject(CNetObj_Laser *pObj, const vec2 &To, const vec2 &From, int StartTick);
+	static void FillPickup(protocol7::CNetObj_Pickup *pPickup, const vec2 &Pos, int Type, int SubType);
+	static void FillPickup(CNetObj_DDNetPickup *pPickup, const vec2 &Pos, int Type, int SubType, int SwitchNumber);
+	static void FillPickup(CNetObj_Pickup *pPickup, const vec2 &Pos, int Type, int SubType, int ClientVersion);
 
 	enum
 	{
@@ -25,6 +25,8 @@ CGameWorld::CGameWorld()
 	m_ResetRequested = false;
 	for(auto &pFirstEntityType : m_apFirstEntityTypes)
 		pFirstEntityType = 0;
+	for(auto &MaxProximityRadius : m_aMaxProximityRadius)
+		MaxProximityRadius = 0.0f;
 }
 
 CGameWorld::~CGameWorld()
@@ -47,24 +49,73 @@ CEntity *CGameWorld::FindFirst(int Type)
 	return Type < 0 || Type >= NUM_ENTTYPES ? 0 : m_apFirstEntityTypes[Type];
 }
 
-int CGameWorld::FindEntities(vec2 Pos, float Radius, CEntity **ppEnts, int Max, int Type)
+void CGameWorld::UpdateGridSize()
 {
-	if(Type < 0 || Type >= NUM_ENTTYPES)
-		return 0;
+	const CCollision *pCollision = GameServer()->Collision();
+	if(pCollision->GetWidth() == m_GridMapWidth && pCollision->GetHeight() == m_GridMapHeight)
+		return;
 
-	int Num = 0;
-	for(CEntity *pEnt = m_apFirstEntityTypes[Type]; pEnt; pEnt = pEnt->m_pNextTypeEntity)
-	{
-		if(distance(pEnt->m_Pos, Pos) < Radius + pEnt->m_ProximityRadius)
+	m_GridMapWidth = pCollision->GetWidth();
+	m_GridMapHeight = pCollision->GetHeight();
+	for(auto &Grid : m_aGrids)
+		Grid.Init(m_GridMapWidth * 32.0f, m_GridMapHeight * 32.0f, GRID_CELL_TILES * 32.0f);
+}
+
+void CGameWorld::CheckGridPositions()
+{
+#ifdef CONF_DEBUG
+	for(auto *pEnt : m_apFirstEntityTypes)
+		for(; pEnt; pEnt = pEnt->m_pNextTypeEntity)
 		{
-			if(ppEnts)
-				ppEnts[Num] = pEnt;
-			Num++;
-			if(Num == Max)
-				break;
+			const vec2 GridPos = m_aGrids[pEnt->m_ObjType].Pos(pEnt->m_GridHandle);
+			dbg_assert(mem_comp(&GridPos, &pEnt->m_Pos, sizeof(GridPos)) == 0, "entity position changed without SetPos");
 		}
+#endif
+}
+
+template<class F>
+void CGameWorld::QueryEntities(int Type, vec2 Min, vec2 Max, F &&Callback)
+{
+	// entities may be up to their proximity radius away, plus rounding slack
+	const float Margin = m_aMaxProximityRadius[Type] + 1.0f;
+	Min -= vec2(Margin, Margin);
+	Max += vec2(Margin, Margin);
+
+	// walking the list is cheaper than visiting more cells than entities
+	if(m_aGrids[Type].NumCells(Min, Max) > m_aGrids[Type].NumItems())
+	{
+		for(CEntity *pEnt = m_apFirstEntityTypes[Type]; pEnt; pEnt = pEnt->m_pNextTypeEntity)
+			Callback(pEnt);
 	}
+	else
+		m_aGrids[Type].Query(Min, Max, Callback);
+}
+
+static void SortByListOrder(std::vector<CEntity *> &vpEntities)
+{
+	// the type lists are ordered by insertion, newest first
+	std::sort(vpEntities.begin(), vpEntities.end(), [](const CEntity *pA, const CEntity *pB) {
+		return pA->InsertOrder() > pB->InsertOrder();
+	});
+}
 
+int CGameWorld::FindEntities(vec2 Pos, float Radius, CEntity **ppEnts, int Max, int Type)
+{
+	if(Type < 0 || Type >= NUM_ENTTYPES)
+		return 0;
+
+	m_vpQueryEntities.clear();
+	QueryEntities(Type, Pos - vec2(Radius, Radius), Pos + vec2(Radius, Radius), [&](CEntity *pEnt) {
+		if(distance(pEnt->m_Pos, Pos) < Radius + pEnt->m_ProximityRadius)
+			m_vpQueryEntities.push_back(pEnt);
+	});
+	SortByListOrder(m_vpQueryEntities);
+
+	int Num = m_vpQueryEntities.size();
+	if(Max > 0)
+		Num = minimum(Num, Max);
+	if(ppEnts)
+		std::copy(m_vpQueryEntities.begin(), m_vpQueryEntities.begin() + Num, ppEnts);
 	return Num;
 }
 
@@ -81,6 +132,11 @@ void CGameWorld::InsertEntity(CEntity *pEnt)
 	pEnt->m_pNextTypeEntity = m_apFirstEntityTypes[pEnt->m_ObjType];
 	pEnt->m_pPrevTypeEntity = 0x0;
 	m_apFirstEntityTypes[pEnt->m_ObjType] = pEnt;
+
+	pEnt->m_InsertOrder = m_NextInsertOrder++;
+	UpdateGridSize();
+	pEnt->m_GridHandle = m_aGrids[pEnt->m_ObjType].Insert(pEnt, pEnt->m_Pos);
+	m_aMaxProximityRadius[pEnt->m_ObjType] = maximum(m_aMaxProximityRadius[pEnt->m_ObjType], pEnt->m_ProximityRadius);
 }
 
 void CGameWorld::RemoveEntity(CEntity *pEnt)
@@ -103,6 +159,9 @@ void CGameWorld::RemoveEntity(CEntity *pEnt)
 
 	pEnt->m_pNextTypeEntity = 0;
 	pEnt->m_pPrevTypeEntity = 0;
+
+	m_aGrids[pEnt->m_ObjType].Remove(pEnt->m_GridHandle);
+	pEnt->m_GridHandle = -1;
 }
 
 //
@@ -196,6 +255,8 @@ void CGameWorld::Tick()
 	if(m_ResetRequested)
 		Reset();
 
+	CheckGridPositions();
+
 	if(!m_Paused)
 	{
 		if(GameServer()->m_pController->IsForceBalanced())
@@ -276,17 +337,16 @@ CCharacter *CGameWorld::IntersectCharacter(vec2 Pos0, vec2 Pos1, float Radius, v
 	float ClosestLen = distance(Pos0, Pos1) * 100.0f;
 	CCharacter *pClosest = 0;
 
-	CCharacter *p = (CCharacter *)FindFirst(ENTTYPE_CHARACTER);
-	for(; p; p = (CCharacter *)p->TypeNext())
-	{
+	auto &&Check = [&](CEntity *pEnt) {
+		CCharacter *p = (CCharacter *)pEnt;
 		if(p == pNotThis)
-			continue;
+			return;
 
 		if(pThisOnly && p != pThisOnly)
-			continue;
+			return;
 
 		if(CollideWith != -1 && !p->CanCollide(CollideWith))
-			continue;
+			return;
 
 		vec2 IntersectPos;
 		if(closest_point_on_line(Pos0, Pos1, p->m_Pos, IntersectPos))
@@ -295,7 +355,8 @@ CCharacter *CGameWorld::IntersectCharacter(vec2 Pos0, vec2 Pos1, float Radius, v
 			if(Len < p->m_ProximityRadius + Radius)
 			{
 				Len = distance(Pos0, IntersectPos);
-				if(Len < ClosestLen)
+				// on ties, prefer the one earlier in the list
+				if(Len < ClosestLen || (Len == ClosestLen && pClosest && p->InsertOrder() > pClosest->InsertOrder()))
 				{
 					NewPos = IntersectPos;
 					ClosestLen = Len;
@@ -303,7 +364,15 @@ CCharacter *CGameWorld::IntersectCharacter(vec2 Pos0, vec2 Pos1, float Radius, v
 				}
 			}
 		}
+	};
+	if(pThisOnly)
+	{
+		// the only candidate, if it is in the world
+		if(((const CEntity *)pThisOnly)->m_GridHandle >= 0)
+			Check((CCharacter *)pThisOnly);
 	}
+	else
+		QueryEntities(ENTTYPE_CHARACTER, vec2(minimum(Pos0.x, Pos1.x), minimum(Pos0.y, Pos1.y)) - vec2(Radius, Radius), vec2(maximum(Pos0.x, Pos1.x), maximum(Pos0.y, Pos1.y)) + vec2(Radius, Radius), Check);
 
 	return pClosest;
 }
@@ -314,34 +383,33 @@ CCharacter *CGameWorld::ClosestCharacter(vec2 Pos, float Radius, const CEntity *
 	float ClosestRange = Radius * 2;
 	CCharacter *pClosest = 0;
 
-	CCharacter *p = (CCharacter *)GameServer()->m_World.FindFirst(ENTTYPE_CHARACTER);
-	for(; p; p = (CCharacter *)p->TypeNext())
-	{
+	QueryEntities(ENTTYPE_CHARACTER, Pos - vec2(Radius, Radius), Pos + vec2(Radius, Radius), [&](CEntity *pEnt) {
+		CCharacter *p = (CCharacter *)pEnt;
 		if(p == pNotThis)
-			continue;
+			return;
 
 		float Len = distance(Pos, p->m_Pos);
 		if(Len < p->m_ProximityRadius + Radius)
 		{
-			if(Len < ClosestRange)
+			// on ties, prefer the one earlier in the list
+			if(Len < ClosestRange || (Len == ClosestRange && pClosest && p->InsertOrder() > pClosest->InsertOrder()))
 			{
 				ClosestRange = Len;
 				pClosest = p;
 			}
 		}
-	}
+	});
 
 	return pClosest;
 }
 
 std::vector<CCharacter *> CGameWorld::IntersectedCharacters(vec2 Pos0, vec2 Pos1, float Radius, const CEntity *pNotThis)
 {
-	std::vector<CCharacter *> vpCharacters;
-	CCharacter *pChr = (CCharacter *)FindFirst(CGameWorld::ENTTYPE_CHARACTER);
-	for(; pChr; pChr = (CCharacter *)pChr->TypeNext())
-	{
+	m_vpQueryEntities.clear();
+	QueryEntities(ENTTYPE_CHARACTER, vec2(minimum(Pos0.x, Pos1.x), minimum(Pos0.y, Pos1.y)) - vec2(Radius, Radius), vec2(maximum(Pos0.x, Pos1.x), maximum(Pos0.y, Pos1.y)) + vec2(Radius, Radius), [&](CEntity *pEnt) {
+		CCharacter *pChr = (CCharacter *)pEnt;
 		if(pChr == pNotThis)
-			continue;
+			return;
 
 		vec2 IntersectPos;
 		if(closest_point_on_line(Pos0, Pos1, pChr->m_Pos, IntersectPos))
@@ -350,10 +418,16 @@ std::vector<CCharacter *> CGameWorld::IntersectedCharacters(vec2 Pos0, vec2 Pos1
 			if(Len < pChr->m_ProximityRadius + Radius)
 			{
 				pChr->m_Intersection = IntersectPos;
-				vpCharacters.push_back(pChr);
+				m_vpQueryEntities.push_back(pChr);
 			}
 		}
-	}
+	});
+	SortByListOrder(m_vpQueryEntities);
+
+	std::vector<CCharacter *> vpCharacters;
+	vpCharacters.reserve(m_vpQueryEntities.size());
+	for(CEntity *pEnt : m_vpQueryEntities)
+		vpCharacters.push_back((CCharacter *)pEnt);
 	return vpCharacters;
 }
 
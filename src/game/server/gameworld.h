@@ -5,6 +5,8 @@
 
 #include <game/gamecore.h>
 
+#include "spatial_grid.h"
+
 #include <vector>
 
 class CEntity;
@@ -17,6 +19,8 @@ class CCharacter;
 */
 class CGameWorld
 {
+	friend CEntity; // moves entities in the spatial grid
+
 public:
 	enum
 	{
@@ -35,6 +39,26 @@ private:
 	CEntity *m_pNextTraverseEntity = nullptr;
 	CEntity *m_apFirstEntityTypes[NUM_ENTTYPES];
 
+	enum
+	{
+		// edge length of a spatial grid cell in tiles
+		GRID_CELL_TILES = 8,
+	};
+	// the entities of each type bucketed by position, to only check
+	// the nearby ones in the range queries
+	CSpatialGrid<CEntity> m_aGrids[NUM_ENTTYPES];
+	float m_aMaxProximityRadius[NUM_ENTTYPES];
+	int m_GridMapWidth = 0;
+	int m_GridMapHeight = 0;
+	int64_t m_NextInsertOrder = 0;
+	std::vector<CEntity *> m_vpQueryEntities;
+
+	void UpdateGridSize();
+	// checks that all positions were changed with CEntity::SetPos
+	void CheckGridPositions();
+	template<class F>
+	void QueryEntities(int Type, vec2 Min, vec2 Max, F &&Callback);
+
 	class CGameContext *m_pGameServer;
 	class CConfig *m_pConfig;
 	class IServer *m_pServer;
@@ -177,7 +177,7 @@ void CSaveTee::Load(CCharacter *pChr, int Team, bool IsSwap)
 	if(m_Time)
 		pChr->m_StartTime = pChr->Server()->Tick() - m_Time;
 
-	pChr->m_Pos = m_Pos;
+	pChr->SetPos(m_Pos);
 	pChr->m_PrevPos = m_PrevPos;
 	pChr->m_TeleCheckpoint = m_TeleCheckpoint;
 	pChr->m_LastPenalty = m_LastPenalty;
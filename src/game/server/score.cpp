@@ -4,6 +4,7 @@
 #include "save.h"
 #include "scoreworker.h"
 
+#include <base/log.h>
 #include <base/system.h>
 #include <engine/server/databases/connection_pool.h>
 #include <engine/shared/config.h>
@@ -41,6 +42,7 @@ void CScore::ExecPlayerThread(
 	str_copy(Tmp->m_aServer, g_Config.m_SvSqlServerName, sizeof(Tmp->m_aServer));
 	str_copy(Tmp->m_aRequestingPlayer, Server()->ClientName(ClientID), sizeof(Tmp->m_aRequestingPlayer));
 	Tmp->m_Offset = Offset;
+	Tmp->m_pCache = m_pCache;
 
 	m_pPool->Execute(pFuncPtr, std::move(Tmp), pThreadName);
 }
@@ -70,6 +72,7 @@ void CScore::GeneratePassphrase(char *pBuf, int BufSize)
 
 CScore::CScore(CGameContext *pGameServer, CDbConnectionPool *pPool) :
 	m_pPool(pPool),
+	m_pCache(std::make_shared<CScoreCache>()),
 	m_pGameServer(pGameServer),
 	m_pServer(pGameServer->Server())
 {
@@ -108,6 +111,11 @@ CScore::CScore(CGameContext *pGameServer, CDbConnectionPool *pPool) :
 	}
 }
 
+CScore::~CScore()
+{
+	log_info("sql", "leaderboard cache hits=%d misses=%d", m_pCache->Hits(), m_pCache->Misses());
+}
+
 void CScore::LoadBestTime()
 {
 	if(((CGameControllerDDRace *)(m_pGameServer->m_pController))->m_pLoadBestTimeResult)
@@ -159,6 +167,7 @@ void CScore::SaveScore(int ClientID, float Time, const char *pTimestamp, const f
 	str_copy(Tmp->m_aTimestamp, pTimestamp, sizeof(Tmp->m_aTimestamp));
 	for(int i = 0; i < NUM_CHECKPOINTS; i++)
 		Tmp->m_aCurrentTimeCp[i] = aTimeCp[i];
+	Tmp->m_pCache = m_pCache;
 
 	m_pPool->ExecuteWrite(CScoreWorker::SaveScore, std::move(Tmp), "save score");
 }
@@ -182,6 +191,7 @@ void CScore::SaveTeamScore(int *pClientIDs, unsigned int Size, float Time, const
 	FormatUuid(GameServer()->GameUuid(), Tmp->m_aGameUuid, sizeof(Tmp->m_aGameUuid));
 	str_copy(Tmp->m_aMap, g_Config.m_SvMap, sizeof(Tmp->m_aMap));
 	Tmp->m_TeamrankUuid = RandomUuid();
+	Tmp->m_pCache = m_pCache;
 
 	m_pPool->ExecuteWrite(CScoreWorker::SaveTeamScore, std::move(Tmp), "save team score");
 }
@@ -15,6 +15,8 @@ class CScore
 {
 	CPlayerData m_aPlayerData[MAX_CLIENTS];
 	CDbConnectionPool *m_pPool;
+	// shared with the queued requests, which may outlive the map
+	std::shared_ptr<CScoreCache> m_pCache;
 
 	CGameContext *GameServer() const { return m_pGameServer; }
 	IServer *Server() const { return m_pServer; }
@@ -40,7 +42,7 @@ class CScore
 
 public:
 	CScore(CGameContext *pGameServer, CDbConnectionPool *pPool);
-	~CScore() {}
+	~CScore();
 
 	CPlayerData *PlayerData(int ID) { return &m_aPlayerData[ID]; }
 
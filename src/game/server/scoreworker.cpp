@@ -15,6 +15,14 @@ static const CUuid UUID_NO_SAVE_ID =
 	{{0x6b, 0x40, 0x7e, 0x81, 0x8b, 0x77, 0x3e, 0x04,
 		0xa2, 0x07, 0x8d, 0xa1, 0x7f, 0x37, 0xd0, 0x00}};
 
+// times are bound as parameters so the statements stay cacheable, round
+// them to hundredths in double precision, so they are the same values the
+// %.2f they used to be formatted with was parsed into
+static double RoundTime(float Time)
+{
+	return std::round(Time * 100.0) / 100.0;
+}
+
 CScorePlayerResult::CScorePlayerResult()
 {
 	SetVariant(Variant::DIRECT);
@@ -46,6 +54,119 @@ void CScorePlayerResult::SetVariant(Variant v)
 	}
 }
 
+std::string CScoreCache::Key(EKind Kind, const CSqlPlayerRequest *pRequest)
+{
+	// only the fields the result depends on, so players share the results
+	const bool MapBound = Kind == TOP || Kind == TEAM_TOP5;
+	const bool Named = Kind == POINTS || Kind == MAP_INFO;
+	const bool Offset = Kind == TOP || Kind == TEAM_TOP5 || Kind == TOP_POINTS;
+	char aKey[512];
+	str_format(aKey, sizeof(aKey), "%d\x1f%s\x1f%s\x1f%s\x1f%d\x1f%s",
+		(int)Kind,
+		MapBound ? pRequest->m_aMap : "",
+		Named ? pRequest->m_aName : "",
+		Named ? pRequest->m_aRequestingPlayer : "",
+		Offset ? pRequest->m_Offset : 0,
+		Kind == TOP ? pRequest->m_aServer : "");
+	return aKey;
+}
+
+bool CScoreCache::Load(EKind Kind, const CSqlPlayerRequest *pRequest, CScorePlayerResult *pResult, uint64_t *pGeneration)
+{
+	const std::string CacheKey = Key(Kind, pRequest);
+	const int64_t Now = time_get();
+	const int64_t Ttl = (int64_t)g_Config.m_SvSqlCacheTtl * time_freq();
+
+	std::lock_guard<std::mutex> Lock(m_Lock);
+	*pGeneration = m_Generation;
+	auto Entry = m_Entries.find(CacheKey);
+	if(Entry == m_Entries.end() || Now - Entry->second.m_StoreTime >= Ttl)
+	{
+		m_Misses++;
+		return false;
+	}
+	pResult->m_MessageKind = Entry->second.m_MessageKind;
+	pResult->m_Data = Entry->second.m_Data;
+	m_Hits++;
+	return true;
+}
+
+void CScoreCache::Store(EKind Kind, const CSqlPlayerRequest *pRequest, const CScorePlayerResult *pResult, uint64_t Generation)
+{
+	if(g_Config.m_SvSqlCacheTtl <= 0)
+		return;
+
+	const std::string CacheKey = Key(Kind, pRequest);
+	const int64_t Now = time_get();
+	const int64_t Ttl = (int64_t)g_Config.m_SvSqlCacheTtl * time_freq();
+
+	std::lock_guard<std::mutex> Lock(m_Lock);
+	// the result might be older than a rank saved in the meantime
+	if(Generation != m_Generation)
+		return;
+	if(m_Entries.size() >= MAX_ENTRIES)
+	{
+		for(auto It = m_Entries.begin(); It != m_Entries.end();)
+		{
+			if(Now - It->second.m_StoreTime >= Ttl)
+				It = m_Entries.erase(It);
+			else
+				++It;
+		}
+		if(m_Entries.size() >= MAX_ENTRIES)
+			m_Entries.clear();
+	}
+	CEntry &Entry = m_Entries[CacheKey];
+	Entry.m_Map = Kind == TOP || Kind == TEAM_TOP5 ? pRequest->m_aMap : "";
+	Entry.m_StoreTime = Now;
+	Entry.m_MessageKind = pResult->m_MessageKind;
+	Entry.m_Data = pResult->m_Data;
+}
+
+void CScoreCache::Invalidate(const char *pMap)
+{
+	std::lock_guard<std::mutex> Lock(m_Lock);
+	m_Generation++;
+	// points and map infos depend on the ranks of all maps
+	for(auto It = m_Entries.begin(); It != m_Entries.end();)
+	{
+		if(It->second.m_Map.empty() || It->second.m_Map == pMap)
+			It = m_Entries.erase(It);
+		else
+			++It;
+	}
+}
+
+void CSqlScoreData::OnCommitted() const
+{
+	if(m_pCache)
+		m_pCache->Invalidate(m_aMap);
+}
+
+void CSqlTeamScoreData::OnCommitted() const
+{
+	if(m_pCache)
+		m_pCache->Invalidate(m_aMap);
+}
+
+// serves the request from the cache if possible, otherwise queries the
+// database and caches the result
+static bool CachedPlayerRequest(CScoreCache::EKind Kind, bool (*pfnQuery)(IDbConnection *, const ISqlData *, char *, int), IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+{
+	const auto *pData = dynamic_cast<const CSqlPlayerRequest *>(pGameData);
+	auto *pResult = dynamic_cast<CScorePlayerResult *>(pGameData->m_pResult.get());
+	if(!pData->m_pCache)
+		return pfnQuery(pSqlServer, pGameData, pError, ErrorSize);
+
+	uint64_t Generation;
+	if(pData->m_pCache->Load(Kind, pData, pResult, &Generation))
+		return false;
+	if(pfnQuery(pSqlServer, pGameData, pError, ErrorSize))
+		return true;
+	pData->m_pCache->Store(Kind, pData, pResult, Generation);
+	return false;
+}
+
 CTeamrank::CTeamrank() :
 	m_NumNames(0)
 {
@@ -264,7 +385,7 @@ bool CScoreWorker::MapVote(IDbConnection *pSqlServer, const ISqlData *pGameData,
 	return false;
 }
 
-bool CScoreWorker::MapInfo(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+static bool MapInfoImpl(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
 {
 	const auto *pData = dynamic_cast<const CSqlPlayerRequest *>(pGameData);
 	auto *pResult = dynamic_cast<CScorePlayerResult *>(pGameData->m_pResult.get());
@@ -390,6 +511,11 @@ bool CScoreWorker::MapInfo(IDbConnection *pSqlServer, const ISqlData *pGameData,
 	return false;
 }
 
+bool CScoreWorker::MapInfo(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+{
+	return CachedPlayerRequest(CScoreCache::MAP_INFO, MapInfoImpl, pSqlServer, pGameData, pError, ErrorSize);
+}
+
 bool CScoreWorker::SaveScore(IDbConnection *pSqlServer, const ISqlData *pGameData, Write w, char *pError, int ErrorSize)
 {
 	const auto *pData = dynamic_cast<const CSqlScoreData *>(pGameData);
@@ -518,23 +644,13 @@ bool CScoreWorker::SaveScore(IDbConnection *pSqlServer, const ISqlData *pGameDat
 		"	cp1, cp2, cp3, cp4, cp5, cp6, cp7, cp8, cp9, cp10, cp11, cp12, cp13, "
 		"	cp14, cp15, cp16, cp17, cp18, cp19, cp20, cp21, cp22, cp23, cp24, cp25, "
 		"	GameID, DDNet7) "
-		"VALUES (?, ?, %s, %.2f, ?, "
-		"	%.2f, %.2f, %.2f, %.2f, %.2f, %.2f, %.2f, %.2f, %.2f, "
-		"	%.2f, %.2f, %.2f, %.2f, %.2f, %.2f, %.2f, %.2f, %.2f, "
-		"	%.2f, %.2f, %.2f, %.2f, %.2f, %.2f, %.2f, "
+		"VALUES (?, ?, %s, ?, ?, "
+		"	?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+		"	?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
 		"	?, %s)",
 		pSqlServer->InsertIgnore(), pSqlServer->GetPrefix(),
 		w == Write::NORMAL ? "" : "_backup",
-		pSqlServer->InsertTimestampAsUtc(), pData->m_Time,
-		pData->m_aCurrentTimeCp[0], pData->m_aCurrentTimeCp[1], pData->m_aCurrentTimeCp[2],
-		pData->m_aCurrentTimeCp[3], pData->m_aCurrentTimeCp[4], pData->m_aCurrentTimeCp[5],
-		pData->m_aCurrentTimeCp[6], pData->m_aCurrentTimeCp[7], pData->m_aCurrentTimeCp[8],
-		pData->m_aCurrentTimeCp[9], pData->m_aCurrentTimeCp[10], pData->m_aCurrentTimeCp[11],
-		pData->m_aCurrentTimeCp[12], pData->m_aCurrentTimeCp[13], pData->m_aCurrentTimeCp[14],
-		pData->m_aCurrentTimeCp[15], pData->m_aCurrentTimeCp[16], pData->m_aCurrentTimeCp[17],
-		pData->m_aCurrentTimeCp[18], pData->m_aCurrentTimeCp[19], pData->m_aCurrentTimeCp[20],
-		pData->m_aCurrentTimeCp[21], pData->m_aCurrentTimeCp[22], pData->m_aCurrentTimeCp[23],
-		pData->m_aCurrentTimeCp[24], pSqlServer->False());
+		pSqlServer->InsertTimestampAsUtc(), pSqlServer->False());
 	if(pSqlServer->PrepareStatement(aBuf, pError, ErrorSize))
 	{
 		return true;
@@ -542,8 +658,11 @@ bool CScoreWorker::SaveScore(IDbConnection *pSqlServer, const ISqlData *pGameDat
 	pSqlServer->BindString(1, pData->m_aMap);
 	pSqlServer->BindString(2, pData->m_aName);
 	pSqlServer->BindString(3, pData->m_aTimestamp);
-	pSqlServer->BindString(4, g_Config.m_SvSqlServerName);
-	pSqlServer->BindString(5, pData->m_aGameUuid);
+	pSqlServer->BindDouble(4, RoundTime(pData->m_Time));
+	pSqlServer->BindString(5, g_Config.m_SvSqlServerName);
+	for(int i = 0; i < NUM_CHECKPOINTS; i++)
+		pSqlServer->BindDouble(6 + i, RoundTime(pData->m_aCurrentTimeCp[i]));
+	pSqlServer->BindString(6 + NUM_CHECKPOINTS, pData->m_aGameUuid);
 	pSqlServer->Print();
 	int NumInserted;
 	return pSqlServer->ExecuteUpdate(&NumInserted, pError, ErrorSize);
@@ -666,15 +785,16 @@ bool CScoreWorker::SaveTeamScore(IDbConnection *pSqlServer, const ISqlData *pGam
 			if(pData->m_Time < Time)
 			{
 				str_format(aBuf, sizeof(aBuf),
-					"UPDATE %s_teamrace SET Time=%.2f, Timestamp=%s, DDNet7=%s, GameID=? WHERE ID = ?",
-					pSqlServer->GetPrefix(), pData->m_Time, pSqlServer->InsertTimestampAsUtc(), pSqlServer->False());
+					"UPDATE %s_teamrace SET Time=?, Timestamp=%s, DDNet7=%s, GameID=? WHERE ID = ?",
+					pSqlServer->GetPrefix(), pSqlServer->InsertTimestampAsUtc(), pSqlServer->False());
 				if(pSqlServer->PrepareStatement(aBuf, pError, ErrorSize))
 				{
 					return true;
 				}
-				pSqlServer->BindString(1, pData->m_aTimestamp);
-				pSqlServer->BindString(2, pData->m_aGameUuid);
-				pSqlServer->BindBlob(3, Teamrank.m_TeamID.m_aData, sizeof(Teamrank.m_TeamID.m_aData));
+				pSqlServer->BindDouble(1, RoundTime(pData->m_Time));
+				pSqlServer->BindString(2, pData->m_aTimestamp);
+				pSqlServer->BindString(3, pData->m_aGameUuid);
+				pSqlServer->BindBlob(4, Teamrank.m_TeamID.m_aData, sizeof(Teamrank.m_TeamID.m_aData));
 				pSqlServer->Print();
 				int NumUpdated;
 				if(pSqlServer->ExecuteUpdate(&NumUpdated, pError, ErrorSize))
@@ -688,34 +808,38 @@ bool CScoreWorker::SaveTeamScore(IDbConnection *pSqlServer, const ISqlData *pGam
 		}
 	}
 
+	// if no entry found... create a new one, with one row per player
+	str_format(aBuf, sizeof(aBuf),
+		"%s INTO %s_teamrace%s(Map, Name, Timestamp, Time, ID, GameID, DDNet7) VALUES ",
+		pSqlServer->InsertIgnore(), pSqlServer->GetPrefix(),
+		w == Write::NORMAL ? "" : "_backup");
+	std::string Insert = aBuf;
 	for(unsigned int i = 0; i < pData->m_Size; i++)
 	{
-		// if no entry found... create a new one
 		str_format(aBuf, sizeof(aBuf),
-			"%s INTO %s_teamrace%s(Map, Name, Timestamp, Time, ID, GameID, DDNet7) "
-			"VALUES (?, ?, %s, %.2f, ?, ?, %s)",
-			pSqlServer->InsertIgnore(), pSqlServer->GetPrefix(),
-			w == Write::NORMAL ? "" : "_backup",
-			pSqlServer->InsertTimestampAsUtc(), pData->m_Time, pSqlServer->False());
-		if(pSqlServer->PrepareStatement(aBuf, pError, ErrorSize))
-		{
-			return true;
-		}
-		pSqlServer->BindString(1, pData->m_aMap);
-		pSqlServer->BindString(2, pData->m_aaNames[i]);
-		pSqlServer->BindString(3, pData->m_aTimestamp);
-		// copy uuid, because mysql BindBlob doesn't support const buffers
-		CUuid TeamrankId = pData->m_TeamrankUuid;
-		pSqlServer->BindBlob(4, TeamrankId.m_aData, sizeof(TeamrankId.m_aData));
-		pSqlServer->BindString(5, pData->m_aGameUuid);
-		pSqlServer->Print();
-		int NumInserted;
-		if(pSqlServer->ExecuteUpdate(&NumInserted, pError, ErrorSize))
-		{
-			return true;
-		}
+			"%s(?, ?, %s, ?, ?, ?, %s)",
+			i == 0 ? "" : ", ",
+			pSqlServer->InsertTimestampAsUtc(), pSqlServer->False());
+		Insert += aBuf;
 	}
-	return false;
+	if(pSqlServer->PrepareStatement(Insert.c_str(), pError, ErrorSize))
+	{
+		return true;
+	}
+	// copy uuid, because mysql BindBlob doesn't support const buffers
+	CUuid TeamrankId = pData->m_TeamrankUuid;
+	for(unsigned int i = 0; i < pData->m_Size; i++)
+	{
+		pSqlServer->BindString(i * 6 + 1, pData->m_aMap);
+		pSqlServer->BindString(i * 6 + 2, pData->m_aaNames[i]);
+		pSqlServer->BindString(i * 6 + 3, pData->m_aTimestamp);
+		pSqlServer->BindDouble(i * 6 + 4, RoundTime(pData->m_Time));
+		pSqlServer->BindBlob(i * 6 + 5, TeamrankId.m_aData, sizeof(TeamrankId.m_aData));
+		pSqlServer->BindString(i * 6 + 6, pData->m_aGameUuid);
+	}
+	pSqlServer->Print();
+	int NumInserted;
+	return pSqlServer->ExecuteUpdate(&NumInserted, pError, ErrorSize);
 }
 
 bool CScoreWorker::ShowRank(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
@@ -913,7 +1037,7 @@ bool CScoreWorker::ShowTeamRank(IDbConnection *pSqlServer, const ISqlData *pGame
 	return false;
 }
 
-bool CScoreWorker::ShowTop(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+static bool ShowTopImpl(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
 {
 	const auto *pData = dynamic_cast<const CSqlPlayerRequest *>(pGameData);
 	auto *pResult = dynamic_cast<CScorePlayerResult *>(pGameData->m_pResult.get());
@@ -1006,7 +1130,12 @@ bool CScoreWorker::ShowTop(IDbConnection *pSqlServer, const ISqlData *pGameData,
 	return !End;
 }
 
-bool CScoreWorker::ShowTeamTop5(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+bool CScoreWorker::ShowTop(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+{
+	return CachedPlayerRequest(CScoreCache::TOP, ShowTopImpl, pSqlServer, pGameData, pError, ErrorSize);
+}
+
+static bool ShowTeamTop5Impl(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
 {
 	const auto *pData = dynamic_cast<const CSqlPlayerRequest *>(pGameData);
 	auto *pResult = dynamic_cast<CScorePlayerResult *>(pGameData->m_pResult.get());
@@ -1093,6 +1222,11 @@ bool CScoreWorker::ShowTeamTop5(IDbConnection *pSqlServer, const ISqlData *pGame
 	return false;
 }
 
+bool CScoreWorker::ShowTeamTop5(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+{
+	return CachedPlayerRequest(CScoreCache::TEAM_TOP5, ShowTeamTop5Impl, pSqlServer, pGameData, pError, ErrorSize);
+}
+
 bool CScoreWorker::ShowPlayerTeamTop5(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
 {
 	const auto *pData = dynamic_cast<const CSqlPlayerRequest *>(pGameData);
@@ -1300,7 +1434,7 @@ bool CScoreWorker::ShowTimes(IDbConnection *pSqlServer, const ISqlData *pGameDat
 	return false;
 }
 
-bool CScoreWorker::ShowPoints(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+static bool ShowPointsImpl(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
 {
 	const auto *pData = dynamic_cast<const CSqlPlayerRequest *>(pGameData);
 	auto *pResult = dynamic_cast<CScorePlayerResult *>(pGameData->m_pResult.get());
@@ -1345,7 +1479,12 @@ bool CScoreWorker::ShowPoints(IDbConnection *pSqlServer, const ISqlData *pGameDa
 	return false;
 }
 
-bool CScoreWorker::ShowTopPoints(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+bool CScoreWorker::ShowPoints(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+{
+	return CachedPlayerRequest(CScoreCache::POINTS, ShowPointsImpl, pSqlServer, pGameData, pError, ErrorSize);
+}
+
+static bool ShowTopPointsImpl(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
 {
 	const auto *pData = dynamic_cast<const CSqlPlayerRequest *>(pGameData);
 	auto *pResult = dynamic_cast<CScorePlayerResult *>(pGameData->m_pResult.get());
@@ -1394,6 +1533,11 @@ bool CScoreWorker::ShowTopPoints(IDbConnection *pSqlServer, const ISqlData *pGam
 	return false;
 }
 
+bool CScoreWorker::ShowTopPoints(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+{
+	return CachedPlayerRequest(CScoreCache::TOP_POINTS, ShowTopPointsImpl, pSqlServer, pGameData, pError, ErrorSize);
+}
+
 bool CScoreWorker::RandomMap(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
 {
 	const auto *pData = dynamic_cast<const CSqlRandomMapRequest *>(pGameData);
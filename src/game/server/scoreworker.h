@@ -1,9 +1,12 @@
 #ifndef GAME_SERVER_SCOREWORKER_H
 #define GAME_SERVER_SCOREWORKER_H
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -61,6 +64,57 @@ struct CScorePlayerResult : ISqlResult
 	void SetVariant(Variant v);
 };
 
+struct CSqlPlayerRequest;
+
+// Results of the leaderboard requests of a server, shared by the database
+// workers. Ranks saved by the server drop the results they change right
+// away, ranks saved by other servers show up after sv_sql_cache_ttl.
+class CScoreCache
+{
+public:
+	enum EKind
+	{
+		TOP,
+		TEAM_TOP5,
+		TOP_POINTS,
+		POINTS,
+		MAP_INFO,
+	};
+
+	// copies a cached result, pGeneration receives the value Store needs on a miss
+	bool Load(EKind Kind, const CSqlPlayerRequest *pRequest, CScorePlayerResult *pResult, uint64_t *pGeneration);
+	// the result is dropped if ranks were saved since Load
+	void Store(EKind Kind, const CSqlPlayerRequest *pRequest, const CScorePlayerResult *pResult, uint64_t Generation);
+	// drops the results that depend on the ranks of the map
+	void Invalidate(const char *pMap);
+
+	int Hits() const { return m_Hits.load(); }
+	int Misses() const { return m_Misses.load(); }
+
+private:
+	enum
+	{
+		MAX_ENTRIES = 1024,
+	};
+
+	struct CEntry
+	{
+		// empty if the result doesn't depend on the ranks of a single map
+		std::string m_Map;
+		int64_t m_StoreTime;
+		CScorePlayerResult::Variant m_MessageKind;
+		decltype(CScorePlayerResult::m_Data) m_Data;
+	};
+
+	static std::string Key(EKind Kind, const CSqlPlayerRequest *pRequest);
+
+	std::mutex m_Lock;
+	std::unordered_map<std::string, CEntry> m_Entries;
+	uint64_t m_Generation = 0;
+	std::atomic_int m_Hits{0};
+	std::atomic_int m_Misses{0};
+};
+
 struct CScoreLoadBestTimeResult : ISqlResult
 {
 	CScoreLoadBestTimeResult() :
@@ -96,6 +150,8 @@ struct CSqlPlayerRequest : ISqlData
 	// relevant for /top5 kind of requests
 	int m_Offset;
 	char m_aServer[5];
+	// nullptr to always query the database
+	std::shared_ptr<CScoreCache> m_pCache;
 };
 
 struct CScoreRandomMapResult : ISqlResult
@@ -144,6 +200,10 @@ struct CSqlScoreData : ISqlData
 	int m_Num;
 	bool m_Search;
 	char m_aRequestingPlayer[MAX_NAME_LENGTH];
+	// invalidated once the score is committed
+	std::shared_ptr<CScoreCache> m_pCache;
+
+	void OnCommitted() const override;
 };
 
 struct CScoreSaveResult : ISqlResult
@@ -184,6 +244,10 @@ struct CSqlTeamScoreData : ISqlData
 	unsigned int m_Size;
 	char m_aaNames[MAX_CLIENTS][MAX_NAME_LENGTH];
 	CUuid m_TeamrankUuid;
+	// invalidated once the score is committed
+	std::shared_ptr<CScoreCache> m_pCache;
+
+	void OnCommitted() const override;
 };
 
 struct CSqlTeamSave : ISqlData
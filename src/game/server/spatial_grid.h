@@ -0,0 +1,180 @@
+#ifndef GAME_SERVER_SPATIAL_GRID_H
+#define GAME_SERVER_SPATIAL_GRID_H
+
+#include <base/math.h>
+#include <base/vmath.h>
+
+#include <cmath>
+#include <vector>
+
+/*
+	Class: Spatial Grid
+		Buckets items into square cells of a uniform grid by their
+		position, so that range queries only have to look at the items
+		of the cells overlapping the range.
+
+		Positions outside of the grid are clamped to the border cells,
+		an item's cell only changes with Move.
+*/
+template<class T>
+class CSpatialGrid
+{
+	struct CItem
+	{
+		T *m_pItem;
+		vec2 m_Pos;
+		int m_Cell;
+		// doubly linked list of the cell, free list when unused
+		int m_Prev;
+		int m_Next;
+	};
+
+	float m_CellSize = 1.0f;
+	int m_Width = 0;
+	int m_Height = 0;
+	std::vector<int> m_vCellHeads;
+	std::vector<CItem> m_vItems;
+	int m_FirstFree = -1;
+	int m_NumItems = 0;
+
+	int CellCoord(float Value, int Size) const
+	{
+		// also maps NaN to the first cell
+		float Cell = Value / m_CellSize;
+		if(!(Cell >= 0.0f))
+			return 0;
+		if(Cell >= Size - 1)
+			return Size - 1;
+		return (int)Cell;
+	}
+
+	int CellIndex(vec2 Pos) const
+	{
+		return CellCoord(Pos.y, m_Height) * m_Width + CellCoord(Pos.x, m_Width);
+	}
+
+	void Link(int Handle, int Cell)
+	{
+		CItem &Item = m_vItems[Handle];
+		Item.m_Cell = Cell;
+		Item.m_Prev = -1;
+		Item.m_Next = m_vCellHeads[Cell];
+		if(Item.m_Next >= 0)
+			m_vItems[Item.m_Next].m_Prev = Handle;
+		m_vCellHeads[Cell] = Handle;
+	}
+
+	void Unlink(int Handle)
+	{
+		CItem &Item = m_vItems[Handle];
+		if(Item.m_Prev >= 0)
+			m_vItems[Item.m_Prev].m_Next = Item.m_Next;
+		else
+			m_vCellHeads[Item.m_Cell] = Item.m_Next;
+		if(Item.m_Next >= 0)
+			m_vItems[Item.m_Next].m_Prev = Item.m_Prev;
+	}
+
+public:
+	CSpatialGrid() { Init(1.0f, 1.0f, 1.0f); }
+
+	/*
+		Function: Init
+			Sets the dimensions of the grid, rebucketing the items
+			already in it.
+
+		Arguments:
+			Width - Width of the covered area.
+			Height - Height of the covered area.
+			CellSize - Side length of a cell.
+	*/
+	void Init(float Width, float Height, float CellSize)
+	{
+		m_CellSize = CellSize;
+		m_Width = maximum((int)std::ceil(Width / CellSize), 1);
+		m_Height = maximum((int)std::ceil(Height / CellSize), 1);
+		m_vCellHeads.assign((size_t)m_Width * m_Height, -1);
+		for(int Handle = 0; Handle < (int)m_vItems.size(); Handle++)
+		{
+			if(m_vItems[Handle].m_pItem)
+				Link(Handle, CellIndex(m_vItems[Handle].m_Pos));
+		}
+	}
+
+	int Width() const { return m_Width; }
+	int Height() const { return m_Height; }
+	int NumItems() const { return m_NumItems; }
+
+	// returns the handle to move and remove the item with
+	int Insert(T *pItem, vec2 Pos)
+	{
+		int Handle;
+		if(m_FirstFree >= 0)
+		{
+			Handle = m_FirstFree;
+			m_FirstFree = m_vItems[Handle].m_Next;
+		}
+		else
+		{
+			Handle = m_vItems.size();
+			m_vItems.emplace_back();
+		}
+		m_vItems[Handle].m_pItem = pItem;
+		m_vItems[Handle].m_Pos = Pos;
+		Link(Handle, CellIndex(Pos));
+		m_NumItems++;
+		return Handle;
+	}
+
+	void Move(int Handle, vec2 Pos)
+	{
+		CItem &Item = m_vItems[Handle];
+		Item.m_Pos = Pos;
+		const int Cell = CellIndex(Pos);
+		if(Cell == Item.m_Cell)
+			return;
+		Unlink(Handle);
+		Link(Handle, Cell);
+	}
+
+	vec2 Pos(int Handle) const { return m_vItems[Handle].m_Pos; }
+
+	void Remove(int Handle)
+	{
+		Unlink(Handle);
+		m_vItems[Handle].m_pItem = nullptr;
+		m_vItems[Handle].m_Next = m_FirstFree;
+		m_FirstFree = Handle;
+		m_NumItems--;
+	}
+
+	// number of cells overlapping the rectangle
+	int NumCells(vec2 Min, vec2 Max) const
+	{
+		return (CellCoord(Max.x, m_Width) - CellCoord(Min.x, m_Width) + 1) * (CellCoord(Max.y, m_Height) - CellCoord(Min.y, m_Height) + 1);
+	}
+
+	/*
+		Function: Query
+			Calls Callback(T *pItem) for every item in the cells
+			overlapping the rectangle, in no particular order. The
+			callback must not modify the grid.
+	*/
+	template<class F>
+	void Query(vec2 Min, vec2 Max, F &&Callback) const
+	{
+		const int MinX = CellCoord(Min.x, m_Width);
+		const int MaxX = CellCoord(Max.x, m_Width);
+		const int MaxY = CellCoord(Max.y, m_Height);
+		for(int y = CellCoord(Min.y, m_Height); y <= MaxY; y++)
+		{
+			for(int x = MinX; x <= MaxX; x++)
+			{
+				for(int Handle = m_vCellHeads[y * m_Width + x]; Handle >= 0; Handle = m_vItems[Handle].m_Next)
+					Callback(m_vItems[Handle].m_pItem);
+			}
+		}
+	}
+};
+
+#endif
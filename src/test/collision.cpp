@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <engine/kernel.h>
+#include <engine/map.h>
+#include <engine/storage.h>
+#include <game/collision.h>
+#include <game/layers.h>
+
+#include <random>
+
+class Collision : public ::testing::Test
+{
+protected:
+	IKernel *m_pKernel;
+	IEngineMap *m_pMap;
+	CLayers m_Layers;
+	CCollision m_Collision;
+
+	Collision()
+	{
+		m_pKernel = IKernel::Create();
+		m_pKernel->RegisterInterface(CreateLocalStorage());
+		m_pMap = CreateEngineMap();
+		m_pKernel->RegisterInterface(m_pMap);
+		m_pKernel->RegisterInterface(static_cast<IMap *>(m_pMap), false);
+	}
+
+	~Collision()
+	{
+		delete m_pKernel;
+	}
+
+	void SetUp() override
+	{
+		ASSERT_TRUE(m_pMap->Load("data/maps/coverage.map"));
+		m_Layers.Init(m_pKernel);
+		m_Collision.Init(&m_Layers);
+	}
+
+	// the tile line walk as it was before ForEachMapIndex, allocating the result
+	std::vector<int> ReferenceMapIndices(vec2 PrevPos, vec2 Pos) const
+	{
+		const int Width = m_Collision.GetWidth();
+		const int Height = m_Collision.GetHeight();
+		std::vector<int> vIndices;
+		float d = distance(PrevPos, Pos);
+		int End(d + 1);
+		if(!d)
+		{
+			int Index = clamp((int)Pos.y / 32, 0, Height - 1) * Width + clamp((int)Pos.x / 32, 0, Width - 1);
+			if(m_Collision.TileExists(Index))
+				vIndices.push_back(Index);
+			return vIndices;
+		}
+		int LastIndex = 0;
+		for(int i = 0; i < End; i++)
+		{
+			vec2 Tmp = mix(PrevPos, Pos, i / d);
+			int Index = clamp((int)Tmp.y / 32, 0, Height - 1) * Width + clamp((int)Tmp.x / 32, 0, Width - 1);
+			if(m_Collision.TileExists(Index) && LastIndex != Index)
+			{
+				vIndices.push_back(Index);
+				LastIndex = Index;
+			}
+		}
+		return vIndices;
+	}
+};
+
+TEST_F(Collision, MapIndices)
+{
+	std::mt19937 Random(0);
+	std::uniform_real_distribution<float> XDist(-100.0f, m_Collision.GetWidth() * 32.0f + 100.0f);
+	std::uniform_real_distribution<float> YDist(-100.0f, m_Collision.GetHeight() * 32.0f + 100.0f);
+	std::uniform_real_distribution<float> StepDist(-40.0f, 40.0f);
+
+	int NumNonEmpty = 0;
+	for(int i = 0; i < 20000; i++)
+	{
+		const vec2 PrevPos(XDist(Random), YDist(Random));
+		// mostly movement at character speeds, sometimes teleports or standing still
+		vec2 Pos = PrevPos + vec2(StepDist(Random), StepDist(Random));
+		if(i % 10 == 0)
+			Pos = vec2(XDist(Random), YDist(Random));
+		else if(i % 10 == 1)
+			Pos = PrevPos;
+
+		std::vector<int> vExpected = ReferenceMapIndices(PrevPos, Pos);
+		std::vector<int> vVisited;
+		int Num = m_Collision.ForEachMapIndex(PrevPos, Pos, [&](int Index) {
+			vVisited.push_back(Index);
+			return true;
+		});
+		EXPECT_EQ(Num, (int)vExpected.size());
+		EXPECT_EQ(vVisited, vExpected);
+		EXPECT_EQ(m_Collision.GetMapIndices(PrevPos, Pos), vExpected);
+		NumNonEmpty += !vExpected.empty();
+
+		// stopping early
+		if(vExpected.size() >= 2)
+		{
+			vVisited.clear();
+			m_Collision.ForEachMapIndex(PrevPos, Pos, [&](int Index) {
+				vVisited.push_back(Index);
+				return vVisited.size() < 2;
+			});
+			EXPECT_EQ(vVisited.size(), 2u);
+		}
+	}
+	EXPECT_GT(NumNonEmpty, 0);
+}
@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <base/math.h>
+#include <base/system.h>
 #include <engine/shared/compression.h>
 
+#include <random>
+
 static const int DATA[] = {0, 1, -1, 32, 64, 256, -512, 12345, -123456, 1234567, 12345678, 123456789, 2147483647, (-2147483647 - 1)};
 static const int NUM = std::size(DATA);
 static const int SIZES[NUM] = {1, 1, 1, 1, 2, 2, 2, 3, 3, 4, 4, 4, 5, 5};
@@ -82,3 +86,74 @@ TEST(CVariableInt, DecompressBufferTooSmall)
 	long CompressedSize = CVariableInt::Decompress(aCompressed, sizeof(aCompressed), aUncompressed, sizeof(aUncompressed));
 	ASSERT_EQ(CompressedSize, -1);
 }
+
+TEST(CVariableInt, PackedSize)
+{
+	for(int i = 0; i < NUM; i++)
+	{
+		EXPECT_EQ(CVariableInt::PackedSize(DATA[i]), SIZES[i]);
+	}
+}
+
+TEST(CVariableInt, CompressZeroRuns)
+{
+	// mostly zeros like a snapshot delta, compared against packing every int on its own
+	int aData[64] = {0};
+	aData[5] = 1;
+	aData[6] = -70000;
+	aData[31] = 12345678;
+	aData[63] = -1;
+
+	unsigned char aExpected[sizeof(aData) / sizeof(int) * CVariableInt::MAX_BYTES_PACKED];
+	unsigned char *pExpectedEnd = aExpected;
+	for(int Value : aData)
+		pExpectedEnd = CVariableInt::Pack(pExpectedEnd, Value, aExpected + sizeof(aExpected) - pExpectedEnd);
+	const long ExpectedSize = pExpectedEnd - aExpected;
+
+	unsigned char aCompressed[sizeof(aExpected)];
+	long CompressedSize = CVariableInt::Compress(aData, sizeof(aData), aCompressed, sizeof(aCompressed));
+	ASSERT_EQ(CompressedSize, ExpectedSize);
+	EXPECT_EQ(mem_comp(aCompressed, aExpected, ExpectedSize), 0);
+
+	int aDecompressed[64];
+	long DecompressedSize = CVariableInt::Decompress(aCompressed, CompressedSize, aDecompressed, sizeof(aDecompressed));
+	ASSERT_EQ(DecompressedSize, sizeof(aData));
+	EXPECT_EQ(mem_comp(aDecompressed, aData, sizeof(aData)), 0);
+
+	// buffers one int too small
+	EXPECT_EQ(CVariableInt::Decompress(aCompressed, CompressedSize, aDecompressed, sizeof(aDecompressed) - sizeof(int)), -1);
+	EXPECT_EQ(CVariableInt::Compress(aData, sizeof(aData), aCompressed, CompressedSize - 1), -1);
+}
+
+TEST(CVariableInt, CompressMatchesScalar)
+{
+	// zero runs of every length around the vector widths, between random values
+	std::mt19937 Rng(0);
+	int aData[256];
+	int Num = 0;
+	while(Num < (int)std::size(aData))
+	{
+		const int Run = minimum((int)(Rng() % 40), (int)std::size(aData) - Num);
+		for(int i = 0; i < Run; i++)
+			aData[Num++] = 0;
+		if(Num < (int)std::size(aData))
+			aData[Num++] = (int)Rng() >> (Rng() % 32);
+	}
+
+	unsigned char aCompressed[sizeof(aData) / sizeof(int) * CVariableInt::MAX_BYTES_PACKED];
+	unsigned char aExpected[sizeof(aCompressed)];
+	const long ExpectedSize = CVariableInt::CompressScalar(aData, sizeof(aData), aExpected, sizeof(aExpected));
+	ASSERT_GT(ExpectedSize, 0);
+	ASSERT_EQ(CVariableInt::Compress(aData, sizeof(aData), aCompressed, sizeof(aCompressed)), ExpectedSize);
+	EXPECT_EQ(mem_comp(aCompressed, aExpected, ExpectedSize), 0);
+
+	int aDecompressed[std::size(aData)];
+	ASSERT_EQ(CVariableInt::Decompress(aCompressed, ExpectedSize, aDecompressed, sizeof(aDecompressed)), (long)sizeof(aData));
+	EXPECT_EQ(mem_comp(aDecompressed, aData, sizeof(aData)), 0);
+
+	// the buffer checks fail at the same sizes
+	for(int Size = 0; Size <= ExpectedSize; Size++)
+		EXPECT_EQ(CVariableInt::Compress(aData, sizeof(aData), aCompressed, Size), CVariableInt::CompressScalar(aData, sizeof(aData), aExpected, Size));
+	for(int Size = 0; Size <= (int)std::size(aData); Size++)
+		EXPECT_EQ(CVariableInt::Decompress(aExpected, ExpectedSize, aDecompressed, Size * sizeof(int)), CVariableInt::DecompressScalar(aExpected, ExpectedSize, aDecompressed, Size * sizeof(int)));
+}
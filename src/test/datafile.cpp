@@ -1,6 +1,8 @@
 #include "test.h"
 #include <gtest/gtest.h>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include <engine/shared/datafile.h>
 #include <engine/storage.h>
@@ -105,3 +107,95 @@ TEST(Datafile, StringData)
 		pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE);
 	}
 }
+
+TEST(Datafile, ParallelData)
+{
+	auto pStorage = std::unique_ptr<IStorage>(CreateLocalStorage());
+	CTestInfo Info;
+
+	const int NumData = 8;
+	std::vector<std::vector<int>> avData(NumData);
+	{
+		CDataFileWriter Writer;
+		Writer.Open(pStorage.get(), Info.m_aFilename);
+		for(int i = 0; i < NumData; i++)
+		{
+			for(int j = 0; j < 10000 * (i + 1); j++)
+				avData[i].push_back(i * j);
+			EXPECT_EQ(Writer.AddData(avData[i].size() * sizeof(int), avData[i].data()), i);
+		}
+		Writer.Finish();
+	}
+
+	{
+		CDataFileReader Reader;
+		ASSERT_TRUE(Reader.Open(pStorage.get(), Info.m_aFilename, IStorage::TYPE_ALL));
+
+		std::vector<std::thread> vThreads;
+		std::vector<const void *> vpData(NumData);
+		for(int i = 0; i < NumData; i++)
+			vThreads.emplace_back([&, i]() { vpData[i] = Reader.GetData(i); });
+		for(auto &Thread : vThreads)
+			Thread.join();
+
+		for(int i = 0; i < NumData; i++)
+		{
+			ASSERT_EQ(Reader.GetDataSize(i), (int)(avData[i].size() * sizeof(int)));
+			ASSERT_TRUE(vpData[i]);
+			EXPECT_EQ(mem_comp(vpData[i], avData[i].data(), avData[i].size() * sizeof(int)), 0);
+		}
+
+		Reader.Close();
+	}
+
+	if(!HasFailure())
+	{
+		pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE);
+	}
+}
+
+TEST(Datafile, ParallelCompression)
+{
+	auto pStorage = std::unique_ptr<IStorage>(CreateLocalStorage());
+	CTestInfo Info;
+
+	// large enough to be compressed on several threads
+	const int NumData = 16;
+	std::vector<std::vector<int>> avData(NumData);
+	for(int i = 0; i < NumData; i++)
+		for(int j = 0; j < 5000 * (NumData - i); j++)
+			avData[i].push_back((i + 1) * j / 3);
+
+	SHA256_DIGEST aSha256[2];
+	for(SHA256_DIGEST &Sha256 : aSha256)
+	{
+		{
+			CDataFileWriter Writer;
+			Writer.Open(pStorage.get(), Info.m_aFilename);
+			for(int i = 0; i < NumData; i++)
+				EXPECT_EQ(Writer.AddData(avData[i].size() * sizeof(int), avData[i].data(), i % 3 == 0 ? Z_BEST_COMPRESSION : Z_DEFAULT_COMPRESSION), i);
+			Writer.Finish();
+		}
+
+		CDataFileReader Reader;
+		ASSERT_TRUE(Reader.Open(pStorage.get(), Info.m_aFilename, IStorage::TYPE_ALL));
+		ASSERT_EQ(Reader.NumData(), NumData);
+		for(int i = 0; i < NumData; i++)
+		{
+			ASSERT_EQ(Reader.GetDataSize(i), (int)(avData[i].size() * sizeof(int)));
+			const void *pData = Reader.GetData(i);
+			ASSERT_TRUE(pData);
+			EXPECT_EQ(mem_comp(pData, avData[i].data(), avData[i].size() * sizeof(int)), 0);
+		}
+		Sha256 = Reader.Sha256();
+		Reader.Close();
+	}
+
+	// the output doesn't depend on the order the threads finished in
+	EXPECT_EQ(aSha256[0], aSha256[1]);
+
+	if(!HasFailure())
+	{
+		pStorage->RemoveFile(Info.m_aFilename, IStorage::TYPE_SAVE);
+	}
+}
@@ -1,8 +1,313 @@
 #include <gtest/gtest.h>
 
+#include <base/math.h>
 #include <base/system.h>
 #include <engine/shared/huffman.h>
 
+#include <algorithm>
+#include <vector>
+
+// the byte by byte implementation before the multi-symbol decoder, the
+// results of CHuffman must stay exactly the same
+class CHuffmanReference
+{
+	enum
+	{
+		HUFFMAN_EOF_SYMBOL = 256,
+
+		HUFFMAN_MAX_SYMBOLS = HUFFMAN_EOF_SYMBOL + 1,
+		HUFFMAN_MAX_NODES = HUFFMAN_MAX_SYMBOLS * 2 - 1,
+
+		HUFFMAN_LUTBITS = 10,
+		HUFFMAN_LUTSIZE = (1 << HUFFMAN_LUTBITS),
+		HUFFMAN_LUTMASK = (HUFFMAN_LUTSIZE - 1)
+	};
+
+	struct CNode
+	{
+		unsigned m_Bits;
+		unsigned m_NumBits;
+		unsigned short m_aLeafs[2];
+		unsigned char m_Symbol;
+	};
+
+	CNode m_aNodes[HUFFMAN_MAX_NODES];
+	CNode *m_apDecodeLut[HUFFMAN_LUTSIZE];
+	CNode *m_pStartNode;
+	int m_NumNodes;
+
+	void Setbits_r(CNode *pNode, int Bits, unsigned Depth);
+	void ConstructTree(const unsigned *pFrequencies);
+
+public:
+	void Init(const unsigned *pFrequencies);
+	int Compress(const void *pInput, int InputSize, void *pOutput, int OutputSize) const;
+	int Decompress(const void *pInput, int InputSize, void *pOutput, int OutputSize) const;
+};
+
+struct CReferenceConstructNode
+{
+	unsigned short m_NodeId;
+	int m_Frequency;
+};
+
+static bool ReferenceCompareNodesByFrequencyDesc(const CReferenceConstructNode *pNode1, const CReferenceConstructNode *pNode2)
+{
+	return pNode2->m_Frequency < pNode1->m_Frequency;
+}
+
+void CHuffmanReference::Setbits_r(CNode *pNode, int Bits, unsigned Depth)
+{
+	if(pNode->m_aLeafs[1] != 0xffff)
+		Setbits_r(&m_aNodes[pNode->m_aLeafs[1]], Bits | (1 << Depth), Depth + 1);
+	if(pNode->m_aLeafs[0] != 0xffff)
+		Setbits_r(&m_aNodes[pNode->m_aLeafs[0]], Bits, Depth + 1);
+
+	if(pNode->m_NumBits)
+	{
+		pNode->m_Bits = Bits;
+		pNode->m_NumBits = Depth;
+	}
+}
+
+void CHuffmanReference::ConstructTree(const unsigned *pFrequencies)
+{
+	CReferenceConstructNode aNodesLeftStorage[HUFFMAN_MAX_SYMBOLS];
+	CReferenceConstructNode *apNodesLeft[HUFFMAN_MAX_SYMBOLS];
+	int NumNodesLeft = HUFFMAN_MAX_SYMBOLS;
+
+	// add the symbols
+	for(int i = 0; i < HUFFMAN_MAX_SYMBOLS; i++)
+	{
+		m_aNodes[i].m_NumBits = 0xFFFFFFFF;
+		m_aNodes[i].m_Symbol = i;
+		m_aNodes[i].m_aLeafs[0] = 0xffff;
+		m_aNodes[i].m_aLeafs[1] = 0xffff;
+
+		if(i == HUFFMAN_EOF_SYMBOL)
+			aNodesLeftStorage[i].m_Frequency = 1;
+		else
+			aNodesLeftStorage[i].m_Frequency = pFrequencies[i];
+		aNodesLeftStorage[i].m_NodeId = i;
+		apNodesLeft[i] = &aNodesLeftStorage[i];
+	}
+
+	m_NumNodes = HUFFMAN_MAX_SYMBOLS;
+
+	// construct the table
+	while(NumNodesLeft > 1)
+	{
+		std::stable_sort(apNodesLeft, apNodesLeft + NumNodesLeft, ReferenceCompareNodesByFrequencyDesc);
+
+		m_aNodes[m_NumNodes].m_NumBits = 0;
+		m_aNodes[m_NumNodes].m_aLeafs[0] = apNodesLeft[NumNodesLeft - 1]->m_NodeId;
+		m_aNodes[m_NumNodes].m_aLeafs[1] = apNodesLeft[NumNodesLeft - 2]->m_NodeId;
+		apNodesLeft[NumNodesLeft - 2]->m_NodeId = m_NumNodes;
+		apNodesLeft[NumNodesLeft - 2]->m_Frequency = apNodesLeft[NumNodesLeft - 1]->m_Frequency + apNodesLeft[NumNodesLeft - 2]->m_Frequency;
+
+		m_NumNodes++;
+		NumNodesLeft--;
+	}
+
+	// set start node
+	m_pStartNode = &m_aNodes[m_NumNodes - 1];
+
+	// build symbol bits
+	Setbits_r(m_pStartNode, 0, 0);
+}
+
+void CHuffmanReference::Init(const unsigned *pFrequencies)
+{
+	// make sure to cleanout every thing
+	mem_zero(m_aNodes, sizeof(m_aNodes));
+	mem_zero(m_apDecodeLut, sizeof(m_apDecodeLut));
+	m_pStartNode = 0x0;
+	m_NumNodes = 0;
+
+	// construct the tree
+	ConstructTree(pFrequencies);
+
+	// build decode LUT
+	for(int i = 0; i < HUFFMAN_LUTSIZE; i++)
+	{
+		unsigned Bits = i;
+		int k;
+		CNode *pNode = m_pStartNode;
+		for(k = 0; k < HUFFMAN_LUTBITS; k++)
+		{
+			pNode = &m_aNodes[pNode->m_aLeafs[Bits & 1]];
+			Bits >>= 1;
+
+			if(!pNode)
+				break;
+
+			if(pNode->m_NumBits)
+			{
+				m_apDecodeLut[i] = pNode;
+				break;
+			}
+		}
+
+		if(k == HUFFMAN_LUTBITS)
+			m_apDecodeLut[i] = pNode;
+	}
+}
+
+//***************************************************************
+int CHuffmanReference::Compress(const void *pInput, int InputSize, void *pOutput, int OutputSize) const
+{
+	// this macro loads a symbol for a byte into bits and bitcount
+#define HUFFMAN_MACRO_LOADSYMBOL(Sym) \
+	do \
+	{ \
+		Bits |= m_aNodes[Sym].m_Bits << Bitcount; \
+		Bitcount += m_aNodes[Sym].m_NumBits; \
+	} while(0)
+
+	// this macro writes the symbol stored in bits and bitcount to the dst pointer
+#define HUFFMAN_MACRO_WRITE() \
+	do \
+	{ \
+		while(Bitcount >= 8) \
+		{ \
+			*pDst++ = (unsigned char)(Bits & 0xff); \
+			if(pDst == pDstEnd) \
+				return -1; \
+			Bits >>= 8; \
+			Bitcount -= 8; \
+		} \
+	} while(0)
+
+	// setup buffer pointers
+	const unsigned char *pSrc = (const unsigned char *)pInput;
+	const unsigned char *pSrcEnd = pSrc + InputSize;
+	unsigned char *pDst = (unsigned char *)pOutput;
+	unsigned char *pDstEnd = pDst + OutputSize;
+
+	// symbol variables
+	unsigned Bits = 0;
+	unsigned Bitcount = 0;
+
+	// make sure that we have data that we want to compress
+	if(InputSize)
+	{
+		// {A} load the first symbol
+		int Symbol = *pSrc++;
+
+		while(pSrc != pSrcEnd)
+		{
+			// {B} load the symbol
+			HUFFMAN_MACRO_LOADSYMBOL(Symbol);
+
+			// {C} fetch next symbol, this is done here because it will reduce dependency in the code
+			Symbol = *pSrc++;
+
+			// {B} write the symbol loaded at
+			HUFFMAN_MACRO_WRITE();
+		}
+
+		// write the last symbol loaded from {C} or {A} in the case of only 1 byte input buffer
+		HUFFMAN_MACRO_LOADSYMBOL(Symbol);
+		HUFFMAN_MACRO_WRITE();
+	}
+
+	// write EOF symbol
+	HUFFMAN_MACRO_LOADSYMBOL(HUFFMAN_EOF_SYMBOL);
+	HUFFMAN_MACRO_WRITE();
+
+	// write out the last bits
+	*pDst++ = Bits;
+
+	// return the size of the output
+	return (int)(pDst - (const unsigned char *)pOutput);
+
+	// remove macros
+#undef HUFFMAN_MACRO_LOADSYMBOL
+#undef HUFFMAN_MACRO_WRITE
+}
+
+//***************************************************************
+int CHuffmanReference::Decompress(const void *pInput, int InputSize, void *pOutput, int OutputSize) const
+{
+	// setup buffer pointers
+	unsigned char *pDst = (unsigned char *)pOutput;
+	unsigned char *pSrc = (unsigned char *)pInput;
+	unsigned char *pDstEnd = pDst + OutputSize;
+	unsigned char *pSrcEnd = pSrc + InputSize;
+
+	unsigned Bits = 0;
+	unsigned Bitcount = 0;
+
+	const CNode *pEof = &m_aNodes[HUFFMAN_EOF_SYMBOL];
+
+	while(true)
+	{
+		// {A} try to load a node now, this will reduce dependency at location {D}
+		const CNode *pNode = 0;
+		if(Bitcount >= HUFFMAN_LUTBITS)
+			pNode = m_apDecodeLut[Bits & HUFFMAN_LUTMASK];
+
+		// {B} fill with new bits
+		while(Bitcount < 24 && pSrc != pSrcEnd)
+		{
+			Bits |= (*pSrc++) << Bitcount;
+			Bitcount += 8;
+		}
+
+		// {C} load symbol now if we didn't that earlier at location {A}
+		if(!pNode)
+			pNode = m_apDecodeLut[Bits & HUFFMAN_LUTMASK];
+
+		if(!pNode)
+			return -1;
+
+		// {D} check if we hit a symbol already
+		if(pNode->m_NumBits)
+		{
+			// remove the bits for that symbol
+			Bits >>= pNode->m_NumBits;
+			Bitcount -= pNode->m_NumBits;
+		}
+		else
+		{
+			// remove the bits that the lut checked up for us
+			Bits >>= HUFFMAN_LUTBITS;
+			Bitcount -= HUFFMAN_LUTBITS;
+
+			// walk the tree bit by bit
+			while(true)
+			{
+				// traverse tree
+				pNode = &m_aNodes[pNode->m_aLeafs[Bits & 1]];
+
+				// remove bit
+				Bitcount--;
+				Bits >>= 1;
+
+				// check if we hit a symbol
+				if(pNode->m_NumBits)
+					break;
+
+				// no more bits, decoding error
+				if(Bitcount == 0)
+					return -1;
+			}
+		}
+
+		// check for eof
+		if(pNode == pEof)
+			break;
+
+		// output character
+		if(pDst == pDstEnd)
+			return -1;
+		*pDst++ = pNode->m_Symbol;
+	}
+
+	// return the size of the decompressed buffer
+	return (int)(pDst - (const unsigned char *)pOutput);
+}
+
 TEST(Huffman, CompressionShouldNotChangeData)
 {
 	CHuffman Huffman;
@@ -46,3 +351,72 @@ TEST(Huffman, CompressionCompatible)
 	EXPECT_EQ(match, 0) << "The compression is not compatible with older/other implementations anymore";
 	EXPECT_EQ(Size, 15);
 }
+
+// mostly zeros and small values like snapshot deltas, with some text
+static std::vector<unsigned char> GenerateTraffic(int Size, unsigned Seed)
+{
+	std::vector<unsigned char> vData(Size);
+	for(int i = 0; i < Size; i++)
+	{
+		Seed = Seed * 1103515245 + 12345;
+		unsigned Random = Seed >> 16;
+		if(Random % 8 < 5)
+			vData[i] = 0;
+		else if(Random % 8 < 7)
+			vData[i] = (Random >> 3) % 16;
+		else
+			vData[i] = Random >> 3;
+	}
+	return vData;
+}
+
+TEST(Huffman, MatchesReference)
+{
+	CHuffman Huffman;
+	Huffman.Init();
+	CHuffmanReference Reference;
+	Reference.Init(CHuffman::ms_aFreqTable);
+
+	unsigned char aCompressed[4096];
+	unsigned char aReferenceCompressed[4096];
+	unsigned char aDecompressed[2048];
+	unsigned char aReferenceDecompressed[2048];
+
+	for(int Size = 0; Size < 1400; Size += 7)
+	{
+		std::vector<unsigned char> vData = GenerateTraffic(Size, Size);
+
+		const int CompressedSize = Huffman.Compress(vData.data(), Size, aCompressed, sizeof(aCompressed));
+		ASSERT_EQ(CompressedSize, Reference.Compress(vData.data(), Size, aReferenceCompressed, sizeof(aReferenceCompressed)));
+		ASSERT_EQ(mem_comp(aCompressed, aReferenceCompressed, CompressedSize), 0);
+
+		// too small output buffers
+		for(int OutputSize = maximum(CompressedSize - 5, 1); OutputSize <= CompressedSize; OutputSize++)
+		{
+			EXPECT_EQ(Huffman.Compress(vData.data(), Size, aCompressed, OutputSize), OutputSize == CompressedSize ? CompressedSize : -1);
+		}
+
+		ASSERT_EQ(Huffman.Decompress(aCompressed, CompressedSize, aDecompressed, sizeof(aDecompressed)), Size);
+		EXPECT_EQ(mem_comp(aDecompressed, vData.data(), Size), 0);
+
+		// too small output buffers, truncated and corrupted input
+		for(int OutputSize = maximum(Size - 4, 0); OutputSize <= Size; OutputSize++)
+		{
+			EXPECT_EQ(Huffman.Decompress(aCompressed, CompressedSize, aDecompressed, OutputSize),
+				Reference.Decompress(aCompressed, CompressedSize, aReferenceDecompressed, OutputSize));
+		}
+		for(int InputSize = maximum(CompressedSize - 8, 0); InputSize < CompressedSize; InputSize++)
+		{
+			const int DecompressedSize = Huffman.Decompress(aCompressed, InputSize, aDecompressed, sizeof(aDecompressed));
+			ASSERT_EQ(DecompressedSize, Reference.Decompress(aCompressed, InputSize, aReferenceDecompressed, sizeof(aReferenceDecompressed)));
+			EXPECT_EQ(mem_comp(aDecompressed, aReferenceDecompressed, maximum(DecompressedSize, 0)), 0);
+		}
+		if(CompressedSize > 2)
+		{
+			aCompressed[CompressedSize / 2] ^= 0x5a;
+			const int DecompressedSize = Huffman.Decompress(aCompressed, CompressedSize, aDecompressed, sizeof(aDecompressed));
+			ASSERT_EQ(DecompressedSize, Reference.Decompress(aCompressed, CompressedSize, aReferenceDecompressed, sizeof(aReferenceDecompressed)));
+			EXPECT_EQ(mem_comp(aDecompressed, aReferenceDecompressed, maximum(DecompressedSize, 0)), 0);
+		}
+	}
+}
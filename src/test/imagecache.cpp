@@ -0,0 +1,200 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <engine/shared/imagecache.h>
+#include <engine/storage.h>
+
+#include <memory>
+
+static CImageCache::CSource MakeSource(const char *pPath, int64_t Size, int64_t Modified)
+{
+	CImageCache::CSource Source;
+	str_copy(Source.m_aPath, pPath);
+	Source.m_Size = Size;
+	Source.m_Modified = Modified;
+	Source.m_Hash = SHA256_ZEROED;
+	return Source;
+}
+
+class ImageCache : public ::testing::Test
+{
+protected:
+	CTestInfo m_Info;
+	std::unique_ptr<IStorage> m_pStorage;
+	CImageCache m_Cache;
+	unsigned char m_aPixels[4 * 3 * 4];
+	CImageInfo m_Img;
+
+	ImageCache()
+	{
+		m_Info.m_DeleteTestStorageFilesOnSuccess = true;
+		m_pStorage.reset(m_Info.CreateTestStorage());
+		m_Cache.Init(m_pStorage.get());
+
+		for(unsigned i = 0; i < sizeof(m_aPixels); i++)
+			m_aPixels[i] = i * 7;
+		m_Img.m_Width = 4;
+		m_Img.m_Height = 3;
+		m_Img.m_Format = CImageInfo::FORMAT_RGBA;
+		m_Img.m_pData = m_aPixels;
+	}
+
+	bool LoadMatches(const CImageCache::CSource &Source, const char *pVariant)
+	{
+		CImageInfo Loaded;
+		if(!m_Cache.Load(Source, pVariant, &Loaded))
+			return false;
+		EXPECT_EQ(Loaded.m_Width, m_Img.m_Width);
+		EXPECT_EQ(Loaded.m_Height, m_Img.m_Height);
+		EXPECT_EQ(Loaded.m_Format, m_Img.m_Format);
+		EXPECT_EQ(mem_comp(Loaded.m_pData, m_aPixels, sizeof(m_aPixels)), 0);
+		free(Loaded.m_pData);
+		return true;
+	}
+};
+
+TEST_F(ImageCache, StoreLoad)
+{
+	const CImageCache::CSource Source = MakeSource("/skins/default.png", 1000, 12345);
+	EXPECT_FALSE(LoadMatches(Source, ""));
+	EXPECT_TRUE(m_Cache.Store(Source, "", m_Img));
+	EXPECT_TRUE(LoadMatches(Source, ""));
+
+	// variants and other files have their own entries
+	EXPECT_FALSE(LoadMatches(Source, "colorable"));
+	EXPECT_FALSE(LoadMatches(MakeSource("/skins/other.png", 1000, 12345), ""));
+}
+
+TEST_F(ImageCache, Invalidation)
+{
+	CImageCache::CSource Source = MakeSource("/skins/default.png", 1000, 12345);
+	Source.m_Hash = sha256("content", 7);
+	EXPECT_TRUE(m_Cache.Store(Source, "", m_Img));
+
+	// changed size or time without the content
+	EXPECT_FALSE(LoadMatches(MakeSource("/skins/default.png", 1001, 12345), ""));
+	CImageCache::CSource Touched = MakeSource("/skins/default.png", 1000, 23456);
+	EXPECT_FALSE(LoadMatches(Touched, ""));
+
+	// same content, the entry is updated to the new time
+	Touched.m_Hash = sha256("content", 7);
+	EXPECT_TRUE(LoadMatches(Touched, ""));
+	EXPECT_TRUE(LoadMatches(MakeSource("/skins/default.png", 1000, 23456), ""));
+
+	// changed content
+	CImageCache::CSource Changed = MakeSource("/skins/default.png", 1000, 34567);
+	Changed.m_Hash = sha256("changed", 7);
+	EXPECT_FALSE(LoadMatches(Changed, ""));
+}
+
+TEST_F(ImageCache, Corrupt)
+{
+	const CImageCache::CSource Source = MakeSource("/skins/default.png", 1000, 12345);
+	EXPECT_TRUE(m_Cache.Store(Source, "", m_Img));
+
+	// truncate the entry
+	m_pStorage->ListDirectory(
+		IStorage::TYPE_SAVE, "cache/images", [](const char *pName, int IsDir, int DirType, void *pUser) {
+			if(IsDir)
+				return 0;
+			char aPath[IO_MAX_PATH_LENGTH];
+			str_format(aPath, sizeof(aPath), "cache/images/%s", pName);
+			IOHANDLE File = ((IStorage *)pUser)->OpenFile(aPath, IOFLAG_WRITE, IStorage::TYPE_SAVE);
+			io_write(File, "IMGC", 4);
+			io_close(File);
+			return 0;
+		},
+		m_pStorage.get());
+	EXPECT_FALSE(LoadMatches(Source, ""));
+}
+
+TEST_F(ImageCache, FindSource)
+{
+	IOHANDLE File = m_pStorage->OpenFile("source.png", IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	ASSERT_TRUE(File);
+	io_write(File, "not really a png", 16);
+	io_close(File);
+
+	CImageCache::CSource Source;
+	ASSERT_TRUE(m_Cache.FindSource("source.png", IStorage::TYPE_SAVE, &Source));
+	EXPECT_EQ(Source.m_Size, 16);
+	EXPECT_GE(Source.m_Modified, 0);
+	EXPECT_TRUE(Source.m_Hash == SHA256_ZEROED);
+	EXPECT_TRUE(str_endswith(Source.m_aPath, "source.png"));
+
+	EXPECT_TRUE(m_Cache.Store(Source, "", m_Img));
+	EXPECT_TRUE(LoadMatches(Source, ""));
+	EXPECT_FALSE(m_Cache.FindSource("missing.png", IStorage::TYPE_SAVE, &Source));
+}
+
+TEST_F(ImageCache, Flags)
+{
+	const CImageCache::CSource Source = MakeSource("/skins/default.png", 1000, 12345);
+	EXPECT_TRUE(m_Cache.Store(Source, "", m_Img, 5));
+	CImageInfo Loaded;
+	int Flags = 0;
+	ASSERT_TRUE(m_Cache.Load(Source, "", &Loaded, &Flags));
+	EXPECT_EQ(Flags, 5);
+	free(Loaded.m_pData);
+}
+
+TEST_F(ImageCache, ReadHash)
+{
+	IOHANDLE File = m_pStorage->OpenFile("source.png", IOFLAG_WRITE, IStorage::TYPE_SAVE);
+	ASSERT_TRUE(File);
+	io_write(File, "content", 7);
+	io_close(File);
+
+	CImageCache::CSource Source;
+	ASSERT_TRUE(m_Cache.FindSource("source.png", IStorage::TYPE_SAVE, &Source));
+	ASSERT_TRUE(Source.ReadHash());
+	EXPECT_TRUE(Source.m_Hash == sha256("content", 7));
+
+	str_copy(Source.m_aPath, "/missing.png");
+	EXPECT_FALSE(Source.ReadHash());
+}
+
+static int CountEntries(IStorage *pStorage)
+{
+	int Count = 0;
+	pStorage->ListDirectory(
+		IStorage::TYPE_SAVE, "cache/images", [](const char *pName, int IsDir, int DirType, void *pUser) {
+			if(!IsDir)
+				(*(int *)pUser)++;
+			return 0;
+		},
+		&Count);
+	return Count;
+}
+
+TEST_F(ImageCache, Prune)
+{
+	const char *apNames[] = {"a.png", "b.png", "c.png"};
+	CImageCache::CSource aSources[3];
+	for(int i = 0; i < 3; i++)
+	{
+		IOHANDLE File = m_pStorage->OpenFile(apNames[i], IOFLAG_WRITE, IStorage::TYPE_SAVE);
+		ASSERT_TRUE(File);
+		io_write(File, "png", 3);
+		io_close(File);
+		ASSERT_TRUE(m_Cache.FindSource(apNames[i], IStorage::TYPE_SAVE, &aSources[i]));
+		EXPECT_TRUE(m_Cache.Store(aSources[i], "", m_Img));
+	}
+	// the source of this one doesn't exist
+	EXPECT_TRUE(m_Cache.Store(MakeSource("/skins/deleted.png", 1000, 12345), "", m_Img));
+	EXPECT_EQ(CountEntries(m_pStorage.get()), 4);
+
+	m_Cache.Prune(1024 * 1024);
+	EXPECT_EQ(CountEntries(m_pStorage.get()), 3);
+	for(const CImageCache::CSource &Source : aSources)
+		EXPECT_TRUE(LoadMatches(Source, ""));
+
+	// sources deleted since the last start
+	m_pStorage->RemoveFile("c.png", IStorage::TYPE_SAVE);
+	m_Cache.Prune(1024 * 1024);
+	EXPECT_EQ(CountEntries(m_pStorage.get()), 2);
+
+	// too large
+	m_Cache.Prune(0);
+	EXPECT_EQ(CountEntries(m_pStorage.get()), 0);
+}
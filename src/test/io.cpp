@@ -68,6 +68,61 @@ TEST(Io, CurrentExe)
 	EXPECT_GE(io_length(CurrentExe), 1024);
 	io_close(CurrentExe);
 }
+TEST(Io, Map)
+{
+	CTestInfo Info;
+	IOHANDLE File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	EXPECT_FALSE(io_close(File));
+
+	// empty files can't be mapped
+	void *pData;
+	size_t Size;
+	File = io_open(Info.m_aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	EXPECT_FALSE(io_map(File, &pData, &Size));
+	EXPECT_FALSE(io_close(File));
+
+	File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	EXPECT_EQ(io_write(File, "abcd", 4), 4);
+	EXPECT_FALSE(io_close(File));
+
+	File = io_open(Info.m_aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+#if defined(CONF_FAMILY_WINDOWS)
+	EXPECT_FALSE(io_map(File, &pData, &Size));
+	EXPECT_FALSE(io_close(File));
+#else
+	ASSERT_TRUE(io_map(File, &pData, &Size));
+	EXPECT_FALSE(io_close(File));
+	ASSERT_EQ(Size, 4u);
+	EXPECT_EQ(mem_comp(pData, "abcd", 4), 0);
+
+	// writes stay in memory
+	static_cast<char *>(pData)[0] = 'x';
+	EXPECT_EQ(mem_comp(pData, "xbcd", 4), 0);
+	char aBuf[4];
+	File = io_open(Info.m_aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	EXPECT_EQ(io_read(File, aBuf, sizeof(aBuf)), 4);
+	EXPECT_EQ(mem_comp(aBuf, "abcd", 4), 0);
+	EXPECT_FALSE(io_close(File));
+
+	// the file can be replaced by renaming while it is mapped
+	char aReplacement[IO_MAX_PATH_LENGTH];
+	str_format(aReplacement, sizeof(aReplacement), "%s.new", Info.m_aFilename);
+	File = io_open(aReplacement, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	EXPECT_EQ(io_write(File, "efgh", 4), 4);
+	EXPECT_FALSE(io_close(File));
+	EXPECT_FALSE(fs_rename(aReplacement, Info.m_aFilename));
+	EXPECT_EQ(mem_comp(pData, "xbcd", 4), 0);
+	io_unmap(pData, Size);
+#endif
+
+	EXPECT_FALSE(fs_remove(Info.m_aFilename));
+}
 TEST(Io, SyncWorks)
 {
 	CTestInfo Info;
@@ -48,3 +48,52 @@ TEST(Net, Ipv4AndIpv6Work)
 	net_udp_close(Socket1);
 	net_udp_close(Socket2);
 }
+
+TEST(Net, UdpBatching)
+{
+	NETADDR Bindaddr = {};
+	NETSOCKET Socket1;
+	NETSOCKET Socket2;
+
+	Bindaddr.type = NETTYPE_IPV4;
+	Socket2 = net_udp_create(Bindaddr);
+	do
+	{
+		Bindaddr.port = secure_rand() % 64511 + 1024;
+	} while(!(Socket1 = net_udp_create(Bindaddr)));
+
+	NETADDR Target;
+	ASSERT_FALSE(net_addr_from_str(&Target, "127.0.0.1"));
+	Target.port = Bindaddr.port;
+
+	net_udp_set_batching(Socket2, 1);
+	const int NumPackets = 200; // more than fit in one batch
+	for(int i = 0; i < NumPackets; i++)
+		EXPECT_EQ(net_udp_send(Socket2, &Target, &i, sizeof(i)), (int)sizeof(i));
+	net_udp_flush(Socket2);
+
+	NETADDR Addr;
+	unsigned char *pData;
+	for(int i = 0; i < NumPackets;)
+	{
+		// received packets may already be buffered, only wait if there are none
+		int Bytes = net_udp_recv(Socket1, &Addr, &pData);
+		if(Bytes <= 0)
+		{
+			ASSERT_EQ(net_socket_read_wait(Socket1, 10000000), 1);
+			continue;
+		}
+		ASSERT_EQ(Bytes, (int)sizeof(i));
+		EXPECT_EQ(mem_comp(pData, &i, sizeof(i)), 0);
+		i++;
+	}
+
+	net_udp_set_batching(Socket2, 0);
+	EXPECT_EQ(net_udp_send(Socket2, &Target, "abc", 3), 3);
+	EXPECT_EQ(net_socket_read_wait(Socket1, 10000000), 1);
+	ASSERT_EQ(net_udp_recv(Socket1, &Addr, &pData), 3);
+	EXPECT_EQ(mem_comp(pData, "abc", 3), 0);
+
+	net_udp_close(Socket1);
+	net_udp_close(Socket2);
+}
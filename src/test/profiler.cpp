@@ -0,0 +1,140 @@
+#include "test.h"
+#include <gtest/gtest.h>
+
+#include <engine/shared/profiler.h>
+
+#include <thread>
+
+TEST(Profiler, Stats)
+{
+	CProfiler Profiler;
+	const int Zone = Profiler.RegisterZone("zone", 1000000);
+	const int Other = Profiler.RegisterZone("other");
+
+	Profiler.Record(Zone, 0, 500000);
+	Profiler.Record(Zone, 0, 2000000);
+	Profiler.Record(Other, 0, 5000000);
+	EXPECT_EQ(Profiler.Count(Zone), 2);
+	EXPECT_EQ(Profiler.Overruns(Zone), 1);
+	EXPECT_EQ(Profiler.Count(Other), 1);
+	EXPECT_EQ(Profiler.Overruns(Other), 0);
+	EXPECT_EQ(Profiler.TotalNs(Zone), 2500000);
+	EXPECT_EQ(Profiler.NumZones(), 2);
+	EXPECT_STREQ(Profiler.ZoneName(Other), "other");
+
+	Profiler.Reset();
+	EXPECT_EQ(Profiler.Count(Zone), 0);
+	EXPECT_EQ(Profiler.Overruns(Zone), 0);
+}
+
+TEST(Profiler, Disabled)
+{
+	CProfiler Profiler;
+	const int Zone = Profiler.RegisterZone("zone");
+	Profiler.SetEnabled(false);
+	{
+		CProfileScope Profile(&Profiler, Zone);
+	}
+	EXPECT_EQ(Profiler.Count(Zone), 0);
+	Profiler.SetEnabled(true);
+	{
+		CProfileScope Profile(&Profiler, Zone);
+		Profile.End();
+	}
+	EXPECT_EQ(Profiler.Count(Zone), 1);
+}
+
+TEST(Profiler, Trace)
+{
+	CTestInfo Info;
+	CProfiler Profiler;
+	const int Zone = Profiler.RegisterZone("zone");
+	const int Worker = Profiler.RegisterZone("worker");
+
+	Profiler.Record(Zone, 1000000, 3000000);
+	std::thread Thread([&]() {
+		for(int i = 0; i < CProfiler::RING_SIZE * 2; i++)
+			Profiler.Record(Worker, 2000000, 2500000);
+	});
+	Thread.join();
+	EXPECT_EQ(Profiler.Count(Worker), CProfiler::RING_SIZE * 2);
+
+	char aFilename[IO_MAX_PATH_LENGTH];
+	Info.Filename(aFilename, sizeof(aFilename), "-trace.json");
+	ASSERT_TRUE(Profiler.WriteTrace(io_open(aFilename, IOFLAG_WRITE)));
+
+	IOHANDLE File = io_open(aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	char *pTrace = io_read_all_str(File);
+	io_close(File);
+	ASSERT_TRUE(pTrace);
+	EXPECT_TRUE(str_startswith(pTrace, "{\n\t\"traceEvents\": ["));
+	EXPECT_TRUE(str_find(pTrace, "\"name\": \"zone\",\n\t\t\t\"ph\": \"X\",\n\t\t\t\"ts\": 0,\n\t\t\t\"dur\": 2000,"));
+	EXPECT_TRUE(str_find(pTrace, "\"ts\": 1000,\n\t\t\t\"dur\": 500,"));
+	free(pTrace);
+	fs_remove(aFilename);
+}
+
+TEST(Profiler, TraceWhileRecording)
+{
+	CTestInfo Info;
+	CProfiler Profiler;
+	const int Zone = Profiler.RegisterZone("zone");
+
+	// every event lasts 500us, a torn copy would mix the times of two events
+	std::atomic_bool Stop{false};
+	std::thread Thread([&]() {
+		for(int64_t i = 0; !Stop.load(); i++)
+			Profiler.Record(Zone, i * 1000000, i * 1000000 + 500000);
+	});
+
+	char aFilename[IO_MAX_PATH_LENGTH];
+	Info.Filename(aFilename, sizeof(aFilename), "-trace.json");
+	for(int i = 0; i < 20; i++)
+	{
+		ASSERT_TRUE(Profiler.WriteTrace(io_open(aFilename, IOFLAG_WRITE)));
+
+		IOHANDLE File = io_open(aFilename, IOFLAG_READ);
+		ASSERT_TRUE(File);
+		char *pTrace = io_read_all_str(File);
+		io_close(File);
+		ASSERT_TRUE(pTrace);
+		for(const char *pDur = str_find(pTrace, "\"dur\": "); pDur; pDur = str_find(pDur + 1, "\"dur\": "))
+			EXPECT_TRUE(str_startswith(pDur, "\"dur\": 500,"));
+		free(pTrace);
+	}
+	Stop.store(true);
+	Thread.join();
+	fs_remove(aFilename);
+}
+
+TEST(Profiler, AlternatingProfilers)
+{
+	CTestInfo Info;
+	CProfiler Profiler;
+	CProfiler Other;
+	const int Zone = Profiler.RegisterZone("zone");
+	const int OtherZone = Other.RegisterZone("other");
+
+	// every thread gets one ring per profiler, no matter how often it switches
+	for(int i = 0; i < 100; i++)
+	{
+		Profiler.Record(Zone, 1000000, 2000000);
+		Other.Record(OtherZone, 1000000, 2000000);
+	}
+	EXPECT_EQ(Profiler.Count(Zone), 100);
+
+	char aFilename[IO_MAX_PATH_LENGTH];
+	Info.Filename(aFilename, sizeof(aFilename), "-trace.json");
+	ASSERT_TRUE(Profiler.WriteTrace(io_open(aFilename, IOFLAG_WRITE)));
+
+	IOHANDLE File = io_open(aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	char *pTrace = io_read_all_str(File);
+	io_close(File);
+	ASSERT_TRUE(pTrace);
+	EXPECT_TRUE(str_find(pTrace, "\"tid\": 0"));
+	EXPECT_FALSE(str_find(pTrace, "\"tid\": 1"));
+	free(pTrace);
+	fs_remove(aFilename);
+}
@@ -9,6 +9,12 @@
 
 #include <sqlite3.h>
 
+#include "test.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #if defined(CONF_TEST_MYSQL)
 int DummyMysqlInit = (MysqlInit(), 1);
 #endif
@@ -36,6 +42,237 @@ TEST(SQLite, Version)
 	ASSERT_GE(sqlite3_libversion_number(), 3025000) << "SQLite >= 3.25.0 required for Window functions";
 }
 
+TEST(SQLite, CachedStatements)
+{
+	auto pConn = CreateSqliteConnection(":memory:", true);
+	char aError[256] = {};
+	ASSERT_FALSE(pConn->Connect(aError, sizeof(aError))) << aError;
+
+	// the same query is reused with other values, also after a reconnect
+	for(int i = 0; i < 3; i++)
+	{
+		ASSERT_FALSE(pConn->PrepareStatement("INSERT INTO record_points(Name, Points) VALUES (?, ?)", aError, sizeof(aError))) << aError;
+		char aName[16];
+		str_format(aName, sizeof(aName), "player%d", i);
+		pConn->BindString(1, aName);
+		pConn->BindInt(2, i * 10);
+		int NumInserted = 0;
+		ASSERT_FALSE(pConn->ExecuteUpdate(&NumInserted, aError, sizeof(aError))) << aError;
+		EXPECT_EQ(NumInserted, 1);
+		pConn->Disconnect();
+		ASSERT_FALSE(pConn->Connect(aError, sizeof(aError))) << aError;
+	}
+
+	for(int i = 0; i < 3; i++)
+	{
+		// a cached statement can be prepared again before all its rows were read
+		ASSERT_FALSE(pConn->PrepareStatement("SELECT Name, Points FROM record_points WHERE Points >= ? ORDER BY Points", aError, sizeof(aError))) << aError;
+		pConn->BindInt(1, i * 10);
+		bool End = true;
+		ASSERT_FALSE(pConn->Step(&End, aError, sizeof(aError))) << aError;
+		ASSERT_FALSE(End);
+		char aName[16];
+		pConn->GetString(1, aName, sizeof(aName));
+		char aExpected[16];
+		str_format(aExpected, sizeof(aExpected), "player%d", i);
+		EXPECT_STREQ(aName, aExpected);
+		EXPECT_EQ(pConn->GetInt(2), i * 10);
+	}
+	pConn->Disconnect();
+}
+
+static std::atomic_int s_NumRunningReads{0};
+static std::atomic_int s_MaxRunningReads{0};
+
+static bool SlowRead(IDbConnection *pSqlServer, const ISqlData *pGameData, char *pError, int ErrorSize)
+{
+	const int Running = ++s_NumRunningReads;
+	int Max = s_MaxRunningReads;
+	while(Running > Max && !s_MaxRunningReads.compare_exchange_weak(Max, Running))
+	{
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	--s_NumRunningReads;
+	return false;
+}
+
+TEST(DbConnectionPool, ParallelReads)
+{
+	CTestInfo Info;
+	char aFilename[IO_MAX_PATH_LENGTH];
+	Info.Filename(aFilename, sizeof(aFilename), ".sqlite");
+
+	std::vector<std::shared_ptr<ISqlResult>> vpResults;
+	{
+		CDbConnectionPool Pool;
+		Pool.RegisterSqliteDatabase(CDbConnectionPool::READ, aFilename);
+		for(int i = 0; i < CDbConnectionPool::NUM_READ_WORKERS; i++)
+		{
+			vpResults.push_back(std::make_shared<ISqlResult>());
+			Pool.Execute(SlowRead, std::make_unique<ISqlData>(vpResults.back()), "slow read");
+		}
+		for(auto &pResult : vpResults)
+			while(!pResult->m_Completed)
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	for(auto &pResult : vpResults)
+		EXPECT_TRUE(pResult->m_Success);
+	// no read waits for the others
+	EXPECT_EQ(s_MaxRunningReads, CDbConnectionPool::NUM_READ_WORKERS);
+	fs_remove(aFilename);
+}
+
+struct CPointsWriteResult : ISqlResult
+{
+	std::atomic_bool m_Committed{false};
+};
+
+struct CPointsWriteData : ISqlData
+{
+	CPointsWriteData(std::shared_ptr<CPointsWriteResult> pResult) :
+		ISqlData(std::move(pResult))
+	{
+	}
+
+	char m_aName[16];
+	bool m_Fail;
+
+	void OnCommitted() const override { static_cast<CPointsWriteResult *>(m_pResult.get())->m_Committed = true; }
+};
+
+static bool PointsWrite(IDbConnection *pSqlServer, const ISqlData *pGameData, Write w, char *pError, int ErrorSize)
+{
+	const auto *pData = dynamic_cast<const CPointsWriteData *>(pGameData);
+	if(pData->m_Fail)
+	{
+		str_copy(pError, "failing on purpose", ErrorSize);
+		return true;
+	}
+	if(pSqlServer->PrepareStatement("INSERT INTO record_points(Name, Points) VALUES (?, 1)", pError, ErrorSize))
+	{
+		return true;
+	}
+	pSqlServer->BindString(1, pData->m_aName);
+	int NumInserted;
+	return pSqlServer->ExecuteUpdate(&NumInserted, pError, ErrorSize);
+}
+
+TEST(DbConnectionPool, BatchedWrites)
+{
+	CTestInfo Info;
+	char aFilename[IO_MAX_PATH_LENGTH];
+	Info.Filename(aFilename, sizeof(aFilename), ".sqlite");
+
+	const int NumWrites = CDbConnectionPool::MAX_WRITE_BATCH * 2 + 3;
+	std::vector<std::shared_ptr<CPointsWriteResult>> vpResults;
+	{
+		CDbConnectionPool Pool;
+		Pool.RegisterSqliteDatabase(CDbConnectionPool::WRITE, aFilename);
+		for(int i = 0; i < NumWrites; i++)
+		{
+			vpResults.push_back(std::make_shared<CPointsWriteResult>());
+			auto pData = std::make_unique<CPointsWriteData>(vpResults.back());
+			str_format(pData->m_aName, sizeof(pData->m_aName), "player%d", i);
+			pData->m_Fail = i == 5;
+			Pool.ExecuteWrite(PointsWrite, std::move(pData), "points write");
+		}
+		for(auto &pResult : vpResults)
+			while(!pResult->m_Completed)
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	// a failing write doesn't roll back the others of its batch
+	for(int i = 0; i < NumWrites; i++)
+	{
+		EXPECT_EQ(vpResults[i]->m_Success, i != 5) << "write " << i;
+		EXPECT_EQ(vpResults[i]->m_Committed.load(), i != 5) << "write " << i;
+	}
+
+	auto pConn = CreateSqliteConnection(aFilename, false);
+	char aError[256] = {};
+	ASSERT_FALSE(pConn->Connect(aError, sizeof(aError))) << aError;
+	ASSERT_FALSE(pConn->PrepareStatement("SELECT COUNT(*) FROM record_points", aError, sizeof(aError))) << aError;
+	bool End = true;
+	ASSERT_FALSE(pConn->Step(&End, aError, sizeof(aError))) << aError;
+	ASSERT_FALSE(End);
+	EXPECT_EQ(pConn->GetInt(1), NumWrites - 1);
+	pConn->Disconnect();
+	pConn.reset();
+	fs_remove(aFilename);
+}
+
+TEST(ScoreCache, InvalidatedOnCommit)
+{
+	CTestInfo Info;
+	char aFilename[IO_MAX_PATH_LENGTH];
+	Info.Filename(aFilename, sizeof(aFilename), ".sqlite");
+	auto pWrite = CreateSqliteConnection(aFilename, true);
+	auto pRead = CreateSqliteConnection(aFilename, false);
+	char aError[256] = {};
+	ASSERT_FALSE(pWrite->Connect(aError, sizeof(aError))) << aError;
+	ASSERT_FALSE(pRead->Connect(aError, sizeof(aError))) << aError;
+
+	g_Config.m_SvRegionalRankings = false;
+	g_Config.m_SvSqlCacheTtl = 30;
+	str_copy(g_Config.m_SvSqlServerName, "USA");
+	auto pCache = std::make_shared<CScoreCache>();
+	auto SaveScore = [&](const char *pName, float Time, CSqlScoreData *pScoreData) {
+		str_copy(pScoreData->m_aMap, "Kobra 3");
+		str_copy(pScoreData->m_aGameUuid, "8d300ecf-5873-4297-bee5-95668fdff320");
+		str_copy(pScoreData->m_aName, pName);
+		pScoreData->m_ClientID = 0;
+		pScoreData->m_Time = Time;
+		str_copy(pScoreData->m_aTimestamp, "2021-11-24 19:24:08");
+		for(float &TimeCp : pScoreData->m_aCurrentTimeCp)
+			TimeCp = 0.0f;
+		str_copy(pScoreData->m_aRequestingPlayer, pName);
+		pScoreData->m_pCache = pCache;
+		return CScoreWorker::SaveScore(pWrite.get(), pScoreData, Write::NORMAL, aError, sizeof(aError));
+	};
+	auto pPlayerResult = std::make_shared<CScorePlayerResult>();
+	CSqlPlayerRequest Request(pPlayerResult);
+	str_copy(Request.m_aMap, "Kobra 3");
+	str_copy(Request.m_aRequestingPlayer, "brainless tee");
+	str_copy(Request.m_aServer, "GER");
+	Request.m_Offset = 0;
+	Request.m_pCache = pCache;
+	auto ShowTop = [&]() {
+		pPlayerResult->SetVariant(CScorePlayerResult::DIRECT);
+		EXPECT_FALSE(CScoreWorker::ShowTop(pRead.get(), &Request, aError, sizeof(aError))) << aError;
+		return std::string(pPlayerResult->m_Data.m_aaMessages[1]);
+	};
+
+	CSqlScoreData First(std::make_shared<CScorePlayerResult>());
+	ASSERT_FALSE(SaveScore("nameless tee", 100.0f, &First)) << aError;
+	First.OnCommitted();
+	EXPECT_EQ(ShowTop(), "1. nameless tee Time: 01:40.00");
+
+	// a read during an open write batch caches what it sees, the old ranks
+	ASSERT_FALSE(pWrite->BeginTransaction(aError, sizeof(aError))) << aError;
+	CSqlScoreData Second(std::make_shared<CScorePlayerResult>());
+	ASSERT_FALSE(SaveScore("brainless tee", 60.0f, &Second)) << aError;
+	EXPECT_EQ(ShowTop(), "1. nameless tee Time: 01:40.00");
+	ASSERT_FALSE(pWrite->CommitTransaction(aError, sizeof(aError))) << aError;
+	Second.OnCommitted();
+	EXPECT_EQ(ShowTop(), "1. brainless tee Time: 01:00.00");
+
+	// a rolled back batch keeps the cached ranks
+	const int Misses = pCache->Misses();
+	ASSERT_FALSE(pWrite->BeginTransaction(aError, sizeof(aError))) << aError;
+	CSqlScoreData Third(std::make_shared<CScorePlayerResult>());
+	ASSERT_FALSE(SaveScore("other tee", 30.0f, &Third)) << aError;
+	pWrite->RollbackTransaction();
+	EXPECT_EQ(ShowTop(), "1. brainless tee Time: 01:00.00");
+	EXPECT_EQ(pCache->Misses(), Misses);
+
+	pRead->Disconnect();
+	pWrite->Disconnect();
+	pRead.reset();
+	pWrite.reset();
+	fs_remove(aFilename);
+}
+
 struct Score : public testing::TestWithParam<IDbConnection *>
 {
 	Score()
@@ -163,6 +400,97 @@ TEST_P(SingleScore, Top)
 			"----------------------------------------"});
 }
 
+TEST_P(SingleScore, TopCached)
+{
+	g_Config.m_SvRegionalRankings = false;
+	g_Config.m_SvSqlCacheTtl = 30;
+	auto pCache = std::make_shared<CScoreCache>();
+	m_PlayerRequest.m_pCache = pCache;
+	ASSERT_FALSE(CScoreWorker::ShowTop(m_pConn, &m_PlayerRequest, m_aError, sizeof(m_aError))) << m_aError;
+	EXPECT_EQ(pCache->Misses(), 1);
+
+	// served from the cache without seeing the faster time of another server
+	int NumUpdated;
+	ASSERT_FALSE(m_pConn->PrepareStatement("UPDATE record_race SET Time = 50", m_aError, sizeof(m_aError))) << m_aError;
+	ASSERT_FALSE(m_pConn->ExecuteUpdate(&NumUpdated, m_aError, sizeof(m_aError))) << m_aError;
+	m_pPlayerResult->SetVariant(CScorePlayerResult::DIRECT);
+	ASSERT_FALSE(CScoreWorker::ShowTop(m_pConn, &m_PlayerRequest, m_aError, sizeof(m_aError))) << m_aError;
+	EXPECT_EQ(pCache->Hits(), 1);
+	ExpectLines(m_pPlayerResult,
+		{"------------ Global Top ------------",
+			"1. nameless tee Time: 01:40.00",
+			"----------------------------------------"});
+
+	// a score saved by this server updates it right away
+	CSqlScoreData ScoreData(std::make_shared<CScorePlayerResult>());
+	str_copy(ScoreData.m_aMap, "Kobra 3");
+	str_copy(ScoreData.m_aGameUuid, "8d300ecf-5873-4297-bee5-95668fdff320");
+	str_copy(ScoreData.m_aName, "brainless tee");
+	ScoreData.m_ClientID = 0;
+	ScoreData.m_Time = 60.0f;
+	str_copy(ScoreData.m_aTimestamp, "2021-11-24 19:24:08");
+	for(float &TimeCp : ScoreData.m_aCurrentTimeCp)
+		TimeCp = 0.0f;
+	str_copy(ScoreData.m_aRequestingPlayer, "brainless tee");
+	ScoreData.m_pCache = pCache;
+	ASSERT_FALSE(CScoreWorker::SaveScore(m_pConn, &ScoreData, Write::NORMAL, m_aError, sizeof(m_aError))) << m_aError;
+	ScoreData.OnCommitted();
+	m_pPlayerResult->SetVariant(CScorePlayerResult::DIRECT);
+	ASSERT_FALSE(CScoreWorker::ShowTop(m_pConn, &m_PlayerRequest, m_aError, sizeof(m_aError))) << m_aError;
+	EXPECT_EQ(pCache->Misses(), 2);
+	ExpectLines(m_pPlayerResult,
+		{"------------ Global Top ------------",
+			"1. nameless tee Time: 00:50.00",
+			"2. brainless tee Time: 01:00.00",
+			"----------------------------------------"});
+}
+
+TEST_P(SingleScore, EqualTimeTied)
+{
+	// an older row, saved with the time formatted into the query
+	int NumUpdated;
+	ASSERT_FALSE(m_pConn->PrepareStatement("UPDATE record_race SET Time = 12.35", m_aError, sizeof(m_aError))) << m_aError;
+	ASSERT_FALSE(m_pConn->ExecuteUpdate(&NumUpdated, m_aError, sizeof(m_aError))) << m_aError;
+
+	CSqlScoreData ScoreData(std::make_shared<CScorePlayerResult>());
+	str_copy(ScoreData.m_aMap, "Kobra 3");
+	str_copy(ScoreData.m_aGameUuid, "8d300ecf-5873-4297-bee5-95668fdff320");
+	str_copy(ScoreData.m_aName, "brainless tee");
+	ScoreData.m_ClientID = 0;
+	ScoreData.m_Time = 12.35f;
+	str_copy(ScoreData.m_aTimestamp, "2021-11-24 19:24:08");
+	for(float &TimeCp : ScoreData.m_aCurrentTimeCp)
+		TimeCp = 0.0f;
+	str_copy(ScoreData.m_aRequestingPlayer, "brainless tee");
+	ASSERT_FALSE(CScoreWorker::SaveScore(m_pConn, &ScoreData, Write::NORMAL, m_aError, sizeof(m_aError))) << m_aError;
+
+	ASSERT_FALSE(m_pConn->PrepareStatement("SELECT Name, RANK() OVER (ORDER BY Time) FROM record_race", m_aError, sizeof(m_aError))) << m_aError;
+	bool End;
+	int NumRows = 0;
+	while(!m_pConn->Step(&End, m_aError, sizeof(m_aError)) && !End)
+	{
+		EXPECT_EQ(m_pConn->GetInt(2), 1);
+		NumRows++;
+	}
+	EXPECT_TRUE(End) << m_aError;
+	EXPECT_EQ(NumRows, 2);
+}
+
+TEST_P(SingleScore, TopCacheDisabled)
+{
+	g_Config.m_SvRegionalRankings = false;
+	g_Config.m_SvSqlCacheTtl = 0;
+	auto pCache = std::make_shared<CScoreCache>();
+	m_PlayerRequest.m_pCache = pCache;
+	for(int i = 0; i < 2; i++)
+	{
+		m_pPlayerResult->SetVariant(CScorePlayerResult::DIRECT);
+		ASSERT_FALSE(CScoreWorker::ShowTop(m_pConn, &m_PlayerRequest, m_aError, sizeof(m_aError))) << m_aError;
+	}
+	EXPECT_EQ(pCache->Hits(), 0);
+	EXPECT_EQ(pCache->Misses(), 2);
+}
+
 TEST_P(SingleScore, RankRegional)
 {
 	g_Config.m_SvRegionalRankings = true;
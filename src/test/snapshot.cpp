@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <engine/shared/snapshot.h>
+#include <game/generated/protocol.h>
+
+#include <iterator>
+#include <memory>
+#include <random>
+
+// creates the NETOBJTYPE_EX item, one extended item and NumProjectiles items with IDs 1 to NumProjectiles
+static int BuildTestSnapshot(CSnapshot *pSnapshot, int NumProjectiles)
+{
+	std::unique_ptr<CSnapshotBuilder> pBuilder = std::make_unique<CSnapshotBuilder>();
+	pBuilder->Init();
+	pBuilder->NewItem(NETOBJTYPE_DDNETCHARACTER, 3, sizeof(CNetObj_DDNetCharacter));
+	pBuilder->Init(); // registers the extended type
+	pBuilder->NewItem(NETOBJTYPE_DDNETCHARACTER, 3, sizeof(CNetObj_DDNetCharacter));
+	for(int i = 1; i <= NumProjectiles; i++)
+	{
+		int *pData = (int *)pBuilder->NewItem(NETOBJTYPE_PROJECTILE + i % 3, i, sizeof(CNetObj_Projectile));
+		pData[0] = i;
+	}
+	return pBuilder->Finish(pSnapshot);
+}
+
+TEST(Snapshot, IndexMatchesLinearSearch)
+{
+	std::unique_ptr<char[]> pData = std::make_unique<char[]>(CSnapshot::MAX_SIZE);
+	CSnapshot *pSnapshot = (CSnapshot *)pData.get();
+	BuildTestSnapshot(pSnapshot, 300);
+
+	std::unique_ptr<CSnapshotIndex> pIndex = std::make_unique<CSnapshotIndex>();
+	pIndex->Build(pSnapshot);
+
+	for(int Type = 0; Type < NETOBJTYPE_PICKUP + 1; Type++)
+	{
+		for(int ID = 0; ID < 310; ID++)
+		{
+			EXPECT_EQ(pIndex->FindItem(Type, ID), pSnapshot->FindItem(Type, ID));
+			EXPECT_EQ(pIndex->GetItemIndex((Type << 16) | ID), pSnapshot->GetItemIndex((Type << 16) | ID));
+		}
+	}
+	EXPECT_NE(pIndex->FindItem(NETOBJTYPE_DDNETCHARACTER, 3), nullptr);
+	EXPECT_EQ(pIndex->FindItem(NETOBJTYPE_DDNETCHARACTER, 3), pSnapshot->FindItem(NETOBJTYPE_DDNETCHARACTER, 3));
+	EXPECT_EQ(pIndex->FindItem(NETOBJTYPE_DDNETCHARACTER, 4), nullptr);
+	EXPECT_EQ(pIndex->FindItem(NETOBJTYPE_DDNETPLAYER, 3), nullptr);
+}
+
+TEST(Snapshot, IndexEmpty)
+{
+	CSnapshotIndex Index;
+	Index.Build(CSnapshot::EmptySnapshot());
+	EXPECT_EQ(Index.GetItemIndex(0), -1);
+	EXPECT_EQ(Index.FindItem(NETOBJTYPE_CHARACTER, 0), nullptr);
+	EXPECT_EQ(Index.FindItem(NETOBJTYPE_DDNETCHARACTER, 0), nullptr);
+}
+
+TEST(Snapshot, DeltaRoundtrip)
+{
+	std::unique_ptr<char[]> pFromData = std::make_unique<char[]>(CSnapshot::MAX_SIZE);
+	std::unique_ptr<char[]> pToData = std::make_unique<char[]>(CSnapshot::MAX_SIZE);
+	std::unique_ptr<char[]> pUnpackedData = std::make_unique<char[]>(CSnapshot::MAX_SIZE);
+	std::unique_ptr<char[]> pDeltaData = std::make_unique<char[]>(CSnapshot::MAX_SIZE);
+	CSnapshot *pFrom = (CSnapshot *)pFromData.get();
+	CSnapshot *pTo = (CSnapshot *)pToData.get();
+	CSnapshot *pUnpacked = (CSnapshot *)pUnpackedData.get();
+
+	BuildTestSnapshot(pFrom, 200);
+	const int ToSize = BuildTestSnapshot(pTo, 250);
+	// change some values, including wrapping ones
+	int *pItemData = (int *)pTo->FindItem(NETOBJTYPE_PROJECTILE + 1, 100);
+	pItemData[1] = -2147483647 - 1;
+	pItemData[2] = 123456;
+
+	CSnapshotDelta Delta;
+	const int DeltaSize = Delta.CreateDelta(pFrom, pTo, pDeltaData.get());
+	ASSERT_GT(DeltaSize, 0);
+	const int UnpackedSize = Delta.UnpackDelta(pFrom, pUnpacked, pDeltaData.get(), DeltaSize);
+	ASSERT_EQ(UnpackedSize, ToSize);
+	EXPECT_EQ(pUnpacked->Crc(), pTo->Crc());
+	for(int i = 0; i < pTo->NumItems(); i++)
+	{
+		const CSnapshotItem *pItem = pTo->GetItem(i);
+		const void *pUnpackedItem = pUnpacked->FindItem(pItem->Type(), pItem->ID());
+		ASSERT_NE(pUnpackedItem, nullptr);
+		EXPECT_EQ(mem_comp(pUnpackedItem, pItem->Data(), pTo->GetItemSize(i)), 0);
+	}
+}
+
+TEST(Snapshot, DeltaKernelsMatchScalar)
+{
+	// values of every packed size, mostly unchanged like real snapshots
+	static const int VALUES[] = {1, -1, 63, -64, 64, 8191, -8192, 8192, 1048575, 1048576, 134217727, -134217728, 134217728, 2147483647, -2147483647 - 1};
+	std::mt19937 Rng(1337);
+	int aPast[67], aCurrent[67], aDiff[67], aExpectedDiff[67], aOut[67], aExpectedOut[67];
+	for(int Size = 0; Size <= (int)std::size(aPast); Size++)
+	{
+		for(int i = 0; i < Size; i++)
+		{
+			aPast[i] = (int)Rng();
+			aCurrent[i] = Rng() % 3 == 0 ? (int)((unsigned)aPast[i] + (unsigned)VALUES[Rng() % std::size(VALUES)]) : aPast[i];
+		}
+
+		EXPECT_EQ(CSnapshotDelta::DiffItem(aPast, aCurrent, aDiff, Size), CSnapshotDelta::DiffItemScalar(aPast, aCurrent, aExpectedDiff, Size));
+		EXPECT_EQ(mem_comp(aDiff, aExpectedDiff, Size * sizeof(int)), 0);
+
+		int DataRate = 7;
+		int ExpectedDataRate = 7;
+		CSnapshotDelta::UndiffItem(aPast, aDiff, aOut, Size, &DataRate);
+		CSnapshotDelta::UndiffItemScalar(aPast, aDiff, aExpectedOut, Size, &ExpectedDataRate);
+		EXPECT_EQ(DataRate, ExpectedDataRate);
+		EXPECT_EQ(mem_comp(aOut, aExpectedOut, Size * sizeof(int)), 0);
+		EXPECT_EQ(mem_comp(aOut, aCurrent, Size * sizeof(int)), 0);
+	}
+}
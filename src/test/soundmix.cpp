@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <base/math.h>
+#include <engine/shared/soundmix.h>
+
+#include <iterator>
+#include <random>
+#include <vector>
+
+static std::vector<short> RandomSamples(std::mt19937 &Random, unsigned Num)
+{
+	std::uniform_int_distribution<int> Dist(-32768, 32767);
+	std::vector<short> vSamples(Num);
+	for(auto &Sample : vSamples)
+		Sample = Dist(Random);
+	return vSamples;
+}
+
+TEST(SoundMix, ConstantVolume)
+{
+	std::mt19937 Random(0);
+	for(int Channels = 1; Channels <= 2; Channels++)
+	{
+		// odd sizes to cover the frames after the vectorized ones
+		for(unsigned NumFrames : {0u, 1u, 3u, 4u, 7u, 64u, 1023u})
+		{
+			const std::vector<short> vIn = RandomSamples(Random, NumFrames * Channels);
+			std::vector<int> vMix(NumFrames * 2, 1000);
+			SoundMixVoice(vMix.data(), vIn.data(), Channels, NumFrames, 200, 17, 200, 17);
+			for(unsigned i = 0; i < NumFrames; i++)
+			{
+				EXPECT_EQ(vMix[i * 2], 1000 + vIn[i * Channels] * 200);
+				EXPECT_EQ(vMix[i * 2 + 1], 1000 + vIn[i * Channels + Channels - 1] * 17);
+			}
+		}
+	}
+}
+
+TEST(SoundMix, Ramp)
+{
+	std::mt19937 Random(1);
+	for(int Channels = 1; Channels <= 2; Channels++)
+	{
+		const unsigned NumFrames = 517;
+		const std::vector<short> vIn = RandomSamples(Random, NumFrames * Channels);
+		std::vector<int> vMix(NumFrames * 2, 0);
+		SoundMixVoice(vMix.data(), vIn.data(), Channels, NumFrames, 0, 255, 255, 3);
+		for(unsigned i = 0; i < NumFrames; i++)
+		{
+			// the volume at every frame is between the linear ramp and one step before it
+			const float VolumeL = 255.0f * i / NumFrames;
+			const float VolumeR = 255.0f - 252.0f * i / NumFrames;
+			EXPECT_NEAR(vMix[i * 2], vIn[i * Channels] * VolumeL, absolute(vIn[i * Channels]) * 255.0f / NumFrames + 2.0f);
+			EXPECT_NEAR(vMix[i * 2 + 1], vIn[i * Channels + Channels - 1] * VolumeR, absolute(vIn[i * Channels + Channels - 1]) * 252.0f / NumFrames + 2.0f);
+		}
+		// starts exactly at the start volumes
+		EXPECT_EQ(vMix[0], 0);
+		EXPECT_EQ(vMix[1], vIn[Channels - 1] * 255);
+	}
+}
+
+TEST(SoundMix, Finish)
+{
+	const int aMix[] = {0, 1 << 8, -(1 << 8), 32767 * 255, -32768 * 255, 2000000000, -2000000000, 123456, -123456, 101 * 256 * 5};
+	const unsigned Num = std::size(aMix);
+	short aOut[std::size(aMix)];
+	for(int MasterVolume : {0, 50, 100})
+	{
+		SoundMixFinish(aOut, aMix, Num, MasterVolume);
+		for(unsigned i = 0; i < Num; i++)
+		{
+			const long long Expected = clamp<long long>((long long)aMix[i] * MasterVolume / (101 * 256), -32768, 32767);
+			EXPECT_NEAR(aOut[i], Expected, 1) << "sample " << i << " master volume " << MasterVolume;
+		}
+	}
+
+	// saturated, not wrapped
+	SoundMixFinish(aOut, aMix, Num, 100);
+	EXPECT_EQ(aOut[5], 32767);
+	EXPECT_EQ(aOut[6], -32768);
+}
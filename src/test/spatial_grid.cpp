@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <game/server/spatial_grid.h>
+
+#include <algorithm>
+#include <random>
+
+struct SItem
+{
+	vec2 m_Pos;
+	int m_Handle;
+};
+
+static const float WORLD_SIZE = 200 * 32.0f;
+static const float CELL_SIZE = 8 * 32.0f;
+
+static vec2 RandomPos(std::mt19937 &Random)
+{
+	// some positions outside of the grid
+	std::uniform_real_distribution<float> Dist(-500.0f, WORLD_SIZE + 500.0f);
+	return vec2(Dist(Random), Dist(Random));
+}
+
+static std::vector<SItem *> QueryGrid(const CSpatialGrid<SItem> &Grid, vec2 Pos, float Radius)
+{
+	std::vector<SItem *> vpResult;
+	Grid.Query(Pos - vec2(Radius, Radius), Pos + vec2(Radius, Radius), [&](SItem *pItem) {
+		if(distance(pItem->m_Pos, Pos) < Radius)
+			vpResult.push_back(pItem);
+	});
+	std::sort(vpResult.begin(), vpResult.end());
+	return vpResult;
+}
+
+static std::vector<SItem *> QueryAll(std::vector<SItem> &vItems, vec2 Pos, float Radius)
+{
+	std::vector<SItem *> vpResult;
+	for(auto &Item : vItems)
+	{
+		if(Item.m_Handle >= 0 && distance(Item.m_Pos, Pos) < Radius)
+			vpResult.push_back(&Item);
+	}
+	std::sort(vpResult.begin(), vpResult.end());
+	return vpResult;
+}
+
+TEST(SpatialGrid, MatchesScan)
+{
+	std::mt19937 Random(0);
+	std::uniform_real_distribution<float> RadiusDist(0.0f, 1000.0f);
+
+	CSpatialGrid<SItem> Grid;
+	Grid.Init(WORLD_SIZE, WORLD_SIZE, CELL_SIZE);
+	std::vector<SItem> vItems(500);
+	for(auto &Item : vItems)
+	{
+		Item.m_Pos = RandomPos(Random);
+		Item.m_Handle = Grid.Insert(&Item, Item.m_Pos);
+	}
+
+	for(int Round = 0; Round < 50; Round++)
+	{
+		for(int i = 0; i < 100; i++)
+		{
+			SItem &Item = vItems[Random() % vItems.size()];
+			if(Item.m_Handle < 0)
+			{
+				Item.m_Pos = RandomPos(Random);
+				Item.m_Handle = Grid.Insert(&Item, Item.m_Pos);
+			}
+			else if(Random() % 4 == 0)
+			{
+				Grid.Remove(Item.m_Handle);
+				Item.m_Handle = -1;
+			}
+			else
+			{
+				// mostly small steps
+				Item.m_Pos += Random() % 2 ? vec2(RadiusDist(Random) / 10.0f, -3.0f) : RandomPos(Random) - Item.m_Pos;
+				Grid.Move(Item.m_Handle, Item.m_Pos);
+			}
+		}
+
+		for(int i = 0; i < 20; i++)
+		{
+			const vec2 Pos = RandomPos(Random);
+			const float Radius = RadiusDist(Random);
+			EXPECT_EQ(QueryGrid(Grid, Pos, Radius), QueryAll(vItems, Pos, Radius));
+		}
+	}
+
+	int NumItems = std::count_if(vItems.begin(), vItems.end(), [](const SItem &Item) { return Item.m_Handle >= 0; });
+	EXPECT_EQ(Grid.NumItems(), NumItems);
+
+	// resizing keeps the items
+	Grid.Init(WORLD_SIZE / 2, WORLD_SIZE, CELL_SIZE / 2);
+	EXPECT_EQ(QueryGrid(Grid, vec2(WORLD_SIZE / 2, WORLD_SIZE / 2), WORLD_SIZE), QueryAll(vItems, vec2(WORLD_SIZE / 2, WORLD_SIZE / 2), WORLD_SIZE));
+}
+
+// moves the item in the grid on every position change, like CEntity::SetPos
+struct SEntity
+{
+	CSpatialGrid<SEntity> *m_pGrid;
+	vec2 m_Pos;
+	int m_Handle;
+
+	void SetPos(vec2 Pos)
+	{
+		m_Pos = Pos;
+		m_pGrid->Move(m_Handle, m_Pos);
+	}
+};
+
+static std::vector<SEntity *> QueryEntities(const CSpatialGrid<SEntity> &Grid, vec2 Pos, float Radius, float ProximityRadius)
+{
+	// the same margin the world's range queries use
+	const float Margin = Radius + ProximityRadius + 1.0f;
+	std::vector<SEntity *> vpResult;
+	Grid.Query(Pos - vec2(Margin, Margin), Pos + vec2(Margin, Margin), [&](SEntity *pEnt) {
+		if(distance(pEnt->m_Pos, Pos) < Radius + ProximityRadius)
+			vpResult.push_back(pEnt);
+	});
+	return vpResult;
+}
+
+TEST(SpatialGrid, TeleportedByOtherEntity)
+{
+	const float ProximityRadius = 28.0f;
+	CSpatialGrid<SEntity> Grid;
+	Grid.Init(WORLD_SIZE, WORLD_SIZE, CELL_SIZE);
+	SEntity A = {&Grid, vec2(100.0f, 100.0f), -1};
+	SEntity B = {&Grid, vec2(200.0f, 100.0f), -1};
+	A.m_Handle = Grid.Insert(&A, A.m_Pos);
+	B.m_Handle = Grid.Insert(&B, B.m_Pos);
+
+	// A's tick teleports B far away and then looks for it there, before
+	// B's own tick ran
+	const vec2 TeleOut = vec2(WORLD_SIZE - 300.0f, WORLD_SIZE - 500.0f);
+	B.SetPos(TeleOut);
+	EXPECT_EQ(QueryEntities(Grid, TeleOut + vec2(10.0f, 0.0f), 5.0f, ProximityRadius), std::vector<SEntity *>{&B});
+	EXPECT_EQ(QueryEntities(Grid, vec2(200.0f, 100.0f), 5.0f, ProximityRadius), std::vector<SEntity *>{});
+	EXPECT_EQ(QueryEntities(Grid, A.m_Pos, 5.0f, ProximityRadius), std::vector<SEntity *>{&A});
+}
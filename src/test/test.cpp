@@ -59,6 +59,9 @@ public:
 		{
 			return m_IsDirectory < Other.m_IsDirectory;
 		}
+		// subdirectories before their parents
+		if(m_IsDirectory)
+			return str_comp(m_aData, Other.m_aData) > 0;
 		return str_comp(m_aData, Other.m_aData) < 0;
 	}
 };
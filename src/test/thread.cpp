@@ -96,3 +96,41 @@ TEST(Thread, Lock)
 	thread_wait(pThread);
 	lock_destroy(Lock);
 }
+
+static const int SPSC_NUM_ITEMS = 100000;
+
+static void SpscProducerThread(void *pUser)
+{
+	CSpscQueue<int, 16> *pQueue = (CSpscQueue<int, 16> *)pUser;
+	for(int i = 0; i < SPSC_NUM_ITEMS;)
+	{
+		int *pItem = pQueue->Back();
+		if(!pItem)
+		{
+			thread_yield();
+			continue;
+		}
+		*pItem = i++;
+		pQueue->Push();
+	}
+}
+
+TEST(Thread, SpscQueue)
+{
+	CSpscQueue<int, 16> Queue;
+	EXPECT_EQ(Queue.Front(), nullptr);
+	void *pThread = thread_init(SpscProducerThread, &Queue, "spsc");
+	for(int i = 0; i < SPSC_NUM_ITEMS;)
+	{
+		int *pItem = Queue.Front();
+		if(!pItem)
+		{
+			thread_yield();
+			continue;
+		}
+		ASSERT_EQ(*pItem, i++);
+		Queue.Pop();
+	}
+	thread_wait(pThread);
+	EXPECT_EQ(Queue.Front(), nullptr);
+}
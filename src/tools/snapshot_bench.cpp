@@ -0,0 +1,213 @@
+#include <base/logger.h>
+#include <base/math.h>
+#include <base/system.h>
+#include <engine/shared/compression.h>
+#include <engine/shared/demo.h>
+#include <engine/shared/network.h>
+#include <engine/shared/snapshot.h>
+#include <engine/storage.h>
+
+#include <chrono>
+#include <vector>
+
+// replays the snapshots of a demo through the vectorized and the scalar snapshot delta kernels
+
+static const char *TOOL_NAME = "snapshot_bench";
+
+class CSnapshotCollector : public CDemoPlayer::IListener
+{
+public:
+	std::vector<std::vector<char>> m_vvSnapshots;
+
+	void OnDemoPlayerSnapshot(void *pData, int Size) override
+	{
+		m_vvSnapshots.emplace_back((char *)pData, (char *)pData + Size);
+	}
+
+	void OnDemoPlayerMessage(void *pData, int Size) override {}
+};
+
+struct SItemPair
+{
+	const int *m_pPast;
+	const int *m_pCurrent;
+	int m_Size;
+	int m_Offset;
+};
+
+struct SKernelTime
+{
+	const char *m_pName;
+	std::chrono::nanoseconds m_Scalar{0};
+	std::chrono::nanoseconds m_Vectorized{0};
+};
+
+enum
+{
+	KERNEL_DIFF = 0,
+	KERNEL_UNDIFF,
+	KERNEL_COMPRESS,
+	KERNEL_DECOMPRESS,
+	NUM_KERNELS
+};
+
+template<typename F>
+static std::chrono::nanoseconds Measure(int Rounds, F &&Func)
+{
+	const auto Start = time_get_nanoseconds();
+	for(int i = 0; i < Rounds; i++)
+		Func();
+	return time_get_nanoseconds() - Start;
+}
+
+static bool LoadSnapshots(const char *pDemoFilePath, IStorage *pStorage, CSnapshotCollector *pCollector)
+{
+	CSnapshotDelta DemoSnapshotDelta;
+	CDemoPlayer DemoPlayer(&DemoSnapshotDelta, false);
+	if(DemoPlayer.Load(pStorage, nullptr, pDemoFilePath, IStorage::TYPE_ALL_OR_ABSOLUTE) == -1)
+	{
+		dbg_msg(TOOL_NAME, "Demo file '%s' failed to load: %s", pDemoFilePath, DemoPlayer.ErrorMessage());
+		return false;
+	}
+
+	DemoPlayer.SetListener(pCollector);
+	const CDemoPlayer::CPlaybackInfo *pInfo = DemoPlayer.Info();
+	DemoPlayer.Play();
+	while(DemoPlayer.IsPlaying())
+	{
+		DemoPlayer.Update(false);
+		if(pInfo->m_Info.m_Paused)
+			break;
+	}
+	DemoPlayer.Stop();
+	return true;
+}
+
+// times both paths on one pair of consecutive snapshots, returns false if their output differs
+static bool ReplayPair(const CSnapshot *pFrom, CSnapshot *pTo, int Rounds, SKernelTime *pTimes)
+{
+	std::vector<SItemPair> vItems;
+	int NumInts = 0;
+	for(int i = 0; i < pTo->NumItems(); i++)
+	{
+		const int PastIndex = pFrom->GetItemIndex(pTo->GetItem(i)->Key());
+		const int Size = pTo->GetItemSize(i);
+		if(PastIndex < 0 || pFrom->GetItemSize(PastIndex) != Size)
+			continue;
+		vItems.push_back({(const int *)pFrom->GetItem(PastIndex)->Data(), (const int *)pTo->GetItem(i)->Data(), Size / (int)sizeof(int), NumInts});
+		NumInts += Size / (int)sizeof(int);
+	}
+
+	std::vector<int> vDiff(NumInts), vExpectedDiff(NumInts), vOut(NumInts), vExpectedOut(NumInts);
+	int DataRate = 0;
+	int ExpectedDataRate = 0;
+	for(const SItemPair &Item : vItems)
+	{
+		const int Offset = Item.m_Offset;
+		if(CSnapshotDelta::DiffItem(Item.m_pPast, Item.m_pCurrent, &vDiff[Offset], Item.m_Size) != CSnapshotDelta::DiffItemScalar(Item.m_pPast, Item.m_pCurrent, &vExpectedDiff[Offset], Item.m_Size))
+			return false;
+		CSnapshotDelta::UndiffItem(Item.m_pPast, &vDiff[Offset], &vOut[Offset], Item.m_Size, &DataRate);
+		CSnapshotDelta::UndiffItemScalar(Item.m_pPast, &vDiff[Offset], &vExpectedOut[Offset], Item.m_Size, &ExpectedDataRate);
+	}
+	if(vDiff != vExpectedDiff || vOut != vExpectedOut || DataRate != ExpectedDataRate)
+		return false;
+
+	pTimes[KERNEL_DIFF].m_Scalar += Measure(Rounds, [&]() {
+		for(const SItemPair &Item : vItems)
+			CSnapshotDelta::DiffItemScalar(Item.m_pPast, Item.m_pCurrent, &vDiff[Item.m_Offset], Item.m_Size);
+	});
+	pTimes[KERNEL_DIFF].m_Vectorized += Measure(Rounds, [&]() {
+		for(const SItemPair &Item : vItems)
+			CSnapshotDelta::DiffItem(Item.m_pPast, Item.m_pCurrent, &vDiff[Item.m_Offset], Item.m_Size);
+	});
+	pTimes[KERNEL_UNDIFF].m_Scalar += Measure(Rounds, [&]() {
+		for(const SItemPair &Item : vItems)
+			CSnapshotDelta::UndiffItemScalar(Item.m_pPast, &vDiff[Item.m_Offset], &vOut[Item.m_Offset], Item.m_Size, &DataRate);
+	});
+	pTimes[KERNEL_UNDIFF].m_Vectorized += Measure(Rounds, [&]() {
+		for(const SItemPair &Item : vItems)
+			CSnapshotDelta::UndiffItem(Item.m_pPast, &vDiff[Item.m_Offset], &vOut[Item.m_Offset], Item.m_Size, &DataRate);
+	});
+
+	// the delta as the server sends it
+	std::vector<char> vDelta(CSnapshot::MAX_SIZE);
+	CSnapshotDelta Delta;
+	const int DeltaSize = Delta.CreateDelta(pFrom, pTo, vDelta.data());
+	if(DeltaSize <= 0)
+		return true;
+
+	std::vector<unsigned char> vCompressed(DeltaSize / sizeof(int) * CVariableInt::MAX_BYTES_PACKED), vExpectedCompressed(vCompressed.size());
+	const long CompressedSize = CVariableInt::Compress(vDelta.data(), DeltaSize, vCompressed.data(), vCompressed.size());
+	if(CompressedSize < 0 || CompressedSize != CVariableInt::CompressScalar(vDelta.data(), DeltaSize, vExpectedCompressed.data(), vExpectedCompressed.size()) || vCompressed != vExpectedCompressed)
+		return false;
+	std::vector<char> vDecompressed(DeltaSize), vExpectedDecompressed(DeltaSize);
+	if(CVariableInt::Decompress(vCompressed.data(), CompressedSize, vDecompressed.data(), DeltaSize) != DeltaSize ||
+		CVariableInt::DecompressScalar(vCompressed.data(), CompressedSize, vExpectedDecompressed.data(), DeltaSize) != DeltaSize ||
+		vDecompressed != vExpectedDecompressed || mem_comp(vDecompressed.data(), vDelta.data(), DeltaSize) != 0)
+		return false;
+
+	pTimes[KERNEL_COMPRESS].m_Scalar += Measure(Rounds, [&]() {
+		CVariableInt::CompressScalar(vDelta.data(), DeltaSize, vCompressed.data(), vCompressed.size());
+	});
+	pTimes[KERNEL_COMPRESS].m_Vectorized += Measure(Rounds, [&]() {
+		CVariableInt::Compress(vDelta.data(), DeltaSize, vCompressed.data(), vCompressed.size());
+	});
+	pTimes[KERNEL_DECOMPRESS].m_Scalar += Measure(Rounds, [&]() {
+		CVariableInt::DecompressScalar(vCompressed.data(), CompressedSize, vDecompressed.data(), DeltaSize);
+	});
+	pTimes[KERNEL_DECOMPRESS].m_Vectorized += Measure(Rounds, [&]() {
+		CVariableInt::Decompress(vCompressed.data(), CompressedSize, vDecompressed.data(), DeltaSize);
+	});
+	return true;
+}
+
+int main(int argc, const char *argv[])
+{
+	CCmdlineFix CmdlineFix(&argc, &argv);
+	log_set_global_logger_default();
+
+	if(argc != 2 && argc != 3)
+	{
+		dbg_msg(TOOL_NAME, "Usage: %s <demo_filename> [rounds]", TOOL_NAME);
+		return -1;
+	}
+	const int Rounds = argc == 3 ? maximum(1, str_toint(argv[2])) : 10;
+
+	IStorage *pStorage = CreateLocalStorage();
+	if(!pStorage)
+	{
+		dbg_msg(TOOL_NAME, "Error loading storage");
+		return -1;
+	}
+
+	CNetBase::Init();
+	CSnapshotCollector Collector;
+	if(!LoadSnapshots(argv[1], pStorage, &Collector))
+		return -1;
+	if(Collector.m_vvSnapshots.size() < 2)
+	{
+		dbg_msg(TOOL_NAME, "Demo file '%s' has less than two snapshots", argv[1]);
+		return -1;
+	}
+
+	SKernelTime aTimes[NUM_KERNELS] = {{"DiffItem"}, {"UndiffItem"}, {"Compress"}, {"Decompress"}};
+	for(size_t i = 1; i < Collector.m_vvSnapshots.size(); i++)
+	{
+		const CSnapshot *pFrom = (const CSnapshot *)Collector.m_vvSnapshots[i - 1].data();
+		CSnapshot *pTo = (CSnapshot *)Collector.m_vvSnapshots[i].data();
+		if(!ReplayPair(pFrom, pTo, Rounds, aTimes))
+		{
+			dbg_msg(TOOL_NAME, "Output of the vectorized kernels differs at snapshot %d", (int)i);
+			return -1;
+		}
+	}
+
+	printf("%d snapshots, %d rounds\n", (int)Collector.m_vvSnapshots.size(), Rounds);
+	for(const SKernelTime &Time : aTimes)
+	{
+		const double ScalarMs = Time.m_Scalar.count() / 1000000.0;
+		const double VectorizedMs = Time.m_Vectorized.count() / 1000000.0;
+		printf("%-10s scalar %9.3f ms, vectorized %9.3f ms, %.2fx\n", Time.m_pName, ScalarMs, VectorizedMs, VectorizedMs > 0.0 ? ScalarMs / VectorizedMs : 0.0);
+	}
+	return 0;
+}